@@ -170,6 +170,10 @@ const char *DBuffer::convertOutputToInput(void) {
 
     return (const char *)m_pcData;
   }
+
+  if (isInput()) {
+    return (const char *)m_pcData;
+  }
   return NULL;
 }
 
@@ -58,6 +58,7 @@ public:
   void writeBuf_LE(const char *pcBuf, int nBufSize);
   void readBuf_LE(char *pcBuf, int nBufSize);
   int numRemainingBytes(void);
+  /* a buffer already converted gives its input data again */
   const char *convertOutputToInput(void);
 
   /* Some I/O */
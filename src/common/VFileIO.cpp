@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <windows.h>
 #else
 #include <dirent.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -459,21 +460,23 @@ std::vector<std::string> XMFS::findPhysFiles(FileDataType i_fdt,
 #endif
 
   if (i_fdt == FDT_DATA) {
-    /* Look in package */
-    for (unsigned int i = 0; i < m_PackFiles.size(); i++) {
-      /* Make sure about the directory... */
-      int k = Files.find_last_of('/');
-      std::string Ds1 = Files.substr(0, k + 1);
-      k = m_PackFiles[i].Name.find_last_of('/');
-      std::string Ds2 = m_PackFiles[i].Name.substr(0, k + 1);
-      if (Ds1.substr(0, 2) == "./")
-        Ds1.erase(Ds1.begin(), Ds1.begin() + 2);
-
-      if (Ds1 == Ds2 && str_match_wildcard((char *)Files.c_str(),
-                                           (char *)m_PackFiles[i].Name.c_str(),
-                                           true)) {
-        /* Match. */
-        Result.push_back(m_PackFiles[i].Name);
+    /* Look in package, only in the directory */
+    int k = Files.find_last_of('/');
+    std::string Ds1 = Files.substr(0, k + 1);
+    if (Ds1.substr(0, 2) == "./")
+      Ds1.erase(Ds1.begin(), Ds1.begin() + 2);
+
+    HashNamespace::unordered_map<std::string,
+                                 std::vector<unsigned int> >::const_iterator
+      v_dir = m_PackDirsIndex.find(Ds1);
+    if (v_dir != m_PackDirsIndex.end()) {
+      for (unsigned int i = 0; i < v_dir->second.size(); i++) {
+        const PackFile &v_packFile = m_PackFiles[v_dir->second[i]];
+        if (str_match_wildcard(
+              (char *)Files.c_str(), (char *)v_packFile.Name.c_str(), true)) {
+          /* Match. */
+          Result.push_back(v_packFile.Name);
+        }
       }
     }
   }
@@ -546,9 +549,7 @@ FileHandle *XMFS::openIFile(FileDataType i_fdt,
   }
 
   if (i_fdt == FDT_DATA) {
-    if (pfh->fp == NULL) {
-      int v_packsize = m_PackFiles.size();
-
+    if (pfh->fp == NULL && m_PackData != NULL) {
       // remove all ./ of the Path
       std::string v_path = Path;
       while (v_path.substr(0, 2) == "./") {
@@ -556,24 +557,19 @@ FileHandle *XMFS::openIFile(FileDataType i_fdt,
       }
 
       /* No luck so far, look in the data package */
-      for (unsigned int i = 0; i < v_packsize; i++) {
-        if (m_PackFiles[i].Name == v_path) {
-          /* Found it, yeah. */
-          pfh->fp = fopen(m_BinDataFile.c_str(), "rb");
-          if (pfh->fp != NULL) {
-            fseek(pfh->fp, m_PackFiles[i].nOffset, SEEK_SET);
-            pfh->Type = FHT_PACKAGE;
-            pfh->nSize = m_PackFiles[i].nSize;
-            pfh->nOffset = ftell(pfh->fp);
-            //            printf("OPENED '%s' IN PACKAGE!\n",Path.c_str());
-          } else
-            break;
-        }
+      HashNamespace::unordered_map<std::string, unsigned int>::const_iterator
+        v_packFile = m_PackFilesIndex.find(v_path);
+      if (v_packFile != m_PackFilesIndex.end()) {
+        /* Found it, yeah. */
+        pfh->Type = FHT_PACKAGE;
+        pfh->nSize = m_PackFiles[v_packFile->second].nSize;
+        pfh->pcData = m_PackData + m_PackFiles[v_packFile->second].nOffset;
+        pfh->nPos = 0;
       }
     }
   }
 
-  if (pfh->fp == NULL) {
+  if (pfh->fp == NULL && pfh->Type != FHT_PACKAGE) {
     delete pfh;
     return NULL;
   }
@@ -594,7 +590,7 @@ void XMFS::closeFile(FileHandle *pfh) {
   if (pfh->Type == FHT_STDIO) {
     fclose(pfh->fp);
   } else if (pfh->Type == FHT_PACKAGE) {
-    fclose(pfh->fp);
+    /* nothing to close, the data is in the package mapping */
   } else
     _ThrowFileError(pfh, "closeFile -> invalid type");
   delete pfh;
@@ -607,16 +603,13 @@ bool XMFS::readBuf(FileHandle *pfh, char *pcBuf, unsigned int nBufSize) {
     if (fread(pcBuf, 1, nBufSize, pfh->fp) != nBufSize)
       return false;
   } else if (pfh->Type == FHT_PACKAGE) {
-    int nRem = pfh->nSize - (ftell(pfh->fp) - pfh->nOffset);
-    //      printf("reading %d bytes. %d left  (%d %d
-    //      %d).\n",nBufSize,nRem,pfh->nSize,ftell(pfh->fp),pfh->nOffset);
+    int nRem = pfh->nSize - pfh->nPos;
     if (nBufSize == 0)
       return true;
-    if (nRem > 0) {
-      if (fread(pcBuf, 1, nBufSize, pfh->fp) != nBufSize)
-        return false;
-    } else
+    if (nRem < (int)nBufSize)
       return false;
+    memcpy(pcBuf, pfh->pcData + pfh->nPos, nBufSize);
+    pfh->nPos += nBufSize;
   } else
     _ThrowFileError(pfh, "readBuf -> invalid type");
   return true;
@@ -637,7 +630,9 @@ bool XMFS::setOffset(FileHandle *pfh, int nOffset) {
   if (pfh->Type == FHT_STDIO) {
     fseek(pfh->fp, nOffset, SEEK_SET);
   } else if (pfh->Type == FHT_PACKAGE) {
-    fseek(pfh->fp, nOffset + pfh->nOffset, SEEK_SET);
+    if (nOffset < 0 || nOffset > pfh->nSize)
+      return false;
+    pfh->nPos = nOffset;
   } else
     _ThrowFileError(pfh, "setOffset -> invalid type");
   return true; /* blahh, this is not right, but... */
@@ -647,7 +642,7 @@ bool XMFS::setEnd(FileHandle *pfh) {
   if (pfh->Type == FHT_STDIO) {
     fseek(pfh->fp, 0, SEEK_END);
   } else if (pfh->Type == FHT_PACKAGE) {
-    fseek(pfh->fp, pfh->nSize + pfh->nOffset, SEEK_SET);
+    pfh->nPos = pfh->nSize;
   } else
     _ThrowFileError(pfh, "setEnd -> invalid type");
   return true; /* ... */
@@ -658,7 +653,7 @@ int XMFS::getOffset(FileHandle *pfh) {
   if (pfh->Type == FHT_STDIO) {
     nOffset = ftell(pfh->fp);
   } else if (pfh->Type == FHT_PACKAGE) {
-    nOffset = ftell(pfh->fp) - pfh->nOffset;
+    nOffset = pfh->nPos;
   } else
     _ThrowFileError(pfh, "getOffset -> invalid type");
   return nOffset;
@@ -674,8 +669,7 @@ bool XMFS::isEnd(FileHandle *pfh) {
     if (!feof(pfh->fp))
       bEnd = false;
   } else if (pfh->Type == FHT_PACKAGE) {
-    int nRem = pfh->nSize - (ftell(pfh->fp) - pfh->nOffset);
-    if (nRem > 0)
+    if (pfh->nPos < pfh->nSize)
       bEnd = false;
   } else
     _ThrowFileError(pfh, "isEnd -> invalid type");
@@ -690,6 +684,13 @@ std::string XMFS::readFileToEnd(FileHandle *pfh) {
 
   v_res = "";
 
+  /* package file : straight from the mapping */
+  if (pfh->Type == FHT_PACKAGE) {
+    v_res.assign(pfh->pcData + pfh->nPos, pfh->nSize - pfh->nPos);
+    pfh->nPos = pfh->nSize;
+    return v_res;
+  }
+
   while (v_remaining > 0) {
     v_toread = v_remaining > 16384 ? 16384 : v_remaining;
     if (readBuf(pfh, v_buffer, v_toread) == false) {
@@ -977,6 +978,20 @@ int XMFS::getFileTimeStamp(const std::string &Path) {
   return (int)S.st_mtime; /* no we don't care about exact value */
 }
 
+bool XMFS::getFileSizeAndTimeStamp(const std::string &Path,
+                                   int &o_size,
+                                   int &o_timeStamp) {
+  struct stat S;
+
+  if (stat(Path.c_str(), &S)) {
+    return false;
+  }
+
+  o_size = (int)S.st_size;
+  o_timeStamp = (int)S.st_mtime;
+  return true;
+}
+
 /*===========================================================================
   Is that a dir or what? - and similar stuffin'
   ===========================================================================*/
@@ -1176,6 +1191,15 @@ bool XMFS::m_bGotSystemDataDir;
 std::string XMFS::m_BinDataFile = "<unavailable>";
 std::string XMFS::m_binCheckSum = "";
 std::vector<PackFile> XMFS::m_PackFiles;
+HashNamespace::unordered_map<std::string, unsigned int> XMFS::m_PackFilesIndex;
+HashNamespace::unordered_map<std::string, std::vector<unsigned int> >
+  XMFS::m_PackDirsIndex;
+const char *XMFS::m_PackData = NULL;
+size_t XMFS::m_PackDataSize = 0;
+bool XMFS::m_PackDataMapped = false;
+#ifdef WIN32
+void *XMFS::m_PackMapping = NULL;
+#endif
 
 const char *buildBinFilePath = "bin/xmoto.bin";
 
@@ -1496,6 +1520,11 @@ void XMFS::init(const std::string &AppDir,
         v_packFile.nOffset = ftell(fp);
         v_packFile.nSize = nSize;
         m_PackFiles.push_back(v_packFile);
+
+        m_PackFilesIndex[v_packFile.Name] = m_PackFiles.size() - 1;
+        m_PackDirsIndex[v_packFile.Name.substr(
+                          0, v_packFile.Name.find_last_of('/') + 1)]
+          .push_back(m_PackFiles.size() - 1);
       }
 
       fseek(fp, nSize, SEEK_CUR);
@@ -1503,6 +1532,7 @@ void XMFS::init(const std::string &AppDir,
   } else {
     throw Exception("Invalid binary data package format");
   }
+  _MapPackage(fp);
   fclose(fp);
 
   m_isInitialized = true;
@@ -1535,9 +1565,94 @@ void XMFS::uninit() {
     free(m_xdgHd);
   }
 #endif
+  _UnmapPackage();
+  m_PackFiles.clear();
+  m_PackFilesIndex.clear();
+  m_PackDirsIndex.clear();
   m_isInitialized = false;
 }
 
+void XMFS::_MapPackage(FILE *fp) {
+  long v_size;
+
+  fseek(fp, 0, SEEK_END);
+  v_size = ftell(fp);
+  if (v_size <= 0) {
+    throw Exception("Unable to get the size of the binary data package");
+  }
+  m_PackDataSize = v_size;
+
+#ifdef WIN32
+  m_PackMapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno(fp)),
+                                    NULL,
+                                    PAGE_READONLY,
+                                    0,
+                                    0,
+                                    NULL);
+  if (m_PackMapping != NULL) {
+    m_PackData = (const char *)MapViewOfFile(
+      (HANDLE)m_PackMapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_PackData == NULL) {
+      CloseHandle((HANDLE)m_PackMapping);
+      m_PackMapping = NULL;
+    }
+  }
+#else
+  void *v_data =
+    mmap(NULL, m_PackDataSize, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+  m_PackData = v_data == MAP_FAILED ? NULL : (const char *)v_data;
+#endif
+  /* the mapping stays valid once the file is closed */
+
+  if (m_PackData != NULL) {
+    m_PackDataMapped = true;
+  } else {
+    /* no mapping, read it in memory */
+    LogWarning("Unable to map the binary data package, reading it");
+    char *v_data = (char *)malloc(m_PackDataSize);
+    if (v_data == NULL) {
+      throw Exception("Unable to read the binary data package");
+    }
+    fseek(fp, 0, SEEK_SET);
+    if (fread(v_data, 1, m_PackDataSize, fp) != m_PackDataSize) {
+      free(v_data);
+      throw Exception("Unable to read the binary data package");
+    }
+    m_PackData = v_data;
+    m_PackDataMapped = false;
+  }
+
+  /* don't trust the package index beyond the end of the file */
+  for (unsigned int i = 0; i < m_PackFiles.size(); i++) {
+    if (m_PackFiles[i].nOffset < 0 || m_PackFiles[i].nSize < 0 ||
+        (size_t)m_PackFiles[i].nOffset + m_PackFiles[i].nSize >
+          m_PackDataSize) {
+      throw Exception("Invalid binary data package (truncated)");
+    }
+  }
+}
+
+void XMFS::_UnmapPackage() {
+  if (m_PackData == NULL) {
+    return;
+  }
+
+  if (m_PackDataMapped) {
+#ifdef WIN32
+    UnmapViewOfFile(m_PackData);
+    CloseHandle((HANDLE)m_PackMapping);
+    m_PackMapping = NULL;
+#else
+    munmap((void *)m_PackData, m_PackDataSize);
+#endif
+  } else {
+    free((void *)m_PackData);
+  }
+
+  m_PackData = NULL;
+  m_PackDataSize = 0;
+}
+
 bool XMFS::isInitialized() {
   return m_isInitialized;
 }
@@ -1664,14 +1779,15 @@ std::string XMFS::md5sum(FileDataType i_fdt, std::string i_filePath) {
 
   if (i_fdt == FDT_DATA) {
     /* package */
-    for (unsigned int i = 0; i < m_PackFiles.size(); i++) {
-      if (m_PackFiles[i].Name == i_filePath ||
-          (std::string("./") + m_PackFiles[i].Name) == i_filePath) {
-        /* Found it, yeah. */
-        // printf("md5sum(%s) = %s\n", m_PackFiles[i].Name.c_str(),
-        // m_PackFiles[i].md5sum.c_str());
-        return m_PackFiles[i].md5sum;
-      }
+    HashNamespace::unordered_map<std::string, unsigned int>::const_iterator
+      v_packFile = m_PackFilesIndex.find(i_filePath);
+    if (v_packFile == m_PackFilesIndex.end() &&
+        i_filePath.substr(0, 2) == "./") {
+      v_packFile = m_PackFilesIndex.find(i_filePath.substr(2));
+    }
+    if (v_packFile != m_PackFilesIndex.end()) {
+      /* Found it, yeah. */
+      return m_PackFiles[v_packFile->second].md5sum;
     }
   }
 
@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <basedir.h>
 #endif
 #include "VFileIO_types.h"
+#include "include/xm_hashmap.h"
 
 /*===========================================================================
   File handle types
@@ -52,6 +53,8 @@ struct FileHandle {
     Type = FHT_UNASSIGNED;
     nRead = nWrite = nSize = 0;
     fp = NULL;
+    pcData = NULL;
+    nPos = 0;
     bRead = bWrite = false;
   }
 
@@ -65,7 +68,8 @@ struct FileHandle {
 
   FILE *fp; /* File pointer for I/O */
 
-  int nOffset; /* in package */
+  const char *pcData; /* package file, in the package mapping */
+  int nPos; /* in package file */
 
   /* I/O mode */
   bool bRead, bWrite;
@@ -169,6 +173,10 @@ public:
   static bool isDir(const std::string &AppDir);
 
   static int getFileTimeStamp(const std::string &Path);
+  /* size and time stamp with a single stat() ; return false on error */
+  static bool getFileSizeAndTimeStamp(const std::string &Path,
+                                      int &o_size,
+                                      int &o_timeStamp);
   static bool isPathAbsolute(const std::string &Path);
 
   static int mkDir(const char *pcPath);
@@ -223,6 +231,8 @@ private:
   static void _FindFilesRecursive(const std::string &Dir,
                                   const std::string &Wildcard,
                                   std::vector<std::string> &List);
+  static void _MapPackage(FILE *fp);
+  static void _UnmapPackage();
 
   /* Data */
   static std::string m_UserDataDir, m_UserDataDirUTF8, m_UserConfigDir,
@@ -231,6 +241,18 @@ private:
 
   static std::string m_BinDataFile;
   static std::vector<PackFile> m_PackFiles;
+  /* package files by name, and by directory (ending with a /) */
+  static HashNamespace::unordered_map<std::string, unsigned int>
+    m_PackFilesIndex;
+  static HashNamespace::unordered_map<std::string, std::vector<unsigned int> >
+    m_PackDirsIndex;
+  /* the package is mapped once ; package files are read from there */
+  static const char *m_PackData;
+  static size_t m_PackDataSize;
+  static bool m_PackDataMapped; /* false if read in memory */
+#ifdef WIN32
+  static void *m_PackMapping;
+#endif
   static std::string m_binCheckSum;
 
   // migrate from .xmoto to xdg base directories
@@ -174,6 +174,111 @@ std::string XMLDocument::getElementText(xmlNodePtr node) {
   return res;
 }
 
+XMLReader::XMLReader() {
+  m_reader = NULL;
+}
+
+XMLReader::~XMLReader() {
+  if (m_reader != NULL) {
+    xmlFreeTextReader(m_reader);
+  }
+}
+
+void XMLReader::openFile(FileDataType i_fdt,
+                         std::string File,
+                         bool i_includeCurrentDir) {
+  if (m_reader != NULL) {
+    xmlFreeTextReader(m_reader);
+    m_reader = NULL;
+  }
+  m_file = File;
+  m_xmlstr = "";
+
+  // directly open the file
+  if (XMFS::doesRealFileOrDirectoryExists(File)) {
+    m_reader = xmlReaderForFile(File.c_str(), NULL, 0);
+  } else {
+    FileHandle *pfh;
+
+    pfh = XMFS::openIFile(i_fdt, File, i_includeCurrentDir);
+    if (pfh == NULL) {
+      throw Exception("failed to load XML " + File);
+    }
+    m_xmlstr = XMFS::readFileToEnd(pfh);
+    XMFS::closeFile(pfh);
+
+    m_reader = xmlReaderForMemory(
+      m_xmlstr.c_str(), m_xmlstr.length(), File.c_str(), NULL, 0);
+  }
+
+  if (m_reader == NULL) {
+    throw Exception("failed to load XML " + File);
+  }
+}
+
+int XMLReader::read() {
+  int v_res;
+
+  /* don't enter into the elements under the root node */
+  if (xmlTextReaderNodeType(m_reader) == XML_READER_TYPE_ELEMENT &&
+      xmlTextReaderDepth(m_reader) >= 1) {
+    v_res = xmlTextReaderNext(m_reader);
+  } else {
+    v_res = xmlTextReaderRead(m_reader);
+  }
+
+  if (v_res == -1) {
+    throw Exception("failed to parse XML " + m_file);
+  }
+  return v_res;
+}
+
+void XMLReader::readRootNode(const char *rootNameToCheck) {
+  if (m_reader == NULL) {
+    throw Exception("Invalid root name");
+  }
+
+  do {
+    if (read() == 0) {
+      throw Exception("Invalid root name");
+    }
+  } while (xmlTextReaderNodeType(m_reader) != XML_READER_TYPE_ELEMENT);
+
+  if (rootNameToCheck != NULL) {
+    if (xmlStrcmp(xmlTextReaderConstName(m_reader),
+                  (const xmlChar *)rootNameToCheck) != 0) {
+      throw Exception("Invalid root name");
+    }
+  }
+}
+
+bool XMLReader::nextSubElement(const char *name) {
+  do {
+    if (read() == 0) {
+      return false;
+    }
+  } while (xmlTextReaderNodeType(m_reader) != XML_READER_TYPE_ELEMENT ||
+           xmlTextReaderDepth(m_reader) != 1 ||
+           xmlStrcmp(xmlTextReaderConstName(m_reader),
+                     (const xmlChar *)name) != 0);
+
+  return true;
+}
+
+std::string XMLReader::getOption(const char *name, std::string Default) {
+  xmlChar *value;
+  std::string res;
+
+  value = xmlTextReaderGetAttribute(m_reader, (const xmlChar *)name);
+  if (value == NULL) {
+    return Default;
+  }
+  res = std::string((char *)value);
+  xmlFree(value);
+
+  return res;
+}
+
 std::string XMLDocument::str2xmlstr(std::string str) {
   std::string v_res = "";
   for (unsigned int i = 0; i < str.length(); i++) {
@@ -24,6 +24,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "VFileIO_types.h"
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 #include <string>
 
 class XMLDocument {
@@ -60,4 +61,35 @@ private:
   xmlDocPtr m_doc;
 };
 
+/*
+  streaming reader for the big files : the elements are parsed one after the
+  other, without building the document in memory
+*/
+class XMLReader {
+public:
+  XMLReader();
+  ~XMLReader();
+
+  void openFile(FileDataType i_fdt,
+                std::string File,
+                bool i_includeCurrentDir = false);
+
+  /* go to the root node ; throw an exception if it's not rootNameToCheck */
+  void readRootNode(const char *rootNameToCheck = NULL);
+
+  /* go to the next element named name directly under the root node ; return
+   * false at the end of the document */
+  bool nextSubElement(const char *name);
+
+  /* option of the current element */
+  std::string getOption(const char *name, std::string Default = "");
+
+private:
+  int read(); /* throw an exception on parsing errors */
+
+  xmlTextReaderPtr m_reader;
+  std::string m_file;
+  std::string m_xmlstr; /* content of the files not directly on the disk */
+};
+
 #endif
@@ -117,6 +117,7 @@ WebRoom::WebRoom(WWWAppInterface *p_WebRoomApp) {
   m_webhighscores_url = DEFAULT_WEBHIGHSCORES_URL;
   m_WebRoomApp = p_WebRoomApp;
   m_proxy_settings = NULL;
+  m_nbParallelDownloads = DEFAULT_TRANSFER_PARALLEL;
 }
 
 WebRoom::~WebRoom() {}
@@ -129,6 +130,39 @@ void WebRoom::setHighscoresUrl(const std::string &i_webhighscores_url) {
   m_webhighscores_url = i_webhighscores_url;
 }
 
+void WebRoom::setNbParallelDownloads(unsigned int i_value) {
+  m_nbParallelDownloads = i_value;
+}
+
+void WebRoom::downloadReplays(const std::vector<std::string> &i_urls,
+                              std::vector<std::string> &o_errors) {
+  WWWDownloader v_downloader(
+    m_WebRoomApp, m_proxy_settings, m_nbParallelDownloads);
+
+  for (unsigned int i = 0; i < i_urls.size(); i++) {
+    std::string v_rplName = XMFS::getFileBaseName(i_urls[i]);
+
+    v_downloader.add(XMFS::getUserReplaysDir() + "/" + v_rplName + ".rpl",
+                     i_urls[i],
+                     v_rplName);
+  }
+
+  v_downloader.perform();
+
+  o_errors.clear();
+  for (unsigned int i = 0; i < v_downloader.getDownloads().size(); i++) {
+    WWWDownload *v_download = v_downloader.getDownloads()[i];
+
+    if (v_download->ok) {
+      o_errors.push_back("");
+    } else if (v_download->error != "") {
+      o_errors.push_back(v_download->error);
+    } else {
+      o_errors.push_back("download cancelled");
+    }
+  }
+}
+
 /* use the id of the room so that if several people share the same room, it
  * doesn't need to recheck if md5 is ok */
 void WebRoom::update(const std::string &i_id_room) {
@@ -323,6 +357,363 @@ void FSWeb::downloadFile(const std::string &p_local_file,
   }
 }
 
+WWWDownloader::WWWDownloader(WWWAppInterface *p_WebApp,
+                             const ProxySettings *p_proxy_settings,
+                             unsigned int i_nbParallel) {
+  m_WebApp = p_WebApp;
+  m_proxy_settings = p_proxy_settings;
+  m_nbParallel = i_nbParallel;
+  if (m_nbParallel < 1) {
+    m_nbParallel = 1;
+  }
+  if (m_nbParallel > DEFAULT_TRANSFER_PARALLEL_MAX) {
+    m_nbParallel = DEFAULT_TRANSFER_PARALLEL_MAX;
+  }
+  m_nbRunning = 0;
+  m_nbDone = 0;
+  m_cancelled = false;
+  m_www_agent = WWW_AGENT;
+
+  if (m_proxy_settings != NULL) {
+    m_proxy_server = m_proxy_settings->getServer();
+    m_proxy_auth_str = m_proxy_settings->getAuthentificationUser() + ":" +
+                       m_proxy_settings->getAuthentificationPassword();
+  }
+
+  m_multi = curl_multi_init();
+  if (m_multi == NULL) {
+    throw Exception("error : unable to init curl multi");
+  }
+
+  /* the connections to the server are kept in the multi handle and reused */
+  curl_multi_setopt(m_multi, CURLMOPT_MAXCONNECTS, (long)m_nbParallel);
+#if CURL_AT_LEAST_VERSION(7, 30, 0)
+  curl_multi_setopt(m_multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)m_nbParallel);
+#endif
+#if CURL_AT_LEAST_VERSION(7, 43, 0)
+  curl_multi_setopt(m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+}
+
+WWWDownloader::~WWWDownloader() {
+  cancelDownloads();
+  curl_multi_cleanup(m_multi);
+
+  for (unsigned int i = 0; i < m_downloads.size(); i++) {
+    delete m_downloads[i];
+  }
+}
+
+void WWWDownloader::add(const std::string &p_local_file,
+                        const std::string &p_web_file,
+                        const std::string &p_information,
+                        bool p_isNew) {
+  WWWDownload *v_download = new WWWDownload;
+
+  v_download->localFile = p_local_file;
+  v_download->webFile = p_web_file;
+  v_download->information = p_information;
+  v_download->isNew = p_isNew;
+  v_download->done = false;
+  v_download->ok = false;
+  v_download->downloader = this;
+  v_download->curl = NULL;
+  v_download->file = NULL;
+  v_download->resumeFrom = 0;
+  v_download->partTime = 0;
+  v_download->dlnow = 0;
+  v_download->dltotal = 0;
+  v_download->restarted = false;
+
+  m_downloads.push_back(v_download);
+}
+
+const std::vector<WWWDownload *> &WWWDownloader::getDownloads() const {
+  return m_downloads;
+}
+
+bool WWWDownloader::isCancelled() const {
+  return m_cancelled;
+}
+
+void WWWDownloader::perform() {
+  unsigned int v_next = 0;
+  int v_nbStillRunning;
+  int v_nbMsgs;
+  CURLMsg *v_msg;
+  CURLMcode v_mres;
+
+  while (m_nbDone < m_downloads.size()) {
+    if (m_WebApp != NULL && m_WebApp->isCancelAsSoonAsPossible()) {
+      cancelDownloads();
+      m_cancelled = true;
+      return;
+    }
+
+    while (m_nbRunning < m_nbParallel && v_next < m_downloads.size()) {
+      startDownload(m_downloads[v_next]);
+      v_next++;
+    }
+
+    v_mres = curl_multi_perform(m_multi, &v_nbStillRunning);
+    if (v_mres != CURLM_OK) {
+      cancelDownloads();
+      throw Exception(std::string("error : curl multi failed (") +
+                      curl_multi_strerror(v_mres) + ")");
+    }
+
+    while ((v_msg = curl_multi_info_read(m_multi, &v_nbMsgs)) != NULL) {
+      if (v_msg->msg == CURLMSG_DONE) {
+        CURL *v_curl = v_msg->easy_handle;
+        CURLcode v_res = v_msg->data.result; // v_msg is freed on remove
+        char *v_private = NULL;
+
+        curl_easy_getinfo(v_curl, CURLINFO_PRIVATE, &v_private);
+        endDownload((WWWDownload *)v_private, v_res);
+      }
+    }
+
+    updateProgress();
+
+    if (m_nbRunning > 0) {
+      curl_multi_wait(m_multi, NULL, 0, 100, NULL);
+    }
+  }
+}
+
+void WWWDownloader::startDownload(WWWDownload *io_download) {
+  std::string v_local_file_tmp = io_download->localFile + ".part";
+
+  LogInfo("downloading %s to %s",
+          io_download->webFile.c_str(),
+          io_download->localFile.c_str());
+
+  /* resume the part downloaded last time */
+  io_download->resumeFrom = 0;
+  io_download->partTime = 0;
+  if (io_download->restarted == false) {
+    struct stat v_stat;
+    if (stat(v_local_file_tmp.c_str(), &v_stat) == 0) {
+      io_download->resumeFrom = v_stat.st_size;
+      io_download->partTime = v_stat.st_mtime;
+    }
+  }
+
+  io_download->file =
+    fopen(v_local_file_tmp.c_str(), io_download->resumeFrom > 0 ? "ab" : "wb");
+  if (io_download->file == NULL) {
+    io_download->done = true;
+    io_download->error = "unable to open output file " + v_local_file_tmp;
+    m_nbDone++;
+    return;
+  }
+
+  io_download->curl = curl_easy_init();
+  if (io_download->curl == NULL) {
+    fclose(io_download->file);
+    io_download->file = NULL;
+    io_download->done = true;
+    io_download->error = "unable to init curl";
+    m_nbDone++;
+    return;
+  }
+
+  CURL *v_curl = io_download->curl;
+  curl_easy_setopt(v_curl, CURLOPT_URL, io_download->webFile.c_str());
+  curl_easy_setopt(v_curl, CURLOPT_WRITEDATA, io_download->file);
+  curl_easy_setopt(v_curl, CURLOPT_WRITEFUNCTION, WWWDownloader::writeData);
+  curl_easy_setopt(v_curl, CURLOPT_TIMEOUT, DEFAULT_TRANSFER_TIMEOUT);
+  curl_easy_setopt(
+    v_curl, CURLOPT_CONNECTTIMEOUT, DEFAULT_TRANSFER_CONNECT_TIMEOUT);
+  curl_easy_setopt(v_curl, CURLOPT_USERAGENT, m_www_agent.c_str());
+  curl_easy_setopt(v_curl, CURLOPT_NOSIGNAL, 1);
+  curl_easy_setopt(v_curl, CURLOPT_FAILONERROR, 1);
+  curl_easy_setopt(v_curl, CURLOPT_FOLLOWLOCATION, 1);
+  curl_easy_setopt(v_curl, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(v_curl, CURLOPT_PRIVATE, io_download);
+  curl_easy_setopt(v_curl, CURLOPT_RESUME_FROM_LARGE, io_download->resumeFrom);
+  if (io_download->resumeFrom > 0) {
+    /* the part is kept only if the file didn't change since it was written,
+       otherwise the server answers 412 and the download restarts */
+    curl_easy_setopt(v_curl, CURLOPT_TIMECONDITION, CURL_TIMECOND_IFUNMODSINCE);
+    curl_easy_setopt(v_curl, CURLOPT_TIMEVALUE, (long)io_download->partTime);
+  }
+
+  /* set proxy settings */
+  if (m_proxy_settings != NULL && m_proxy_settings->getTypeStr() != "") {
+    if (m_proxy_settings->useDefaultServer() == false) {
+      curl_easy_setopt(v_curl, CURLOPT_PROXY, m_proxy_server.c_str());
+    }
+
+    if (m_proxy_settings->useDefaultPort() == false) {
+      curl_easy_setopt(v_curl, CURLOPT_PROXYPORT, m_proxy_settings->getPort());
+    }
+
+    curl_easy_setopt(v_curl, CURLOPT_PROXYTYPE, m_proxy_settings->getType());
+
+    if (m_proxy_settings->useDefaultAuthentification() == false) {
+      curl_easy_setopt(v_curl, CURLOPT_PROXYUSERPWD, m_proxy_auth_str.c_str());
+    }
+  }
+  /* ***** */
+
+  curl_easy_setopt(v_curl, CURLOPT_NOPROGRESS, false);
+  curl_easy_setopt(
+    v_curl, CURLOPT_XFERINFOFUNCTION, WWWDownloader::f_curl_progress_callback);
+  curl_easy_setopt(v_curl, CURLOPT_XFERINFODATA, io_download);
+
+  if (curl_multi_add_handle(m_multi, v_curl) != CURLM_OK) {
+    curl_easy_cleanup(v_curl);
+    io_download->curl = NULL;
+    fclose(io_download->file);
+    io_download->file = NULL;
+    io_download->done = true;
+    io_download->error = "unable to add the transfer to curl multi";
+    m_nbDone++;
+    return;
+  }
+  m_nbRunning++;
+
+  if (m_WebApp != NULL) {
+    m_WebApp->setBeingDownloadedInformation(io_download->information,
+                                            io_download->isNew);
+  }
+}
+
+void WWWDownloader::endDownload(WWWDownload *io_download, CURLcode i_res) {
+  std::string v_local_file_tmp = io_download->localFile + ".part";
+  long v_conditionUnmet = 0;
+
+  curl_easy_getinfo(
+    io_download->curl, CURLINFO_CONDITION_UNMET, &v_conditionUnmet);
+  curl_multi_remove_handle(m_multi, io_download->curl);
+  curl_easy_cleanup(io_download->curl);
+  io_download->curl = NULL;
+  fclose(io_download->file);
+  io_download->file = NULL;
+  m_nbRunning--;
+
+  /* the server doesn't resume the part, or it has changed : restart */
+  if (io_download->resumeFrom > 0 && io_download->restarted == false &&
+      (i_res == CURLE_RANGE_ERROR || i_res == CURLE_HTTP_RETURNED_ERROR ||
+       v_conditionUnmet != 0)) {
+    remove(v_local_file_tmp.c_str());
+    io_download->restarted = true;
+    io_download->dlnow = 0;
+    io_download->dltotal = 0;
+    startDownload(io_download);
+    return;
+  }
+
+  io_download->done = true;
+  m_nbDone++;
+
+  if (i_res != CURLE_OK) {
+    char v_err[256];
+
+    /* keep the part of interrupted transfers to resume them next time */
+    if (i_res != CURLE_ABORTED_BY_CALLBACK && i_res != CURLE_PARTIAL_FILE &&
+        i_res != CURLE_OPERATION_TIMEDOUT && i_res != CURLE_RECV_ERROR) {
+      remove(v_local_file_tmp.c_str());
+    }
+
+    snprintf(v_err,
+             256,
+             "unable to download file %s (curl[%i]: %s)",
+             io_download->webFile.c_str(),
+             i_res,
+             curl_easy_strerror(i_res));
+    io_download->error = v_err;
+    return;
+  }
+
+  /* replace file */
+  /* On windows you can't rename FILE1 to FILE2 if FILE2 already exists...
+     So we need to delete it first. */
+  remove(io_download->localFile.c_str());
+  if (rename(v_local_file_tmp.c_str(), io_download->localFile.c_str()) != 0) {
+    remove(v_local_file_tmp.c_str());
+    io_download->error =
+      "unable to write output file " + io_download->localFile;
+    return;
+  }
+
+  io_download->ok = true;
+}
+
+size_t WWWDownloader::writeData(void *ptr,
+                                size_t size,
+                                size_t nmemb,
+                                FILE *stream) {
+  return fwrite(ptr, size, nmemb, stream);
+}
+
+void WWWDownloader::cancelDownloads() {
+  for (unsigned int i = 0; i < m_downloads.size(); i++) {
+    WWWDownload *v_download = m_downloads[i];
+
+    if (v_download->curl != NULL) {
+      endDownload(v_download, CURLE_ABORTED_BY_CALLBACK);
+    }
+  }
+}
+
+void WWWDownloader::updateProgress() {
+  if (m_WebApp == NULL || m_downloads.empty()) {
+    return;
+  }
+
+  /* we can't trust the web server information */
+  float v_nbFilesDone = 0.0f;
+  for (unsigned int i = 0; i < m_downloads.size(); i++) {
+    WWWDownload *v_download = m_downloads[i];
+
+    if (v_download->done) {
+      v_nbFilesDone += 1.0f;
+    } else if (v_download->dltotal > 0) {
+      float fract = v_download->dlnow / (float)v_download->dltotal;
+      if (fract >= 0.0f && fract <= 1.0f) {
+        v_nbFilesDone += fract;
+      }
+    }
+  }
+
+  m_WebApp->setTaskProgress((v_nbFilesDone * 100.0f) /
+                            (float)m_downloads.size());
+}
+
+int WWWDownloader::f_curl_progress_callback(void *clientp,
+                                            curl_off_t dltotal,
+                                            curl_off_t dlnow,
+                                            curl_off_t ultotal,
+                                            curl_off_t ulnow) {
+  WWWDownload *v_download = (WWWDownload *)clientp;
+  WWWAppInterface *v_WebApp = v_download->downloader->m_WebApp;
+
+  /* resumed transfers only count the remaining part */
+  v_download->dlnow = v_download->resumeFrom + dlnow;
+  v_download->dltotal =
+    dltotal > 0 ? v_download->resumeFrom + dltotal : (curl_off_t)0;
+
+  if (v_WebApp == NULL) {
+    return 0;
+  }
+
+  /* cancel if it's wanted */
+  if (v_WebApp->isCancelAsSoonAsPossible()) {
+    return 1;
+  }
+
+  if (v_download->dltotal > 0) {
+    float fract = v_download->dlnow / (float)v_download->dltotal;
+    if (fract >= 0.0f && fract <= 1.0f) {
+      v_WebApp->setFileProgress(v_download->information, fract * 100.0f);
+    }
+  }
+
+  return 0;
+}
+
 void FSWeb::uploadReplay(const std::string &p_replayFilename,
                          const std::string &p_id_room,
                          const std::string &p_login,
@@ -773,6 +1164,7 @@ void FSWeb::uploadDbSync(const std::string &p_dbSyncFilename,
 WebLevels::WebLevels(WWWAppInterface *p_WebLevelApp) {
   m_WebLevelApp = p_WebLevelApp;
   m_proxy_settings = NULL;
+  m_nbParallelDownloads = DEFAULT_TRANSFER_PARALLEL;
   m_levels_url = DEFAULT_WEBLEVELS_URL;
 }
 
@@ -784,6 +1176,10 @@ void WebLevels::setWebsiteInfos(const std::string &p_url,
   m_proxy_settings = p_proxy_settings;
 }
 
+void WebLevels::setNbParallelDownloads(unsigned int i_value) {
+  m_nbParallelDownloads = i_value;
+}
+
 std::string WebLevels::getXmlFileName() {
   return XMFS::getUserDir(FDT_CACHE) + "/" + DEFAULT_WEBLEVELS_FILENAME;
 }
@@ -896,11 +1292,8 @@ void WebLevels::upgrade(xmDatabase *i_db, int i_nb_levels) {
   std::string v_urlFile;
   bool v_isAnUpdate;
   std::string v_filePath;
-  f_curl_download_data v_data;
-
-  int v_nb_levels_to_download;
-  int v_nb_levels_performed = 0;
-  float v_percentage;
+  std::vector<std::string> v_destFiles;
+  std::string v_error;
   bool to_download;
 
   createDestinationDirIfRequired();
@@ -920,84 +1313,97 @@ void WebLevels::upgrade(xmDatabase *i_db, int i_nb_levels) {
                  "by creationDate DESC" +
                    v_sqlLimit + ";",
                  nrow);
-  v_nb_levels_to_download = nrow;
-  v_data.v_WebApp = m_WebLevelApp;
-  v_data.v_nb_files_to_download = v_nb_levels_to_download;
 
   m_webLevelsNewDownloadedOK.clear();
   m_webLevelsUpdatedDownloadedOK.clear();
 
-  try {
-    /* download levels */
-    for (unsigned int i = 0; i < nrow; i++) {
-      if (m_WebLevelApp != NULL) {
-        if (m_WebLevelApp->isCancelAsSoonAsPossible()) {
-          break;
-        }
-      }
+  WWWDownloader v_downloader(
+    m_WebLevelApp, m_proxy_settings, m_nbParallelDownloads);
 
-      v_levelId = i_db->getResult(v_result, 4, i, 0);
-      v_levelName = i_db->getResult(v_result, 4, i, 1);
-      v_urlFile = i_db->getResult(v_result, 4, i, 2);
-      v_isAnUpdate = i_db->getResult(v_result, 4, i, 3) != NULL;
-      if (v_isAnUpdate) {
-        v_filePath = i_db->getResult(v_result, 4, i, 3);
+  /* choose the levels to download */
+  for (unsigned int i = 0; i < nrow; i++) {
+    if (m_WebLevelApp != NULL) {
+      if (m_WebLevelApp->isCancelAsSoonAsPossible()) {
+        i_db->read_DB_free(v_result);
+        return;
       }
-      v_percentage = (((float)v_nb_levels_performed) * 100.0) /
-                     ((float)v_nb_levels_to_download);
+    }
 
-      m_WebLevelApp->setTaskProgress(v_percentage);
-      m_WebLevelApp->setBeingDownloadedInformation(v_levelName, v_isAnUpdate);
+    v_levelId = i_db->getResult(v_result, 4, i, 0);
+    v_levelName = i_db->getResult(v_result, 4, i, 1);
+    v_urlFile = i_db->getResult(v_result, 4, i, 2);
+    v_isAnUpdate = i_db->getResult(v_result, 4, i, 3) != NULL;
+    if (v_isAnUpdate) {
+      v_filePath = i_db->getResult(v_result, 4, i, 3);
+    }
 
-      /* should the level be updated */
-      to_download = true;
-      if (v_isAnUpdate) {
-        /* does the user want to update the level ? */
-        to_download = m_WebLevelApp->shouldLevelBeUpdated(v_levelId);
-      }
+    /* should the level be updated */
+    to_download = true;
+    if (v_isAnUpdate) {
+      /* does the user want to update the level ? */
+      to_download = m_WebLevelApp->shouldLevelBeUpdated(v_levelId);
+    }
 
-      if (to_download) {
-        v_data.v_nb_files_performed = v_nb_levels_performed;
-        std::string v_destFile;
+    if (to_download) {
+      std::string v_destFile;
 
-        if (v_isAnUpdate) {
-          if (XMFS::isInUserDir(FDT_DATA, v_filePath)) {
-            v_destFile = v_filePath;
-          } else {
-            v_destFile = WebLevels::getDestinationFile(v_urlFile);
-          }
+      if (v_isAnUpdate) {
+        if (XMFS::isInUserDir(FDT_DATA, v_filePath)) {
+          v_destFile = v_filePath;
         } else {
-          v_destFile = getDestinationFile(v_urlFile);
+          v_destFile = WebLevels::getDestinationFile(v_urlFile);
         }
+      } else {
+        v_destFile = getDestinationFile(v_urlFile);
+      }
 
-        FSWeb::downloadFileBz2(v_destFile,
-                               v_urlFile,
-                               FSWeb::f_curl_progress_callback_download,
-                               &v_data,
-                               m_proxy_settings);
+      v_downloader.add(
+        v_destFile + ".bz2", v_urlFile + ".bz2", v_levelName, !v_isAnUpdate);
+      v_destFiles.push_back(v_destFile);
+    }
+  }
+  i_db->read_DB_free(v_result);
 
-        if (v_isAnUpdate) {
-          m_webLevelsUpdatedDownloadedOK.push_back(v_destFile);
-        } else {
-          m_webLevelsNewDownloadedOK.push_back(v_destFile);
-        }
-      }
+  /* download levels */
+  v_downloader.perform();
+
+  for (unsigned int i = 0; i < v_downloader.getDownloads().size(); i++) {
+    WWWDownload *v_download = v_downloader.getDownloads()[i];
 
-      v_nb_levels_performed++;
+    if (v_download->ok == false) {
+      if (v_error == "" && v_download->error != "") {
+        v_error = "error : " + v_download->error;
+      }
+      continue;
     }
-  } catch (Exception &e) {
-    i_db->read_DB_free(v_result);
 
-    if (m_WebLevelApp != NULL) { // this is not an error in this case
-      if (m_WebLevelApp->isCancelAsSoonAsPossible()) {
-        return;
+    try {
+      FileCompression::bunzip2(v_download->localFile, v_destFiles[i]);
+      remove(v_download->localFile.c_str());
+    } catch (Exception &e) {
+      remove(v_download->localFile.c_str());
+      if (v_error == "") {
+        v_error = e.getMsg();
       }
+      continue;
     }
 
-    throw e;
+    if (v_download->isNew) {
+      m_webLevelsNewDownloadedOK.push_back(v_destFiles[i]);
+    } else {
+      m_webLevelsUpdatedDownloadedOK.push_back(v_destFiles[i]);
+    }
+  }
+
+  /* this is not an error in this case */
+  if (v_downloader.isCancelled()) {
+    return;
+  }
+
+  if (v_error != "") {
+    throw Exception(v_error);
   }
   m_WebLevelApp->setTaskProgress(100.0);
-  i_db->read_DB_free(v_result);
 }
 
 const std::vector<std::string> &WebLevels::getNewDownloadedLevels(void) {
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <curl/curl.h>
 #include <stdio.h>
 #include <string>
+#include <time.h>
 #include <vector>
 
 #include "Theme.h"
@@ -38,12 +39,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 class ThemeChoice;
 class WebRoom;
+class WWWDownloader;
 class xmDatabase;
 
 #define DEFAULT_SITE_URL "https://" WEBSITE_DOMAIN
 
 #define DEFAULT_TRANSFER_TIMEOUT 240
 #define DEFAULT_TRANSFER_CONNECT_TIMEOUT 15
+#define DEFAULT_TRANSFER_PARALLEL 4
+#define DEFAULT_TRANSFER_PARALLEL_MAX 16
 
 #define DEFAULT_WEBHIGHSCORES_URL DEFAULT_SITE_URL "/highscores.xml"
 #define DEFAULT_WEBLEVELS_URL DEFAULT_SITE_URL "/levels.xml"
@@ -205,6 +209,78 @@ private:
                                   const ProxySettings *p_proxy_settings);
 };
 
+struct WWWDownload {
+  std::string localFile;
+  std::string webFile;
+  std::string information; /* given to the WWWAppInterface */
+  bool isNew;
+
+  bool done;
+  bool ok;
+  std::string error;
+
+  /* transfer */
+  WWWDownloader *downloader;
+  CURL *curl;
+  FILE *file;
+  curl_off_t resumeFrom;
+  time_t partTime; /* last write of the resumed part */
+  curl_off_t dlnow;
+  curl_off_t dltotal;
+  bool restarted;
+};
+
+/*
+  download several files at the same time on a curl multi handle ; the
+  connections are kept alive and reused from a file to the next one, and the
+  partial files left by an interrupted download are resumed
+*/
+class WWWDownloader {
+public:
+  WWWDownloader(WWWAppInterface *p_WebApp,
+                const ProxySettings *p_proxy_settings,
+                unsigned int i_nbParallel = DEFAULT_TRANSFER_PARALLEL);
+  ~WWWDownloader();
+
+  void add(const std::string &p_local_file,
+           const std::string &p_web_file,
+           const std::string &p_information = "",
+           bool p_isNew = true);
+
+  /* a failed file doesn't stop the other ones ; check the downloads once done
+   */
+  void perform(); /* throws exceptions if curl can't be used */
+  const std::vector<WWWDownload *> &getDownloads() const;
+  bool isCancelled() const;
+
+private:
+  void startDownload(WWWDownload *io_download);
+  void endDownload(WWWDownload *io_download, CURLcode i_res);
+  void cancelDownloads();
+  void updateProgress();
+
+  static size_t writeData(void *ptr, size_t size, size_t nmemb, FILE *stream);
+  static int f_curl_progress_callback(void *clientp,
+                                      curl_off_t dltotal,
+                                      curl_off_t dlnow,
+                                      curl_off_t ultotal,
+                                      curl_off_t ulnow);
+
+  WWWAppInterface *m_WebApp;
+  CURLM *m_multi;
+  std::vector<WWWDownload *> m_downloads;
+  unsigned int m_nbParallel;
+  unsigned int m_nbRunning;
+  unsigned int m_nbDone;
+  bool m_cancelled;
+
+  /* kept for curl while transferring */
+  std::string m_proxy_server;
+  std::string m_proxy_auth_str;
+  std::string m_www_agent;
+  const ProxySettings *m_proxy_settings;
+};
+
 class WebRoom {
 public:
   WebRoom(WWWAppInterface *p_WebRoomApp);
@@ -223,11 +299,18 @@ public:
   void downloadReplay(const std::string &i_url);
   bool downloadReplayExists(const std::string &i_url);
 
+  /* download the replays at the same time ; o_errors gets an empty string for
+   * the replays downloaded */
+  void downloadReplays(const std::vector<std::string> &i_urls,
+                       std::vector<std::string> &o_errors);
+  void setNbParallelDownloads(unsigned int i_value);
+
 private:
   WWWAppInterface *m_WebRoomApp;
   std::string m_userFilename_prefix;
   std::string m_webhighscores_url;
   const ProxySettings *m_proxy_settings;
+  unsigned int m_nbParallelDownloads;
 };
 
 class WebLevels {
@@ -253,6 +336,9 @@ public:
   void setWebsiteInfos(const std::string &p_url,
                        const ProxySettings *p_proxy_settings);
 
+  /* number of levels downloaded at the same time by upgrade() */
+  void setNbParallelDownloads(unsigned int i_value);
+
   static std::string getDestinationFile(std::string p_url);
 
   /* return the number of level files required to download for an upgrade */
@@ -267,6 +353,7 @@ which where downloaded OK (so we can load them right away) and which are new */
   std::vector<std::string> m_webLevelsUpdatedDownloadedOK;
 
   const ProxySettings *m_proxy_settings;
+  unsigned int m_nbParallelDownloads;
 
   std::string m_levels_url;
 
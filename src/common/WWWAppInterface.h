@@ -43,6 +43,10 @@ public:
   virtual void setBeingDownloadedInformation(const std::string &p_information,
                                              bool p_isNew = true) {}
 
+  /* progress of one of the files downloaded at the same time */
+  virtual void setFileProgress(const std::string &p_information,
+                               float p_percent) {}
+
   /* Ask the user whether he want a level to be updated */
   virtual bool shouldLevelBeUpdated(const std::string &LevelID) {
     return false;
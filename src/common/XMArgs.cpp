@@ -41,6 +41,8 @@ XMArguments::XMArguments() {
   m_opt_drawlib = false;
   m_opt_ugly = false;
   m_opt_noLog = false;
+  m_opt_logSampling = false;
+  m_opt_logSampling_value = 1;
   m_opt_nowww = false;
   m_opt_help = false;
   m_opt_verbose = false;
@@ -76,6 +78,12 @@ XMArguments::XMArguments() {
   m_opt_serverPort = false;
   m_opt_serverAdminPassword = false;
   m_opt_updateLevelsOnly = false;
+  m_opt_benchSimulation = false;
+  m_opt_benchSimulationInputs = false;
+  m_opt_benchSimulationTime = false;
+  m_opt_benchSimulationTime_value = 0;
+  m_opt_benchSimulationStep = false;
+  m_opt_benchSimulationStep_value = 0;
   m_opt_clientConnectAtStartup = false;
   m_opt_adminMode = false;
   m_opt_buildQueries = false;
@@ -207,6 +215,17 @@ void XMArguments::parse(int i_argc, char **i_argv) {
       m_opt_cleanCache = true;
     } else if (v_opt == "--noLog") {
       m_opt_noLog = true;
+    } else if (v_opt == "--logSampling") {
+      m_opt_logSampling = true;
+      if (i + 1 >= i_argc) {
+        throw SyntaxError("missing value");
+      }
+      int v_rate = atoi(i_argv[i + 1]);
+      if (v_rate <= 0) {
+        throw SyntaxError("invalid sampling rate");
+      }
+      m_opt_logSampling_value = v_rate;
+      i++;
     } else if (v_opt == "--cleanNoWWWLevels") {
       m_opt_cleanNoWWWLevels = true;
     } else if (v_opt == "-ri" || v_opt == "--replayInfos") {
@@ -283,6 +302,47 @@ void XMArguments::parse(int i_argc, char **i_argv) {
       i++;
     } else if (v_opt == "--updateLevelsOnly") {
       m_opt_updateLevelsOnly = true;
+    } else if (v_opt == "--benchSimulation") {
+      m_opt_benchSimulation = true;
+      if (i + 1 >= i_argc) {
+        throw SyntaxError("missing level id");
+      }
+      m_opt_benchSimulation_level = levelArg2levelId(i_argv[i + 1]);
+      i++;
+    } else if (v_opt == "--benchSimulationReplay") {
+      m_opt_benchSimulation = true;
+      if (i + 1 >= i_argc) {
+        throw SyntaxError("missing replay");
+      }
+      m_opt_benchSimulation_replay = i_argv[i + 1];
+      i++;
+    } else if (v_opt == "--benchSimulationInputs") {
+      m_opt_benchSimulationInputs = true;
+      if (i + 1 >= i_argc) {
+        throw SyntaxError("missing inputs file");
+      }
+      m_opt_benchSimulationInputs_file = i_argv[i + 1];
+      i++;
+    } else if (v_opt == "--benchSimulationTime") {
+      m_opt_benchSimulationTime = true;
+      if (i + 1 >= i_argc) {
+        throw SyntaxError("missing value");
+      }
+      m_opt_benchSimulationTime_value = atoi(i_argv[i + 1]);
+      if (m_opt_benchSimulationTime_value < 1) {
+        m_opt_benchSimulationTime_value = 1;
+      }
+      i++;
+    } else if (v_opt == "--benchSimulationStep") {
+      m_opt_benchSimulationStep = true;
+      if (i + 1 >= i_argc) {
+        throw SyntaxError("missing value");
+      }
+      m_opt_benchSimulationStep_value = atoi(i_argv[i + 1]);
+      if (m_opt_benchSimulationStep_value < 1) {
+        m_opt_benchSimulationStep_value = 1;
+      }
+      i++;
     } else if (v_opt == "--connectAtStartup") {
       m_opt_clientConnectAtStartup = true;
     } else if (v_opt == "--defaultTheme") {
@@ -510,6 +570,14 @@ bool XMArguments::isOptNoLog() const {
   return m_opt_noLog;
 }
 
+bool XMArguments::isOptLogSampling() const {
+  return m_opt_logSampling;
+}
+
+int XMArguments::getOptLogSampling_value() const {
+  return m_opt_logSampling_value;
+}
+
 bool XMArguments::isOptTestTheme() const {
   return m_opt_testTheme;
 }
@@ -638,6 +706,42 @@ bool XMArguments::isOptBuildQueries() const {
   return m_opt_buildQueries;
 }
 
+bool XMArguments::isOptBenchSimulation() const {
+  return m_opt_benchSimulation;
+}
+
+std::string XMArguments::getOptBenchSimulation_level() const {
+  return m_opt_benchSimulation_level;
+}
+
+std::string XMArguments::getOptBenchSimulation_replay() const {
+  return m_opt_benchSimulation_replay;
+}
+
+bool XMArguments::isOptBenchSimulationInputs() const {
+  return m_opt_benchSimulationInputs;
+}
+
+std::string XMArguments::getOptBenchSimulationInputs_file() const {
+  return m_opt_benchSimulationInputs_file;
+}
+
+bool XMArguments::isOptBenchSimulationTime() const {
+  return m_opt_benchSimulationTime;
+}
+
+int XMArguments::getOptBenchSimulationTime_value() const {
+  return m_opt_benchSimulationTime_value;
+}
+
+bool XMArguments::isOptBenchSimulationStep() const {
+  return m_opt_benchSimulationStep;
+}
+
+int XMArguments::getOptBenchSimulationStep_value() const {
+  return m_opt_benchSimulationStep_value;
+}
+
 void XMArguments::help(const std::string &i_cmd) {
   printf("X-Moto %s\n", XMBuild::getVersionString().c_str());
   printf("usage:  %s [options]\n"
@@ -681,6 +785,8 @@ void XMArguments::help(const std::string &i_cmd) {
   printf("\t--cleanNoWWWLevels\n\t\tCheck web levels list and remove levels "
          "which are not available on the web.\n");
   printf("\t--noLog\n\t\tDon't log information into the xmoto.log file\n");
+  printf("\t--logSampling RATE\n\t\tLog only 1 information line out of "
+         "RATE (errors\n\t\tand warnings are always logged).\n");
   printf("\t--videoRecording\n\t\tEnable video recording.\n");
   printf("\t--videoRecordingSizeDivision DIVISION\n\t\tChange video size "
          "(1=full, 2=50%%, 4=25%%).\n");
@@ -704,6 +810,17 @@ void XMArguments::help(const std::string &i_cmd) {
   printf("\t--serverAdminPassword PASSWORD\n\t\tSpecify a server admin "
          "password which is always valid (with --server only).\n");
   printf("\t--updateLevelsOnly\n\t\tOnly update levels (no gui).\n");
+  printf("\t--benchSimulation ID\n\t\tRun the simulation of level ID as "
+         "fast as possible (no gui)\n\t\tand report its speed.\n");
+  printf("\t--benchSimulationReplay NAME\n\t\tSame as --benchSimulation, "
+         "but replays the replay NAME.\n");
+  printf("\t--benchSimulationInputs FILE\n\t\tDrive the biker of "
+         "--benchSimulation with the inputs of FILE.\n");
+  printf("\t--benchSimulationTime NBCENTSOFSECONDS\n\t\tStop the "
+         "simulation benchmark after this game time.\n");
+  printf("\t--benchSimulationStep NBCENTSOFSECONDS\n\t\tSimulate with "
+         "steps of this size ; the bike is swept\n\t\talong its path "
+         "when larger than 1.\n");
   printf(
     "\t--connectAtStartup\n\t\tConnect the client to the server at startup.\n");
   printf("\t-h, -?, -help, --help\n\t\tDisplay this message.\n");
@@ -68,6 +68,8 @@ public:
   bool isOptFps() const;
   bool isOptUgly() const;
   bool isOptNoLog() const;
+  bool isOptLogSampling() const;
+  int getOptLogSampling_value() const;
   bool isOptTestTheme() const;
   bool isOptBenchmark() const;
   bool isOptCleanCache() const;
@@ -101,6 +103,15 @@ public:
   bool isOptClientConnectAtStartup() const;
   bool isOptAdminMode() const;
   bool isOptBuildQueries() const;
+  bool isOptBenchSimulation() const;
+  std::string getOptBenchSimulation_level() const;
+  std::string getOptBenchSimulation_replay() const;
+  bool isOptBenchSimulationInputs() const;
+  std::string getOptBenchSimulationInputs_file() const;
+  bool isOptBenchSimulationTime() const;
+  int getOptBenchSimulationTime_value() const;
+  bool isOptBenchSimulationStep() const;
+  int getOptBenchSimulationStep_value() const;
 
 private:
   /* pack options */
@@ -125,6 +136,8 @@ private:
   bool m_opt_ugly;
   bool m_opt_nosound;
   bool m_opt_noLog;
+  bool m_opt_logSampling;
+  int m_opt_logSampling_value;
 
   /* config */
   bool m_opt_configpath;
@@ -190,6 +203,17 @@ private:
   /* update levels only */
   bool m_opt_updateLevelsOnly;
 
+  /* headless simulation benchmark */
+  bool m_opt_benchSimulation;
+  std::string m_opt_benchSimulation_level;
+  std::string m_opt_benchSimulation_replay;
+  bool m_opt_benchSimulationInputs;
+  std::string m_opt_benchSimulationInputs_file;
+  bool m_opt_benchSimulationTime; /* value in cent of seconds */
+  int m_opt_benchSimulationTime_value;
+  bool m_opt_benchSimulationStep; /* value in cent of seconds */
+  int m_opt_benchSimulationStep_value;
+
   /* server */
   bool m_opt_serverOnly;
   bool m_opt_serverPort;
@@ -77,6 +77,7 @@ void XMSession::setToDefault() {
   m_ghostStrategy_BESTOFREFROOM = DEFAULT_GHOSTBESTREFROOM;
   m_ghostStrategy_BESTOFOTHERROOMS = DEFAULT_GHOSTBESTOTHERROOMS;
   m_autosaveHighscoreReplays = DEFAULT_AUTOSAVEHIGHSCORESREPLAYS;
+  m_compactReplays = DEFAULT_COMPACTREPLAYS;
   m_disableAnimations = DEFAULT_DISABLEANIMATIONS;
   m_enableGhosts = DEFAULT_ENABLEGHOSTS;
   m_enableEngineSound = DEFAULT_ENABLEENGINESOUND;
@@ -113,6 +114,7 @@ void XMSession::setToDefault() {
     m_idRoom[i] = DEFAULT_WEBROOM_ID;
   }
   m_nbRoomsEnabled = DEFAULT_NBROOMSENABLED;
+  m_webDownloadsParallel = DEFAULT_WEBDOWNLOADSPARALLEL;
   m_showGhostTimeDifference = DEFAULT_SHOWGHOSTTIMEDIFFERENCE;
   m_ghostMotionBlur = DEFAULT_GHOSTMOTIONBLUR;
   m_showGhostsInfos = DEFAULT_SHOWGHOSTSINFOS;
@@ -152,6 +154,9 @@ void XMSession::setToDefault() {
   m_clientConnectAtStartup = DEFAULT_CLIENTCONNECTATSTARTUP;
   m_serverPort = DEFAULT_SERVERPORT;
   m_serverMaxClients = DEFAULT_SERVERMAXCLIENTS;
+  m_serverRooms = DEFAULT_SERVERROOMS;
+  m_serverUseEpoll = DEFAULT_SERVERUSEEPOLL;
+  m_serverPhysicsStep = DEFAULT_SERVERPHYSICSSTEP;
   m_clientServerName = DEFAULT_CLIENTSERVERNAME;
   m_clientGhostMode = DEFAULT_CLIENTGHOSTMODE;
   m_clientServerPort = DEFAULT_CLIENTSERVERPORT;
@@ -334,6 +339,8 @@ void XMSession::loadProfile(const std::string &i_id_profile, xmDatabase *pDb) {
     pDb->config_getBool(i_id_profile, "EngineSoundEnable", m_enableAudioEngine);
   m_autosaveHighscoreReplays = pDb->config_getBool(
     i_id_profile, "AutosaveHighscoreReplays", m_autosaveHighscoreReplays);
+  m_compactReplays =
+    pDb->config_getBool(i_id_profile, "CompactReplays", m_compactReplays);
   m_notifyAtInit =
     pDb->config_getBool(i_id_profile, "NotifyAtInit", m_notifyAtInit);
 
@@ -422,6 +429,12 @@ void XMSession::loadProfile(const std::string &i_id_profile, xmDatabase *pDb) {
     pDb->config_getInteger(i_id_profile, "ServerPort", m_serverPort);
   m_serverMaxClients = pDb->config_getInteger(
     i_id_profile, "ServerMaxClients", m_serverMaxClients);
+  m_serverRooms =
+    pDb->config_getInteger(i_id_profile, "ServerRooms", m_serverRooms);
+  m_serverUseEpoll =
+    pDb->config_getBool(i_id_profile, "ServerUseEpoll", m_serverUseEpoll);
+  m_serverPhysicsStep = pDb->config_getInteger(
+    i_id_profile, "ServerPhysicsStep", m_serverPhysicsStep);
   m_clientServerName =
     pDb->config_getString(i_id_profile, "ClientServerName", m_clientServerName);
   m_clientServerPort = pDb->config_getInteger(
@@ -441,6 +454,15 @@ void XMSession::loadProfile(const std::string &i_id_profile, xmDatabase *pDb) {
   if (m_nbRoomsEnabled > ROOMS_NB_MAX) {
     m_nbRoomsEnabled = ROOMS_NB_MAX;
   }
+  int v_webDownloadsParallel = pDb->config_getInteger(
+    i_id_profile, "WebDownloadsParallel", m_webDownloadsParallel);
+  if (v_webDownloadsParallel < 1) {
+    v_webDownloadsParallel = 1;
+  }
+  if (v_webDownloadsParallel > DEFAULT_TRANSFER_PARALLEL_MAX) {
+    v_webDownloadsParallel = DEFAULT_TRANSFER_PARALLEL_MAX;
+  }
+  m_webDownloadsParallel = v_webDownloadsParallel;
   for (unsigned int i = 0; i < ROOMS_NB_MAX; i++) {
     if (i == 0) {
       m_idRoom[i] =
@@ -562,6 +584,7 @@ void XMSession::saveProfile(xmDatabase *pDb) {
   pDb->config_setBool(m_profile, "EngineSoundEnable", m_enableAudioEngine);
   pDb->config_setBool(
     m_profile, "AutosaveHighscoreReplays", m_autosaveHighscoreReplays);
+  pDb->config_setBool(m_profile, "CompactReplays", m_compactReplays);
   pDb->config_setBool(m_profile, "NotifyAtInit", m_notifyAtInit);
   pDb->config_setBool(m_profile, "ShowMiniMap", m_showMinimap);
   pDb->config_setBool(m_profile, "ShowEngineCounter", m_showEngineCounter);
@@ -620,6 +643,9 @@ void XMSession::saveProfile(xmDatabase *pDb) {
     m_profile, "ClientConnectAtStartup", m_clientConnectAtStartup);
   pDb->config_setInteger(m_profile, "ServerPort", m_serverPort);
   pDb->config_setInteger(m_profile, "ServerMaxClients", m_serverMaxClients);
+  pDb->config_setInteger(m_profile, "ServerRooms", m_serverRooms);
+  pDb->config_setBool(m_profile, "ServerUseEpoll", m_serverUseEpoll);
+  pDb->config_setInteger(m_profile, "ServerPhysicsStep", m_serverPhysicsStep);
   pDb->config_setString(m_profile, "ClientServerName", m_clientServerName);
   pDb->config_setInteger(m_profile, "ClientServerPort", m_clientServerPort);
   pDb->config_setInteger(
@@ -646,6 +672,8 @@ void XMSession::saveProfile(xmDatabase *pDb) {
   pDb->config_setInteger(m_profile, "ProxyPort", proxySettings()->getPort());
 
   pDb->config_setInteger(m_profile, "WebHighscoresNbRooms", m_nbRoomsEnabled);
+  pDb->config_setInteger(
+    m_profile, "WebDownloadsParallel", m_webDownloadsParallel);
   for (unsigned int i = 0; i < ROOMS_NB_MAX; i++) {
     if (i == 0) {
       pDb->config_setString(m_profile, "WebHighscoresIdRoom", m_idRoom[i]);
@@ -879,6 +907,15 @@ void XMSession::setAutosaveHighscoreReplays(bool i_value) {
   m_autosaveHighscoreReplays = i_value;
 }
 
+bool XMSession::compactReplays() const {
+  return m_compactReplays;
+}
+
+void XMSession::setCompactReplays(bool i_value) {
+  PROPAGATE(XMSession, setCompactReplays, i_value, bool);
+  m_compactReplays = i_value;
+}
+
 void XMSession::setEnableGhosts(bool i_value) {
   PROPAGATE(XMSession, setEnableGhosts, i_value, bool);
   m_enableGhosts = i_value;
@@ -1220,6 +1257,15 @@ void XMSession::setNbRoomsEnabled(unsigned int i_value) {
   m_nbRoomsEnabled = i_value;
 }
 
+unsigned int XMSession::webDownloadsParallel() const {
+  return m_webDownloadsParallel;
+}
+
+void XMSession::setWebDownloadsParallel(unsigned int i_value) {
+  PROPAGATE(XMSession, setWebDownloadsParallel, i_value, unsigned int);
+  m_webDownloadsParallel = i_value;
+}
+
 void XMSession::setIdRoom(unsigned int i_number, const std::string &i_value) {
   XMSession::propagate(
     this,
@@ -1484,6 +1530,33 @@ void XMSession::setServerMaxClients(unsigned int i_value) {
   m_serverMaxClients = i_value;
 }
 
+unsigned int XMSession::serverRooms() const {
+  return m_serverRooms;
+}
+
+void XMSession::setServerRooms(unsigned int i_value) {
+  PROPAGATE(XMSession, setServerRooms, i_value, unsigned int);
+  m_serverRooms = i_value;
+}
+
+bool XMSession::serverUseEpoll() const {
+  return m_serverUseEpoll;
+}
+
+void XMSession::setServerUseEpoll(bool i_value) {
+  PROPAGATE(XMSession, setServerUseEpoll, i_value, bool);
+  m_serverUseEpoll = i_value;
+}
+
+unsigned int XMSession::serverPhysicsStep() const {
+  return m_serverPhysicsStep;
+}
+
+void XMSession::setServerPhysicsStep(unsigned int i_value) {
+  PROPAGATE(XMSession, setServerPhysicsStep, i_value, unsigned int);
+  m_serverPhysicsStep = i_value;
+}
+
 std::string XMSession::clientServerName() const {
   return m_clientServerName;
 }
@@ -160,6 +160,9 @@ public:
   void setGhostStrategy_BESTOFOTHERROOMS(bool i_value);
   bool autosaveHighscoreReplays() const;
   void setAutosaveHighscoreReplays(bool i_value);
+  // replays in format 4, not readable by the versions before it
+  bool compactReplays() const;
+  void setCompactReplays(bool i_value);
   void setEnableGhosts(bool i_value);
   bool enableGhosts() const;
   bool disableAnimations() const;
@@ -232,6 +235,8 @@ public:
   std::string idRoom(unsigned int i_number) const;
   void setNbRoomsEnabled(unsigned int i_value);
   unsigned int nbRoomsEnabled() const;
+  void setWebDownloadsParallel(unsigned int i_value);
+  unsigned int webDownloadsParallel() const;
   void setShowGhostTimeDifference(bool i_value);
   bool showGhostTimeDifference() const;
   void setGhostMotionBlur(bool i_value);
@@ -298,6 +303,12 @@ public:
   void setServerPort(int i_value);
   unsigned int serverMaxClients() const;
   void setServerMaxClients(unsigned int i_value);
+  unsigned int serverRooms() const;
+  void setServerRooms(unsigned int i_value);
+  bool serverUseEpoll() const;
+  void setServerUseEpoll(bool i_value);
+  unsigned int serverPhysicsStep() const;
+  void setServerPhysicsStep(unsigned int i_value);
   std::string clientServerName() const;
   void setClientServerName(const std::string &i_value);
   bool clientGhostMode() const;
@@ -364,6 +375,7 @@ private:
   bool m_hideSpritesMinimap;
   bool m_testTheme;
   bool m_autosaveHighscoreReplays;
+  bool m_compactReplays;
   bool m_disableAnimations;
   bool m_ghostStrategy_MYBEST;
   bool m_ghostStrategy_THEBEST;
@@ -409,6 +421,7 @@ private:
   std::string m_uploadHighscoreUrl;
   std::string m_idRoom[ROOMS_NB_MAX];
   unsigned int m_nbRoomsEnabled;
+  unsigned int m_webDownloadsParallel;
   bool m_showGhostTimeDifference;
   bool m_ghostMotionBlur;
   bool m_showGhostsInfos;
@@ -446,6 +459,9 @@ private:
   bool m_clientConnectAtStartup;
   int m_serverPort;
   unsigned int m_serverMaxClients;
+  unsigned int m_serverRooms;
+  bool m_serverUseEpoll;
+  unsigned int m_serverPhysicsStep;
   std::string m_clientServerName;
   int m_clientServerPort;
   int m_clientFramerateUpload;
@@ -75,6 +75,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define DEFAULT_GHOSTBESTREFROOM true
 #define DEFAULT_GHOSTBESTOTHERROOMS false
 #define DEFAULT_AUTOSAVEHIGHSCORESREPLAYS true
+#define DEFAULT_COMPACTREPLAYS false
 #define DEFAULT_DISABLEANIMATIONS false
 #define DEFAULT_ENABLEGHOSTS true
 #define DEFAULT_ENABLEENGINESOUND true
@@ -104,6 +105,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define DEFAULT_SHOWHIGHSCOREINGAME true
 #define DEFAULT_SHOWNEXTMEDALINGAME false
 #define DEFAULT_NBROOMSENABLED 1
+#define DEFAULT_WEBDOWNLOADSPARALLEL 4
 #define DEFAULT_SHOWGHOSTTIMEDIFFERENCE true
 #define DEFAULT_GHOSTMOTIONBLUR true
 #define DEFAULT_SHOWGHOSTSINFOS true
@@ -142,6 +144,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define DEFAULT_CLIENTCONNECTATSTARTUP false
 #define DEFAULT_SERVERPORT 4130
 #define DEFAULT_SERVERMAXCLIENTS 64
+#define DEFAULT_SERVERROOMS 1
+#define DEFAULT_SERVERUSEEPOLL true
+#define DEFAULT_SERVERPHYSICSSTEP 1 // hundreaths, as PHYS_STEP_SIZE
 #define DEFAULT_CLIENTSERVERNAME GAMES_DOMAIN
 #define DEFAULT_CLIENTGHOSTMODE true
 #define DEFAULT_CLIENTSERVERPORT DEFAULT_SERVERPORT
@@ -33,7 +33,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <sstream>
 #include <utility>
 
-#define XMDB_VERSION 38
+#define XMDB_VERSION 39
 #define DB_MAX_SQL_RUNTIME 0.25
 #define DB_BUSY_TIMEOUT 60000 // 60 seconds
 
@@ -163,11 +163,7 @@ bool xmDatabase::init(const std::string &i_dbFileUTF8,
         LogError(e.getMsg().c_str());
         LogError("Bailing out..");
 
-        if (m_db != NULL) {
-          sqlite3_close(m_db);
-          m_db = NULL;
-        }
-
+        closeDB();
         return false;
       }
     }
@@ -308,7 +304,12 @@ void xmDatabase::init(const std::string &i_dbFile, bool i_readOnly) {
 }
 
 xmDatabase::~xmDatabase() {
+  closeDB();
+}
+
+void xmDatabase::closeDB() {
   if (m_db != NULL) {
+    finalizeStatements(); // else, the database can't be closed
     sqlite3_close(m_db);
     m_db = NULL;
   }
@@ -1094,6 +1095,17 @@ void xmDatabase::upgradeXmDbToVersion(int i_fromVersion,
         throw Exception("Unable to update xmDb from 37: " + e.getMsg());
       }
 
+    case 38:
+      try {
+        simpleSql("ALTER TABLE replays ADD COLUMN filepath DEFAULT NULL;");
+        simpleSql("ALTER TABLE replays ADD COLUMN fileSize DEFAULT NULL;");
+        simpleSql(
+          "ALTER TABLE replays ADD COLUMN fileTimeStamp DEFAULT NULL;");
+        updateXmDbVersion(39, i_interface);
+      } catch (Exception &e) {
+        throw Exception("Unable to update xmDb from 38: " + e.getMsg());
+      }
+
       // next
   }
 }
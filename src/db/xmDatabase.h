@@ -23,15 +23,25 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "common/VFileIO_types.h"
 #include "helpers/MultiSingleton.h"
+#include "include/xm_hashmap.h"
 #include "xmDatabaseUpdateInterface.h"
 #include <sqlite3.h>
 #include <string>
 #include <vector>
 
 class Level;
+class xmDbQuery;
+
+/* file a replay of the index was read from */
+struct xmDbReplayFile {
+  std::string filepath;
+  int fileSize;
+  int fileTimeStamp;
+};
 
 class xmDatabase : public MultiSingleton<xmDatabase> {
   friend class MultiSingleton<xmDatabase>;
+  friend class xmDbQuery;
 
 private:
   xmDatabase();
@@ -57,7 +67,7 @@ public:
 
   /* RULE:
      all write access must be done from class xmDatabase
-     read can be done from anywhere using readDB;
+     read can be done from anywhere using readDB or xmDbQuery;
   */
   char **readDB(const std::string &i_sql, unsigned int &i_nrow);
   void read_DB_free(char **i_result);
@@ -150,8 +160,12 @@ public:
                    const std::string &i_name,
                    const std::string &i_id_profile,
                    bool i_isFinished,
-                   int i_finishTime);
+                   int i_finishTime,
+                   const xmDbReplayFile &i_file);
   void replays_add_end();
+  /* files of the indexed replays, by replay name */
+  void replays_getFiles(
+    HashNamespace::unordered_map<std::string, xmDbReplayFile> &o_files);
   void replays_delete(const std::string &i_replay);
   bool replays_exists(const std::string &i_name);
   void replays_print();
@@ -270,6 +284,17 @@ public:
 
 private:
   sqlite3 *m_db;
+
+  /* prepared statements, by sql */
+  struct CachedStatement {
+    sqlite3_stmt *stmt;
+    bool inUse;
+  };
+  HashNamespace::unordered_map<std::string, CachedStatement> m_statements;
+  CachedStatement *getStatement(const std::string &i_sql);
+  void finalizeStatements();
+  void closeDB();
+
   bool m_requiredLevelsUpdateAfterInit;
   bool m_requiredReplaysUpdateAfterInit;
   bool m_requiredThemesUpdateAfterInit;
@@ -376,4 +401,38 @@ private:
                           const std::string &i_checkSum);
 };
 
+/*
+  query on a statement prepared once and kept by the database, so that the
+  sql is not parsed again at each call. Parameters ('?' in the sql) are bound
+  in their order of appearance, and values are read typed from the current
+  row. The statement is available again once the query is destroyed.
+*/
+class xmDbQuery {
+public:
+  xmDbQuery(xmDatabase *i_db, const std::string &i_sql);
+  ~xmDbQuery();
+
+  xmDbQuery &bind(const std::string &i_value);
+  xmDbQuery &bind(int i_value);
+  xmDbQuery &bind(double i_value);
+
+  /* go to the next row ; return false once all rows are read */
+  bool next();
+  /* for queries which don't return rows */
+  void exec();
+
+  bool isNull(int i_column);
+  std::string getString(int i_column);
+  int getInt(int i_column);
+  double getDouble(int i_column);
+
+private:
+  xmDatabase *m_db;
+  xmDatabase::CachedStatement *m_cached; /* NULL if not cached */
+  sqlite3_stmt *m_stmt;
+  int m_nextParam;
+
+  void checkBind(int i_res);
+};
+
 #endif
@@ -92,34 +92,34 @@ bool xmDatabase::levels_isIndexUptodate() const {
 
 void xmDatabase::levels_addToFavorite(const std::string &i_profile,
                                       const std::string &i_id_level) {
-  simpleSql("INSERT INTO levels_favorite(id_profile, id_level) "
-            "VALUES(\"" +
-            protectString(i_profile) + "\", \"" + protectString(i_id_level) +
-            "\");");
+  xmDbQuery v_query(this,
+                    "INSERT INTO levels_favorite(id_profile, id_level) "
+                    "VALUES(?, ?);");
+  v_query.bind(i_profile).bind(i_id_level).exec();
 }
 
 void xmDatabase::levels_delToFavorite(const std::string &i_profile,
                                       const std::string &i_id_level) {
-  simpleSql("DELETE FROM levels_favorite "
-            "WHERE id_profile=\"" +
-            protectString(i_profile) + "\" AND  id_level=\"" +
-            protectString(i_id_level) + "\";");
+  xmDbQuery v_query(this,
+                    "DELETE FROM levels_favorite "
+                    "WHERE id_profile=? AND id_level=?;");
+  v_query.bind(i_profile).bind(i_id_level).exec();
 }
 
 void xmDatabase::levels_addToBlacklist(const std::string &i_profile,
                                        const std::string &i_id_level) {
-  simpleSql("INSERT INTO levels_blacklist(id_profile, id_level) "
-            "VALUES(\"" +
-            protectString(i_profile) + "\", \"" + protectString(i_id_level) +
-            "\");");
+  xmDbQuery v_query(this,
+                    "INSERT INTO levels_blacklist(id_profile, id_level) "
+                    "VALUES(?, ?);");
+  v_query.bind(i_profile).bind(i_id_level).exec();
 }
 
 void xmDatabase::levels_delToBlacklist(const std::string &i_profile,
                                        const std::string &i_id_level) {
-  simpleSql("DELETE FROM levels_blacklist "
-            "WHERE id_profile=\"" +
-            protectString(i_profile) + "\" AND  id_level=\"" +
-            protectString(i_id_level) + "\";");
+  xmDbQuery v_query(this,
+                    "DELETE FROM levels_blacklist "
+                    "WHERE id_profile=? AND id_level=?;");
+  v_query.bind(i_profile).bind(i_id_level).exec();
 }
 
 void xmDatabase::updateDB_favorite(const std::string &i_profile,
@@ -169,10 +169,10 @@ void xmDatabase::levels_cleanNew() {
 
 void xmDatabase::levels_addToNew(const std::string &i_id_level,
                                  bool i_isAnUpdate) {
-  simpleSql("INSERT INTO levels_new(id_level, isAnUpdate) "
-            "VALUES (\"" +
-            protectString(i_id_level) + "\", " +
-            std::string(i_isAnUpdate ? "1" : "0") + ");");
+  xmDbQuery v_query(this,
+                    "INSERT INTO levels_new(id_level, isAnUpdate) "
+                    "VALUES (?, ?);");
+  v_query.bind(i_id_level).bind(i_isAnUpdate ? 1 : 0).exec();
 }
 
 void xmDatabase::levels_add(const std::string &i_id_level,
@@ -186,24 +186,27 @@ void xmDatabase::levels_add(const std::string &i_id_level,
                             bool i_isScripted,
                             bool i_isPhysics,
                             bool i_isToReload) {
-  std::ostringstream v_cacheFV;
-  v_cacheFV << CACHE_LEVEL_FORMAT_VERSION;
-
-  simpleSql("INSERT INTO levels(id_level,"
-            "filepath, name, checkSum, author, description, "
-            "date_str, music, isScripted, isPhysics, isToReload, loaded, "
-            "loadingCacheFormatVersion) "
-            "VALUES(\"" +
-            protectString(i_id_level) + "\", " + "\"" +
-            protectString(i_filepath) + "\", " + "\"" + protectString(i_name) +
-            "\", " + "\"" + protectString(i_checkSum) + "\", " + "\"" +
-            protectString(i_author) + "\", " + "\"" +
-            protectString(i_description) + "\", " + "\"" +
-            protectString(i_date) + "\", " + "\"" + protectString(i_music) +
-            "\", " + std::string(i_isScripted ? "1" : "0") + ", " +
-            std::string(i_isPhysics ? "1" : "0") + ", " +
-            std::string(i_isToReload ? "1" : "0") +
-            std::string(", 1, " + v_cacheFV.str() + ");"));
+  xmDbQuery v_query(
+    this,
+    "INSERT INTO levels(id_level,"
+    "filepath, name, checkSum, author, description, "
+    "date_str, music, isScripted, isPhysics, isToReload, loaded, "
+    "loadingCacheFormatVersion) "
+    "VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, 1, ?);");
+
+  v_query.bind(i_id_level)
+    .bind(i_filepath)
+    .bind(i_name)
+    .bind(i_checkSum)
+    .bind(i_author)
+    .bind(i_description)
+    .bind(i_date)
+    .bind(i_music)
+    .bind(i_isScripted ? 1 : 0)
+    .bind(i_isPhysics ? 1 : 0)
+    .bind(i_isToReload ? 1 : 0)
+    .bind(CACHE_LEVEL_FORMAT_VERSION)
+    .exec();
 }
 
 void xmDatabase::levels_update(const std::string &i_id_level,
@@ -217,20 +220,26 @@ void xmDatabase::levels_update(const std::string &i_id_level,
                                bool i_isScripted,
                                bool i_isPhysics,
                                bool i_isToReload) {
-  std::ostringstream v_cacheFV;
-  v_cacheFV << CACHE_LEVEL_FORMAT_VERSION;
-
-  simpleSql("UPDATE levels SET name=\"" + protectString(i_name) +
-            "\", filepath=\"" + protectString(i_filepath) + "\", checkSum=\"" +
-            protectString(i_checkSum) + "\", author=\"" +
-            protectString(i_author) + "\", description=\"" +
-            protectString(i_description) + "\", date_str=\"" +
-            protectString(i_date) + "\", music=\"" + protectString(i_music) +
-            "\", isScripted=" + std::string(i_isScripted ? "1" : "0") +
-            ", isPhysics=" + std::string(i_isPhysics ? "1" : "0") +
-            ", isToReload=" + std::string(i_isToReload ? "1" : "0") +
-            ", loaded=1, loadingCacheFormatVersion = " + v_cacheFV.str() +
-            " WHERE id_level=\"" + protectString(i_id_level) + "\";");
+  xmDbQuery v_query(this,
+                    "UPDATE levels SET name=?, filepath=?, checkSum=?, "
+                    "author=?, description=?, date_str=?, music=?, "
+                    "isScripted=?, isPhysics=?, isToReload=?, loaded=1, "
+                    "loadingCacheFormatVersion=? "
+                    "WHERE id_level=?;");
+
+  v_query.bind(i_name)
+    .bind(i_filepath)
+    .bind(i_checkSum)
+    .bind(i_author)
+    .bind(i_description)
+    .bind(i_date)
+    .bind(i_music)
+    .bind(i_isScripted ? 1 : 0)
+    .bind(i_isPhysics ? 1 : 0)
+    .bind(i_isToReload ? 1 : 0)
+    .bind(CACHE_LEVEL_FORMAT_VERSION)
+    .bind(i_id_level)
+    .exec();
 }
 
 void xmDatabase::levels_cleanNoWWWLevels() {
@@ -286,41 +295,35 @@ void xmDatabase::levels_cleanNoWWWLevels() {
 bool xmDatabase::levels_add_fast(const std::string &i_filepath,
                                  std::string &o_levelName,
                                  bool i_isToReload) {
-  char **v_result;
-  unsigned int nrow;
-  unsigned int i;
   bool v_found;
-  std::string v_checksum, v_dbchecksum;
+  std::string v_checksum;
   std::string v_cond;
   if (i_isToReload) {
     v_cond = "isToReload=1 AND ";
   }
 
-  v_result =
-    readDB("SELECT name, checkSum FROM levels "
-           "WHERE " +
-             v_cond + "filepath=\"" + protectString(i_filepath) + "\";",
-           nrow);
-
-  // no result, no need to compute checksum
-  if (nrow == 0) {
-    read_DB_free(v_result);
-    return false;
-  }
+  {
+    xmDbQuery v_query(this,
+                      "SELECT name, checkSum FROM levels "
+                      "WHERE " +
+                        v_cond + "filepath=?;");
+    v_query.bind(i_filepath);
 
-  // checksum
-  v_checksum = XMFS::md5sum(FDT_DATA, i_filepath);
-  i = 0;
-  v_found = false;
-  while (i < nrow && v_found == false) {
-    v_dbchecksum = getResult(v_result, 2, i, 1);
-    if (v_dbchecksum == v_checksum) {
-      v_found = true;
-      o_levelName = getResult(v_result, 2, i, 0);
+    // no result, no need to compute checksum
+    if (v_query.next() == false) {
+      return false;
     }
-    i++;
+
+    // checksum
+    v_checksum = XMFS::md5sum(FDT_DATA, i_filepath);
+    v_found = false;
+    do {
+      if (v_query.getString(1) == v_checksum) {
+        v_found = true;
+        o_levelName = v_query.getString(0);
+      }
+    } while (v_found == false && v_query.next());
   }
-  read_DB_free(v_result);
 
   // no level with the same checksum found
   if (v_found == false) {
@@ -328,10 +331,9 @@ bool xmDatabase::levels_add_fast(const std::string &i_filepath,
   }
 
   // found it in the database
-  simpleSql("UPDATE levels SET loaded=1 WHERE " + v_cond + "filepath=\"" +
-            protectString(i_filepath) +
-            "\" "
-            "AND checkSum=\"" +
-            protectString(v_checksum) + "\";");
+  xmDbQuery v_query(this,
+                    "UPDATE levels SET loaded=1 WHERE " + v_cond +
+                      "filepath=? AND checkSum=?;");
+  v_query.bind(i_filepath).bind(v_checksum).exec();
   return true;
 }
@@ -0,0 +1,166 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "helpers/Log.h"
+#include "helpers/VExcept.h"
+#include "xmDatabase.h"
+
+/* level packs make one query each ; keep enough of them for a big set of
+   packs */
+#define XMDB_MAX_CACHED_STATEMENTS 256
+
+xmDatabase::CachedStatement *xmDatabase::getStatement(
+  const std::string &i_sql) {
+  HashNamespace::unordered_map<std::string, CachedStatement>::iterator it;
+  CachedStatement v_statement;
+
+  it = m_statements.find(i_sql);
+  if (it != m_statements.end()) {
+    if (it->second.inUse) {
+      return NULL; // the same query is running, let the caller prepare another
+    }
+    it->second.inUse = true;
+    return &(it->second);
+  }
+
+  if (m_statements.size() >= XMDB_MAX_CACHED_STATEMENTS) {
+    it = m_statements.begin();
+    while (it != m_statements.end()) {
+      if (it->second.inUse) {
+        ++it;
+      } else {
+        sqlite3_finalize(it->second.stmt);
+        it = m_statements.erase(it);
+      }
+    }
+  }
+
+  if (sqlite3_prepare_v2(m_db, i_sql.c_str(), -1, &v_statement.stmt, NULL) !=
+      SQLITE_OK) {
+    std::string v_errMsg = sqlite3_errmsg(m_db);
+    LogError("xmDb failed while preparing :");
+    LogInfo("%s", i_sql.c_str());
+    LogError("%s", v_errMsg.c_str());
+    throw Exception("xmDb: " + v_errMsg);
+  }
+  v_statement.inUse = true;
+
+  /* elements of an unordered_map keep their address while they are not
+     erased */
+  return &(m_statements[i_sql] = v_statement);
+}
+
+void xmDatabase::finalizeStatements() {
+  HashNamespace::unordered_map<std::string, CachedStatement>::iterator it;
+
+  for (it = m_statements.begin(); it != m_statements.end(); ++it) {
+    sqlite3_finalize(it->second.stmt);
+  }
+  m_statements.clear();
+}
+
+xmDbQuery::xmDbQuery(xmDatabase *i_db, const std::string &i_sql) {
+  m_db = i_db;
+  m_nextParam = 1;
+  m_cached = m_db->getStatement(i_sql);
+
+  if (m_cached != NULL) {
+    m_stmt = m_cached->stmt;
+  } else {
+    if (sqlite3_prepare_v2(m_db->m_db, i_sql.c_str(), -1, &m_stmt, NULL) !=
+        SQLITE_OK) {
+      throw Exception(std::string("xmDb: ") + sqlite3_errmsg(m_db->m_db));
+    }
+  }
+}
+
+xmDbQuery::~xmDbQuery() {
+  if (m_cached != NULL) {
+    sqlite3_reset(m_stmt);
+    sqlite3_clear_bindings(m_stmt);
+    m_cached->inUse = false;
+  } else {
+    sqlite3_finalize(m_stmt);
+  }
+}
+
+void xmDbQuery::checkBind(int i_res) {
+  if (i_res != SQLITE_OK) {
+    throw Exception(std::string("xmDb: ") + sqlite3_errmsg(m_db->m_db));
+  }
+  m_nextParam++;
+}
+
+xmDbQuery &xmDbQuery::bind(const std::string &i_value) {
+  checkBind(sqlite3_bind_text(
+    m_stmt, m_nextParam, i_value.c_str(), i_value.length(), SQLITE_TRANSIENT));
+  return *this;
+}
+
+xmDbQuery &xmDbQuery::bind(int i_value) {
+  checkBind(sqlite3_bind_int(m_stmt, m_nextParam, i_value));
+  return *this;
+}
+
+xmDbQuery &xmDbQuery::bind(double i_value) {
+  checkBind(sqlite3_bind_double(m_stmt, m_nextParam, i_value));
+  return *this;
+}
+
+bool xmDbQuery::next() {
+  switch (sqlite3_step(m_stmt)) {
+    case SQLITE_ROW:
+      return true;
+    case SQLITE_DONE:
+      return false;
+    default:
+      LogError("xmDb failed while running :");
+      LogInfo("%s", sqlite3_sql(m_stmt));
+      LogError("%s", sqlite3_errmsg(m_db->m_db));
+      throw Exception(std::string("xmDb: ") + sqlite3_errmsg(m_db->m_db));
+  }
+}
+
+void xmDbQuery::exec() {
+  while (next())
+    ;
+}
+
+bool xmDbQuery::isNull(int i_column) {
+  return sqlite3_column_type(m_stmt, i_column) == SQLITE_NULL;
+}
+
+std::string xmDbQuery::getString(int i_column) {
+  const unsigned char *v_text = sqlite3_column_text(m_stmt, i_column);
+
+  if (v_text == NULL) {
+    return "";
+  }
+  return std::string((const char *)v_text,
+                     sqlite3_column_bytes(m_stmt, i_column));
+}
+
+int xmDbQuery::getInt(int i_column) {
+  return sqlite3_column_int(m_stmt, i_column);
+}
+
+double xmDbQuery::getDouble(int i_column) {
+  return sqlite3_column_double(m_stmt, i_column);
+}
@@ -21,32 +21,58 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "xmDatabase.h"
 #include "xmoto/GameText.h"
 #include <math.h>
-#include <sstream>
 
 bool xmDatabase::replays_isIndexUptodate() const {
   return m_requiredReplaysUpdateAfterInit == false;
 }
 
+// the index is updated incrementally : rows are kept, the caller removes the
+// ones of the replays which changed or disappeared
 void xmDatabase::replays_add_begin() {
   simpleSql("BEGIN TRANSACTION;");
-  simpleSql("DELETE FROM replays;");
 }
 
 void xmDatabase::replays_add(const std::string &i_id_level,
                              const std::string &i_name,
                              const std::string &i_id_profile,
                              bool i_isFinished,
-                             int i_finishTime) {
-  std::ostringstream v_finishTime;
-
-  v_finishTime << i_finishTime;
+                             int i_finishTime,
+                             const xmDbReplayFile &i_file) {
+  xmDbQuery v_query(this,
+                    "INSERT INTO replays(id_level, name, id_profile, "
+                    "isFinished, finishTime, filepath, fileSize, "
+                    "fileTimeStamp) VALUES (?, ?, ?, ?, ?, ?, ?, ?);");
+  v_query.bind(i_id_level)
+    .bind(i_name)
+    .bind(i_id_profile)
+    .bind(i_isFinished ? 1 : 0)
+    .bind(i_finishTime)
+    .bind(i_file.filepath)
+    .bind(i_file.fileSize)
+    .bind(i_file.fileTimeStamp)
+    .exec();
+}
 
-  simpleSql(
-    "INSERT INTO replays(id_level, name, id_profile, isFinished, finishTime) "
-    "VALUES (\"" +
-    protectString(i_id_level) + "\", \"" + protectString(i_name) + "\", \"" +
-    protectString(i_id_profile) + "\", " +
-    std::string(i_isFinished ? "1" : "0") + ", " + v_finishTime.str() + ");");
+void xmDatabase::replays_getFiles(
+  HashNamespace::unordered_map<std::string, xmDbReplayFile> &o_files) {
+  xmDbQuery v_query(this,
+                    "SELECT name, filepath, fileSize, fileTimeStamp "
+                    "FROM replays;");
+  xmDbReplayFile v_file;
+
+  while (v_query.next()) {
+    // replays indexed before the files were recorded are read again
+    if (v_query.isNull(1)) {
+      v_file.filepath = "";
+      v_file.fileSize = -1;
+      v_file.fileTimeStamp = -1;
+    } else {
+      v_file.filepath = v_query.getString(1);
+      v_file.fileSize = v_query.getInt(2);
+      v_file.fileTimeStamp = v_query.getInt(3);
+    }
+    o_files[v_query.getString(0)] = v_file;
+  }
 }
 
 void xmDatabase::replays_add_end() {
@@ -23,7 +23,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "xmDatabase.h"
 #include "xmoto/Game.h"
 #include "xmoto/GameText.h"
-#include <sstream>
 
 /*
   IMPORTANT NOTE: this update is used ONLY when sitekey didn't exits !!
@@ -147,10 +146,11 @@ void xmDatabase::updateDB_stats(XmDatabaseUpdateInterface *i_interface) {
 
 void xmDatabase::stats_createProfile(const std::string &i_sitekey,
                                      const std::string &i_profile) {
-  simpleSql("INSERT INTO stats_profiles(sitekey, id_profile, nbStarts, since) "
-            "VALUES(\"" +
-            protectString(i_sitekey) + "\", \"" + protectString(i_profile) +
-            "\", 0, \"" + GameApp::getTimeStamp() + "\");");
+  xmDbQuery v_query(
+    this,
+    "INSERT INTO stats_profiles(sitekey, id_profile, nbStarts, since) "
+    "VALUES(?, ?, 0, ?);");
+  v_query.bind(i_sitekey).bind(i_profile).bind(GameApp::getTimeStamp()).exec();
 }
 
 void xmDatabase::stats_destroyProfile(const std::string &i_profile) {
@@ -175,27 +175,22 @@ void xmDatabase::stats_destroyProfile(const std::string &i_profile) {
 bool xmDatabase::stats_checkKeyExists_stats_profiles(
   const std::string &i_sitekey,
   const std::string &i_profile) {
-  return checkKey("SELECT count(1) FROM stats_profiles "
-                  "WHERE sitekey=\"" +
-                  protectString(i_sitekey) +
-                  "\" "
-                  "AND   id_profile=\"" +
-                  protectString(i_profile) + "\";");
+  xmDbQuery v_query(this,
+                    "SELECT count(1) FROM stats_profiles "
+                    "WHERE sitekey=? AND id_profile=?;");
+  v_query.bind(i_sitekey).bind(i_profile).next();
+  return v_query.getInt(0) != 0;
 }
 
 bool xmDatabase::stats_checkKeyExists_stats_profiles_levels(
   const std::string &i_sitekey,
   const std::string &i_profile,
   const std::string &i_level) {
-  return checkKey("SELECT count(1) FROM stats_profiles_levels "
-                  "WHERE sitekey=\"" +
-                  protectString(i_sitekey) +
-                  "\" "
-                  "AND   id_profile=\"" +
-                  protectString(i_profile) +
-                  "\" "
-                  "AND   id_level=\"" +
-                  protectString(i_level) + "\";");
+  xmDbQuery v_query(this,
+                    "SELECT count(1) FROM stats_profiles_levels "
+                    "WHERE sitekey=? AND id_profile=? AND id_level=?;");
+  v_query.bind(i_sitekey).bind(i_profile).bind(i_level).next();
+  return v_query.getInt(0) != 0;
 }
 
 void xmDatabase::stats_levelCompleted(const std::string &i_sitekey,
@@ -203,35 +198,34 @@ void xmDatabase::stats_levelCompleted(const std::string &i_sitekey,
                                       const std::string &LevelID,
                                       int i_playTime) {
   // printf("stats: level completed\n");
-  std::ostringstream v_playTime;
-  v_playTime << i_playTime;
-
   if (stats_checkKeyExists_stats_profiles_levels(
         i_sitekey, PlayerName, LevelID)) {
-    simpleSql("UPDATE stats_profiles_levels SET "
-              "nbCompleted=nbCompleted+1,"
-              "nbPlayed=nbPlayed+1,"
-              "playedTime=playedTime+" +
-              v_playTime.str() + "," +
-              "last_play_date=datetime('now', 'localtime'), "
-              "synchronized = 0 "
-              "WHERE sitekey=\"" +
-              protectString(i_sitekey) +
-              "\" "
-              "AND id_profile=\"" +
-              protectString(PlayerName) +
-              "\" "
-              "AND id_level=\"" +
-              protectString(LevelID) + "\";");
+    xmDbQuery v_query(this,
+                      "UPDATE stats_profiles_levels SET "
+                      "nbCompleted=nbCompleted+1,"
+                      "nbPlayed=nbPlayed+1,"
+                      "playedTime=playedTime+?,"
+                      "last_play_date=datetime('now', 'localtime'), "
+                      "synchronized = 0 "
+                      "WHERE sitekey=? AND id_profile=? AND id_level=?;");
+    v_query.bind(i_playTime)
+      .bind(i_sitekey)
+      .bind(PlayerName)
+      .bind(LevelID)
+      .exec();
   } else {
-    simpleSql("INSERT INTO stats_profiles_levels("
-              "sitekey, id_profile, id_level,"
-              "nbPlayed, nbDied, nbCompleted, nbRestarted, playedTime, "
-              "last_play_date, synchronized) "
-              "VALUES (\"" +
-              protectString(i_sitekey) + "\",\"" + protectString(PlayerName) +
-              "\", \"" + protectString(LevelID) + "\", 1, 0, 1, 0, \"" +
-              v_playTime.str() + "\", datetime('now', 'localtime'), 0);");
+    xmDbQuery v_query(this,
+                      "INSERT INTO stats_profiles_levels("
+                      "sitekey, id_profile, id_level,"
+                      "nbPlayed, nbDied, nbCompleted, nbRestarted, playedTime, "
+                      "last_play_date, synchronized) "
+                      "VALUES (?, ?, ?, 1, 0, 1, 0, ?, "
+                      "datetime('now', 'localtime'), 0);");
+    v_query.bind(i_sitekey)
+      .bind(PlayerName)
+      .bind(LevelID)
+      .bind(i_playTime)
+      .exec();
   }
 }
 
@@ -240,35 +234,34 @@ void xmDatabase::stats_died(const std::string &i_sitekey,
                             const std::string &LevelID,
                             int i_playTime) {
   // printf("stats: level dead\n");
-  std::ostringstream v_playTime;
-  v_playTime << i_playTime;
-
   if (stats_checkKeyExists_stats_profiles_levels(
         i_sitekey, PlayerName, LevelID)) {
-    simpleSql("UPDATE stats_profiles_levels SET "
-              "nbDied=nbDied+1,"
-              "nbPlayed=nbPlayed+1,"
-              "playedTime=playedTime+" +
-              v_playTime.str() + "," +
-              "last_play_date=datetime('now', 'localtime'), "
-              "synchronized = 0 "
-              "WHERE sitekey=\"" +
-              protectString(i_sitekey) +
-              "\" "
-              "AND id_profile=\"" +
-              protectString(PlayerName) +
-              "\" "
-              "AND id_level=\"" +
-              protectString(LevelID) + "\";");
+    xmDbQuery v_query(this,
+                      "UPDATE stats_profiles_levels SET "
+                      "nbDied=nbDied+1,"
+                      "nbPlayed=nbPlayed+1,"
+                      "playedTime=playedTime+?,"
+                      "last_play_date=datetime('now', 'localtime'), "
+                      "synchronized = 0 "
+                      "WHERE sitekey=? AND id_profile=? AND id_level=?;");
+    v_query.bind(i_playTime)
+      .bind(i_sitekey)
+      .bind(PlayerName)
+      .bind(LevelID)
+      .exec();
   } else {
-    simpleSql("INSERT INTO stats_profiles_levels("
-              "sitekey, id_profile, id_level,"
-              "nbPlayed, nbDied, nbCompleted, nbRestarted, playedTime, "
-              "last_play_date, synchronized) "
-              "VALUES (\"" +
-              protectString(i_sitekey) + "\",\"" + protectString(PlayerName) +
-              "\", \"" + protectString(LevelID) + "\", 1, 1, 0, 0, \"" +
-              v_playTime.str() + "\", datetime('now', 'localtime'), 0);");
+    xmDbQuery v_query(this,
+                      "INSERT INTO stats_profiles_levels("
+                      "sitekey, id_profile, id_level,"
+                      "nbPlayed, nbDied, nbCompleted, nbRestarted, playedTime, "
+                      "last_play_date, synchronized) "
+                      "VALUES (?, ?, ?, 1, 1, 0, 0, ?, "
+                      "datetime('now', 'localtime'), 0);");
+    v_query.bind(i_sitekey)
+      .bind(PlayerName)
+      .bind(LevelID)
+      .bind(i_playTime)
+      .exec();
   }
 }
 
@@ -277,34 +270,33 @@ void xmDatabase::stats_abortedLevel(const std::string &i_sitekey,
                                     const std::string &LevelID,
                                     int i_playTime) {
   // printf("stats: level aborted\n");
-  std::ostringstream v_playTime;
-  v_playTime << i_playTime;
-
   if (stats_checkKeyExists_stats_profiles_levels(
         i_sitekey, PlayerName, LevelID)) {
-    simpleSql("UPDATE stats_profiles_levels SET "
-              "nbPlayed=nbPlayed+1,"
-              "playedTime=playedTime+" +
-              v_playTime.str() + "," +
-              "last_play_date=datetime('now', 'localtime'), "
-              "synchronized = 0 "
-              "WHERE sitekey=\"" +
-              protectString(i_sitekey) +
-              "\" "
-              "AND id_profile=\"" +
-              protectString(PlayerName) +
-              "\" "
-              "AND id_level=\"" +
-              protectString(LevelID) + "\";");
+    xmDbQuery v_query(this,
+                      "UPDATE stats_profiles_levels SET "
+                      "nbPlayed=nbPlayed+1,"
+                      "playedTime=playedTime+?,"
+                      "last_play_date=datetime('now', 'localtime'), "
+                      "synchronized = 0 "
+                      "WHERE sitekey=? AND id_profile=? AND id_level=?;");
+    v_query.bind(i_playTime)
+      .bind(i_sitekey)
+      .bind(PlayerName)
+      .bind(LevelID)
+      .exec();
   } else {
-    simpleSql("INSERT INTO stats_profiles_levels("
-              "sitekey, id_profile, id_level,"
-              "nbPlayed, nbDied, nbCompleted, nbRestarted, playedTime, "
-              "last_play_date, synchronized) "
-              "VALUES (\"" +
-              protectString(i_sitekey) + "\",\"" + protectString(PlayerName) +
-              "\", \"" + protectString(LevelID) + "\", 1, 0, 0, 0, \"" +
-              v_playTime.str() + "\", datetime('now', 'localtime'), 0);");
+    xmDbQuery v_query(this,
+                      "INSERT INTO stats_profiles_levels("
+                      "sitekey, id_profile, id_level,"
+                      "nbPlayed, nbDied, nbCompleted, nbRestarted, playedTime, "
+                      "last_play_date, synchronized) "
+                      "VALUES (?, ?, ?, 1, 0, 0, 0, ?, "
+                      "datetime('now', 'localtime'), 0);");
+    v_query.bind(i_sitekey)
+      .bind(PlayerName)
+      .bind(LevelID)
+      .bind(i_playTime)
+      .exec();
   }
 }
 
@@ -313,43 +305,42 @@ void xmDatabase::stats_levelRestarted(const std::string &i_sitekey,
                                       const std::string &LevelID,
                                       int i_playTime) {
   // printf("stats: level restarted\n");
-  std::ostringstream v_playTime;
-  v_playTime << i_playTime;
-
   if (stats_checkKeyExists_stats_profiles_levels(
         i_sitekey, PlayerName, LevelID)) {
-    simpleSql("UPDATE stats_profiles_levels SET "
-              "nbRestarted=nbRestarted+1,"
-              "nbPlayed=nbPlayed+1,"
-              "playedTime=playedTime+" +
-              v_playTime.str() + "," +
-              "last_play_date=datetime('now', 'localtime'), "
-              "synchronized = 0 "
-              "WHERE sitekey=\"" +
-              protectString(i_sitekey) +
-              "\" "
-              "AND id_profile=\"" +
-              protectString(PlayerName) +
-              "\" "
-              "AND id_level=\"" +
-              protectString(LevelID) + "\";");
+    xmDbQuery v_query(this,
+                      "UPDATE stats_profiles_levels SET "
+                      "nbRestarted=nbRestarted+1,"
+                      "nbPlayed=nbPlayed+1,"
+                      "playedTime=playedTime+?,"
+                      "last_play_date=datetime('now', 'localtime'), "
+                      "synchronized = 0 "
+                      "WHERE sitekey=? AND id_profile=? AND id_level=?;");
+    v_query.bind(i_playTime)
+      .bind(i_sitekey)
+      .bind(PlayerName)
+      .bind(LevelID)
+      .exec();
   } else {
-    simpleSql("INSERT INTO stats_profiles_levels("
-              "sitekey, id_profile, id_level,"
-              "nbPlayed, nbDied, nbCompleted, nbRestarted, playedTime, "
-              "last_play_date, synchronized) "
-              "VALUES (\"" +
-              protectString(i_sitekey) + "\",\"" + protectString(PlayerName) +
-              "\", \"" + protectString(LevelID) + "\", 1, 0, 0, 1, \"" +
-              v_playTime.str() + "\", datetime('now', 'localtime'), 0);");
+    xmDbQuery v_query(this,
+                      "INSERT INTO stats_profiles_levels("
+                      "sitekey, id_profile, id_level,"
+                      "nbPlayed, nbDied, nbCompleted, nbRestarted, playedTime, "
+                      "last_play_date, synchronized) "
+                      "VALUES (?, ?, ?, 1, 0, 0, 1, ?, "
+                      "datetime('now', 'localtime'), 0);");
+    v_query.bind(i_sitekey)
+      .bind(PlayerName)
+      .bind(LevelID)
+      .bind(i_playTime)
+      .exec();
   }
 }
 
 void xmDatabase::stats_xmotoStarted(const std::string &i_sitekey,
                                     const std::string &PlayerName) {
-  simpleSql("UPDATE stats_profiles SET "
-            "nbStarts=nbStarts+1 "
-            "WHERE sitekey=\"" +
-            i_sitekey + "\" AND id_profile=\"" + protectString(PlayerName) +
-            "\";");
+  xmDbQuery v_query(this,
+                    "UPDATE stats_profiles SET "
+                    "nbStarts=nbStarts+1 "
+                    "WHERE sitekey=? AND id_profile=?;");
+  v_query.bind(i_sitekey).bind(PlayerName).exec();
 }
@@ -24,7 +24,6 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "helpers/VExcept.h"
 #include "xmDatabase.h"
 #include "xmoto/GameText.h"
-#include <sstream>
 
 #define XM_NB_THIEFS_MAX 3
 
@@ -37,19 +36,21 @@ bool xmDatabase::webrooms_checkKeyExists_id_room(const std::string &i_id_room) {
 void xmDatabase::webrooms_addRoom(const std::string &i_id_room,
                                   const std::string &i_name,
                                   const std::string &i_highscoreUrl) {
-  simpleSql("INSERT INTO webrooms("
+  xmDbQuery(this,
+            "INSERT INTO webrooms("
             "id_room,  name, highscoresUrl) "
-            "VALUES(" +
-            i_id_room + ", " + "\"" + protectString(i_name) + "\", " + "\"" +
-            protectString(i_highscoreUrl) + "\");");
+            "VALUES(CAST(? AS NUMERIC), ?, ?);")
+    .bind(i_id_room)
+    .bind(i_name)
+    .bind(i_highscoreUrl)
+    .exec();
 }
 
 std::string xmDatabase::webhighscores_updateDB(
   FileDataType i_fdt,
   const std::string &i_webhighscoresFile,
   const std::string &i_websource) {
-  XMLDocument v_xml;
-  xmlNodePtr v_xmlElt;
+  XMLReader v_xml;
   std::string v_roomName;
   std::string v_roomId;
   std::string v_levelId;
@@ -63,16 +64,12 @@ std::string xmDatabase::webhighscores_updateDB(
   try {
     simpleSql("BEGIN TRANSACTION;");
 
-    v_xml.readFromFile(i_fdt, i_webhighscoresFile);
-
-    v_xmlElt = v_xml.getRootNode("xmoto_worldrecords");
-    if (v_xmlElt == NULL) {
-      throw Exception("unable to analyze xml highscore file");
-    }
+    v_xml.openFile(i_fdt, i_webhighscoresFile);
+    v_xml.readRootNode("xmoto_worldrecords");
 
     /* get Room information */
-    v_roomName = XMLDocument::getOption(v_xmlElt, "roomname");
-    v_roomId = XMLDocument::getOption(v_xmlElt, "roomid");
+    v_roomName = v_xml.getOption("roomname");
+    v_roomId = v_xml.getOption("roomid");
 
     if (v_roomId == "") {
       throw Exception("error : unable to analyze xml highscore file");
@@ -85,21 +82,20 @@ std::string xmDatabase::webhighscores_updateDB(
 
     simpleSql("DELETE FROM webhighscores WHERE id_room=" + v_roomId + ";");
 
-    for (xmlNodePtr pSubElem = XMLDocument::subElement(v_xmlElt, "worldrecord");
-         pSubElem != NULL;
-         pSubElem = XMLDocument::nextElement(pSubElem)) {
-      v_levelId = XMLDocument::getOption(pSubElem, "level_id");
+    /* the records are inserted while the file is read */
+    while (v_xml.nextSubElement("worldrecord")) {
+      v_levelId = v_xml.getOption("level_id");
       if (v_levelId == "") {
         continue;
       }
 
-      v_player = XMLDocument::getOption(pSubElem, "player");
+      v_player = v_xml.getOption("player");
       if (v_player == "") {
         continue;
       }
 
       /* time */
-      v_strtime = XMLDocument::getOption(pSubElem, "time");
+      v_strtime = v_xml.getOption("time");
       if (v_strtime == "") {
         continue;
       }
@@ -118,26 +114,28 @@ std::string xmDatabase::webhighscores_updateDB(
           v_strtime.substr(pos_2 + 1, v_strtime.length() - pos_2 - 1).c_str());
 
       /* replay */
-      v_rplUrl = XMLDocument::getOption(pSubElem, "replay");
+      v_rplUrl = v_xml.getOption("replay");
       if (v_rplUrl == "") {
         continue;
       }
 
       /* date */
-      v_date = XMLDocument::getOption(pSubElem, "date");
+      v_date = v_xml.getOption("date");
       if (v_date == "") {
         continue;
       }
 
-      std::ostringstream v_secondTime;
-      v_secondTime << v_time;
-
-      simpleSql("INSERT INTO webhighscores(id_room, id_level, id_profile, "
+      xmDbQuery(this,
+                "INSERT INTO webhighscores(id_room, id_level, id_profile, "
                 "finishTime, date, fileUrl)"
-                "VALUES(" +
-                v_roomId + ", \"" + protectString(v_levelId) + "\", \"" +
-                protectString(v_player) + "\", " + v_secondTime.str() + ", \"" +
-                v_date + "\", \"" + protectString(v_rplUrl) + "\");");
+                "VALUES(CAST(? AS NUMERIC), ?, ?, ?, ?, ?);")
+        .bind(v_roomId)
+        .bind(v_levelId)
+        .bind(v_player)
+        .bind(v_time)
+        .bind(v_date)
+        .bind(v_rplUrl)
+        .exec();
     }
     simpleSql("COMMIT;");
   } catch (Exception &e) {
@@ -197,51 +195,45 @@ bool xmDatabase::isWebVoteLocked(const std::string &i_id_level) {
 
 void xmDatabase::weblevels_updateDB(FileDataType i_fdt,
                                     const std::string &i_weblevelsFile) {
-  XMLDocument v_xml;
-  xmlNodePtr v_xmlElt;
+  XMLReader v_xml;
 
   try {
     simpleSql("BEGIN TRANSACTION;");
     simpleSql("DELETE FROM weblevels;");
 
-    v_xml.readFromFile(i_fdt, i_weblevelsFile);
-
-    v_xmlElt = v_xml.getRootNode("xmoto_levels");
-    if (v_xmlElt == NULL) {
-      throw Exception("unable to analyze xml file");
-    }
+    v_xml.openFile(i_fdt, i_weblevelsFile);
+    v_xml.readRootNode("xmoto_levels");
 
-    for (xmlNodePtr pSubElem = XMLDocument::subElement(v_xmlElt, "level");
-         pSubElem != NULL;
-         pSubElem = XMLDocument::nextElement(pSubElem)) {
+    /* the levels are inserted while the file is read */
+    while (v_xml.nextSubElement("level")) {
       std::string v_levelId, v_levelName, v_url, v_MD5sum_web;
       std::string v_difficulty, v_quality, v_creationDate;
       std::string v_crappy, v_children_compliant, v_vote_locked;
       std::string v_packname, v_packnum;
 
-      v_levelId = XMLDocument::getOption(pSubElem, "level_id");
+      v_levelId = v_xml.getOption("level_id");
       if (v_levelId == "")
         continue;
 
-      v_levelName = XMLDocument::getOption(pSubElem, "name");
+      v_levelName = v_xml.getOption("name");
       if (v_levelName == "")
         continue;
 
-      v_packname = XMLDocument::getOption(pSubElem, "packname");
+      v_packname = v_xml.getOption("packname");
       if (v_packname != "") {
-        v_packnum = XMLDocument::getOption(pSubElem, "packnum");
+        v_packnum = v_xml.getOption("packnum");
       }
 
-      v_url = XMLDocument::getOption(pSubElem, "url");
+      v_url = v_xml.getOption("url");
       if (v_url == "")
         continue;
 
-      v_MD5sum_web = XMLDocument::getOption(pSubElem, "sum");
+      v_MD5sum_web = v_xml.getOption("sum");
       if (v_MD5sum_web == "")
         continue;
 
       /* web information */
-      v_difficulty = XMLDocument::getOption(pSubElem, "web_difficulty");
+      v_difficulty = v_xml.getOption("web_difficulty");
       if (v_difficulty == "")
         continue;
       for (unsigned int i = 0; i < v_difficulty.length(); i++) {
@@ -249,7 +241,7 @@ void xmDatabase::weblevels_updateDB(FileDataType i_fdt,
           v_difficulty[i] = '.';
       }
 
-      v_quality = XMLDocument::getOption(pSubElem, "web_quality");
+      v_quality = v_xml.getOption("web_quality");
       if (v_quality == "")
         continue;
       for (unsigned int i = 0; i < v_quality.length(); i++) {
@@ -257,26 +249,25 @@ void xmDatabase::weblevels_updateDB(FileDataType i_fdt,
           v_quality[i] = '.';
       }
 
-      v_creationDate = XMLDocument::getOption(pSubElem, "creation_date");
+      v_creationDate = v_xml.getOption("creation_date");
       if (v_creationDate == "")
         continue;
 
-      v_crappy = XMLDocument::getOption(pSubElem, "crappy");
+      v_crappy = v_xml.getOption("crappy");
       if (v_crappy == "") {
         v_crappy = "0";
       } else {
         v_crappy = v_crappy == "true" ? "1" : "0";
       }
 
-      v_children_compliant =
-        XMLDocument::getOption(pSubElem, "children_compliant");
+      v_children_compliant = v_xml.getOption("children_compliant");
       if (v_children_compliant == "") {
         v_children_compliant = "1";
       } else {
         v_children_compliant = v_children_compliant == "true" ? "1" : "0";
       }
 
-      v_vote_locked = XMLDocument::getOption(pSubElem, "vote_locked");
+      v_vote_locked = v_xml.getOption("vote_locked");
       if (v_vote_locked == "") {
         v_vote_locked = "0";
       } else {
@@ -284,16 +275,24 @@ void xmDatabase::weblevels_updateDB(FileDataType i_fdt,
       }
 
       // add the level
-      simpleSql(
-        "INSERT INTO weblevels(id_level, name, packname, packnum, fileUrl, "
-        "checkSum, difficulty, quality, creationDate, crappy, "
-        "children_compliant, vote_locked) VALUES (\"" +
-        protectString(v_levelId) + "\", \"" + protectString(v_levelName) +
-        "\", \"" + protectString(v_packname) + "\", \"" +
-        protectString(v_packnum) + "\", \"" + protectString(v_url) + "\", \"" +
-        protectString(v_MD5sum_web) + "\", " + v_difficulty + ", " + v_quality +
-        ", \"" + v_creationDate + "\", " + v_crappy + ", " +
-        v_children_compliant + ", " + v_vote_locked + ");");
+      xmDbQuery(this,
+                "INSERT INTO weblevels(id_level, name, packname, packnum, "
+                "fileUrl, checkSum, difficulty, quality, creationDate, crappy, "
+                "children_compliant, vote_locked) VALUES (?, ?, ?, ?, ?, ?, "
+                "CAST(? AS NUMERIC), CAST(? AS NUMERIC), ?, ?, ?, ?);")
+        .bind(v_levelId)
+        .bind(v_levelName)
+        .bind(v_packname)
+        .bind(v_packnum)
+        .bind(v_url)
+        .bind(v_MD5sum_web)
+        .bind(v_difficulty)
+        .bind(v_quality)
+        .bind(v_creationDate)
+        .bind(atoi(v_crappy.c_str()))
+        .bind(atoi(v_children_compliant.c_str()))
+        .bind(atoi(v_vote_locked.c_str()))
+        .exec();
     }
     simpleSql("COMMIT;");
   } catch (Exception &e) {
@@ -304,34 +303,26 @@ void xmDatabase::weblevels_updateDB(FileDataType i_fdt,
 
 void xmDatabase::webrooms_updateDB(FileDataType i_fdt,
                                    const std::string &i_webroomsFile) {
-  XMLDocument v_xml;
-  xmlNodePtr v_xmlElt;
-
+  XMLReader v_xml;
   std::string v_RoomName, v_RoomHighscoreUrl, v_RoomId;
 
   try {
     simpleSql("BEGIN TRANSACTION;");
     simpleSql("DELETE FROM webrooms;");
 
-    v_xml.readFromFile(i_fdt, i_webroomsFile);
-
-    v_xmlElt = v_xml.getRootNode("xmoto_rooms");
-    if (v_xmlElt == NULL) {
-      throw Exception("unable to analyze xml file");
-    }
+    v_xml.openFile(i_fdt, i_webroomsFile);
+    v_xml.readRootNode("xmoto_rooms");
 
-    for (xmlNodePtr pSubElem = XMLDocument::subElement(v_xmlElt, "room");
-         pSubElem != NULL;
-         pSubElem = XMLDocument::nextElement(pSubElem)) {
-      v_RoomName = XMLDocument::getOption(pSubElem, "name");
+    while (v_xml.nextSubElement("room")) {
+      v_RoomName = v_xml.getOption("name");
       if (v_RoomName == "")
         continue;
 
-      v_RoomHighscoreUrl = XMLDocument::getOption(pSubElem, "highscores_url");
+      v_RoomHighscoreUrl = v_xml.getOption("highscores_url");
       if (v_RoomName == "")
         continue;
 
-      v_RoomId = XMLDocument::getOption(pSubElem, "id");
+      v_RoomId = v_xml.getOption("id");
       if (v_RoomId == "")
         continue;
 
@@ -346,33 +337,26 @@ void xmDatabase::webrooms_updateDB(FileDataType i_fdt,
 
 void xmDatabase::webthemes_updateDB(FileDataType i_fdt,
                                     const std::string &i_webThemesFile) {
-  XMLDocument v_xml;
-  xmlNodePtr v_xmlElt;
+  XMLReader v_xml;
   std::string v_themeName, v_url, v_MD5sum_web;
 
   try {
     simpleSql("BEGIN TRANSACTION;");
     simpleSql("DELETE FROM webthemes;");
 
-    v_xml.readFromFile(i_fdt, i_webThemesFile);
-
-    v_xmlElt = v_xml.getRootNode("xmoto_themes");
-    if (v_xmlElt == NULL) {
-      throw Exception("unable to analyze xml file");
-    }
+    v_xml.openFile(i_fdt, i_webThemesFile);
+    v_xml.readRootNode("xmoto_themes");
 
-    for (xmlNodePtr pSubElem = XMLDocument::subElement(v_xmlElt, "theme");
-         pSubElem != NULL;
-         pSubElem = XMLDocument::nextElement(pSubElem)) {
-      v_themeName = XMLDocument::getOption(pSubElem, "name");
+    while (v_xml.nextSubElement("theme")) {
+      v_themeName = v_xml.getOption("name");
       if (v_themeName == "")
         continue;
 
-      v_url = XMLDocument::getOption(pSubElem, "url");
+      v_url = v_xml.getOption("url");
       if (v_url == "")
         continue;
 
-      v_MD5sum_web = XMLDocument::getOption(pSubElem, "sum");
+      v_MD5sum_web = v_xml.getOption("sum");
       if (v_MD5sum_web == "")
         continue;
 
@@ -388,11 +372,14 @@ void xmDatabase::webthemes_updateDB(FileDataType i_fdt,
 void xmDatabase::webthemes_addTheme(const std::string &i_id_theme,
                                     const std::string &i_url,
                                     const std::string &i_checkSum) {
-  simpleSql("INSERT INTO webthemes("
+  xmDbQuery(this,
+            "INSERT INTO webthemes("
             "id_theme,  fileUrl, checkSum) "
-            "VALUES(\"" +
-            protectString(i_id_theme) + "\", " + "\"" + protectString(i_url) +
-            "\", " + "\"" + protectString(i_checkSum) + "\");");
+            "VALUES(?, ?, ?);")
+    .bind(i_id_theme)
+    .bind(i_url)
+    .bind(i_checkSum)
+    .exec();
 }
 
 void xmDatabase::webLoadDataFirstTime() {
@@ -33,10 +33,14 @@
 #include "helpers/utf8.h"
 #include "include/xm_hashmap.h"
 #include "xmscene/Camera.h"
+#include <list>
 
 #define UTF8_INTERLINE_SPACE 2
 #define UTF8_INTERCHAR_SPACE 0
 
+// strings glyphs kept in memory by font, the least recently used is removed
+#define GLFONT_MAX_GLYPHS 512
+
 #ifdef ENABLE_OPENGL
 
 class ScrapTextures : public Singleton<ScrapTextures> {
@@ -60,7 +64,8 @@ public:
   void display(DrawLib *pDrawLib);
 
 private:
-#define MAX_SCRAPS 4
+// scraps are allocated when needed
+#define MAX_SCRAPS 16
 // we need 3dfx first gen compatibility, which has only 256x256 max
 // texture size
 #define BLOCK_WIDTH 256
@@ -70,6 +75,7 @@ private:
   unsigned int m_scrapsAllocated[MAX_SCRAPS][BLOCK_WIDTH];
   SDL_Surface *m_scrapsTexels[MAX_SCRAPS];
   bool m_scrapsUsed[MAX_SCRAPS];
+  bool m_scrapsDirty[MAX_SCRAPS];
   unsigned int m_scrapsTextures[MAX_SCRAPS];
 
   bool m_dirty;
@@ -161,15 +167,22 @@ public:
   virtual void displayScrap(DrawLib *pDrawLib);
 
 private:
-  std::vector<std::string> m_glyphsKeys;
-  std::vector<GLFontGlyph *> m_glyphsValues;
-  HashNamespace::unordered_map<std::string, GLFontGlyph *> m_glyphs;
+  /* glyphs of the strings, the most recently used first */
+  std::list<GLFontGlyph *> m_glyphsValues;
+  HashNamespace::unordered_map<std::string, std::list<GLFontGlyph *>::iterator>
+    m_glyphs;
 
   std::vector<std::string> m_glyphsLettersKeys;
   std::vector<GLFontGlyphLetter *> m_glyphsLettersValues;
   HashNamespace::unordered_map<std::string, GLFontGlyphLetter *>
     m_glyphsLetters;
 
+  /* quads of the letters sharing a texture, drawn at once */
+  std::vector<float> m_quadsVertices;
+  std::vector<float> m_quadsTexCoords;
+  std::vector<unsigned char> m_quadsColors;
+  void drawQuads();
+
   unsigned int getLonguestLineSize(const std::string &i_value,
                                    unsigned int i_start = 0,
                                    unsigned int i_nbLinesToRead = -1);
@@ -648,15 +661,18 @@ ScrapTextures::ScrapTextures() {
   m_dirty = false;
   memset(m_scrapsAllocated, 0, sizeof(unsigned int) * BLOCK_WIDTH * MAX_SCRAPS);
   for (unsigned int i = 0; i < MAX_SCRAPS; i++) {
-    m_scrapsTexels[i] = createSDLSurface(BLOCK_WIDTH, BLOCK_HEIGHT);
+    m_scrapsTexels[i] = NULL;
     m_scrapsUsed[i] = false;
+    m_scrapsDirty[i] = false;
   }
   glGenTextures(MAX_SCRAPS, (GLuint *)&m_scrapsTextures);
 }
 
 ScrapTextures::~ScrapTextures() {
   for (unsigned int i = 0; i < MAX_SCRAPS; i++) {
-    SDL_FreeSurface(m_scrapsTexels[i]);
+    if (m_scrapsTexels[i] != NULL) {
+      SDL_FreeSurface(m_scrapsTexels[i]);
+    }
   }
   glDeleteTextures(MAX_SCRAPS, (GLuint *)&m_scrapsTextures);
 }
@@ -698,6 +714,9 @@ int ScrapTextures::allocateAndLoadTexture(unsigned int width,
   }
 
   if (useScrap == true) {
+    if (m_scrapsTexels[scrap] == NULL) {
+      m_scrapsTexels[scrap] = createSDLSurface(BLOCK_WIDTH, BLOCK_HEIGHT);
+    }
     m_scrapsUsed[scrap] = true;
 
     for (unsigned int i = 0; i < width; i++)
@@ -709,6 +728,7 @@ int ScrapTextures::allocateAndLoadTexture(unsigned int width,
     *vy = (y + height - 0.01) / (float)BLOCK_HEIGHT;
 
     m_dirty = true;
+    m_scrapsDirty[scrap] = true;
     SDL_Rect v_area_dest;
 
     v_area_dest.x = x;
@@ -718,7 +738,7 @@ int ScrapTextures::allocateAndLoadTexture(unsigned int width,
 
     return m_scrapsTextures[scrap];
   } else {
-    // there's four scraps, approximatly less than 100 characters, this
+    // there's sixteen scraps, approximatly less than 400 characters, this
     // should not happen
     LogError("Scrap is full.");
     throw Exception("Scrap is full !");
@@ -732,7 +752,8 @@ bool ScrapTextures::isDirty() {
 void ScrapTextures::update() {
   if (isDirty() == true) {
     for (unsigned int i = 0; i < MAX_SCRAPS; i++) {
-      if (m_scrapsUsed[i] == false)
+      // upload only the scraps which received new letters
+      if (m_scrapsDirty[i] == false)
         continue;
 
       glBindTexture(GL_TEXTURE_2D, m_scrapsTextures[i]);
@@ -747,6 +768,7 @@ void ScrapTextures::update() {
                    GL_RGBA,
                    GL_UNSIGNED_BYTE,
                    m_scrapsTexels[i]->pixels);
+      m_scrapsDirty[i] = false;
     }
     m_dirty = false;
   }
@@ -863,7 +885,10 @@ GLFontGlyphLetter::GLFontGlyphLetter(const std::string &i_value,
 }
 
 GLFontGlyphLetter::~GLFontGlyphLetter() {
-  glDeleteTextures(1, &m_GLID);
+  // scraps textures are shared by the letters
+  if (m_useScrap == false) {
+    glDeleteTextures(1, &m_GLID);
+  }
 }
 
 GLuint GLFontGlyphLetter::GLID() const {
@@ -970,8 +995,9 @@ void GLFontManager::displayScrap(DrawLib *pDrawLib) {
 }
 
 GLFontManager::~GLFontManager() {
-  for (unsigned int i = 0; i < m_glyphsValues.size(); i++) {
-    delete m_glyphsValues[i];
+  std::list<GLFontGlyph *>::iterator it;
+  for (it = m_glyphsValues.begin(); it != m_glyphsValues.end(); it++) {
+    delete *it;
   }
 
   for (unsigned int i = 0; i < m_glyphsLettersValues.size(); i++) {
@@ -1021,9 +1047,15 @@ FontGlyph *GLFontManager::getGlyph(const std::string &i_string) {
   GLFontGlyph *v_glyph;
   GLFontGlyphLetter *v_glyphLetter;
 
-  v_glyph = m_glyphs[i_string];
-  if (v_glyph != NULL)
-    return v_glyph;
+  HashNamespace::unordered_map<std::string,
+                               std::list<GLFontGlyph *>::iterator>::iterator
+    v_found = m_glyphs.find(i_string);
+  if (v_found != m_glyphs.end()) {
+    // most recently used
+    m_glyphsValues.splice(
+      m_glyphsValues.begin(), m_glyphsValues, v_found->second);
+    return *(v_found->second);
+  }
 
   /* make sure that chars exists into the hashmap before continuing */
   unsigned int n = 0;
@@ -1042,9 +1074,16 @@ FontGlyph *GLFontManager::getGlyph(const std::string &i_string) {
   }
 
   v_glyph = new GLFontGlyph(i_string, m_glyphsLetters);
-  m_glyphsKeys.push_back(i_string);
-  m_glyphsValues.push_back(v_glyph);
-  m_glyphs[m_glyphsKeys[m_glyphsKeys.size() - 1]] = v_glyph;
+  m_glyphsValues.push_front(v_glyph);
+  m_glyphs[i_string] = m_glyphsValues.begin();
+
+  // the letters are kept, only the string metrics are forgotten
+  if (m_glyphsValues.size() > GLFONT_MAX_GLYPHS) {
+    GLFontGlyph *v_oldest = m_glyphsValues.back();
+    m_glyphs.erase(v_oldest->Value());
+    m_glyphsValues.pop_back();
+    delete v_oldest;
+  }
 
   return v_glyph;
 }
@@ -1137,8 +1176,14 @@ void GLFontManager::printStringGradOne(DrawLib *pDrawLib,
     glEnable(GL_TEXTURE_2D);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    // the first glBegin/glEnd will draw nothing
-    glBegin(GL_QUADS);
+
+    /* the arrays are in memory, not in a buffer object */
+    if (pDrawLib->useVBOs()) {
+      glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+    }
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
 
     v_longuest_linesize = getLonguestLineSize(v_value);
     v_size = v_value.size();
@@ -1177,35 +1222,47 @@ void GLFontManager::printStringGradOne(DrawLib *pDrawLib,
 
           newTextureId = v_glyphLetter->GLID();
           if (newTextureId != oldTextureId) {
-            glEnd();
+            drawQuads();
             glBindTexture(GL_TEXTURE_2D, newTextureId);
-            glBegin(GL_QUADS);
             oldTextureId = newTextureId;
           }
 
-          glColor4ub(r1, g1, b1, a1);
-          glTexCoord2f(v_glyphLetter->m_u.x, v_glyphLetter->m_v.y);
-          glVertex2i(v_x, v_y);
-
-          glColor4ub(r2, g2, b2, a2);
-          glTexCoord2f(v_glyphLetter->m_v.x, v_glyphLetter->m_v.y);
-          glVertex2i(v_x + v_glyphLetter->drawWidth(), v_y);
-
-          glColor4ub(r4, g4, b4, a4);
-          glTexCoord2f(v_glyphLetter->m_v.x, v_glyphLetter->m_u.y);
-          glVertex2i(v_x + v_glyphLetter->drawWidth(),
-                     v_y + v_glyphLetter->drawHeight());
-
-          glColor4ub(r3, g3, b3, a3);
-          glTexCoord2f(v_glyphLetter->m_u.x, v_glyphLetter->m_u.y);
-          glVertex2i(v_x, v_y + v_glyphLetter->drawHeight());
+          float v_x1 = v_x;
+          float v_y1 = v_y;
+          float v_x2 = v_x + v_glyphLetter->drawWidth();
+          float v_y2 = v_y + v_glyphLetter->drawHeight();
+          float v_vertices[8] = { v_x1, v_y1, v_x2, v_y1,
+                                  v_x2, v_y2, v_x1, v_y2 };
+          float v_texCoords[8] = {
+            v_glyphLetter->m_u.x, v_glyphLetter->m_v.y,
+            v_glyphLetter->m_v.x, v_glyphLetter->m_v.y,
+            v_glyphLetter->m_v.x, v_glyphLetter->m_u.y,
+            v_glyphLetter->m_u.x, v_glyphLetter->m_u.y
+          };
+          unsigned char v_colors[16] = { (unsigned char)r1, (unsigned char)g1,
+                                         (unsigned char)b1, (unsigned char)a1,
+                                         (unsigned char)r2, (unsigned char)g2,
+                                         (unsigned char)b2, (unsigned char)a2,
+                                         (unsigned char)r4, (unsigned char)g4,
+                                         (unsigned char)b4, (unsigned char)a4,
+                                         (unsigned char)r3, (unsigned char)g3,
+                                         (unsigned char)b3, (unsigned char)a3 };
+
+          m_quadsVertices.insert(
+            m_quadsVertices.end(), v_vertices, v_vertices + 8);
+          m_quadsTexCoords.insert(
+            m_quadsTexCoords.end(), v_texCoords, v_texCoords + 8);
+          m_quadsColors.insert(m_quadsColors.end(), v_colors, v_colors + 16);
 
           v_x += v_glyphLetter->realWidth() + UTF8_INTERCHAR_SPACE;
         }
       }
     }
 
-    glEnd();
+    drawQuads();
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
     glDisable(GL_BLEND);
     glDisable(GL_TEXTURE_2D);
 
@@ -1214,6 +1271,21 @@ void GLFontManager::printStringGradOne(DrawLib *pDrawLib,
   }
 }
 
+void GLFontManager::drawQuads() {
+  if (m_quadsVertices.size() == 0) {
+    return;
+  }
+
+  glVertexPointer(2, GL_FLOAT, 0, &m_quadsVertices[0]);
+  glTexCoordPointer(2, GL_FLOAT, 0, &m_quadsTexCoords[0]);
+  glColorPointer(4, GL_UNSIGNED_BYTE, 0, &m_quadsColors[0]);
+  glDrawArrays(GL_QUADS, 0, m_quadsVertices.size() / 2);
+
+  m_quadsVertices.clear();
+  m_quadsTexCoords.clear();
+  m_quadsColors.clear();
+}
+
 unsigned int GLFontManager::getLonguestLineSize(const std::string &i_value,
                                                 unsigned int i_start,
                                                 unsigned int i_nbLinesToRead) {
@@ -769,6 +769,8 @@ struct UIListEntry {
   std::vector<std::string> Text;
   void *pvUser;
   bool bFiltered;
+  bool bToComplete; /* the columns are completed by completeEntry() once the
+                       entry is displayed or filtered */
 
   bool bUseOwnProperties;
   Color ownTextColor;
@@ -843,6 +845,11 @@ public:
 
   int nbVisibleItems() const;
 
+protected:
+  /* called for the entries with bToComplete set, only when they are required
+   * ; allows long lists to format their columns lazily */
+  virtual void completeEntry(UIListEntry *i_entry);
+
 private:
   /* Data */
   bool m_bChanged;
@@ -872,6 +879,13 @@ private:
   std::string m_filter;
   unsigned int m_filteredItems;
 
+  /* indexes in m_Entries of the unfiltered entries, so that only the
+   * displayed rows are browsed */
+  std::vector<unsigned int> m_visibleEntries;
+  bool m_visibleEntriesDirty;
+  void updateVisibleEntries();
+  void completeEntryIfRequired(UIListEntry *i_entry);
+
   //
   void adaptRealSelectedOnVisibleEntries();
 
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "xmoto/Game.h"
 #include "xmoto/Sound.h"
 #include "xmoto/input/Joystick.h"
+#include <algorithm>
 #include <sstream>
 
 #define GUILIST_SCROLL_SIZE 10
@@ -173,6 +174,7 @@ UIList::UIList(UIWindow *pParent,
   /* **** */
 
   m_filteredItems = 0;
+  m_visibleEntriesDirty = true;
 
   unhideAllColumns();
 }
@@ -465,8 +467,17 @@ void UIList::paint(void) {
 
   setScissor(m_lineMargeX, LinesStartY(), LinesWidth(), LinesHeight());
 
-  int m_numEntryDisplayed = 0;
-  for (unsigned int i = 0; i < m_Entries.size(); i++) {
+  /* start at the first row in the view */
+  updateVisibleEntries();
+  int m_numEntryDisplayed = -m_nScroll / m_rowHeight;
+  if (m_numEntryDisplayed < 0) {
+    m_numEntryDisplayed = 0;
+  }
+
+  for (unsigned int v = m_numEntryDisplayed; v < m_visibleEntries.size(); v++) {
+    unsigned int i = m_visibleEntries[v];
+    completeEntryIfRequired(m_Entries[i]);
+
     if (m_Entries[i]->bFiltered == false) {
       if (m_Entries[i]->bUseOwnProperties) {
         setTextSolidColor(m_Entries[i]->ownTextColor);
@@ -776,46 +787,60 @@ void UIList::mouseHover(int x, int y) {
 /*===========================================================================
 Allocate entry / vice versa
 ===========================================================================*/
+namespace {
+struct UIListEntryCompare {
+  UIListEntryCompare(int (*f)(void *pvUser1, void *pvUser2)) { m_fsort = f; }
+
+  bool operator()(const UIListEntry *a, const UIListEntry *b) const {
+    if (a->pvUser != NULL && b->pvUser != NULL && m_fsort != NULL) {
+      return m_fsort(a->pvUser, b->pvUser) < 0;
+    }
+
+    /* Make lowercase before comparing */
+    const std::string &s1 = a->Text[0];
+    const std::string &s2 = b->Text[0];
+    unsigned int n = std::min(s1.length(), s2.length());
+
+    for (unsigned int i = 0; i < n; i++) {
+      unsigned char c1 = tolower(s1[i]);
+      unsigned char c2 = tolower(s2[i]);
+
+      if (c1 != c2) {
+        return c1 < c2;
+      }
+    }
+    return s1.length() < s2.length();
+  }
+
+  int (*m_fsort)(void *pvUser1, void *pvUser2);
+};
+}
+
 UIListEntry *UIList::addEntry(std::string Text, void *pvUser, int i_position) {
   UIListEntry *p = new UIListEntry;
   p->Text.push_back(Text);
   p->pvUser = pvUser;
   p->bFiltered = false;
+  p->bToComplete = false;
   p->bUseOwnProperties = false;
 
+  m_visibleEntriesDirty = true;
+
   if (i_position >= 0 && (unsigned int)i_position < m_Entries.size()) {
     m_Entries.insert(m_Entries.begin() + i_position, p);
     return p;
   }
 
-  /* Make a temp. lowercase text */
-  std::string LCText = Text;
-  for (unsigned int i = 0; i < LCText.length(); i++)
-    LCText[i] = tolower(LCText[i]);
-
   /* Sorted? */
   if (m_bSort) {
-    /* Yeah, keep it alphabetical, please */
-    for (unsigned int i = 0; i < m_Entries.size(); i++) {
-      if (pvUser != NULL && m_Entries[i]->pvUser != NULL && m_fsort != NULL) {
-        if (m_fsort(pvUser, m_Entries[i]->pvUser) < 0) {
-          /* Here! */
-          m_Entries.insert(m_Entries.begin() + i, p);
-          return p;
-        }
-      } else {
-        /* Make lowercase before comparing */
-        std::string LC = m_Entries[i]->Text[0];
-        for (unsigned int j = 0; j < LC.length(); j++)
-          LC[j] = tolower(LC[j]);
-
-        if (LCText < LC) {
-          /* Here! */
-          m_Entries.insert(m_Entries.begin() + i, p);
-          return p;
-        }
-      }
-    }
+    /* Yeah, keep it alphabetical, please ; the entries are already sorted, so
+     * look for the place by dichotomy */
+    m_Entries.insert(std::upper_bound(m_Entries.begin(),
+                                      m_Entries.end(),
+                                      p,
+                                      UIListEntryCompare(m_fsort)),
+                     p);
+    return p;
   }
 
   /* Just add it to the end */
@@ -825,6 +850,7 @@ UIListEntry *UIList::addEntry(std::string Text, void *pvUser, int i_position) {
 
 void UIList::clear(void) {
   _FreeUIList();
+  m_filteredItems = 0;
   m_nRealSelected = 0;
   m_nVisibleSelected = 0;
   m_nScroll = 0;
@@ -844,6 +870,7 @@ void UIList::randomize() {
     m_Entries[n] = m_Entries[r];
     m_Entries[r] = v_tmp;
   }
+  m_visibleEntriesDirty = true;
 }
 
 /*===========================================================================
@@ -853,6 +880,34 @@ void UIList::_FreeUIList(void) {
   for (unsigned int i = 0; i < m_Entries.size(); i++)
     delete m_Entries[i];
   m_Entries.clear();
+  m_visibleEntriesDirty = true;
+}
+
+void UIList::updateVisibleEntries() {
+  /* the entries may have been changed through getEntries() */
+  if (m_visibleEntriesDirty == false &&
+      m_visibleEntries.size() == m_Entries.size() - m_filteredItems) {
+    return;
+  }
+
+  m_visibleEntries.clear();
+  m_visibleEntries.reserve(m_Entries.size() - m_filteredItems);
+  for (unsigned int i = 0; i < m_Entries.size(); i++) {
+    if (m_Entries[i]->bFiltered == false) {
+      m_visibleEntries.push_back(i);
+    }
+  }
+  m_visibleEntriesDirty = false;
+}
+
+void UIList::completeEntry(UIListEntry *i_entry) {
+}
+
+void UIList::completeEntryIfRequired(UIListEntry *i_entry) {
+  if (i_entry->bToComplete) {
+    completeEntry(i_entry);
+    i_entry->bToComplete = false;
+  }
 }
 
 /*===========================================================================
@@ -1123,12 +1178,11 @@ void UIList::setRealSelected(unsigned int n) {
         adaptRealSelectedOnVisibleEntries();
       }
 
-      m_nVisibleSelected = 0;
-      for (unsigned int i = 0; i < m_nRealSelected; i++) {
-        if (m_Entries[i]->bFiltered == false) {
-          m_nVisibleSelected++;
-        }
-      }
+      updateVisibleEntries();
+      m_nVisibleSelected = std::lower_bound(m_visibleEntries.begin(),
+                                            m_visibleEntries.end(),
+                                            m_nRealSelected) -
+                           m_visibleEntries.begin();
     }
   }
   _NewlySelectedItem();
@@ -1146,14 +1200,9 @@ void UIList::setVisibleSelected(unsigned int n) {
     m_nVisibleSelected = n;
     m_nRealSelected = 0;
 
-    unsigned int v = 0;
-    for (unsigned int i = 0; i < m_Entries.size(); i++) {
-      if (m_Entries[i]->bFiltered == false) {
-        if (v == n) {
-          m_nRealSelected = i;
-        }
-        v++;
-      }
+    updateVisibleEntries();
+    if (n < m_visibleEntries.size()) {
+      m_nRealSelected = m_visibleEntries[n];
     }
   }
   _NewlySelectedItem();
@@ -1216,6 +1265,7 @@ void UIList::setFilter(std::string i_filter) {
 
   for (unsigned int i = 0; i < m_Entries.size(); i++) {
     bool v_filter = true;
+    completeEntryIfRequired(m_Entries[i]);
     for (unsigned int j = 0; j < m_Entries[i]->Text.size(); j++) {
       v_entry_lower = m_Entries[i]->Text[j];
       for (unsigned int k = 0; k < v_entry_lower.length(); k++) {
@@ -1241,6 +1291,7 @@ void UIList::checkForFilteredEntries() {
       m_filteredItems++;
     }
   }
+  m_visibleEntriesDirty = true;
 
   /* repair the scroll bar */
   m_nScroll = 0;
@@ -47,7 +47,7 @@ UILevelList::~UILevelList() {
 std::string UILevelList::getLevel(int n) {
   if (getEntries().empty() == false) {
     UIListEntry *pEntry = getEntries()[n];
-    return *(reinterpret_cast<std::string *>(pEntry->pvUser));
+    return reinterpret_cast<LevelRow *>(pEntry->pvUser)->idLevel;
   }
   return "";
 }
@@ -69,10 +69,9 @@ void UILevelList::hideRoomBestTime() {
 }
 
 void UILevelList::clear() {
-  for (unsigned int i = 0; i < getEntries().size(); i++) {
-    delete ((std::string *)getEntries()[i]->pvUser);
-  }
   UIList::clear();
+  m_rows.clear();
+  m_levelsIndex.clear();
 }
 
 void UILevelList::addLevel(const std::string &i_id_level,
@@ -87,52 +86,96 @@ void UILevelList::addLevel(const std::string &i_id_level,
   else
     v_name = "???";
 
+  LevelRow v_row;
+  v_row.idLevel = i_id_level;
+  v_row.playerHighscore = i_playerHighscore;
+  v_row.roomHighscore = i_roomHighscore;
+  m_rows.push_back(v_row);
+
   UIListEntry *pEntry = NULL;
   pEntry = addEntry(i_prefix + v_name,
-                    reinterpret_cast<void *>(new std::string(i_id_level)));
+                    reinterpret_cast<void *>(&m_rows.back()));
 
-  /* Add times to list entry */
+  /* Add times to list entry, formatted once displayed */
   if (pEntry != NULL) {
-    if (i_playerHighscore < 0) {
-      pEntry->Text.push_back(GAMETEXT_HIGHSCORE_NONE);
-    } else {
-      pEntry->Text.push_back(formatTime(i_playerHighscore));
-    }
+    pEntry->Text.push_back("");
+    pEntry->Text.push_back("");
+    pEntry->bToComplete = true;
+  }
+}
 
-    if (i_roomHighscore < 0) {
-      pEntry->Text.push_back(GAMETEXT_HIGHSCORE_NONE);
-    } else {
-      pEntry->Text.push_back(formatTime(i_roomHighscore));
-    }
+void UILevelList::completeEntry(UIListEntry *i_entry) {
+  LevelRow *v_row = reinterpret_cast<LevelRow *>(i_entry->pvUser);
+
+  if (v_row->playerHighscore < 0) {
+    i_entry->Text[1] = GAMETEXT_HIGHSCORE_NONE;
+  } else {
+    i_entry->Text[1] = formatTime(v_row->playerHighscore);
+  }
+
+  if (v_row->roomHighscore < 0) {
+    i_entry->Text[2] = GAMETEXT_HIGHSCORE_NONE;
+  } else {
+    i_entry->Text[2] = formatTime(v_row->roomHighscore);
   }
 }
 
+int UILevelList::levelIndex(const std::string &i_id_level) {
+  HashNamespace::unordered_map<std::string, unsigned int>::const_iterator it;
+
+  it = m_levelsIndex.find(i_id_level);
+  if (it != m_levelsIndex.end() && it->second < getEntries().size() &&
+      getLevel(it->second) == i_id_level) {
+    return it->second;
+  }
+
+  /* not indexed yet, or the list has been reordered */
+  m_levelsIndex.clear();
+  for (unsigned int i = 0; i < getEntries().size(); i++) {
+    m_levelsIndex.insert(std::make_pair(getLevel(i), i)); // keep the first one
+  }
+
+  it = m_levelsIndex.find(i_id_level);
+  if (it == m_levelsIndex.end()) {
+    return -1;
+  }
+  return it->second;
+}
+
 void UILevelList::updateLevel(const std::string &i_id_level,
                               int i_playerHighscore) {
-  for (unsigned int i = 0; i < getEntries().size(); i++) {
-    if (*(reinterpret_cast<std::string *>(getEntries()[i]->pvUser)) ==
-        i_id_level) {
-      getEntries()[i]->Text[1] = formatTime(i_playerHighscore);
-    }
+  int n = levelIndex(i_id_level);
+
+  if (n >= 0) {
+    UIListEntry *pEntry = getEntries()[n];
+    reinterpret_cast<LevelRow *>(pEntry->pvUser)->playerHighscore =
+      i_playerHighscore;
+    pEntry->bToComplete = true;
   }
 }
 
 std::string UILevelList::determineNextLevel(const std::string &i_id_level) {
-  for (unsigned int i = 0; i < getEntries().size() - 1; i++) {
-    if ((*((std::string *)getEntries()[i]->pvUser)) == i_id_level) {
-      return *((std::string *)getEntries()[i + 1]->pvUser);
-    }
+  if (getEntries().empty()) {
+    return "";
+  }
+
+  int n = levelIndex(i_id_level);
+  if (n >= 0 && (unsigned int)n + 1 < getEntries().size()) {
+    return getLevel(n + 1);
   }
-  return *((std::string *)getEntries()[0]->pvUser);
+  return getLevel(0);
 }
 
 std::string UILevelList::determinePreviousLevel(const std::string &i_id_level) {
-  for (unsigned int i = 1; i < getEntries().size(); i++) {
-    if ((*((std::string *)getEntries()[i]->pvUser)) == i_id_level) {
-      return *((std::string *)getEntries()[i - 1]->pvUser);
-    }
+  if (getEntries().empty()) {
+    return "";
+  }
+
+  int n = levelIndex(i_id_level);
+  if (n > 0) {
+    return getLevel(n - 1);
   }
-  return *((std::string *)getEntries()[getEntries().size() - 1]->pvUser);
+  return getLevel(getEntries().size() - 1);
 }
 
 UIPackTree::UIPackTree(UIWindow *pParent,
@@ -23,7 +23,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "../basic/GUI.h"
 #include "helpers/VMath.h"
+#include "include/xm_hashmap.h"
 #include "xmoto/VirtualLevelsList.h"
+#include <deque>
 
 class LevelsPack;
 
@@ -55,7 +57,24 @@ public:
   void hideBestTime();
   void hideRoomBestTime();
 
+protected:
+  /* the times are formatted only for the displayed levels */
+  virtual void completeEntry(UIListEntry *i_entry);
+
 private:
+  struct LevelRow {
+    std::string idLevel;
+    int playerHighscore;
+    int roomHighscore;
+  };
+
+  /* a deque to keep the rows in place : the entries point on them */
+  std::deque<LevelRow> m_rows;
+
+  /* position of the levels in the entries ; checked on use and rebuilt if the
+   * list has been reordered */
+  HashNamespace::unordered_map<std::string, unsigned int> m_levelsIndex;
+  int levelIndex(const std::string &i_id_level); // -1 if not found
 };
 
 class UIPackTree : public UIList {
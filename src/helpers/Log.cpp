@@ -21,20 +21,92 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Log.h"
 #include "VExcept.h"
 #include "common/VFileIO.h"
+#include "include/xm_SDL.h"
 
 #include <cassert>
 #include <cstdio>
+#include <signal.h>
 #include <stdarg.h>
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define LOG_QUEUE_SIZE 4096 // lines, a power of 2
+#define LOG_WRITER_PERIOD 50 // ms between two writes of the queued lines
 
 bool Logger::m_isInitialized = false;
 bool Logger::m_activ = true;
 bool Logger::m_verbose = false;
 FILE *Logger::m_fd = NULL;
+unsigned int Logger::m_samplingRate = 1;
 std::string Logger::m_logName;
 
 const int RETENTION_COUNT = 9;
 const std::string LOG_NAME = "xmoto.log";
 
+/*
+  bounded queue without lock for several producers : a line can be filled
+  once its sequence is equal to the enqueue position, and read once it is
+  equal to the dequeue position + 1. Only one thread reads at a time (under
+  g_writeMutex).
+*/
+struct LogQueueLine {
+  SDL_atomic_t seq;
+  std::string text;
+  bool verbose;
+};
+
+static LogQueueLine g_logQueue[LOG_QUEUE_SIZE];
+static SDL_atomic_t g_logEnqueuePos;
+static unsigned int g_logDequeuePos = 0;
+static SDL_atomic_t g_logNbLost;
+static SDL_atomic_t g_logSamplingCounter;
+static SDL_atomic_t g_logStopWriter;
+static SDL_mutex *g_writeMutex = NULL;
+static SDL_sem *g_writerSem = NULL;
+static SDL_Thread *g_writerThread = NULL;
+static int g_logFileNo = -1; // for the crash handler, which can't use stdio
+
+static bool logQueuePush(const std::string &s, bool i_verbose) {
+  LogQueueLine *v_line;
+  unsigned int v_pos = SDL_AtomicGet(&g_logEnqueuePos);
+
+  while (true) {
+    v_line = &g_logQueue[v_pos & (LOG_QUEUE_SIZE - 1)];
+    int v_diff = (int)((unsigned int)SDL_AtomicGet(&v_line->seq) - v_pos);
+
+    if (v_diff == 0) {
+      if (SDL_AtomicCAS(&g_logEnqueuePos, v_pos, v_pos + 1)) {
+        break;
+      }
+    } else if (v_diff < 0) {
+      return false; // full
+    }
+    v_pos = SDL_AtomicGet(&g_logEnqueuePos);
+  }
+
+  v_line->text = s;
+  v_line->verbose = i_verbose;
+  SDL_AtomicSet(&v_line->seq, v_pos + 1);
+  return true;
+}
+
+static bool logQueuePop(std::string &o_text, bool &o_verbose) {
+  LogQueueLine *v_line = &g_logQueue[g_logDequeuePos & (LOG_QUEUE_SIZE - 1)];
+
+  if ((unsigned int)SDL_AtomicGet(&v_line->seq) != g_logDequeuePos + 1) {
+    return false; // empty
+  }
+
+  o_text.swap(v_line->text);
+  o_verbose = v_line->verbose;
+  SDL_AtomicSet(&v_line->seq, g_logDequeuePos + LOG_QUEUE_SIZE);
+  g_logDequeuePos++;
+  return true;
+}
+
 void Logger::init() {
   assert(XMFS::isInitialized());
 
@@ -61,12 +133,58 @@ void Logger::init() {
   if (!m_fd) {
     throw Exception("Unable to open log file");
   }
+  g_logFileNo = fileno(m_fd);
+
+  for (unsigned int i = 0; i < LOG_QUEUE_SIZE; i++) {
+    SDL_AtomicSet(&g_logQueue[i].seq, i);
+  }
+  SDL_AtomicSet(&g_logEnqueuePos, 0);
+  g_logDequeuePos = 0;
+  SDL_AtomicSet(&g_logNbLost, 0);
+  SDL_AtomicSet(&g_logStopWriter, 0);
+
+  g_writeMutex = SDL_CreateMutex();
+  g_writerSem = SDL_CreateSemaphore(0);
+  if (g_writeMutex != NULL && g_writerSem != NULL) {
+    g_writerThread = SDL_CreateThread(&Logger::writerThread, "LogWriter", NULL);
+  }
+  /* without writer, the lines are written by the logging threads */
+
+  /* write the queued lines on a crash */
+  signal(SIGSEGV, Logger::crashHandler);
+  signal(SIGABRT, Logger::crashHandler);
+  signal(SIGFPE, Logger::crashHandler);
+  signal(SIGILL, Logger::crashHandler);
 
   m_isInitialized = true;
 }
 
 void Logger::uninit() {
+  if (g_writerThread != NULL) {
+    SDL_AtomicSet(&g_logStopWriter, 1);
+    SDL_SemPost(g_writerSem);
+    SDL_WaitThread(g_writerThread, NULL);
+    g_writerThread = NULL;
+  }
+  flush();
+
+  signal(SIGSEGV, SIG_DFL);
+  signal(SIGABRT, SIG_DFL);
+  signal(SIGFPE, SIG_DFL);
+  signal(SIGILL, SIG_DFL);
+
+  if (g_writerSem != NULL) {
+    SDL_DestroySemaphore(g_writerSem);
+    g_writerSem = NULL;
+  }
+  if (g_writeMutex != NULL) {
+    SDL_DestroyMutex(g_writeMutex);
+    g_writeMutex = NULL;
+  }
+
+  g_logFileNo = -1;
   fclose(m_fd);
+  m_fd = NULL;
   m_isInitialized = false;
 }
 
@@ -86,20 +204,135 @@ void Logger::setActiv(bool i_value) {
   m_activ = i_value;
 }
 
-void Logger::LogRaw(const std::string &s) {
+void Logger::setSampling(unsigned int i_rate) {
+  m_samplingRate = i_rate < 1 ? 1 : i_rate;
+}
+
+void Logger::LogRaw(LogLevel i_level, const std::string &s) {
   if (m_activ == false) {
     return;
   }
 
-  fprintf(m_fd, "%s\n", s.c_str());
-  fflush(m_fd);
+  if (m_samplingRate > 1 && i_level >= LOG_INFO) {
+    if (SDL_AtomicAdd(&g_logSamplingCounter, 1) % m_samplingRate != 0) {
+      return;
+    }
+  }
+
+  queueLine(i_level, s, m_verbose);
+}
+
+void Logger::queueLine(LogLevel i_level, const std::string &s, bool i_verbose) {
+  if (g_writerThread == NULL) {
+    if (m_fd != NULL) {
+      fprintf(m_fd, "%s\n", s.c_str());
+      fflush(m_fd);
+    }
+
+    if (i_verbose) {
+      printf("%s\n", s.c_str());
+      fflush(stdout);
+    }
+    return;
+  }
+
+  while (logQueuePush(s, i_verbose) == false) {
+    /* the queue is full : only errors and warnings wait for the writer */
+    if (i_level > LOG_WARNING) {
+      SDL_AtomicIncRef(&g_logNbLost);
+      return;
+    }
+    SDL_SemPost(g_writerSem);
+    SDL_Delay(1);
+  }
 
-  if (m_verbose) {
-    printf("%s\n", s.c_str());
+  if (i_level == LOG_ERROR) {
+    SDL_SemPost(g_writerSem);
+  }
+}
+
+void Logger::writeLines() {
+  std::string v_text;
+  bool v_verbose;
+  bool v_stdout = false;
+  int v_nbLost;
+
+  while (logQueuePop(v_text, v_verbose)) {
+    fprintf(m_fd, "%s\n", v_text.c_str());
+
+    if (v_verbose) {
+      printf("%s\n", v_text.c_str());
+      v_stdout = true;
+    }
+  }
+
+  v_nbLost = SDL_AtomicSet(&g_logNbLost, 0);
+  if (v_nbLost > 0) {
+    fprintf(m_fd, "** Warning ** : %i log lines lost\n", v_nbLost);
+  }
+
+  fflush(m_fd);
+  if (v_stdout) {
     fflush(stdout);
   }
 }
 
+int Logger::writerThread(void *i_data) {
+  while (SDL_AtomicGet(&g_logStopWriter) == 0) {
+    SDL_SemWaitTimeout(g_writerSem, LOG_WRITER_PERIOD);
+
+    SDL_LockMutex(g_writeMutex);
+    writeLines();
+    SDL_UnlockMutex(g_writeMutex);
+  }
+
+  return 0;
+}
+
+void Logger::flush() {
+  if (g_writeMutex == NULL) {
+    return;
+  }
+
+  SDL_LockMutex(g_writeMutex);
+  writeLines();
+  SDL_UnlockMutex(g_writeMutex);
+}
+
+void Logger::crashHandler(int i_signal) {
+  static const char v_msg[] = "** Error ** : crash\n";
+  LogQueueLine *v_line;
+  unsigned int v_end;
+
+  signal(i_signal, SIG_DFL);
+
+  /* stdio and malloc can't be used in a signal handler (the crash may be
+     inside them) ; the queued lines are written as they are with write(2),
+     which is safe */
+  if (g_logFileNo != -1) {
+    v_end = SDL_AtomicGet(&g_logEnqueuePos);
+    for (unsigned int i = g_logDequeuePos; i != v_end; i++) {
+      v_line = &g_logQueue[i & (LOG_QUEUE_SIZE - 1)];
+
+      /* line not filled yet */
+      if ((unsigned int)SDL_AtomicGet(&v_line->seq) != i + 1) {
+        continue;
+      }
+
+      if (write(g_logFileNo, v_line->text.c_str(), v_line->text.size()) < 0 ||
+          write(g_logFileNo, "\n", 1) < 0) {
+        break;
+      }
+    }
+
+    if (write(g_logFileNo, v_msg, sizeof(v_msg) - 1) < 0) {
+      /* nothing more can be done */
+    }
+  }
+
+  raise(i_signal);
+}
+
 void Logger::LogLevelMsg(LogLevel i_level, const char *pcFmt, ...) {
   va_list List;
   char cBuf[4096];
@@ -109,16 +342,16 @@ void Logger::LogLevelMsg(LogLevel i_level, const char *pcFmt, ...) {
 
   switch (i_level) {
     case LOG_ERROR:
-      LogRaw(std::string("** Error ** : ") + cBuf);
+      LogRaw(i_level, std::string("** Error ** : ") + cBuf);
       break;
     case LOG_WARNING:
-      LogRaw(std::string("** Warning ** : ") + cBuf);
+      LogRaw(i_level, std::string("** Warning ** : ") + cBuf);
       break;
     case LOG_INFO:
-      LogRaw(cBuf);
+      LogRaw(i_level, cBuf);
       break;
     case LOG_DEBUG:
-      LogRaw(std::string("** Debug ** : ") + cBuf);
+      LogRaw(i_level, std::string("** Debug ** : ") + cBuf);
       break;
   }
 }
@@ -128,10 +361,12 @@ void Logger::LogData(void *data, unsigned int len) {
     return;
   }
 
-  fprintf(m_fd, "=== Packet [%u]: ===\n", len);
-  fflush(m_fd);
-  fwrite(data, len, 1, m_fd);
-  fprintf(m_fd, "====================\n");
+  char v_header[64];
+  snprintf(v_header, 64, "=== Packet [%u]: ===\n", len);
+
+  queueLine(LOG_DEBUG,
+            v_header + std::string((char *)data, len) + "====================",
+            false);
 }
 
 void Logger::deleteLegacyLog() {
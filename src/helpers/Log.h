@@ -51,6 +51,13 @@ public:
   static void LogLevelMsg(LogLevel i_level, const char *pcFmt, ...);
   static void LogData(void *data, unsigned int len);
 
+  /* keep only 1 info or debug line out of i_rate ; errors and warnings are
+   * always kept */
+  static void setSampling(unsigned int i_rate);
+
+  /* write the lines still waiting for the writer thread */
+  static void flush();
+
   static void deleteLegacyLog();
 
 private:
@@ -58,10 +65,17 @@ private:
   static bool m_verbose;
   static bool m_activ;
   static FILE *m_fd;
+  static unsigned int m_samplingRate;
 
   static std::string m_logName;
 
-  static void LogRaw(const std::string &s);
+  /* the lines are queued by the logging threads and written to the file by a
+   * writer thread, so that logging doesn't wait for the disk */
+  static void LogRaw(LogLevel i_level, const std::string &s);
+  static void queueLine(LogLevel i_level, const std::string &s, bool i_verbose);
+  static void writeLines();
+  static int writerThread(void *i_data);
+  static void crashHandler(int i_signal);
 };
 
 #endif
@@ -0,0 +1,144 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "ParallelReader.h"
+#include "include/xm_SDL.h"
+
+ParallelReader::ParallelReader(unsigned int i_nbItems,
+                               const std::string &i_threadName) {
+  m_nbItems = i_nbItems;
+  m_threadName = i_threadName;
+  m_done.resize(m_nbItems, false);
+  m_next = 0;
+  m_nextToTake = 0;
+  m_window = XM_PARALLELREADER_WINDOW;
+  m_abort = false;
+
+  m_mutex = SDL_CreateMutex();
+  m_doneCond = SDL_CreateCond();
+  m_windowCond = SDL_CreateCond();
+}
+
+ParallelReader::~ParallelReader() {
+  stopThreads();
+
+  SDL_DestroyCond(m_windowCond);
+  SDL_DestroyCond(m_doneCond);
+  SDL_DestroyMutex(m_mutex);
+}
+
+void ParallelReader::startThreads() {
+  unsigned int v_nbThreads;
+
+  v_nbThreads = SDL_GetCPUCount();
+  if (v_nbThreads > XM_PARALLELREADER_MAX_THREADS) {
+    v_nbThreads = XM_PARALLELREADER_MAX_THREADS;
+  }
+  if (v_nbThreads > m_nbItems) {
+    v_nbThreads = m_nbItems;
+  }
+  if (v_nbThreads > 0) {
+    m_window = XM_PARALLELREADER_WINDOW * v_nbThreads;
+  }
+
+  for (unsigned int i = 0; i < v_nbThreads; i++) {
+    SDL_Thread *v_thread =
+      SDL_CreateThread(&ParallelReader::run, m_threadName.c_str(), this);
+    if (v_thread == NULL) {
+      break; // waitItem() reads the items which are not taken by a thread
+    }
+    m_threads.push_back(v_thread);
+  }
+}
+
+void ParallelReader::stopThreads() {
+  // stop the threads after their current item
+  SDL_LockMutex(m_mutex);
+  m_abort = true;
+  SDL_CondBroadcast(m_windowCond);
+  SDL_UnlockMutex(m_mutex);
+
+  for (unsigned int i = 0; i < m_threads.size(); i++) {
+    SDL_WaitThread(m_threads[i], NULL);
+  }
+  m_threads.clear();
+}
+
+int ParallelReader::run(void *i_reader) {
+  ((ParallelReader *)i_reader)->work();
+  return 0;
+}
+
+void ParallelReader::work() {
+  unsigned int v_item;
+
+  SDL_LockMutex(m_mutex);
+
+  while (true) {
+    // wait for the caller to take the items already read
+    while (m_abort == false && m_next < m_nbItems &&
+           m_next >= m_nextToTake + m_window) {
+      SDL_CondWait(m_windowCond, m_mutex);
+    }
+
+    if (m_abort || m_next >= m_nbItems) {
+      SDL_UnlockMutex(m_mutex);
+      return;
+    }
+    v_item = m_next++;
+    SDL_UnlockMutex(m_mutex);
+
+    readItem(v_item);
+
+    SDL_LockMutex(m_mutex);
+    m_done[v_item] = true;
+    SDL_CondBroadcast(m_doneCond);
+  }
+}
+
+void ParallelReader::waitItem(unsigned int i) {
+  SDL_LockMutex(m_mutex);
+
+  // no thread, or all the threads failed : read it here
+  if (m_threads.size() == 0 && i >= m_next) {
+    m_next = i + 1;
+    SDL_UnlockMutex(m_mutex);
+
+    readItem(i);
+    return;
+  }
+
+  // the items before i are not wanted anymore
+  if (i > m_nextToTake) {
+    m_nextToTake = i;
+    SDL_CondBroadcast(m_windowCond);
+  }
+
+  while (m_done[i] == false) {
+    SDL_CondWait(m_doneCond, m_mutex);
+  }
+
+  if (i + 1 > m_nextToTake) {
+    m_nextToTake = i + 1;
+    SDL_CondBroadcast(m_windowCond);
+  }
+
+  SDL_UnlockMutex(m_mutex);
+}
@@ -0,0 +1,77 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __PARALLELREADER_H__
+#define __PARALLELREADER_H__
+
+#include <string>
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+#define XM_PARALLELREADER_MAX_THREADS 8
+#define XM_PARALLELREADER_WINDOW 4 // items read in advance per thread
+
+/**
+ * read the items of a list with several threads, the caller taking them in
+ * the order of the list (to stay the only one writing into the database for
+ * example). The threads don't read more than a few items in advance of the
+ * caller.
+ */
+class ParallelReader {
+public:
+  ParallelReader(unsigned int i_nbItems, const std::string &i_threadName);
+  virtual ~ParallelReader();
+
+protected:
+  /* to call at the end of the constructor of the child class */
+  void startThreads();
+  /* to call at the start of the destructor of the child class, before the
+     items are freed */
+  void stopThreads();
+
+  /* wait for the item i to be read. Call it in the order of the list */
+  void waitItem(unsigned int i);
+
+  /* read the item i and keep it ; called once per item, from any thread */
+  virtual void readItem(unsigned int i) = 0;
+
+private:
+  unsigned int m_nbItems;
+  std::string m_threadName;
+
+  std::vector<bool> m_done;
+  unsigned int m_next; // next item to read
+  unsigned int m_nextToTake; // first item not taken by the caller
+  unsigned int m_window; // items read in advance of m_nextToTake
+  bool m_abort;
+
+  SDL_mutex *m_mutex;
+  SDL_cond *m_doneCond;
+  SDL_cond *m_windowCond;
+  std::vector<SDL_Thread *> m_threads;
+
+  static int run(void *i_reader);
+  void work();
+};
+
+#endif
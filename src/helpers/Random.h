@@ -34,6 +34,13 @@ public:
     }
   }
 
+  /* the cursor can be saved and restored so that a sequence doesn't depend
+     on the thread using it */
+  static unsigned int cursor() { return m_current; }
+  static void setCursor(unsigned int i_cursor) {
+    m_current = i_cursor & (NB_RANDOM - 1);
+  }
+
   static inline float randomNum(float min, float max) {
     m_current = (m_current + 1) & (NB_RANDOM - 1);
     return min + (max - min) * m_random[m_current];
@@ -42,7 +49,7 @@ public:
 private:
   // random numbers in [0, 1]
   static float m_random[NB_RANDOM];
-  static unsigned int m_current;
+  static thread_local unsigned int m_current; // one cursor per thread
 };
 
 #endif
@@ -0,0 +1,164 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "WorkersPool.h"
+#include "VExcept.h"
+#include "include/xm_SDL.h"
+#include <exception>
+
+WorkersPool::WorkersPool() {
+  m_jobs = NULL;
+  m_next = 0;
+  m_nbDone = 0;
+  m_failed = false;
+  m_abort = false;
+  m_threadsStarted = false;
+
+  m_mutex = SDL_CreateMutex();
+  m_workCond = SDL_CreateCond();
+  m_doneCond = SDL_CreateCond();
+}
+
+WorkersPool::~WorkersPool() {
+  SDL_LockMutex(m_mutex);
+  m_abort = true;
+  SDL_CondBroadcast(m_workCond);
+  SDL_UnlockMutex(m_mutex);
+
+  for (unsigned int i = 0; i < m_threads.size(); i++) {
+    SDL_WaitThread(m_threads[i], NULL);
+  }
+
+  SDL_DestroyCond(m_doneCond);
+  SDL_DestroyCond(m_workCond);
+  SDL_DestroyMutex(m_mutex);
+}
+
+void WorkersPool::startThreads() {
+  int v_nbThreads;
+
+  m_threadsStarted = true;
+
+  // the calling thread is one of the workers
+  v_nbThreads = SDL_GetCPUCount() - 1;
+  if (v_nbThreads > XM_WORKERSPOOL_MAX_THREADS) {
+    v_nbThreads = XM_WORKERSPOOL_MAX_THREADS;
+  }
+
+  for (int i = 0; i < v_nbThreads; i++) {
+    SDL_Thread *v_thread =
+      SDL_CreateThread(&WorkersPool::runThread, "WorkersPool", this);
+    if (v_thread == NULL) {
+      break; // run() does the jobs which are not taken by a thread
+    }
+    m_threads.push_back(v_thread);
+  }
+}
+
+int WorkersPool::runThread(void *i_pool) {
+  ((WorkersPool *)i_pool)->work();
+  return 0;
+}
+
+void WorkersPool::work() {
+  SDL_LockMutex(m_mutex);
+
+  while (true) {
+    while (m_abort == false && (m_jobs == NULL || m_next >= m_jobs->size())) {
+      SDL_CondWait(m_workCond, m_mutex);
+    }
+
+    if (m_abort) {
+      SDL_UnlockMutex(m_mutex);
+      return;
+    }
+
+    runJob((*m_jobs)[m_next++]);
+  }
+}
+
+void WorkersPool::runJob(WorkersPoolJob *i_job) {
+  bool v_failed = false;
+  std::string v_error;
+
+  SDL_UnlockMutex(m_mutex);
+  try {
+    i_job->run();
+  } catch (Exception &e) {
+    v_failed = true;
+    v_error = e.getMsg();
+  } catch (std::exception &e) {
+    v_failed = true;
+    v_error = e.what();
+  } catch (...) {
+    /* nothing may leave a worker thread ; reported by run() */
+    v_failed = true;
+    v_error = "unknown error in a job";
+  }
+  SDL_LockMutex(m_mutex);
+
+  if (v_failed && m_failed == false) {
+    m_failed = true;
+    m_error = v_error;
+  }
+
+  m_nbDone++;
+  if (m_nbDone == m_jobs->size()) {
+    SDL_CondBroadcast(m_doneCond);
+  }
+}
+
+void WorkersPool::run(const std::vector<WorkersPoolJob *> &i_jobs) {
+  bool v_failed;
+  std::string v_error;
+
+  if (i_jobs.size() == 0) {
+    return;
+  }
+
+  if (m_threadsStarted == false) {
+    startThreads();
+  }
+
+  SDL_LockMutex(m_mutex);
+  m_jobs = &i_jobs;
+  m_next = 0;
+  m_nbDone = 0;
+  m_failed = false;
+  m_error = "";
+  SDL_CondBroadcast(m_workCond);
+
+  while (m_next < i_jobs.size()) {
+    runJob(i_jobs[m_next++]);
+  }
+
+  while (m_nbDone < i_jobs.size()) {
+    SDL_CondWait(m_doneCond, m_mutex);
+  }
+
+  m_jobs = NULL;
+  v_failed = m_failed;
+  v_error = m_error;
+  SDL_UnlockMutex(m_mutex);
+
+  if (v_failed) {
+    throw Exception(v_error);
+  }
+}
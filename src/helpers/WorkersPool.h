@@ -0,0 +1,79 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __WORKERSPOOL_H__
+#define __WORKERSPOOL_H__
+
+#include <string>
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_cond;
+
+#define XM_WORKERSPOOL_MAX_THREADS 8
+
+class WorkersPoolJob {
+public:
+  virtual ~WorkersPoolJob() {}
+
+  /* called from any thread of the pool ; errors are thrown again by
+     WorkersPool::run() as an Exception */
+  virtual void run() = 0;
+};
+
+/**
+ * run batches of independent jobs on threads kept alive between the batches,
+ * so that small jobs done at each frame (like the physics step of a scene)
+ * don't pay the creation of the threads. The calling thread runs jobs too.
+ */
+class WorkersPool {
+public:
+  WorkersPool();
+  ~WorkersPool();
+
+  /* run the jobs and return once they are all done ; if some of them failed,
+     the error of the first one is thrown once all the jobs are done */
+  void run(const std::vector<WorkersPoolJob *> &i_jobs);
+
+private:
+  const std::vector<WorkersPoolJob *> *m_jobs; // NULL between the batches
+  unsigned int m_next; // next job to run
+  unsigned int m_nbDone;
+  bool m_failed;
+  std::string m_error;
+  bool m_abort;
+  bool m_threadsStarted;
+
+  SDL_mutex *m_mutex;
+  SDL_cond *m_workCond;
+  SDL_cond *m_doneCond;
+  std::vector<SDL_Thread *> m_threads;
+
+  void startThreads();
+  static int runThread(void *i_pool);
+  void work();
+
+  /* run the job and count it as done ; m_mutex is locked by the caller, and
+     released while the job runs */
+  void runJob(WorkersPoolJob *i_job);
+};
+
+#endif
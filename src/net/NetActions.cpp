@@ -20,6 +20,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "NetActions.h"
 #include "NetClient.h"
+#include "NetFramesHistory.h"
 #include "common/DBuffer.h"
 #include "common/XMBuild.h"
 #include "common/XMSession.h"
@@ -30,6 +31,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "helpers/Text.h"
 #include "helpers/VExcept.h"
 #include "helpers/utf8.h"
+#include "thread/ServerEpoll.h"
 #include <sstream>
 
 char NetAction::m_buffer[NETACTION_MAX_PACKET_SIZE];
@@ -39,11 +41,14 @@ unsigned int NetAction::m_nbTCPPacketsSent = 0;
 unsigned int NetAction::m_nbUDPPacketsSent = 0;
 unsigned int NetAction::m_TCPPacketsSizeSent = 0;
 unsigned int NetAction::m_UDPPacketsSizeSent = 0;
+ServerEpoll *NetAction::m_udpQueue = NULL;
 
 std::string NA_chatMessage::ActionKey = "message";
 std::string NA_chatMessagePP::ActionKey = "messagePP";
 // frame : while it's sent a lot, reduce it at maximum
 std::string NA_frame::ActionKey = "f";
+std::string NA_frames::ActionKey = "F";
+std::string NA_framesAck::ActionKey = "Fa";
 std::string NA_clientInfos::ActionKey = "clientInfos";
 std::string NA_udpBind::ActionKey = "udpbind";
 std::string NA_udpBindQuery::ActionKey = "udpbindingQuery";
@@ -70,6 +75,8 @@ std::string NA_ping::ActionKey = "ping";
 NetActionType NA_chatMessage::NAType = TNA_chatMessage;
 NetActionType NA_chatMessagePP::NAType = TNA_chatMessagePP;
 NetActionType NA_frame::NAType = TNA_frame;
+NetActionType NA_frames::NAType = TNA_frames;
+NetActionType NA_framesAck::NAType = TNA_framesAck;
 NetActionType NA_clientInfos::NAType = TNA_clientInfos;
 NetActionType NA_udpBind::NAType = TNA_udpBind;
 NetActionType NA_udpBindQuery::NAType = TNA_udpBindQuery;
@@ -99,6 +106,10 @@ NetAction::NetAction(bool i_forceTcp) {
 
 NetAction::~NetAction() {}
 
+void NetAction::setUdpQueue(ServerEpoll *i_udpQueue) {
+  m_udpQueue = i_udpQueue;
+}
+
 /* log version */
 void NetAction::logStats() {
   LogInfo("%-36s : %u",
@@ -170,7 +181,17 @@ void NetAction::send(TCPsocket *i_tcpsd,
       memcpy(i_sendPacket->data, m_buffer, v_totalPacketSize);
 
       i_sendPacket->address = *i_udpRemoteIP;
-      if (SDLNet_UDP_Send(*i_udpsd, -1, i_sendPacket) == 0) {
+#if HAVE_EPOLL
+      bool v_queued =
+        m_udpQueue != NULL && m_udpQueue->udpSocket() == *i_udpsd;
+      if (v_queued) {
+        m_udpQueue->queueUdp(i_sendPacket);
+      }
+#else
+      bool v_queued = false;
+#endif
+      if (v_queued == false &&
+          SDLNet_UDP_Send(*i_udpsd, -1, i_sendPacket) == 0) {
         LogWarning("SDLNet_UDP_Send failed : %s", SDLNet_GetError());
       }
 
@@ -242,6 +263,18 @@ void NetAction::getNetAction(NetActionU *o_netAction,
     o_netAction->master = &(o_netAction->frame);
   }
 
+  else if (v_cmd == NA_frames::ActionKey) {
+    o_netAction->frames =
+      NA_frames(((char *)data) + v_totalOffset, len - v_totalOffset);
+    o_netAction->master = &(o_netAction->frames);
+  }
+
+  else if (v_cmd == NA_framesAck::ActionKey) {
+    o_netAction->framesAck =
+      NA_framesAck(((char *)data) + v_totalOffset, len - v_totalOffset);
+    o_netAction->master = &(o_netAction->framesAck);
+  }
+
   else if (v_cmd == NA_playerControl::ActionKey) {
     o_netAction->playerControl =
       NA_playerControl(((char *)data) + v_totalOffset, len - v_totalOffset);
@@ -629,6 +662,198 @@ SerializedBikeState *NA_frame::getState() {
   return &m_state;
 }
 
+NA_frames::NA_frames(unsigned int i_seq)
+  : NetAction(false) {
+  m_seq = i_seq;
+  SDLNet_Write32(m_seq, m_buffer);
+  m_bufferLength = 4;
+}
+
+NA_frames::NA_frames(void *data, unsigned int len)
+  : NetAction(false) {
+  unsigned int v_offset;
+  unsigned int v_nbBytes;
+
+  // -1 because in the protocol, you always finish by a \n
+  if (len < 1 + 4 || len - 1 > XM_NET_FRAMES_MAX_SIZE) {
+    throw Exception("Invalid NA_frames");
+  }
+  m_bufferLength = len - 1;
+  memcpy(m_buffer, data, m_bufferLength);
+  m_seq = SDLNet_Read32(m_buffer);
+
+  // check the frames and keep their offsets
+  v_offset = 4;
+  while (v_offset < m_bufferLength) {
+    if (v_offset + 4 + 1 + XM_NET_FRAME_MASK_SIZE > m_bufferLength) {
+      throw Exception("Invalid NA_frames");
+    }
+    m_framesOffsets.push_back(v_offset);
+
+    v_nbBytes = 0;
+    for (unsigned int i = 0; i < XM_NET_FRAME_MASK_SIZE; i++) {
+      for (unsigned int j = 0; j < 8; j++) {
+        if (m_buffer[v_offset + 4 + 1 + i] & (1 << j)) {
+          v_nbBytes++;
+        }
+      }
+    }
+    if (v_nbBytes > sizeof(SerializedBikeState)) {
+      throw Exception("Invalid NA_frames");
+    }
+
+    v_offset += 4 + 1 + XM_NET_FRAME_MASK_SIZE + v_nbBytes;
+  }
+
+  if (v_offset != m_bufferLength) {
+    throw Exception("Invalid NA_frames");
+  }
+}
+
+NA_frames::~NA_frames() {}
+
+void NA_frames::send(TCPsocket *i_tcpsd,
+                     UDPsocket *i_udpsd,
+                     UDPpacket *i_sendPacket,
+                     IPaddress *i_udpRemoteIP) {
+  if (i_udpsd != NULL) {
+    // if udp is available, prefer udp
+    NetAction::send(
+      NULL, i_udpsd, i_sendPacket, i_udpRemoteIP, m_buffer, m_bufferLength);
+  } else {
+    NetAction::send(
+      i_tcpsd, i_udpsd, i_sendPacket, i_udpRemoteIP, m_buffer, m_bufferLength);
+  }
+}
+
+unsigned int NA_frames::seq() const {
+  return m_seq;
+}
+
+unsigned int NA_frames::nbFrames() const {
+  return m_framesOffsets.size();
+}
+
+bool NA_frames::isFull() const {
+  return m_bufferLength + XM_NET_FRAME_MAX_ENCODED_SIZE >
+         XM_NET_FRAMES_MAX_SIZE;
+}
+
+void NA_frames::add(int i_netId,
+                    const SerializedBikeState *i_state,
+                    const SerializedBikeState *i_base,
+                    unsigned int i_baseSeq) {
+  SerializedBikeState v_zero;
+  const unsigned char *v_new = (const unsigned char *)i_state;
+  const unsigned char *v_base;
+  unsigned char *v_mask;
+  unsigned char v_xor;
+
+  if (isFull()) {
+    throw Exception("NA_frames: too many frames");
+  }
+
+  if (i_base == NULL) {
+    memset(&v_zero, 0, sizeof(SerializedBikeState));
+    v_base = (const unsigned char *)&v_zero;
+  } else {
+    if (m_seq - i_baseSeq == 0 || m_seq - i_baseSeq > 255) {
+      throw Exception("NA_frames: invalid base");
+    }
+    v_base = (const unsigned char *)i_base;
+  }
+
+  m_framesOffsets.push_back(m_bufferLength);
+
+  SDLNet_Write32((Uint32)i_netId, m_buffer + m_bufferLength);
+  m_buffer[m_bufferLength + 4] =
+    i_base == NULL ? 0 : (unsigned char)(m_seq - i_baseSeq);
+  v_mask = m_buffer + m_bufferLength + 4 + 1;
+  memset(v_mask, 0, XM_NET_FRAME_MASK_SIZE);
+  m_bufferLength += 4 + 1 + XM_NET_FRAME_MASK_SIZE;
+
+  // only the bytes which changed
+  for (unsigned int i = 0; i < sizeof(SerializedBikeState); i++) {
+    v_xor = v_new[i] ^ v_base[i];
+    if (v_xor != 0) {
+      v_mask[i / 8] |= (1 << (i % 8));
+      m_buffer[m_bufferLength++] = v_xor;
+    }
+  }
+}
+
+bool NA_frames::getFrame(unsigned int i,
+                         const NetFramesHistory *i_history,
+                         NetFrame *o_frame) const {
+  unsigned int v_offset = m_framesOffsets[i];
+  unsigned char v_baseDiff;
+  const unsigned char *v_mask;
+  unsigned char *v_state;
+
+  o_frame->NetId = (int)SDLNet_Read32(m_buffer + v_offset);
+  v_baseDiff = m_buffer[v_offset + 4];
+  v_mask = m_buffer + v_offset + 4 + 1;
+  v_offset += 4 + 1 + XM_NET_FRAME_MASK_SIZE;
+
+  if (v_baseDiff == 0) {
+    memset(&(o_frame->State), 0, sizeof(SerializedBikeState));
+  } else {
+    const SerializedBikeState *v_base =
+      i_history->getState(m_seq - v_baseDiff, o_frame->NetId);
+    if (v_base == NULL) {
+      return false;
+    }
+    o_frame->State = *v_base;
+  }
+
+  v_state = (unsigned char *)&(o_frame->State);
+  for (unsigned int j = 0; j < sizeof(SerializedBikeState); j++) {
+    if (v_mask[j / 8] & (1 << (j % 8))) {
+      v_state[j] ^= m_buffer[v_offset++];
+    }
+  }
+
+  return true;
+}
+
+NA_framesAck::NA_framesAck(unsigned int i_seq)
+  : NetAction(false) {
+  m_seq = i_seq;
+}
+
+NA_framesAck::NA_framesAck(void *data, unsigned int len)
+  : NetAction(false) {
+  unsigned int v_localOffset = 0;
+
+  m_seq = strtoul(
+    getLine(((char *)data) + v_localOffset, len - v_localOffset, &v_localOffset)
+      .c_str(),
+    NULL,
+    10);
+}
+
+NA_framesAck::~NA_framesAck() {}
+
+void NA_framesAck::send(TCPsocket *i_tcpsd,
+                        UDPsocket *i_udpsd,
+                        UDPpacket *i_sendPacket,
+                        IPaddress *i_udpRemoteIP) {
+  std::ostringstream v_send;
+
+  v_send << m_seq;
+
+  NetAction::send(i_tcpsd,
+                  i_udpsd,
+                  i_sendPacket,
+                  i_udpRemoteIP,
+                  v_send.str().c_str(),
+                  v_send.str().size()); // don't send the \0
+}
+
+unsigned int NA_framesAck::seq() const {
+  return m_seq;
+}
+
 NA_udpBind::NA_udpBind(const std::string &i_key)
   : NetAction(false) {
   m_key = i_key;
@@ -27,7 +27,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <string>
 #include <vector>
 
-#define XM_NET_PROTOCOL_VERSION 6
+#define XM_NET_PROTOCOL_VERSION 7
 /*
 DELTA 1->2:
 clientInfos : add xmversion string
@@ -39,15 +39,23 @@ DELTA 4->5
 add slaveClientsPoints
 DELTA 5->6
 add pings
+DELTA 6->7
+add frames (frames of all players in one packet) and framesAck
 */
 
 #define NETACTION_MAX_PACKET_SIZE 1024 * 8 // bytes
 #define NETACTION_MAX_SUBSRC 4 // maximum 4 players by client
 #define XM_NET_MAX_EVENTS_SHOT_SIZE 1024 * 8
+#define XM_NET_FRAMES_MAX_SIZE 960 // bytes, must fit in an udp packet
+#define XM_NET_FRAME_MASK_SIZE ((sizeof(SerializedBikeState) + 7) / 8)
+#define XM_NET_FRAME_MAX_ENCODED_SIZE \
+  (4 + 1 + XM_NET_FRAME_MASK_SIZE + sizeof(SerializedBikeState))
 
 class NetClient;
 class ServerThread;
+class ServerEpoll;
 class DBuffer;
+class NetFramesHistory;
 
 enum NetActionType {
   TNA_clientInfos,
@@ -72,7 +80,9 @@ enum NetActionType {
   TNA_gameEvents,
   TNA_srvCmd,
   TNA_srvCmdAsw,
-  TNA_ping
+  TNA_ping,
+  TNA_frames,
+  TNA_framesAck
 };
 
 struct NetInfosClient {
@@ -85,6 +95,11 @@ struct NetPointsClient {
   int Points;
 };
 
+struct NetFrame {
+  int NetId; // -1 for the frame of the receiver
+  SerializedBikeState State;
+};
+
 struct NetActionU;
 
 class NetAction {
@@ -109,6 +124,10 @@ public:
 
   static void logStats();
 
+  /* udp packets sent on the socket of the queue are only queued ; NULL to
+   * send them immediately */
+  static void setUdpQueue(ServerEpoll *i_udpQueue);
+
   /* stats */
   static unsigned int m_biggestTCPPacketSent;
   static unsigned int m_biggestUDPPacketSent;
@@ -148,6 +167,7 @@ protected:
 
 private:
   static char m_buffer[NETACTION_MAX_PACKET_SIZE];
+  static ServerEpoll *m_udpQueue;
 
   bool m_forceTCP; // by default, xmoto try to use UDP when available ; for some
   // actions, TCP can be forced
@@ -344,6 +364,68 @@ private:
   SerializedBikeState m_state;
 };
 
+/* frames of several players in one packet. Each frame is xor-ed with the
+   frame of the same player in a previous packet the receiver acknowledged
+   (NA_framesAck) ; only the bytes which changed are sent. */
+class NA_frames : public NetAction {
+public:
+  NA_frames(unsigned int i_seq = 0);
+  NA_frames(void *data, unsigned int len);
+  virtual ~NA_frames();
+  std::string actionKey() { return ActionKey; }
+  NetActionType actionType() { return NAType; }
+  static std::string ActionKey;
+  static NetActionType NAType;
+
+  void send(TCPsocket *i_tcpsd,
+            UDPsocket *i_udpsd,
+            UDPpacket *i_sendPacket,
+            IPaddress *i_udpRemoteIP);
+
+  unsigned int seq() const;
+  unsigned int nbFrames() const;
+  bool isFull() const; // no more space for an other frame
+
+  // i_base is NULL to send the full frame ; otherwise, it is the frame of the
+  // same player in the packet i_baseSeq
+  void add(int i_netId,
+           const SerializedBikeState *i_state,
+           const SerializedBikeState *i_base,
+           unsigned int i_baseSeq);
+
+  // return false if the frame is based on a packet unknown in i_history
+  bool getFrame(unsigned int i,
+                const NetFramesHistory *i_history,
+                NetFrame *o_frame) const;
+
+private:
+  unsigned int m_seq;
+  unsigned char m_buffer[XM_NET_FRAMES_MAX_SIZE];
+  unsigned int m_bufferLength;
+  std::vector<unsigned int> m_framesOffsets;
+};
+
+class NA_framesAck : public NetAction {
+public:
+  NA_framesAck(unsigned int i_seq = 0);
+  NA_framesAck(void *data, unsigned int len);
+  virtual ~NA_framesAck();
+  std::string actionKey() { return ActionKey; }
+  NetActionType actionType() { return NAType; }
+  static std::string ActionKey;
+  static NetActionType NAType;
+
+  void send(TCPsocket *i_tcpsd,
+            UDPsocket *i_udpsd,
+            UDPpacket *i_sendPacket,
+            IPaddress *i_udpRemoteIP);
+
+  unsigned int seq() const;
+
+private:
+  unsigned int m_seq;
+};
+
 class NA_changeName : public NetAction {
 public:
   NA_changeName(const std::string &i_name = "");
@@ -698,6 +780,8 @@ public:
   NA_chatMessagePP chatMessagePP;
   NA_serverError serverError;
   NA_frame frame;
+  NA_frames frames;
+  NA_framesAck framesAck;
   NA_changeName changeName;
   NA_clientsNumber clientsNumber;
   NA_clientsNumberQuery clientsNumberQuery;
@@ -223,6 +223,7 @@ void NetClient::connect(const std::string &i_server, int i_port) {
   // reset udp server information
   m_serverReceivesUdp = false;
   m_serverSendsUdp = false;
+  m_framesHistory.reset();
 
   if (SDLNet_ResolveHost(&serverIp, i_server.c_str(), i_port) < 0) {
     throw Exception(SDLNet_GetError());
@@ -400,6 +401,103 @@ void NetClient::updateOtherClientsMode(std::vector<int> i_slavePlayers) {
   }
 }
 
+void NetClient::manageFrame(int i_src,
+                            int i_subsrc,
+                            SerializedBikeState *i_state) {
+  NetGhost *v_ghost = NULL;
+  int v_clientId = -1;
+
+  if (m_universe == NULL) {
+    return;
+  }
+
+  /* the server sending us our own frame */
+  if (i_src == -1) {
+    if (m_mode == NETCLIENT_SLAVE_MODE) { /* ONLY IN SLAVE MODE */
+      if (GameApp::getXMTimeInt() - m_currentOwnFramesTime > 1000) {
+        m_lastOwnFPS = (m_currentOwnFramesNb * 1000) /
+                       (GameApp::getXMTimeInt() - m_currentOwnFramesTime);
+        m_currentOwnFramesTime = GameApp::getXMTimeInt();
+        m_currentOwnFramesNb = 0;
+      }
+      m_currentOwnFramesNb++;
+
+      for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+        for (unsigned int j = 0;
+             j < m_universe->getScenes()[i]->Players().size();
+             j++) {
+          BikeState::convertStateFromReplay(
+            i_state,
+            m_universe->getScenes()[i]->Players()[j]->getStateForUpdate(),
+            m_universe->getScenes()[i]->getPhysicsSettings());
+
+          // adjust the time of the server frame to the time of the local scene
+          m_universe->getScenes()[i]->setTargetTime(i_state->fGameTime * 100.0);
+        }
+
+        // if the game is in pause, at least update the player position
+        if (m_universe->getScenes()[i]->isPaused()) {
+          m_universe->getScenes()[i]->updatePlayers(0 /* 0 to not update */,
+                                                    true);
+        }
+      }
+    }
+
+  } else {
+    // search the client
+    for (unsigned int i = 0; i < m_otherClients.size(); i++) {
+      if (m_otherClients[i]->id() == i_src) {
+        v_clientId = i;
+        break;
+      }
+    }
+    if (v_clientId < 0) {
+      return; // client not declared
+    }
+
+    // check if the ghost already exists
+    if (m_otherClients[v_clientId]->netGhost(i_subsrc) != NULL) {
+      v_ghost = m_otherClients[v_clientId]->netGhost(i_subsrc);
+    }
+
+    if (v_ghost == NULL) {
+      /* add the net ghost */
+
+      // if this is a client of the current party, add it as normal player
+      bool v_isSlaveMode =
+        m_otherClients[v_clientId]->mode() == NETCLIENT_SLAVE_MODE;
+
+      BikerTheme *v_bikerTheme = v_isSlaveMode
+                                   ? Theme::instance()->getNetPlayerTheme()
+                                   : Theme::instance()->getGhostTheme();
+      TColor v_filterColor = v_isSlaveMode ? TColor(0, 255, 255, 0)
+                                           : TColor(255, 255, 255, 0);
+      Color v_uglyColor = v_bikerTheme->getUglyRiderColor();
+
+      for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+        v_ghost = m_universe->getScenes()[i]->addNetGhost(
+          m_otherClients[v_clientId]->name(),
+          Theme::instance(),
+          v_bikerTheme,
+          v_filterColor,
+          TColor(GET_RED(v_uglyColor),
+                 GET_GREEN(v_uglyColor),
+                 GET_BLUE(v_uglyColor),
+                 0));
+        m_otherClients[v_clientId]->setNetGhost(i_subsrc, v_ghost);
+      }
+    }
+
+    // take the physic of the first world
+    if (m_universe->getScenes().size() > 0) {
+      BikeState::convertStateFromReplay(
+        i_state,
+        v_ghost->getStateForUpdate(),
+        m_universe->getScenes()[0]->getPhysicsSettings());
+    }
+  }
+}
+
 void NetClient::manageAction(xmDatabase *pDb, NetAction *i_netAction) {
   switch (i_netAction->actionType()) {
     case TNA_clientInfos:
@@ -408,6 +506,7 @@ void NetClient::manageAction(xmDatabase *pDb, NetAction *i_netAction) {
     case TNA_srvCmd:
     case TNA_clientsNumber:
     case TNA_clientsNumberQuery:
+    case TNA_framesAck:
       /* should not happend */
       break;
 
@@ -496,116 +595,35 @@ void NetClient::manageAction(xmDatabase *pDb, NetAction *i_netAction) {
     } break;
 
     case TNA_frame: {
-      NetGhost *v_ghost = NULL;
-      int v_clientId = -1;
-
-      if (m_universe == NULL) {
-        return;
-      }
-
-      /* the server sending us our own frame */
-      if (i_netAction->getSource() == -1) {
-        if (m_mode == NETCLIENT_SLAVE_MODE) { /* ONLY IN SLAVE MODE */
-          if (GameApp::getXMTimeInt() - m_currentOwnFramesTime > 1000) {
-            m_lastOwnFPS = (m_currentOwnFramesNb * 1000) /
-                           (GameApp::getXMTimeInt() - m_currentOwnFramesTime);
-            m_currentOwnFramesTime = GameApp::getXMTimeInt();
-            m_currentOwnFramesNb = 0;
-          }
-          m_currentOwnFramesNb++;
-
-          for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
-            for (unsigned int j = 0;
-                 j < m_universe->getScenes()[i]->Players().size();
-                 j++) {
-              BikeState::convertStateFromReplay(
-                ((NA_frame *)i_netAction)->getState(),
-                m_universe->getScenes()[i]->Players()[j]->getStateForUpdate(),
-                m_universe->getScenes()[i]->getPhysicsSettings());
-
-              // adjust the time of the server frame to the time of the local
-              // scene
-              m_universe->getScenes()[i]->setTargetTime(
-                ((NA_frame *)i_netAction)->getState()->fGameTime * 100.0);
-            }
-
-            // if the game is in pause, at least update the player position
-            if (m_universe->getScenes()[i]->isPaused()) {
-              m_universe->getScenes()[i]->updatePlayers(0 /* 0 to not update */,
-                                                        true);
-            }
-          }
-        }
-
-      } else {
-        // search the client
-        for (unsigned int i = 0; i < m_otherClients.size(); i++) {
-          if (m_otherClients[i]->id() == i_netAction->getSource()) {
-            v_clientId = i;
-            break;
-          }
-        }
-        if (v_clientId < 0) {
-          return; // client not declared
-        }
-
-        // check if the ghost already exists
-        if (m_otherClients[v_clientId]->netGhost(i_netAction->getSubSource()) !=
-            NULL) {
-          v_ghost =
-            m_otherClients[v_clientId]->netGhost(i_netAction->getSubSource());
-        }
-
-        if (v_ghost == NULL) {
-          /* add the net ghost */
+      manageFrame(i_netAction->getSource(),
+                  i_netAction->getSubSource(),
+                  ((NA_frame *)i_netAction)->getState());
+    } break;
 
-          // if this is a client of the current party, add it as normal player
-          bool v_isSlaveMode =
-            m_otherClients[v_clientId]->mode() == NETCLIENT_SLAVE_MODE;
+    case TNA_frames: {
+      NA_frames *v_na = (NA_frames *)i_netAction;
+      std::vector<NetFrame> v_frames;
+      NetFrame v_frame;
+      bool v_complete = true;
 
-          for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
-            if (v_isSlaveMode) {
-              v_ghost = m_universe->getScenes()[i]->addNetGhost(
-                m_otherClients[v_clientId]->name(),
-                Theme::instance(),
-                Theme::instance()->getNetPlayerTheme(),
-                TColor(0, 255, 255, 0),
-                TColor(GET_RED(Theme::instance()
-                                 ->getNetPlayerTheme()
-                                 ->getUglyRiderColor()),
-                       GET_GREEN(Theme::instance()
-                                   ->getNetPlayerTheme()
-                                   ->getUglyRiderColor()),
-                       GET_BLUE(Theme::instance()
-                                  ->getNetPlayerTheme()
-                                  ->getUglyRiderColor()),
-                       0));
-            } else {
-              v_ghost = m_universe->getScenes()[i]->addNetGhost(
-                m_otherClients[v_clientId]->name(),
-                Theme::instance(),
-                Theme::instance()->getGhostTheme(),
-                TColor(255, 255, 255, 0),
-                TColor(
-                  GET_RED(
-                    Theme::instance()->getGhostTheme()->getUglyRiderColor()),
-                  GET_GREEN(
-                    Theme::instance()->getGhostTheme()->getUglyRiderColor()),
-                  GET_BLUE(
-                    Theme::instance()->getGhostTheme()->getUglyRiderColor()),
-                  0));
-            }
-            m_otherClients[v_clientId]->setNetGhost(i_netAction->getSubSource(),
-                                                    v_ghost);
-          }
+      for (unsigned int i = 0; i < v_na->nbFrames(); i++) {
+        if (v_na->getFrame(i, &m_framesHistory, &v_frame)) {
+          v_frames.push_back(v_frame);
+          manageFrame(v_frame.NetId, 0, &(v_frame.State));
+        } else {
+          // the frame is based on a lost packet
+          v_complete = false;
         }
+      }
 
-        // take the physic of the first world
-        if (m_universe->getScenes().size() > 0) {
-          BikeState::convertStateFromReplay(
-            ((NA_frame *)i_netAction)->getState(),
-            v_ghost->getStateForUpdate(),
-            m_universe->getScenes()[0]->getPhysicsSettings());
+      // the server can encode the next frames against this packet only if all
+      // its frames are known
+      if (v_complete) {
+        m_framesHistory.add(v_na->seq(), v_frames);
+        NA_framesAck na(v_na->seq());
+        try {
+          send(&na, 0);
+        } catch (Exception &e) {
         }
       }
     } break;
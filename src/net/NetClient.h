@@ -25,6 +25,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../include/xm_SDL.h"
 #include "../include/xm_SDL_net.h"
 #include "NetActions.h"
+#include "NetFramesHistory.h"
 #include <string>
 #include <vector>
 
@@ -145,6 +146,7 @@ private:
   void updateOtherClientsMode(std::vector<int> i_slavePlayers);
 
   void manageAction(xmDatabase *pDb, NetAction *i_netAction);
+  void manageFrame(int i_src, int i_subsrc, SerializedBikeState *i_state);
   void cleanOtherClientsGhosts();
 
   int m_lastOwnFPS;
@@ -155,6 +157,7 @@ private:
   std::vector<int> m_previous_private_people;
 
   NetPing m_lastPing;
+  NetFramesHistory m_framesHistory; // frames received with NA_frames
 };
 
 #endif
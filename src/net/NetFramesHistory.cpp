@@ -0,0 +1,96 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "NetFramesHistory.h"
+
+NetFramesHistory::NetFramesHistory() {
+  reset();
+}
+
+NetFramesHistory::~NetFramesHistory() {}
+
+void NetFramesHistory::reset() {
+  for (unsigned int i = 0; i < XM_NET_FRAMES_HISTORY_SIZE; i++) {
+    m_packets[i].isSet = false;
+    m_packets[i].frames.clear();
+  }
+  m_isAcknowledged = false;
+  m_lastAcknowledged = 0;
+}
+
+void NetFramesHistory::add(unsigned int i_seq,
+                           const std::vector<NetFrame> &i_frames) {
+  NetFramesPacket *v_packet = &(m_packets[i_seq % XM_NET_FRAMES_HISTORY_SIZE]);
+
+  v_packet->isSet = true;
+  v_packet->seq = i_seq;
+  v_packet->frames = i_frames;
+}
+
+const SerializedBikeState *NetFramesHistory::getState(unsigned int i_seq,
+                                                      int i_netId) const {
+  const NetFramesPacket *v_packet =
+    &(m_packets[i_seq % XM_NET_FRAMES_HISTORY_SIZE]);
+
+  if (v_packet->isSet == false || v_packet->seq != i_seq) {
+    return NULL;
+  }
+
+  for (unsigned int i = 0; i < v_packet->frames.size(); i++) {
+    if (v_packet->frames[i].NetId == i_netId) {
+      return &(v_packet->frames[i].State);
+    }
+  }
+
+  return NULL;
+}
+
+void NetFramesHistory::acknowledge(unsigned int i_seq) {
+  const NetFramesPacket *v_packet =
+    &(m_packets[i_seq % XM_NET_FRAMES_HISTORY_SIZE]);
+
+  // unknown or too old packet
+  if (v_packet->isSet == false || v_packet->seq != i_seq) {
+    return;
+  }
+
+  // acks can arrive in the wrong order
+  if (m_isAcknowledged && i_seq <= m_lastAcknowledged) {
+    return;
+  }
+
+  m_isAcknowledged = true;
+  m_lastAcknowledged = i_seq;
+}
+
+bool NetFramesHistory::lastAcknowledged(unsigned int i_currentSeq,
+                                        unsigned int *o_seq) const {
+  if (m_isAcknowledged == false) {
+    return false;
+  }
+
+  // the receiver keeps only the last packets ; the offset must fit in a byte
+  if (i_currentSeq - m_lastAcknowledged >= XM_NET_FRAMES_HISTORY_SIZE) {
+    return false;
+  }
+
+  *o_seq = m_lastAcknowledged;
+  return true;
+}
@@ -0,0 +1,60 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __NETFRAMESHISTORY_H__
+#define __NETFRAMESHISTORY_H__
+
+#include "NetActions.h"
+#include <vector>
+
+#define XM_NET_FRAMES_HISTORY_SIZE 32
+
+/* last NA_frames packets sent to (or received from) a peer ; the frames they
+   contain are the references the next packets are encoded against */
+class NetFramesHistory {
+public:
+  NetFramesHistory();
+  ~NetFramesHistory();
+
+  void reset();
+  void add(unsigned int i_seq, const std::vector<NetFrame> &i_frames);
+
+  // NULL if the frame of i_netId is unknown in the packet i_seq
+  const SerializedBikeState *getState(unsigned int i_seq, int i_netId) const;
+
+  // the peer confirms it received the packet i_seq
+  void acknowledge(unsigned int i_seq);
+  // false if no packet of the history has been acknowledged
+  bool lastAcknowledged(unsigned int i_currentSeq,
+                        unsigned int *o_seq) const;
+
+private:
+  struct NetFramesPacket {
+    bool isSet;
+    unsigned int seq;
+    std::vector<NetFrame> frames;
+  };
+
+  NetFramesPacket m_packets[XM_NET_FRAMES_HISTORY_SIZE];
+  bool m_isAcknowledged;
+  unsigned int m_lastAcknowledged;
+};
+
+#endif
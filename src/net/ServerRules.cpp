@@ -20,6 +20,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "ServerRules.h"
 #include "helpers/Log.h"
+#include "thread/ServerRoom.h"
 #include "thread/ServerThread.h"
 #include "xmoto/Universe.h"
 
@@ -34,17 +35,15 @@ luaL_Reg ServerRules::m_rulesFuncs[] = {
   { NULL, NULL }
 };
 
-ServerThread *ServerRules::m_exec_server = NULL;
-
-ServerRules::ServerRules(ServerThread *i_st)
+ServerRules::ServerRules(ServerRoom *i_room)
   : LuaLibBase("Rules", m_rulesFuncs) {
-  m_server = i_st;
+  m_room = i_room;
 }
 
 ServerRules::~ServerRules() {}
 
-void ServerRules::setInstance() {
-  m_exec_server = m_server;
+ServerRoom *ServerRules::room(lua_State *pL) {
+  return ((ServerRules *)getInstance(pL))->m_room;
 }
 
 /* rules functions */
@@ -66,7 +65,7 @@ int ServerRules::L_Rules_player_setPoints(lua_State *pL) {
   args_CheckNumberOfArguments(pL, 2);
   v_playerId = (int)luaL_checknumber(pL, 1);
   v_points = (int)luaL_checknumber(pL, 2);
-  m_exec_server->getNetSClientById(v_playerId)->setPoints(v_points);
+  room(pL)->getNetSClientById(v_playerId)->setPoints(v_points);
   return 0;
 }
 
@@ -77,12 +76,12 @@ int ServerRules::L_Rules_player_addPoints(lua_State *pL) {
   args_CheckNumberOfArguments(pL, 2);
   v_playerId = (int)luaL_checknumber(pL, 1);
   v_points = (int)luaL_checknumber(pL, 2);
-  m_exec_server->getNetSClientById(v_playerId)->addPoints(v_points);
+  room(pL)->getNetSClientById(v_playerId)->addPoints(v_points);
   return 0;
 }
 
 int ServerRules::L_Rules_sendPointsToPlayers(lua_State *pL) {
-  m_exec_server->sendPointsToSlavePlayers();
+  room(pL)->sendPointsToSlavePlayers();
   return 0;
 }
 
@@ -90,7 +89,7 @@ int ServerRules::L_Rules_Round_getTime(lua_State *pL) {
   args_CheckNumberOfArguments(pL, 0);
 
   Universe *v_universe;
-  v_universe = m_exec_server->getUniverse();
+  v_universe = room(pL)->getUniverse();
   if (v_universe == NULL) {
     lua_pushnumber(pL, 0);
     return 1;
@@ -108,7 +107,7 @@ int ServerRules::L_Rules_Round_getNbRemainingEntitiesToTake(lua_State *pL) {
   args_CheckNumberOfArguments(pL, 0);
 
   Universe *v_universe;
-  v_universe = m_exec_server->getUniverse();
+  v_universe = room(pL)->getUniverse();
   if (v_universe == NULL) {
     lua_pushnumber(pL, 0);
     return 1;
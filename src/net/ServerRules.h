@@ -23,21 +23,20 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "xmoto/LuaLibBase.h"
 
-class ServerThread;
+class ServerRoom;
 
 class ServerRules : public LuaLibBase {
 public:
-  ServerRules(ServerThread *i_st);
+  ServerRules(ServerRoom *i_room);
   ~ServerRules();
 
-protected:
-  void setInstance();
-
 private:
-  ServerThread *m_server;
+  ServerRoom *m_room;
 
   static luaL_Reg m_rulesFuncs[];
-  static ServerThread *m_exec_server;
+
+  /* room of the instance running the lua state */
+  static ServerRoom *room(lua_State *pL);
 
   /* Lua library prototypes */
   // system
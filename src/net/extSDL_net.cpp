@@ -35,6 +35,12 @@ struct _TCPsocket {
   int sflag;
 };
 
+/* only the beginning of the structure is required */
+struct _UDPsocket {
+  int ready;
+  SOCKET channel;
+};
+
 int SDLNet_TCP_Send_noBlocking(TCPsocket sock, const void *datap, int len) {
   const Uint8 *data = (const Uint8 *)datap; /* For pointer arithmetic */
   int sent, left;
@@ -61,6 +67,14 @@ int SDLNet_TCP_Send_noBlocking(TCPsocket sock, const void *datap, int len) {
   return (sent);
 }
 
+int SDLNet_TCP_GetFd(TCPsocket sock) {
+  return sock->channel;
+}
+
+int SDLNet_UDP_GetFd(UDPsocket sock) {
+  return sock->channel;
+}
+
 #else
 // i don't know whether it's blocking or not ; i mainly want it works for the
 // servers on linux
@@ -32,4 +32,13 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 int SDLNet_TCP_Send_noBlocking(TCPsocket sock, const void *datap, int len);
 
+#if !defined(WIN32) && !defined(__APPLE__)
+/*
+  system descriptors of the sdl_net sockets, for the servers which watch them
+  directly (epoll)
+*/
+int SDLNet_TCP_GetFd(TCPsocket sock);
+int SDLNet_UDP_GetFd(UDPsocket sock);
+#endif
+
 #endif
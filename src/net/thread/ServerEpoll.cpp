@@ -0,0 +1,208 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "ServerEpoll.h"
+
+#if HAVE_EPOLL
+#include "../extSDL_net.h"
+#include "helpers/Log.h"
+#include "helpers/VExcept.h"
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+// clients are keyed by their id, which is an unsigned int
+#define XM_SERVER_EPOLL_KEY_TCP_SERVER (((uint64_t)1) << 32)
+#define XM_SERVER_EPOLL_KEY_UDP (((uint64_t)2) << 32)
+
+ServerEpoll::ServerEpoll(TCPsocket i_tcpsd, UDPsocket i_udpsd) {
+  m_udpsd = i_udpsd;
+  m_udpFd = SDLNet_UDP_GetFd(i_udpsd);
+  m_nbQueued = 0;
+
+  m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_epollFd == -1) {
+    throw Exception(std::string("epoll_create1: ") + strerror(errno));
+  }
+
+  try {
+    watch(SDLNet_TCP_GetFd(i_tcpsd), XM_SERVER_EPOLL_KEY_TCP_SERVER);
+    watch(m_udpFd, XM_SERVER_EPOLL_KEY_UDP);
+  } catch (Exception &e) {
+    ::close(m_epollFd);
+    throw e;
+  }
+
+  for (unsigned int i = 0; i < XM_SERVER_EPOLL_UDP_BATCH; i++) {
+    m_recvIovecs[i].iov_base = m_recvBuffers[i];
+    m_recvIovecs[i].iov_len = XM_SERVER_EPOLL_UDP_PACKET_SIZE;
+    memset(&m_recvMsgs[i], 0, sizeof(struct mmsghdr));
+    m_recvMsgs[i].msg_hdr.msg_iov = &m_recvIovecs[i];
+    m_recvMsgs[i].msg_hdr.msg_iovlen = 1;
+    m_recvMsgs[i].msg_hdr.msg_name = &m_recvAddrs[i];
+    m_recvMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+
+    m_sendIovecs[i].iov_base = m_sendBuffers[i];
+    memset(&m_sendMsgs[i], 0, sizeof(struct mmsghdr));
+    m_sendMsgs[i].msg_hdr.msg_iov = &m_sendIovecs[i];
+    m_sendMsgs[i].msg_hdr.msg_iovlen = 1;
+    m_sendMsgs[i].msg_hdr.msg_name = &m_sendAddrs[i];
+    m_sendMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+  }
+}
+
+ServerEpoll::~ServerEpoll() {
+  ::close(m_epollFd);
+}
+
+void ServerEpoll::watch(int i_fd, uint64_t i_key) {
+  struct epoll_event v_event;
+
+  memset(&v_event, 0, sizeof(v_event));
+  v_event.events = EPOLLIN; // level triggered, like the sdl_net socket set
+  v_event.data.u64 = i_key;
+
+  if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, i_fd, &v_event) == -1) {
+    throw Exception(std::string("epoll_ctl: ") + strerror(errno));
+  }
+}
+
+void ServerEpoll::addClient(TCPsocket i_csd, unsigned int i_clientId) {
+  watch(SDLNet_TCP_GetFd(i_csd), i_clientId);
+}
+
+void ServerEpoll::removeClient(TCPsocket i_csd) {
+  struct epoll_event v_event; // required by kernels before 2.6.9
+
+  if (epoll_ctl(
+        m_epollFd, EPOLL_CTL_DEL, SDLNet_TCP_GetFd(i_csd), &v_event) == -1) {
+    LogWarning("server: epoll_ctl: %s", strerror(errno));
+  }
+}
+
+int ServerEpoll::wait(int i_timeout) {
+  int n;
+
+  n = epoll_wait(m_epollFd, m_events, XM_SERVER_EPOLL_MAX_EVENTS, i_timeout);
+  if (n == -1 && errno == EINTR) {
+    return 0;
+  }
+  return n;
+}
+
+bool ServerEpoll::isTcpServerEvent(unsigned int i) const {
+  return m_events[i].data.u64 == XM_SERVER_EPOLL_KEY_TCP_SERVER;
+}
+
+bool ServerEpoll::isUdpEvent(unsigned int i) const {
+  return m_events[i].data.u64 == XM_SERVER_EPOLL_KEY_UDP;
+}
+
+unsigned int ServerEpoll::clientIdOfEvent(unsigned int i) const {
+  return (unsigned int)m_events[i].data.u64;
+}
+
+unsigned int ServerEpoll::receiveUdp() {
+  int n;
+
+  for (unsigned int i = 0; i < XM_SERVER_EPOLL_UDP_BATCH; i++) {
+    m_recvMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+  }
+
+  n = recvmmsg(
+    m_udpFd, m_recvMsgs, XM_SERVER_EPOLL_UDP_BATCH, MSG_DONTWAIT, NULL);
+  if (n == -1) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      LogWarning("server: recvmmsg: %s", strerror(errno));
+    }
+    return 0;
+  }
+
+  return n;
+}
+
+void ServerEpoll::getUdpPacket(unsigned int i, UDPpacket *o_packet) const {
+  unsigned int v_len = m_recvMsgs[i].msg_len;
+
+  if (v_len > (unsigned int)o_packet->maxlen) {
+    v_len = o_packet->maxlen; // truncated, as sdl_net does
+  }
+
+  memcpy(o_packet->data, m_recvBuffers[i], v_len);
+  o_packet->len = v_len;
+  o_packet->channel = -1;
+  o_packet->status = v_len;
+
+  // sdl_net keeps the addresses in network byte order too
+  o_packet->address.host = m_recvAddrs[i].sin_addr.s_addr;
+  o_packet->address.port = m_recvAddrs[i].sin_port;
+}
+
+UDPsocket ServerEpoll::udpSocket() const {
+  return m_udpsd;
+}
+
+void ServerEpoll::queueUdp(const UDPpacket *i_packet) {
+  if (i_packet->len > XM_SERVER_EPOLL_UDP_PACKET_SIZE) {
+    throw Exception("UDP packet too big to be queued");
+  }
+
+  if (m_nbQueued == XM_SERVER_EPOLL_UDP_BATCH) {
+    flushUdp();
+  }
+
+  memcpy(m_sendBuffers[m_nbQueued], i_packet->data, i_packet->len);
+  m_sendIovecs[m_nbQueued].iov_len = i_packet->len;
+
+  memset(&m_sendAddrs[m_nbQueued], 0, sizeof(struct sockaddr_in));
+  m_sendAddrs[m_nbQueued].sin_family = AF_INET;
+  m_sendAddrs[m_nbQueued].sin_addr.s_addr = i_packet->address.host;
+  m_sendAddrs[m_nbQueued].sin_port = i_packet->address.port;
+
+  m_nbQueued++;
+}
+
+void ServerEpoll::flushUdp() {
+  unsigned int v_sent = 0;
+  int n;
+
+  while (v_sent < m_nbQueued) {
+    n = sendmmsg(
+      m_udpFd, m_sendMsgs + v_sent, m_nbQueued - v_sent, MSG_DONTWAIT);
+    if (n == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // udp : the packets are lost, as with a full sdl_net socket buffer
+        LogWarning("server: sendmmsg: %u udp packet(s) lost",
+                   m_nbQueued - v_sent);
+        break;
+      }
+      // the first packet is in error, skip it and send the next ones
+      LogWarning("server: sendmmsg: %s", strerror(errno));
+      n = 1;
+    }
+    v_sent += n;
+  }
+
+  m_nbQueued = 0;
+}
+#endif
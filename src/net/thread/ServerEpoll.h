@@ -0,0 +1,90 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __SERVEREPOLL_H__
+#define __SERVEREPOLL_H__
+
+#include "../../include/xm_SDL_net.h"
+
+#if HAVE_EPOLL
+#include <netinet/in.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#define XM_SERVER_EPOLL_MAX_EVENTS 128
+#define XM_SERVER_EPOLL_UDP_BATCH 64
+#define XM_SERVER_EPOLL_UDP_PACKET_SIZE 1024 // bytes
+
+/*
+  linux network backend of the server : the sockets are watched with epoll
+  instead of a sdl_net socket set, and udp packets are received and sent by
+  batches with recvmmsg/sendmmsg to save system calls when many clients play
+*/
+class ServerEpoll {
+public:
+  ServerEpoll(TCPsocket i_tcpsd, UDPsocket i_udpsd); // throw on error
+  ~ServerEpoll();
+
+  void addClient(TCPsocket i_csd, unsigned int i_clientId);
+  void removeClient(TCPsocket i_csd);
+
+  /* 0 for no timeout, -1 for infinite ; return the number of events, -1 on
+   * error */
+  int wait(int i_timeout);
+  bool isTcpServerEvent(unsigned int i) const;
+  bool isUdpEvent(unsigned int i) const;
+  unsigned int clientIdOfEvent(unsigned int i) const;
+
+  /* read the pending udp packets ; return the number of packets */
+  unsigned int receiveUdp();
+  void getUdpPacket(unsigned int i, UDPpacket *o_packet) const;
+
+  /* packets sent on the udp socket are queued until flushUdp() */
+  UDPsocket udpSocket() const;
+  void queueUdp(const UDPpacket *i_packet);
+  void flushUdp();
+
+private:
+  int m_epollFd;
+  int m_udpFd;
+  UDPsocket m_udpsd;
+  struct epoll_event m_events[XM_SERVER_EPOLL_MAX_EVENTS];
+
+  void watch(int i_fd, uint64_t i_key);
+
+  // reception
+  struct mmsghdr m_recvMsgs[XM_SERVER_EPOLL_UDP_BATCH];
+  struct iovec m_recvIovecs[XM_SERVER_EPOLL_UDP_BATCH];
+  struct sockaddr_in m_recvAddrs[XM_SERVER_EPOLL_UDP_BATCH];
+  Uint8 m_recvBuffers[XM_SERVER_EPOLL_UDP_BATCH]
+                     [XM_SERVER_EPOLL_UDP_PACKET_SIZE];
+
+  // emission
+  unsigned int m_nbQueued;
+  struct mmsghdr m_sendMsgs[XM_SERVER_EPOLL_UDP_BATCH];
+  struct iovec m_sendIovecs[XM_SERVER_EPOLL_UDP_BATCH];
+  struct sockaddr_in m_sendAddrs[XM_SERVER_EPOLL_UDP_BATCH];
+  Uint8 m_sendBuffers[XM_SERVER_EPOLL_UDP_BATCH]
+                     [XM_SERVER_EPOLL_UDP_PACKET_SIZE];
+};
+#endif
+
+#endif
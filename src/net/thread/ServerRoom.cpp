@@ -0,0 +1,864 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "ServerRoom.h"
+#include "../NetActions.h"
+#include "../ServerRules.h"
+#include "ServerThread.h"
+#include "common/DBuffer.h"
+#include "common/XMSession.h"
+#include "db/xmDatabase.h"
+#include "helpers/Log.h"
+#include "helpers/VExcept.h"
+#include "xmoto/Game.h"
+#include "xmoto/Universe.h"
+#include "xmscene/BikeController.h"
+#include "xmscene/Level.h"
+#include <string.h>
+
+#define XM_SERVER_PLAYER_INACTIV_TIME_MAX 1000
+#define XM_SERVER_PLAYER_INACTIV_TIME_PREV 300
+#define XM_SERVER_PREPLAYING_TIME 300
+#define XM_SERVER_FRAMES_MIN_PROTOCOL_VERSION 7
+
+ServerRoom::ServerRoom(ServerThread *i_server, unsigned int i_id) {
+  m_server = i_server;
+  m_id = i_id;
+
+  m_universe = NULL;
+  m_DBuffer = new DBuffer();
+  m_DBuffer->initOutput(XM_NET_MAX_EVENTS_SHOT_SIZE);
+  m_sp2phase = SP2_PHASE_NONE;
+  m_currentFrame = 0;
+  m_sp2_gameStarted = false;
+  m_sp2_stepPlaying = false;
+  m_sp2_updateScenes = false;
+  m_sp2_updateDone = false;
+  m_sp2_firstFrame = false;
+  m_rules = NULL;
+  m_needToReloadRules = false;
+  m_sceneHook = new XMServerSceneHooks(this);
+}
+
+ServerRoom::~ServerRoom() {
+  if (m_universe != NULL) {
+    delete m_universe;
+  }
+  delete m_DBuffer;
+  if (m_rules != NULL) {
+    delete m_rules;
+  }
+  delete m_sceneHook;
+}
+
+unsigned int ServerRoom::id() const {
+  return m_id;
+}
+
+ServerP2Phase ServerRoom::phase() const {
+  return m_sp2phase;
+}
+
+std::string ServerRoom::playingLevelId() const {
+  if (m_universe == NULL) {
+    return "";
+  }
+  return m_playingLevelId;
+}
+
+bool ServerRoom::isClientInRoom(unsigned int i_client) const {
+  return m_server->m_clients[i_client]->room() == m_id;
+}
+
+bool ServerRoom::isClientPlaying(unsigned int i_client) const {
+  return isClientInRoom(i_client) &&
+         m_server->m_clients[i_client]->isMarkedToPlay();
+}
+
+unsigned int ServerRoom::nbClients() const {
+  unsigned int n = 0;
+
+  for (unsigned int i = 0; i < m_server->m_clients.size(); i++) {
+    if (isClientInRoom(i)) {
+      n++;
+    }
+  }
+
+  return n;
+}
+
+unsigned int ServerRoom::nbClientsMarkedToPlay() const {
+  unsigned int n = 0;
+
+  for (unsigned int i = 0; i < m_server->m_clients.size(); i++) {
+    if (isClientPlaying(i)) {
+      n++;
+    }
+  }
+
+  return n;
+}
+
+unsigned int ServerRoom::nbClientsInMode(NetClientMode i_mode) const {
+  unsigned int n = 0;
+
+  for (unsigned int i = 0; i < m_server->m_clients.size(); i++) {
+    if (isClientInRoom(i) && m_server->m_clients[i]->mode() == i_mode) {
+      n++;
+    }
+  }
+
+  return n;
+}
+
+void ServerRoom::run_stepBegin() {
+  std::vector<NetSClient *> &v_clients = m_server->m_clients;
+
+  m_sp2_stepPlaying = false;
+
+  switch (m_sp2phase) {
+    case SP2_PHASE_NONE:
+      break;
+
+    case SP2_PHASE_WAIT_CLIENTS:
+      if (nbClientsInMode(NETCLIENT_SLAVE_MODE) > 0) {
+        // mark clients as to play
+        for (unsigned int i = 0; i < v_clients.size(); i++) {
+          if (isClientInRoom(i) &&
+              v_clients[i]->mode() == NETCLIENT_SLAVE_MODE) {
+            v_clients[i]->markToPlay(m_rules, true);
+          }
+        }
+        SP2_setPhase(SP2_PHASE_PLAYING);
+      }
+      break;
+
+    case SP2_PHASE_PLAYING:
+      SP2_updateScenePlayingBegin();
+      m_sp2_stepPlaying = true;
+      break;
+  }
+}
+
+void ServerRoom::run_stepScenes() {
+  if (m_sp2_stepPlaying) {
+    SP2_updateScenesPlaying();
+  }
+}
+
+void ServerRoom::run_stepEnd() {
+  if (m_sp2_stepPlaying) {
+    SP2_updateScenePlayingEnd();
+    SP2_updateCheckScenePlaying();
+  }
+}
+
+std::string ServerRoom::SP2_determineLevel() {
+  char **v_result;
+  unsigned int nrow;
+  std::string v_id_level;
+  xmDatabase *v_pDb = m_server->m_pDb;
+
+  // don't allow own levels (isToReload=1)
+  v_result = v_pDb->readDB(
+    "SELECT id_level "
+    "FROM levels "
+    "WHERE isToReload=0 AND isScripted=0 AND isPhysics=0 " // warning,
+    // addforcetoplayer
+    // event cannot be
+    // over network game
+    // cause player id is
+    // serialized
+    //"WHERE id_level='_iL00_' " // for tests
+    "ORDER BY RANDOM() LIMIT 1;",
+    nrow);
+  if (nrow == 0) {
+    v_pDb->read_DB_free(v_result);
+    throw Exception("Unable to get a level");
+  }
+  v_id_level = v_pDb->getResult(v_result, 1, 0, 0);
+  v_pDb->read_DB_free(v_result);
+  /* */
+
+  return v_id_level;
+}
+
+void ServerRoom::SP2_initPlaying() {
+  unsigned int v_numPlayer;
+  unsigned int v_localNetId = 0;
+  std::string v_id_level;
+  std::vector<NetSClient *> &v_clients = m_server->m_clients;
+  m_lastPhysTime = GameApp::getXMTimeInt();
+
+  v_id_level = SP2_determineLevel();
+  NA_playingLevel v_napl(v_id_level);
+
+  m_universe = new Universe();
+  m_universe->initPlayServer();
+  m_playingLevelId = v_id_level;
+
+  // set hooks for the scenes
+  for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+    m_universe->getScenes()[i]->setHooks(m_sceneHook);
+  }
+
+  try {
+    for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+      v_numPlayer = 0;
+      m_universe->getScenes()[i]->loadLevel(
+        m_server->m_pDb, v_id_level, true);
+      if (m_universe->getScenes()[i]->getLevelSrc()->isXMotoTooOld()) {
+        throw Exception("Level " + v_id_level + " is too old");
+      }
+
+      m_DBuffer->clear();
+      m_universe->getScenes()[i]->prePlayLevel(m_DBuffer, true, true, false);
+      SP2_sendSceneEvents(m_DBuffer);
+
+      // add the bikers
+      for (unsigned int j = 0; j < v_clients.size(); j++) {
+        if (isClientPlaying(j)) {
+          m_universe->getScenes()[i]->addPlayerLocalBiker(
+            v_localNetId,
+            m_universe->getScenes()[i]->getLevelSrc()->PlayerStart(),
+            DD_RIGHT,
+            Theme::instance(),
+            Theme::instance()->getPlayerTheme(),
+            GameApp::getColorFromPlayerNumber(v_numPlayer),
+            GameApp::getUglyColorFromPlayerNumber(v_numPlayer),
+            false);
+          v_clients[j]->markScenePlayer(0, v_numPlayer);
+
+          // mark the player as playing the level
+          v_clients[j]->setPlayingLevelId(v_id_level);
+          m_server->sendToAllClients(&v_napl, v_clients[j]->id(), 0, j);
+
+          v_numPlayer++;
+          v_localNetId++;
+        }
+      }
+      m_universe->getScenes()[i]->playInitLevel();
+    }
+  } catch (Exception &e) {
+    LogWarning("server: Unable to load level %s in room %u",
+               v_id_level.c_str(),
+               m_id);
+    throw Exception("Unable to load level " + v_id_level);
+  }
+
+  try {
+    std::vector<int> v_players;
+    for (unsigned int i = 0; i < v_clients.size(); i++) {
+      if (isClientPlaying(i)) {
+        v_players.push_back(v_clients[i]->id());
+      }
+    }
+
+    NA_prepareToPlay na(v_id_level, v_players);
+    sendToAllClientsMarkedToPlay(&na, -1, 0);
+  } catch (Exception &e) {
+    /* bad */
+  }
+
+  m_sceneStartTime = (GameApp::getXMTimeInt() / 10) + XM_SERVER_PREPLAYING_TIME;
+  m_lastPrepareToGoAlert = -1;
+}
+
+void ServerRoom::SP2_uninitPlaying() {
+  try {
+    m_rules->scriptCallVoid("Round_whenRound_ends");
+  } catch (Exception &e) {
+    // continue the game even if the rules are badly written
+    LogError(std::string("Rules: " + e.getMsg()).c_str());
+  }
+  delete m_universe;
+  m_universe = NULL;
+}
+
+void ServerRoom::SP2_manageInactivity() {
+  int v_inactivDiff;
+  int v_prevTime;
+  Biker *v_player;
+  bool v_isOk;
+  std::vector<NetSClient *> &v_clients = m_server->m_clients;
+
+  /* kill players not playing for a too long time */
+  for (unsigned int i = 0; i < v_clients.size(); i++) {
+    if (isClientPlaying(i)) {
+      v_player = m_universe->getScenes()[v_clients[i]->getNumScene()]
+                   ->Players()[v_clients[i]->getNumPlayer()];
+
+      if (v_player->isDead() == false && v_player->isFinished() == false) {
+        v_isOk = false;
+
+        // check driving
+        if (v_player->getControler() != NULL) {
+          if (v_player->getControler()->isDriving()) {
+            v_clients[i]->setLastActivTime(GameApp::getXMTimeInt());
+            v_isOk = true;
+          }
+        }
+
+        // check last move
+        if (v_isOk == false) {
+          v_inactivDiff =
+            GameApp::getXMTimeInt() - v_clients[i]->lastActivTime();
+          if (XM_SERVER_PLAYER_INACTIV_TIME_MAX * 10 < v_inactivDiff) {
+            m_universe->getScenes()[v_clients[i]->getNumScene()]->killPlayer(
+              v_clients[i]->getNumPlayer());
+          } else {
+            v_prevTime = XM_SERVER_PLAYER_INACTIV_TIME_MAX * 10 - v_inactivDiff;
+
+            if (XM_SERVER_PLAYER_INACTIV_TIME_PREV * 10 > v_prevTime) {
+              if (v_clients[i]->lastInactivTimeAlert() != v_prevTime / 1000) {
+                v_clients[i]->setLastInactivTimeAlert(v_prevTime / 1000);
+
+                NA_killAlert na(v_clients[i]->lastInactivTimeAlert() + 1);
+                try {
+                  m_server->sendToClient(&na, i, -1, 0);
+                } catch (Exception &e) {
+                  /* hehe, ok, no pb */
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+bool ServerRoom::SP2_managePreplayTime() {
+  int v_waitTime;
+
+  if (m_sceneStartTime <= GameApp::getXMTimeInt() / 10 &&
+      m_lastPrepareToGoAlert < 0) {
+    return false;
+  }
+
+  v_waitTime = (m_sceneStartTime - (GameApp::getXMTimeInt() / 10)) / 100;
+
+  if (v_waitTime <
+      0) { /* only the GO! has not been send and time is just under 0 */
+    m_lastPrepareToGoAlert = -1;
+    try {
+      NA_prepareToGo na(0);
+      sendToAllClientsMarkedToPlay(&na, -1, 0);
+    } catch (Exception &e) {
+      /* ok, not good */
+    }
+  } else {
+    try {
+      if (m_lastPrepareToGoAlert != v_waitTime) {
+        NA_prepareToGo na(v_waitTime + 1);
+        sendToAllClientsMarkedToPlay(&na, -1, 0);
+        m_lastPrepareToGoAlert = v_waitTime;
+      }
+    } catch (Exception &e) {
+      /* ok, not good */
+    }
+  }
+
+  return true;
+}
+
+void ServerRoom::SP2_sendSceneEvents(DBuffer *i_buffer) {
+  try {
+    if (i_buffer->isEmpty() == false) {
+      NA_gameEvents na(i_buffer);
+      sendToAllClientsMarkedToPlay(&na, -1, 0);
+    }
+  } catch (Exception &e) {
+    /* ok, not good */
+  }
+}
+
+void ServerRoom::SP2_updateScenePlayingBegin() {
+  m_sp2_updateScenes = false;
+  m_sp2_updateDone = false;
+  m_sp2_firstFrame = false;
+
+  if (SP2_managePreplayTime() == false) {
+    // manage the first time the update is done
+    if (m_sp2_gameStarted == false) {
+      m_sp2_gameStarted = true;
+
+      try {
+        m_rules->scriptCallVoid("Round_whenRound_begins");
+      } catch (Exception &e) {
+        // continue the game even if the rules are badly written
+        LogError(std::string("Rules: " + e.getMsg()).c_str());
+      }
+    }
+
+    SP2_manageInactivity();
+
+    m_DBuffer->clear();
+    m_sp2_updateScenes = true;
+  } else {
+    /* send the first frame regularly, so that the client received it once ready
+     */
+    if (GameApp::getXMTimeInt() - m_firstFrameSent >
+        100) { /* 100 => 10 times / seconde */
+      m_firstFrameSent = GameApp::getXMTimeInt();
+      m_sp2_firstFrame = true;
+    }
+    // initialize the physics time
+    m_lastPhysTime = GameApp::getXMTimeInt();
+  }
+}
+
+void ServerRoom::SP2_updateScenesPlaying() {
+  int nPhysSteps;
+  int v_physStep;
+  Scene *v_scene;
+
+  if (m_sp2_updateScenes == false) {
+    return;
+  }
+
+  /* update the scene ; steps larger than PHYS_STEP_SIZE are lighter for
+     the server, the bikes being swept along their path to not go through
+     the blocks */
+  nPhysSteps = 0;
+  v_physStep = XMSession::instance()->serverPhysicsStep();
+  if (v_physStep < PHYS_STEP_SIZE) {
+    v_physStep = PHYS_STEP_SIZE;
+  }
+
+  while (m_lastPhysTime + (v_physStep * 10) <= GameApp::getXMTimeInt() &&
+         nPhysSteps < 10) {
+    for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+      v_scene = m_universe->getScenes()[i];
+      v_scene->updateLevel(v_physStep,
+                           NULL,
+                           m_DBuffer,
+                           nPhysSteps != 0,
+                           false /* no particles */,
+                           false /* don't update died players */);
+    }
+    m_sp2_updateDone = true;
+    m_lastPhysTime += v_physStep * 10;
+    nPhysSteps++;
+  }
+
+  // if the delay is too long, reinitialize -- don't skip in server mode
+  // if(m_fLastPhysTime + PHYS_STEP_SIZE/100.0 < GameApp::getXMTime()) {
+  //  m_fLastPhysTime = GameApp::getXMTime();
+  //}
+}
+
+void ServerRoom::SP2_updateScenePlayingEnd() {
+  bool v_ownFrames;
+  bool v_othersFrames;
+
+  if (m_sp2_updateScenes) {
+    SP2_sendSceneEvents(m_DBuffer);
+  }
+
+  // send to each client his frame and the frame of the others
+  if (m_sp2_updateDone || m_sp2_firstFrame) {
+    v_ownFrames = m_sp2_firstFrame ||
+                  m_currentFrame % (100 / XM_SERVER_UPLOADING_FPS_PLAYER) == 0;
+    v_othersFrames =
+      m_sp2_firstFrame ||
+      m_currentFrame % (100 / XM_SERVER_UPLOADING_FPS_OPLAYERS) == 0;
+    if (v_ownFrames || v_othersFrames) {
+      SP2_sendFrames(v_ownFrames, v_othersFrames);
+    }
+    m_currentFrame = (m_currentFrame + 1) % 1000;
+  }
+}
+
+void ServerRoom::SP2_sendFrames(bool i_ownFrames, bool i_othersFrames) {
+  std::vector<NetSClient *> &v_clients = m_server->m_clients;
+  std::vector<unsigned int> v_players;
+  std::vector<SerializedBikeState> v_states;
+  SerializedBikeState v_state;
+  Scene *v_scene;
+  bool v_isOwn;
+
+  // frames of the players still alive
+  for (unsigned int i = 0; i < v_clients.size(); i++) {
+    if (isClientPlaying(i)) {
+      v_scene = m_universe->getScenes()[v_clients[i]->getNumScene()];
+
+      if (v_scene->Players()[v_clients[i]->getNumPlayer()]->isDead() ==
+          false) {
+        // the padding bytes are sent too, keep them constant
+        memset(&v_state, 0, sizeof(SerializedBikeState));
+        v_scene->getSerializedBikeState(
+          v_scene->Players()[v_clients[i]->getNumPlayer()]->getState(),
+          v_scene->getTime(),
+          &v_state,
+          v_scene->getPhysicsSettings());
+        v_players.push_back(i);
+        v_states.push_back(v_state);
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < v_clients.size(); i++) {
+    if (isClientPlaying(i)) {
+      if (v_clients[i]->protocolVersion() >=
+          XM_SERVER_FRAMES_MIN_PROTOCOL_VERSION) {
+        SP2_sendFramesToClient(
+          i, v_players, v_states, i_ownFrames, i_othersFrames);
+      } else {
+        // one packet by frame for old clients
+        for (unsigned int j = 0; j < v_players.size(); j++) {
+          v_isOwn = v_players[j] == i;
+          if (v_isOwn ? i_ownFrames : i_othersFrames) {
+            NA_frame na(&(v_states[j]));
+            try {
+              m_server->sendToClient(
+                &na, i, v_isOwn ? -1 : v_clients[v_players[j]]->id(), 0);
+            } catch (Exception &e) {
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void ServerRoom::SP2_sendFramesToClient(
+  unsigned int i_client,
+  const std::vector<unsigned int> &i_players,
+  const std::vector<SerializedBikeState> &i_states,
+  bool i_ownFrames,
+  bool i_othersFrames) {
+  NetSClient *v_client = m_server->m_clients[i_client];
+  NetFramesHistory *v_history = v_client->framesHistory();
+  NA_frames v_na;
+  bool v_isPacketOpen = false;
+  std::vector<NetFrame> v_frames;
+  NetFrame v_frame;
+  const SerializedBikeState *v_base;
+  unsigned int v_baseSeq = 0;
+  bool v_hasBase = false;
+  bool v_isOwn;
+
+  for (unsigned int i = 0; i < i_players.size(); i++) {
+    v_isOwn = i_players[i] == i_client;
+
+    if (v_isOwn ? i_ownFrames : i_othersFrames) {
+      if (v_isPacketOpen == false) {
+        v_na = NA_frames(v_client->nextFramesSeq());
+        v_hasBase = v_history->lastAcknowledged(v_na.seq(), &v_baseSeq);
+        v_frames.clear();
+        v_isPacketOpen = true;
+      }
+
+      v_frame.NetId = v_isOwn ? -1 : m_server->m_clients[i_players[i]]->id();
+      v_frame.State = i_states[i];
+      v_base = v_hasBase ? v_history->getState(v_baseSeq, v_frame.NetId) : NULL;
+      v_na.add(v_frame.NetId, &(v_frame.State), v_base, v_baseSeq);
+      v_frames.push_back(v_frame);
+
+      // packets must fit in an udp datagram
+      if (v_na.isFull()) {
+        v_history->add(v_na.seq(), v_frames);
+        try {
+          m_server->sendToClient(&v_na, i_client, -1, 0);
+        } catch (Exception &e) {
+        }
+        v_isPacketOpen = false;
+      }
+    }
+  }
+
+  if (v_isPacketOpen) {
+    v_history->add(v_na.seq(), v_frames);
+    try {
+      m_server->sendToClient(&v_na, i_client, -1, 0);
+    } catch (Exception &e) {
+    }
+  }
+}
+
+void ServerRoom::SP2_updateCheckScenePlaying() {
+  Scene *v_scene;
+  bool v_nobodyPlaying = true;
+
+  for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+    v_scene = m_universe->getScenes()[i];
+    for (unsigned int j = 0; j < v_scene->Players().size(); j++) {
+      if (v_scene->Players()[j]->isDead() == false &&
+          v_scene->Players()[j]->isFinished() == false) {
+        v_nobodyPlaying = false;
+      }
+    }
+  }
+
+  if (v_nobodyPlaying) {
+    SP2_setPhase(SP2_PHASE_WAIT_CLIENTS);
+  }
+}
+
+void ServerRoom::SP2_setPhase(ServerP2Phase i_sp2phase) {
+  SP2_unsetPhase();
+  m_sp2phase = i_sp2phase;
+
+  switch (m_sp2phase) {
+    case SP2_PHASE_NONE:
+      break;
+
+    case SP2_PHASE_WAIT_CLIENTS:
+      // load rules if they changed
+      try {
+        if (m_needToReloadRules) {
+          m_needToReloadRules = false;
+          reloadRules(XM_SERVER_DEFAULT_RULES);
+        }
+      } catch (Exception &e) {
+        LogError((e.getMsg() + "\n" + m_rules->getErrorMsg()).c_str());
+      }
+      break;
+
+    case SP2_PHASE_PLAYING:
+      m_firstFrameSent = GameApp::getXMTimeInt();
+      m_sp2_gameStarted = false;
+      try {
+        SP2_initPlaying();
+      } catch (Exception &e) {
+        LogWarning("Unable to init playing (%s)", e.getMsg().c_str());
+        SP2_setPhase(SP2_PHASE_WAIT_CLIENTS);
+      }
+      break;
+  }
+}
+
+void ServerRoom::SP2_unsetPhase() {
+  switch (m_sp2phase) {
+    case SP2_PHASE_NONE:
+      break;
+
+    case SP2_PHASE_WAIT_CLIENTS:
+      break;
+
+    case SP2_PHASE_PLAYING:
+      SP2_uninitPlaying();
+
+      /* update scores */
+      sendPointsToSlavePlayers();
+      break;
+  }
+}
+
+void ServerRoom::sendToAllClientsMarkedToPlay(NetAction *i_netAction,
+                                              int i_src,
+                                              int i_subsrc,
+                                              int i_except) {
+  for (unsigned int i = 0; i < m_server->m_clients.size(); i++) {
+    if ((int)i != i_except && isClientPlaying(i)) {
+      try {
+        m_server->sendToClient(i_netAction, i, i_src, i_subsrc);
+      } catch (Exception &e) {
+        // don't remove the client while removeclient function can call
+        // sendToAllClients ...
+      }
+    }
+  }
+}
+
+void ServerRoom::sendPointsToSlavePlayers() {
+  for (unsigned int i = 0; i < m_server->m_clients.size(); i++) {
+    if (isClientInRoom(i) &&
+        m_server->m_clients[i]->mode() == NETCLIENT_SLAVE_MODE) {
+      sendPointsToClient(i);
+    }
+  }
+}
+
+void ServerRoom::sendPointsToClient(unsigned int i_client) {
+  NA_slaveClientsPoints nascp;
+  NetPointsClient npc;
+  std::vector<NetSClient *> &v_clients = m_server->m_clients;
+
+  try {
+    for (unsigned int i = 0; i < v_clients.size(); i++) {
+      if (isClientInRoom(i) && v_clients[i]->mode() == NETCLIENT_SLAVE_MODE) {
+        if (i == i_client) {
+          npc.NetId = -1;
+        } else {
+          npc.NetId = v_clients[i]->id();
+        }
+        npc.Points = v_clients[i]->points();
+        nascp.add(&npc);
+      }
+    }
+    m_server->sendToClient(&nascp, i_client, -1, 0);
+  } catch (Exception &e) {
+  }
+}
+
+void ServerRoom::removeClient(unsigned int i_client) {
+  NetSClient *v_client = m_server->m_clients[i_client];
+
+  // remove the client from the scene if he is playing
+  if (m_universe != NULL) {
+    if (v_client->isMarkedToPlay()) {
+      m_universe->getScenes()[v_client->getNumScene()]->killPlayer(
+        v_client->getNumPlayer());
+    }
+  }
+
+  // trigger the rules actions by removing the player of the sp2
+  v_client->markToPlay(m_rules, false);
+}
+
+NetSClient *ServerRoom::getNetSClientByScenePlayer(
+  unsigned int i_numScene,
+  unsigned int i_numPlayer) const {
+  for (unsigned int i = 0; i < m_server->m_clients.size(); i++) {
+    if (isClientPlaying(i)) {
+      if (m_server->m_clients[i]->getNumScene() == i_numScene) {
+        if (m_server->m_clients[i]->getNumPlayer() == i_numPlayer) {
+          return m_server->m_clients[i];
+        }
+      }
+    }
+  }
+  return NULL;
+}
+
+NetSClient *ServerRoom::getNetSClientById(unsigned int i_id) const {
+  return m_server->getNetSClientById(i_id);
+}
+
+ServerRules *ServerRoom::getRules() {
+  return m_rules;
+}
+
+Universe *ServerRoom::getUniverse() {
+  return m_universe;
+}
+
+void ServerRoom::askToReloadRules() {
+  m_needToReloadRules = true;
+}
+
+void ServerRoom::reloadRules(const std::string &i_rulesFile) {
+  std::vector<NetSClient *> &v_clients = m_server->m_clients;
+
+  if (m_rules != NULL) {
+    delete m_rules;
+  }
+  m_rules = new ServerRules(this);
+
+  // init player points
+  for (unsigned int i = 0; i < v_clients.size(); i++) {
+    if (isClientInRoom(i)) {
+      v_clients[i]->setPoints(0);
+    }
+  }
+
+  m_rules->loadScriptFile(i_rulesFile);
+  m_rules->scriptCallVoid("Global_init");
+
+  // simulate the Global_whenPlayer_added for players as the rule ignore these
+  // players
+  for (unsigned int i = 0; i < v_clients.size(); i++) {
+    if (isClientInRoom(i) && v_clients[i]->mode() == NETCLIENT_SLAVE_MODE) {
+      m_rules->scriptCallVoidNumberArg("Global_whenPlayer_added",
+                                       v_clients[i]->id());
+    }
+  }
+}
+
+XMServerSceneHooks::XMServerSceneHooks(ServerRoom *i_room) {
+  m_room = i_room;
+}
+
+XMServerSceneHooks::~XMServerSceneHooks() {}
+
+void XMServerSceneHooks::OnEntityToTakeTakenByPlayer(unsigned int i_player) {
+  // only one scene is managed per room -- for the moment
+  NetSClient *v_client = m_room->getNetSClientByScenePlayer(0, i_player);
+
+  if (v_client != NULL) {
+    try {
+      m_room->getRules()->scriptCallVoidNumberArg(
+        "Round_whenPlayer_onEntityToTakeTaken", v_client->id());
+    } catch (Exception &e) {
+      // continue the game even if the rules are badly written
+      LogError(std::string("Rules: " + e.getMsg()).c_str());
+    }
+  }
+}
+
+void XMServerSceneHooks::OnEntityToTakeTakenExternal() {
+  try {
+    m_room->getRules()->scriptCallVoid(
+      "Round_whenExternal_onEntityToTakeTaken");
+  } catch (Exception &e) {
+    // continue the game even if the rules are badly written
+    LogError(std::string("Rules: " + e.getMsg()).c_str());
+  }
+}
+
+void XMServerSceneHooks::OnPlayerWins(unsigned int i_player) {
+  // only one scene is managed per room -- for the moment
+  NetSClient *v_client = m_room->getNetSClientByScenePlayer(0, i_player);
+
+  if (v_client != NULL) {
+    try {
+      m_room->getRules()->scriptCallVoidNumberArg("Round_whenPlayer_wins",
+                                                  v_client->id());
+    } catch (Exception &e) {
+      // continue the game even if the rules are badly written
+      LogError(std::string("Rules: " + e.getMsg()).c_str());
+    }
+  }
+}
+
+void XMServerSceneHooks::OnPlayerDies(unsigned int i_player) {
+  // only one scene is managed per room -- for the moment
+  NetSClient *v_client = m_room->getNetSClientByScenePlayer(0, i_player);
+
+  if (v_client != NULL) {
+    try {
+      m_room->getRules()->scriptCallVoidNumberArg("Round_whenPlayer_dies",
+                                                  v_client->id());
+    } catch (Exception &e) {
+      // continue the game even if the rules are badly written
+      LogError(std::string("Rules: " + e.getMsg()).c_str());
+    }
+  }
+}
+
+void XMServerSceneHooks::OnPlayerSomersault(unsigned int i_player,
+                                            bool i_counterclock) {
+  // only one scene is managed per room -- for the moment
+  NetSClient *v_client = m_room->getNetSClientByScenePlayer(0, i_player);
+
+  if (v_client != NULL) {
+    try {
+      m_room->getRules()->scriptCallVoidNumberArg(
+        "Round_whenPlayer_DoesASomersault",
+        v_client->id(),
+        i_counterclock ? 1 : 0);
+    } catch (Exception &e) {
+      // continue the game even if the rules are badly written
+      LogError(std::string("Rules: " + e.getMsg()).c_str());
+    }
+  }
+}
@@ -0,0 +1,151 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __SERVERROOM_H__
+#define __SERVERROOM_H__
+
+#include "../../xmscene/Scene.h"
+#include "../BasicStructures.h"
+#include <string>
+#include <vector>
+
+class NetAction;
+class NetSClient;
+class ServerThread;
+class Universe;
+class DBuffer;
+class ServerRules;
+class XMServerSceneHooks;
+
+#define XM_SERVER_DEFAULT_RULES "Rules/classical.rules"
+
+enum ServerP2Phase {
+  SP2_PHASE_NONE,
+  SP2_PHASE_WAIT_CLIENTS,
+  SP2_PHASE_PLAYING
+};
+
+/* a room is an independent party on the server : it has its own rules, its
+   own level rotation and its own universe. Clients of a room only play with
+   the other clients of the same room. */
+class ServerRoom {
+public:
+  ServerRoom(ServerThread *i_server, unsigned int i_id);
+  ~ServerRoom();
+
+  unsigned int id() const;
+  ServerP2Phase phase() const;
+  std::string playingLevelId() const;
+  unsigned int nbClients() const;
+  unsigned int nbClientsMarkedToPlay() const;
+
+  /* update the room state machine ; called once per server loop. Only
+     run_stepScenes() (the physics of the scenes) can run in parallel with the
+     other rooms, the begin and the end of the step are run by the server
+     thread */
+  void run_stepBegin();
+  void run_stepScenes();
+  void run_stepEnd();
+
+  NetSClient *getNetSClientByScenePlayer(unsigned int i_numScene,
+                                         unsigned int i_numPlayer) const;
+  NetSClient *getNetSClientById(unsigned int i_id) const;
+  Universe *getUniverse(); // NULL if no party is currently playing
+  ServerRules *getRules();
+  void sendPointsToSlavePlayers();
+  void sendPointsToClient(unsigned int i_client);
+
+  // the client leaves the room (disconnection or room change)
+  void removeClient(unsigned int i_client);
+
+  void reloadRules(const std::string &i_rulesFile);
+  void askToReloadRules();
+
+  void SP2_setPhase(ServerP2Phase i_sp2phase);
+
+private:
+  ServerThread *m_server;
+  unsigned int m_id;
+
+  Universe *m_universe;
+  DBuffer *m_DBuffer;
+  ServerP2Phase m_sp2phase;
+  std::string m_playingLevelId;
+  int m_lastPhysTime;
+  int m_currentFrame;
+  int m_sceneStartTime;
+  int m_lastPrepareToGoAlert;
+  int m_firstFrameSent; // send the first frame only one time before the game
+  // starts
+  bool m_sp2_gameStarted;
+  bool m_sp2_stepPlaying; // the current step updates the scenes
+  bool m_sp2_updateScenes; // the preplay time is over
+  bool m_sp2_updateDone;
+  bool m_sp2_firstFrame;
+
+  ServerRules *m_rules;
+  bool m_needToReloadRules; // rules are reloaded only when out of a round, not
+  // immediatly when requested
+  XMServerSceneHooks *m_sceneHook;
+
+  bool isClientInRoom(unsigned int i_client) const;
+  bool isClientPlaying(unsigned int i_client) const;
+  unsigned int nbClientsInMode(NetClientMode i_mode) const;
+  void sendToAllClientsMarkedToPlay(NetAction *i_netAction,
+                                    int i_src,
+                                    int i_subsrc,
+                                    int i_except = -1);
+
+  /* SP2 */
+  void SP2_initPlaying();
+  void SP2_uninitPlaying();
+  void SP2_updateScenePlayingBegin();
+  void SP2_updateScenesPlaying();
+  void SP2_updateScenePlayingEnd();
+  void SP2_updateCheckScenePlaying();
+  void SP2_unsetPhase();
+  void SP2_manageInactivity();
+  bool SP2_managePreplayTime();
+  std::string SP2_determineLevel();
+  void SP2_sendSceneEvents(DBuffer *i_buffer);
+  void SP2_sendFrames(bool i_ownFrames, bool i_othersFrames);
+  void SP2_sendFramesToClient(unsigned int i_client,
+                              const std::vector<unsigned int> &i_players,
+                              const std::vector<SerializedBikeState> &i_states,
+                              bool i_ownFrames,
+                              bool i_othersFrames);
+};
+
+class XMServerSceneHooks : public SceneHooks {
+public:
+  XMServerSceneHooks(ServerRoom *i_room);
+  virtual ~XMServerSceneHooks();
+
+  void OnEntityToTakeTakenByPlayer(unsigned int i_player);
+  void OnEntityToTakeTakenExternal();
+  void OnPlayerWins(unsigned int i_player);
+  void OnPlayerDies(unsigned int i_player);
+  void OnPlayerSomersault(unsigned int i_player, bool i_counterclock);
+
+private:
+  ServerRoom *m_room;
+};
+
+#endif
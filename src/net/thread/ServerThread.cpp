@@ -23,31 +23,38 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../NetActions.h"
 #include "../ServerRules.h"
 #include "../helpers/Net.h"
-#include "common/DBuffer.h"
+#include "ServerEpoll.h"
+#include "ServerRoom.h"
 #include "common/XMSession.h"
 #include "db/xmDatabase.h"
 #include "helpers/Log.h"
 #include "helpers/System.h"
 #include "helpers/VExcept.h"
+#include "helpers/WorkersPool.h"
 #include "helpers/utf8.h"
 #include "states/StateManager.h"
 #include "xmoto/Game.h"
 #include "xmoto/GameText.h"
 #include "xmoto/Universe.h"
 #include "xmscene/BikeController.h"
-#include "xmscene/Level.h"
+#include <errno.h>
 #include <sstream>
 #include <string>
 
 #define XM_SERVER_SLAVE_MODE_MIN_PROTOCOL_VERSION 1
 
-#define XM_SERVER_UPLOADING_FPS_PLAYER 40
-#define XM_SERVER_UPLOADING_FPS_OPLAYERS 15
-#define XM_SERVER_PLAYER_INACTIV_TIME_MAX 1000
-#define XM_SERVER_PLAYER_INACTIV_TIME_PREV 300
+class RoomStepJob : public WorkersPoolJob {
+public:
+  RoomStepJob(ServerRoom *i_room) { m_room = i_room; }
+
+  virtual void run() { m_room->run_stepScenes(); }
+
+private:
+  ServerRoom *m_room;
+};
+
 #define XM_SERVER_NB_SOCKETS_MAX 128
 #define XM_SERVER_MAX_UDP_PACKET_SIZE 1024 // bytes
-#define XM_SERVER_PREPLAYING_TIME 300
 #define XM_SERVER_DEFAULT_BAN_NBDAYS 30
 #define XM_SERVER_MAX_FOLLOWING_UDP 100
 #define XM_SERVER_DEFAULT_BANNER "Welcome on this server"
@@ -58,13 +65,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 // think it's private
 #define XM_SERVER_MAXIMUM_MULTI_PRIVATE_MESSAGE 3
 
-#define XM_SERVER_DEFAULT_RULES "Rules/classical.rules"
-
 NetSClient::NetSClient(unsigned int i_id,
                        TCPsocket i_tcpSocket,
                        IPaddress *i_tcpRemoteIP) {
   m_id = i_id;
   m_mode = NETCLIENT_GHOST_MODE;
+  m_room = 0;
   m_isMarkedToPlay = false;
   m_numScene = 0;
   m_numPlayer = 0;
@@ -86,6 +92,8 @@ NetSClient::NetSClient(unsigned int i_id,
   m_lastPing.id = -1;
   m_lastPing.pingTime = -1;
   m_lastPing.pongTime = -1;
+
+  m_framesSeq = 0;
 }
 
 NetSClient::~NetSClient() {
@@ -223,6 +231,14 @@ void NetSClient::setLastInactivTimeAlert(int i_time) {
   m_lastInactivTimeAlert = i_time;
 }
 
+void NetSClient::setRoom(unsigned int i_room) {
+  m_room = i_room;
+}
+
+unsigned int NetSClient::room() const {
+  return m_room;
+}
+
 void NetSClient::markToPlay(ServerRules *i_rules, bool i_value) {
   // do a rule action only if the value changes
   if (i_value != m_isMarkedToPlay) {
@@ -272,6 +288,14 @@ NetPing *NetSClient::lastPing() {
   return &m_lastPing;
 }
 
+NetFramesHistory *NetSClient::framesHistory() {
+  return &m_framesHistory;
+}
+
+unsigned int NetSClient::nextFramesSeq() {
+  return m_framesSeq++;
+}
+
 ServerThread::ServerThread(const std::string &i_dbKey,
                            int i_port,
                            const std::string &i_adminPassword)
@@ -280,24 +304,18 @@ ServerThread::ServerThread(const std::string &i_dbKey,
   m_adminPassword = i_adminPassword;
 
   m_set = NULL;
+  m_epoll = NULL;
   m_nextClientId = 0;
+  m_workersPool = new WorkersPool();
   m_udpPacket = SDLNet_AllocPacket(XM_SERVER_MAX_UDP_PACKET_SIZE);
 
-  m_universe = NULL;
-  m_DBuffer = new DBuffer();
-  m_DBuffer->initOutput(XM_NET_MAX_EVENTS_SHOT_SIZE);
-  m_sp2phase = SP2_PHASE_NONE;
-  m_lastFrameTimeStamp = -1;
-  m_frameLate = 0;
-  m_currentFrame = 0;
+  m_sp2_lastLoopTime = -1;
+  m_sp2_lastLoopDelta = 0;
   m_nFollowingUdp = 0;
   m_startTimeStr = GameApp::getTimeStamp();
   m_banner = XM_SERVER_DEFAULT_BANNER;
   m_acceptConnections = false;
   m_unmanagedActions = 0;
-  m_rules = NULL;
-  m_needToReloadRules = false;
-  m_sceneHook = new XMServerSceneHooks(this);
 
   if (!m_udpPacket) {
     throw Exception("SDLNet_AllocPacket: " + std::string(SDLNet_GetError()));
@@ -306,11 +324,8 @@ ServerThread::ServerThread(const std::string &i_dbKey,
 
 ServerThread::~ServerThread() {
   SDLNet_FreePacket(m_udpPacket);
-  delete m_DBuffer;
-  if (m_rules != NULL) {
-    delete m_rules;
-  }
-  delete m_sceneHook;
+  uninitRooms();
+  delete m_workersPool;
 }
 
 int ServerThread::realThreadFunction() {
@@ -321,11 +336,11 @@ int ServerThread::realThreadFunction() {
 
   // this is not really required here, but it will not start the server if an
   // error occurred
-  // init rules
+  // init rooms and their rules
   try {
-    reloadRules(XM_SERVER_DEFAULT_RULES);
+    initRooms(XMSession::instance()->serverRooms());
   } catch (Exception &e) {
-    LogError((e.getMsg() + "\n" + m_rules->getErrorMsg()).c_str());
+    LogError(e.getMsg().c_str());
     return 1;
   }
 
@@ -375,13 +390,29 @@ int ServerThread::realThreadFunction() {
     return 1;
   }
 
+#if HAVE_EPOLL
+  if (XMSession::instance()->serverUseEpoll()) {
+    try {
+      m_epoll = new ServerEpoll(m_tcpsd, m_udpsd);
+      NetAction::setUdpQueue(m_epoll);
+      LogInfo("server: epoll network backend");
+    } catch (Exception &e) {
+      LogWarning("server: epoll backend unavailable (%s), using SDL_net",
+                 e.getMsg().c_str());
+      m_epoll = NULL;
+    }
+  }
+#endif
+
   m_acceptConnections = true;
   if (StateManager::exists()) {
     StateManager::instance()->sendAsynchronousMessage("SERVER_STATUS_CHANGED");
   }
 
   // SP2 phase initialisation
-  SP2_setPhase(SP2_PHASE_WAIT_CLIENTS);
+  for (unsigned int i = 0; i < m_rooms.size(); i++) {
+    m_rooms[i]->SP2_setPhase(SP2_PHASE_WAIT_CLIENTS);
+  }
 
   // manage server
   while (m_askThreadToEnd == false) {
@@ -408,8 +439,10 @@ void ServerThread::close() {
   // close the server
   m_acceptConnections = false;
 
-  // end the game
-  SP2_setPhase(SP2_PHASE_NONE);
+  // end the games
+  for (unsigned int i = 0; i < m_rooms.size(); i++) {
+    m_rooms[i]->SP2_setPhase(SP2_PHASE_NONE);
+  }
 
   // disconnection
   LogInfo("server: %i client(s) still connected", m_clients.size());
@@ -421,6 +454,15 @@ void ServerThread::close() {
     i++;
   }
 
+#if HAVE_EPOLL
+  if (m_epoll != NULL) {
+    m_epoll->flushUdp();
+    NetAction::setUdpQueue(NULL);
+    delete m_epoll;
+    m_epoll = NULL;
+  }
+#endif
+
   SDLNet_TCP_DelSocket(m_set, m_tcpsd);
   SDLNet_UDP_DelSocket(m_set, m_udpsd);
 
@@ -437,447 +479,122 @@ void ServerThread::close() {
   LogInfo("server: ending normally");
 }
 
-std::string ServerThread::SP2_determineLevel() {
-  char **v_result;
-  unsigned int nrow;
-  std::string v_id_level;
-
-  // don't allow own levels (isToReload=1)
-  v_result = m_pDb->readDB(
-    "SELECT id_level "
-    "FROM levels "
-    "WHERE isToReload=0 AND isScripted=0 AND isPhysics=0 " // warning,
-    // addforcetoplayer
-    // event cannot be
-    // over network game
-    // cause player id is
-    // serialized
-    //"WHERE id_level='_iL00_' " // for tests
-    "ORDER BY RANDOM() LIMIT 1;",
-    nrow);
-  if (nrow == 0) {
-    m_pDb->read_DB_free(v_result);
-    throw Exception("Unable to get a level");
-  }
-  v_id_level = m_pDb->getResult(v_result, 1, 0, 0);
-  m_pDb->read_DB_free(v_result);
-  /* */
+void ServerThread::initRooms(unsigned int i_nbRooms) {
+  ServerRoom *v_room;
 
-  return v_id_level;
-}
+  uninitRooms();
 
-void ServerThread::SP2_initPlaying() {
-  unsigned int v_numPlayer;
-  unsigned int v_localNetId = 0;
-  std::string v_id_level;
-  m_lastPhysTime = GameApp::getXMTimeInt();
-
-  v_id_level = SP2_determineLevel();
-  NA_playingLevel v_napl(v_id_level);
-
-  m_universe = new Universe();
-  m_universe->initPlayServer();
-
-  // set hooks for the scenes
-  for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
-    m_universe->getScenes()[i]->setHooks(m_sceneHook);
+  // at least one room
+  if (i_nbRooms == 0) {
+    i_nbRooms = 1;
   }
 
-  try {
-    for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
-      v_numPlayer = 0;
-      m_universe->getScenes()[i]->loadLevel(m_pDb, v_id_level, true);
-      if (m_universe->getScenes()[i]->getLevelSrc()->isXMotoTooOld()) {
-        throw Exception("Level " + v_id_level + " is too old");
-      }
+  LogInfo("server: %u room(s)", i_nbRooms);
+  for (unsigned int i = 0; i < i_nbRooms; i++) {
+    v_room = new ServerRoom(this, i);
+    m_rooms.push_back(v_room);
 
-      m_DBuffer->clear();
-      m_universe->getScenes()[i]->prePlayLevel(m_DBuffer, true, true, false);
-      SP2_sendSceneEvents(m_DBuffer);
-
-      // add the bikers
-      for (unsigned int j = 0; j < m_clients.size(); j++) {
-        if (m_clients[j]->isMarkedToPlay()) {
-          m_universe->getScenes()[i]->addPlayerLocalBiker(
-            v_localNetId,
-            m_universe->getScenes()[i]->getLevelSrc()->PlayerStart(),
-            DD_RIGHT,
-            Theme::instance(),
-            Theme::instance()->getPlayerTheme(),
-            GameApp::getColorFromPlayerNumber(v_numPlayer),
-            GameApp::getUglyColorFromPlayerNumber(v_numPlayer),
-            false);
-          m_clients[j]->markScenePlayer(0, v_numPlayer);
-
-          // mark the player as playing the level
-          m_clients[j]->setPlayingLevelId(v_id_level);
-          sendToAllClients(&v_napl, m_clients[j]->id(), 0, j);
-
-          v_numPlayer++;
-          v_localNetId++;
-        }
-      }
-      m_universe->getScenes()[i]->playInitLevel();
+    try {
+      v_room->reloadRules(XM_SERVER_DEFAULT_RULES);
+    } catch (Exception &e) {
+      throw Exception(e.getMsg() + "\n" + v_room->getRules()->getErrorMsg());
     }
-  } catch (Exception &e) {
-    LogWarning("server: Unable to load level %s", v_id_level.c_str());
-    throw Exception("Unable to load level " + v_id_level);
   }
-
-  try {
-    std::vector<int> v_players;
-    for (unsigned int i = 0; i < m_clients.size(); i++) {
-      if (m_clients[i]->isMarkedToPlay()) {
-        v_players.push_back(m_clients[i]->id());
-      }
-    }
-
-    NA_prepareToPlay na(v_id_level, v_players);
-    sendToAllClientsMarkedToPlay(&na, -1, 0);
-  } catch (Exception &e) {
-    /* bad */
-  }
-
-  m_sceneStartTime = (GameApp::getXMTimeInt() / 10) + XM_SERVER_PREPLAYING_TIME;
-  m_lastPrepareToGoAlert = -1;
 }
 
-void ServerThread::SP2_uninitPlaying() {
-  try {
-    m_rules->scriptCallVoid("Round_whenRound_ends");
-  } catch (Exception &e) {
-    // continue the game even if the rules are badly written
-    LogError(std::string("Rules: " + e.getMsg()).c_str());
+void ServerThread::uninitRooms() {
+  for (unsigned int i = 0; i < m_rooms.size(); i++) {
+    delete m_rooms[i];
   }
-  delete m_universe;
-  m_universe = NULL;
+  m_rooms.clear();
 }
 
-void ServerThread::SP2_manageInactivity() {
-  int v_inactivDiff;
-  int v_prevTime;
-  Biker *v_player;
-  bool v_isOk;
-
-  /* kill players not playing for a too long time */
-  for (unsigned int i = 0; i < m_clients.size(); i++) {
-    if (m_clients[i]->isMarkedToPlay()) {
-      v_player = m_universe->getScenes()[m_clients[i]->getNumScene()]
-                   ->Players()[m_clients[i]->getNumPlayer()];
-
-      if (v_player->isDead() == false && v_player->isFinished() == false) {
-        v_isOk = false;
-
-        // check driving
-        if (v_player->getControler() != NULL) {
-          if (v_player->getControler()->isDriving()) {
-            m_clients[i]->setLastActivTime(GameApp::getXMTimeInt());
-            v_isOk = true;
-          }
-        }
-
-        // check last move
-        if (v_isOk == false) {
-          v_inactivDiff =
-            GameApp::getXMTimeInt() - m_clients[i]->lastActivTime();
-          if (XM_SERVER_PLAYER_INACTIV_TIME_MAX * 10 < v_inactivDiff) {
-            m_universe->getScenes()[m_clients[i]->getNumScene()]->killPlayer(
-              m_clients[i]->getNumPlayer());
-          } else {
-            v_prevTime = XM_SERVER_PLAYER_INACTIV_TIME_MAX * 10 - v_inactivDiff;
-
-            if (m_clients[i]->isMarkedToPlay() &&
-                XM_SERVER_PLAYER_INACTIV_TIME_PREV * 10 > v_prevTime) {
-              if (m_clients[i]->lastInactivTimeAlert() != v_prevTime / 1000) {
-                m_clients[i]->setLastInactivTimeAlert(v_prevTime / 1000);
-
-                NA_killAlert na(m_clients[i]->lastInactivTimeAlert() + 1);
-                try {
-                  sendToClient(&na, i, -1, 0);
-                } catch (Exception &e) {
-                  /* hehe, ok, no pb */
-                }
-              }
-            }
-          }
-        }
-      }
+bool ServerThread::isOneRoomPlaying() const {
+  for (unsigned int i = 0; i < m_rooms.size(); i++) {
+    if (m_rooms[i]->phase() == SP2_PHASE_PLAYING) {
+      return true;
     }
   }
+  return false;
 }
 
-bool ServerThread::SP2_managePreplayTime() {
-  int v_waitTime;
+void ServerThread::changeClientRoom(unsigned int i_client,
+                                    unsigned int i_room) {
+  unsigned int v_previousRoom = m_clients[i_client]->room();
 
-  if (m_sceneStartTime <= GameApp::getXMTimeInt() / 10 &&
-      m_lastPrepareToGoAlert < 0) {
-    return false;
+  if (v_previousRoom == i_room) {
+    return;
   }
 
-  v_waitTime = (m_sceneStartTime - (GameApp::getXMTimeInt() / 10)) / 100;
+  // leave the previous room : the player dies in its round
+  m_rooms[v_previousRoom]->removeClient(i_client);
+  m_clients[i_client]->setRoom(i_room);
 
-  if (v_waitTime <
-      0) { /* only the GO! has not been send and time is just under 0 */
-    m_lastPrepareToGoAlert = -1;
-    try {
-      NA_prepareToGo na(0);
-      sendToAllClientsMarkedToPlay(&na, -1, 0);
-    } catch (Exception &e) {
-      /* ok, not good */
-    }
-  } else {
-    try {
-      if (m_lastPrepareToGoAlert != v_waitTime) {
-        NA_prepareToGo na(v_waitTime + 1);
-        sendToAllClientsMarkedToPlay(&na, -1, 0);
-        m_lastPrepareToGoAlert = v_waitTime;
-      }
-    } catch (Exception &e) {
-      /* ok, not good */
-    }
-  }
+  // points are given by the rules of the room ; the rules of the new room
+  // know the player once it is marked to play for the next round
+  m_clients[i_client]->setPoints(0);
 
-  return true;
+  m_rooms[v_previousRoom]->sendPointsToSlavePlayers();
+  m_rooms[i_room]->sendPointsToSlavePlayers();
 }
 
-void ServerThread::SP2_sendSceneEvents(DBuffer *i_buffer) {
-  try {
-    if (i_buffer->isEmpty() == false) {
-      NA_gameEvents na(i_buffer);
-      sendToAllClientsMarkedToPlay(&na, -1, 0);
+void ServerThread::run_loop() {
+  int v_loopTime = GameApp::getXMTimeInt();
+  std::vector<RoomStepJob> v_jobs;
+  std::vector<WorkersPoolJob *> v_pjobs;
+
+  // the scenes of the rooms are updated in parallel ; the hooks and the
+  // network sends they do are serialized by Scene::lockSharedResources(), the
+  // rest of the step (rules, inactivity, events and frames) stays here
+  for (unsigned int i = 0; i < m_rooms.size(); i++) {
+    m_rooms[i]->run_stepBegin();
+  }
+
+  v_jobs.reserve(m_rooms.size());
+  for (unsigned int i = 0; i < m_rooms.size(); i++) {
+    if (m_rooms[i]->phase() == SP2_PHASE_PLAYING) {
+      v_jobs.push_back(RoomStepJob(m_rooms[i]));
+      v_pjobs.push_back(&v_jobs.back());
     }
-  } catch (Exception &e) {
-    /* ok, not good */
   }
-}
-
-void ServerThread::SP2_updateScenePlaying() {
-  int nPhysSteps;
-  Scene *v_scene;
-  SerializedBikeState BikeState;
-  bool v_updateDone = false;
-  bool v_firstFrame = false;
-
-  if (SP2_managePreplayTime() == false) {
-    // manage the first time the update is done
-    if (m_sp2_gameStarted == false) {
-      m_sp2_gameStarted = true;
-
-      try {
-        m_rules->scriptCallVoid("Round_whenRound_begins");
-      } catch (Exception &e) {
-        // continue the game even if the rules are badly written
-        LogError(std::string("Rules: " + e.getMsg()).c_str());
-      }
-    }
-
-    SP2_manageInactivity();
-
-    /* update the scene */
-    m_DBuffer->clear();
-    nPhysSteps = 0;
-
-    while (m_lastPhysTime + (PHYS_STEP_SIZE * 10) <= GameApp::getXMTimeInt() &&
-           nPhysSteps < 10) {
-      for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
-        v_scene = m_universe->getScenes()[i];
-        v_scene->updateLevel(PHYS_STEP_SIZE,
-                             NULL,
-                             m_DBuffer,
-                             nPhysSteps != 0,
-                             false /* no particles */,
-                             false /* don't update died players */);
-      }
-      v_updateDone = true;
-      m_lastPhysTime += PHYS_STEP_SIZE * 10;
-      nPhysSteps++;
-    }
 
-    // if the delay is too long, reinitialize -- don't skip in server mode
-    // if(m_fLastPhysTime + PHYS_STEP_SIZE/100.0 < GameApp::getXMTime()) {
-    //  m_fLastPhysTime = GameApp::getXMTime();
-    //}
-    SP2_sendSceneEvents(m_DBuffer);
+  if (v_pjobs.size() == 1) {
+    v_pjobs[0]->run(); // don't wake the pool for a single room
   } else {
-    /* send the first frame regularly, so that the client received it once ready
-     */
-    if (GameApp::getXMTimeInt() - m_firstFrameSent >
-        100) { /* 100 => 10 times / seconde */
-      m_firstFrameSent = GameApp::getXMTimeInt();
-      v_firstFrame = true;
-    }
-    // initialize the physics time
-    m_lastPhysTime = GameApp::getXMTimeInt();
-  }
-
-  // send to each client his frame and the frame of the others
-  if (v_updateDone || v_firstFrame) {
-    if (v_firstFrame ||
-        (m_currentFrame % (100 / XM_SERVER_UPLOADING_FPS_PLAYER) == 0 ||
-         m_currentFrame % (100 / XM_SERVER_UPLOADING_FPS_OPLAYERS) == 0)) {
-      for (unsigned int i = 0; i < m_clients.size(); i++) {
-        if (m_clients[i]->isMarkedToPlay()) {
-          v_scene = m_universe->getScenes()[m_clients[i]->getNumScene()];
-
-          if (v_scene->Players()[m_clients[i]->getNumPlayer()]->isDead() ==
-              false) {
-            v_scene->getSerializedBikeState(
-              v_scene->Players()[m_clients[i]->getNumPlayer()]->getState(),
-              v_scene->getTime(),
-              &BikeState,
-              v_scene->getPhysicsSettings());
-            NA_frame na(&BikeState);
-            try {
-              if (v_firstFrame ||
-                  m_currentFrame % (100 / XM_SERVER_UPLOADING_FPS_PLAYER) ==
-                    0) {
-                sendToClient(&na, i, -1, 0);
-              }
-              if (v_firstFrame ||
-                  m_currentFrame % (100 / XM_SERVER_UPLOADING_FPS_OPLAYERS) ==
-                    0) {
-                sendToAllClientsMarkedToPlay(&na, m_clients[i]->id(), 0, i);
-              }
-            } catch (Exception &e) {
-            }
-          }
-        }
-      }
-    }
-    m_currentFrame = (m_currentFrame + 1) % 1000;
+    m_workersPool->run(v_pjobs);
   }
-}
 
-void ServerThread::SP2_updateCheckScenePlaying() {
-  Scene *v_scene;
-  bool v_nobodyPlaying = true;
-
-  for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
-    v_scene = m_universe->getScenes()[i];
-    for (unsigned int j = 0; j < v_scene->Players().size(); j++) {
-      if (v_scene->Players()[j]->isDead() == false &&
-          v_scene->Players()[j]->isFinished() == false) {
-        v_nobodyPlaying = false;
-      }
-    }
+  for (unsigned int i = 0; i < m_rooms.size(); i++) {
+    m_rooms[i]->run_stepEnd();
   }
 
-  if (v_nobodyPlaying) {
-    SP2_setPhase(SP2_PHASE_WAIT_CLIENTS);
+  if (isOneRoomPlaying() == false) {
+    m_sp2_lastLoopTime = -1;
+    manageNetwork(-1); // wait a network event
+    return;
   }
-}
-
-void ServerThread::SP2_setPhase(ServerP2Phase i_sp2phase) {
-  SP2_unsetPhase();
-  m_sp2phase = i_sp2phase;
 
-  switch (m_sp2phase) {
-    case SP2_PHASE_NONE:
-      break;
-
-    case SP2_PHASE_WAIT_CLIENTS:
-      // load rules if they changed
-      try {
-        if (m_needToReloadRules) {
-          m_needToReloadRules = false;
-          reloadRules(XM_SERVER_DEFAULT_RULES);
-        }
-      } catch (Exception &e) {
-        LogError((e.getMsg() + "\n" + m_rules->getErrorMsg()).c_str());
-      }
-      break;
-
-    case SP2_PHASE_PLAYING:
-      m_firstFrameSent = GameApp::getXMTimeInt();
-      m_sp2_gameStarted = false;
-      m_sp2_lastLoopTime = -1;
-      try {
-        SP2_initPlaying();
-      } catch (Exception &e) {
-        LogWarning("Unable to init playing (%s)", e.getMsg().c_str());
-        SP2_setPhase(SP2_PHASE_WAIT_CLIENTS);
-      }
-      break;
+  // update the delta time to the reality
+  if (m_sp2_lastLoopTime == -1) {
+    m_sp2_lastLoopDelta = 0; // initialize the delta
+  } else {
+    m_sp2_lastLoopDelta +=
+      (v_loopTime - m_sp2_lastLoopTime) - 10; // update the delta
   }
-}
-
-void ServerThread::SP2_unsetPhase() {
-  switch (m_sp2phase) {
-    case SP2_PHASE_NONE:
-      break;
-
-    case SP2_PHASE_WAIT_CLIENTS:
-      break;
-
-    case SP2_PHASE_PLAYING:
-      SP2_uninitPlaying();
-
-      /* update scores */
-      sendPointsToSlavePlayers();
-      break;
+  // too much delta, reset the delta
+  if (m_sp2_lastLoopDelta > 100 || m_sp2_lastLoopDelta < -100) {
+    m_sp2_lastLoopDelta = 0;
   }
-}
+  m_sp2_lastLoopTime = v_loopTime;
 
-unsigned int ServerThread::nbClientsInMode(NetClientMode i_mode) {
-  unsigned int n = 0;
-
-  for (unsigned int i = 0; i < m_clients.size(); i++) {
-    if (m_clients[i]->mode() == i_mode) {
-      n++;
-    }
-  }
-
-  return n;
-}
-
-void ServerThread::run_loop() {
-  switch (m_sp2phase) {
-    case SP2_PHASE_NONE:
-      manageNetwork(-1); // wait a network event
-      break;
-
-    case SP2_PHASE_WAIT_CLIENTS:
-      if (nbClientsInMode(NETCLIENT_SLAVE_MODE) > 0) {
-        // mark clients as to play
-        for (unsigned int i = 0; i < m_clients.size(); i++) {
-          if (m_clients[i]->mode() == NETCLIENT_SLAVE_MODE) {
-            m_clients[i]->markToPlay(m_rules, true);
-          }
-        }
-        SP2_setPhase(SP2_PHASE_PLAYING);
-      } else {
-        manageNetwork(-1); // wait a network event
-      }
-      break;
-
-    case SP2_PHASE_PLAYING:
-      // update the delta time to the reality
-      if (m_sp2_lastLoopTime == -1) {
-        m_sp2_lastLoopDelta = 0; // initialize the delta
-      } else {
-        m_sp2_lastLoopDelta += (GameApp::getXMTimeInt() - m_sp2_lastLoopTime) -
-                               10; // update the delta
-      }
-      // too much delta, reset the delta
-      if (m_sp2_lastLoopDelta > 100 || m_sp2_lastLoopDelta < -100) {
-        m_sp2_lastLoopDelta = 0;
-      }
-      m_sp2_lastLoopTime = GameApp::getXMTimeInt();
-
-      SP2_updateScenePlaying();
-      SP2_updateCheckScenePlaying();
-
-      // mange the network according to time spent
-      // what is the remaing time on the 0.01s allowed
-      int v_remainingTime = 10 -
-                            (GameApp::getXMTimeInt() - m_sp2_lastLoopTime) -
-                            m_sp2_lastLoopDelta;
-      if (v_remainingTime > 0) {
-        manageNetwork(v_remainingTime);
-      } else {
-        manageNetwork(0); // do at least one loop
-      }
-      break;
+  // mange the network according to time spent
+  // what is the remaing time on the 0.01s allowed
+  int v_remainingTime = 10 - (GameApp::getXMTimeInt() - m_sp2_lastLoopTime) -
+                        m_sp2_lastLoopDelta;
+  if (v_remainingTime > 0) {
+    manageNetwork(v_remainingTime);
+  } else {
+    manageNetwork(0); // do at least one loop
   }
 }
 
@@ -901,6 +618,10 @@ bool ServerThread::manageNetworkOnePacket(int i_timeout) {
   unsigned int i;
   bool v_needMore = false;
 
+  if (m_epoll != NULL) {
+    return manageNetworkEpoll(i_timeout);
+  }
+
   n_activ = SDLNet_CheckSockets(m_set, i_timeout);
   if (n_activ == -1) {
     LogError("SDLNet_CheckSockets: %s", SDLNet_GetError());
@@ -932,31 +653,8 @@ bool ServerThread::manageNetworkOnePacket(int i_timeout) {
         i = 0;
         while (i < m_clients.size()) {
           if (SDLNet_SocketReady(*(m_clients[i]->tcpSocket()))) {
-            try {
-              if (manageClientTCP(i) == false) {
-                removeClient(i);
-              } else {
-                i++;
-              }
-            } catch (Exception &e) {
-              if (e.getMsg() == "Disconnected") { // catch(DisconnectedException
-                // &e) won't work, i don't
-                // understand why
-                LogInfo("server: client %u disconnected (%s:%d) : %s",
-                        i,
-                        XMNet::getIp(m_clients[i]->tcpRemoteIP()).c_str(),
-                        SDLNet_Read16(&(m_clients[i]->tcpRemoteIP())->port),
-                        e.getMsg().c_str());
-                removeClient(i);
-              } else {
-                LogInfo(
-                  "server: bad TCP packet received by client %u (%s:%d) : %s",
-                  i,
-                  XMNet::getIp(m_clients[i]->tcpRemoteIP()).c_str(),
-                  SDLNet_Read16(&(m_clients[i]->tcpRemoteIP())->port),
-                  e.getMsg().c_str());
-                removeClient(i);
-              }
+            if (manageClientTCPReady(i)) {
+              i++;
             }
           } else {
             i++;
@@ -972,24 +670,101 @@ bool ServerThread::manageNetworkOnePacket(int i_timeout) {
   return v_needMore;
 }
 
-void ServerThread::removeClient(unsigned int i) {
-  // remove the client from the scene if he is playing
-  if (m_universe != NULL) {
-    if (m_clients[i]->isMarkedToPlay()) {
-      m_universe->getScenes()[m_clients[i]->getNumScene()]->killPlayer(
-        m_clients[i]->getNumPlayer());
+bool ServerThread::manageNetworkEpoll(int i_timeout) {
+#if HAVE_EPOLL
+  int n_activ;
+  unsigned int v_nbPackets;
+  unsigned int v_client;
+  bool v_needMore = false;
+
+  // the answers of the previous step are sent before waiting
+  m_epoll->flushUdp();
+
+  n_activ = m_epoll->wait(i_timeout);
+  if (n_activ == -1) {
+    LogError("server: epoll_wait: %s", strerror(errno));
+    m_askThreadToEnd = true;
+  } else if (n_activ > 0) {
+    v_needMore = true;
+
+    // all the ready sockets are managed at once, no tcp famine possible
+    for (int j = 0; j < n_activ; j++) {
+      if (m_epoll->isTcpServerEvent(j)) {
+        acceptClient();
+      } else if (m_epoll->isUdpEvent(j)) {
+        v_nbPackets = m_epoll->receiveUdp();
+        for (unsigned int k = 0; k < v_nbPackets; k++) {
+          m_epoll->getUdpPacket(k, m_udpPacket);
+          manageUDPPacket();
+        }
+      } else {
+        try {
+          v_client = getClientById(m_epoll->clientIdOfEvent(j));
+        } catch (Exception &e) {
+          continue; // removed while managing a previous event
+        }
+        manageClientTCPReady(v_client);
+      }
     }
+
+    m_epoll->flushUdp();
+  }
+
+  // remove client marked to be removed
+  cleanClientsMarkedToBeRemoved();
+
+  return v_needMore;
+#else
+  return false;
+#endif
+}
+
+bool ServerThread::manageClientTCPReady(unsigned int i) {
+  try {
+    if (manageClientTCP(i) == false) {
+      removeClient(i);
+      return false;
+    }
+  } catch (Exception &e) {
+    // catch(DisconnectedException &e) won't work, i don't understand why
+    if (e.getMsg() == "Disconnected") {
+      LogInfo("server: client %u disconnected (%s:%d) : %s",
+              i,
+              XMNet::getIp(m_clients[i]->tcpRemoteIP()).c_str(),
+              SDLNet_Read16(&(m_clients[i]->tcpRemoteIP())->port),
+              e.getMsg().c_str());
+    } else {
+      LogInfo("server: bad TCP packet received by client %u (%s:%d) : %s",
+              i,
+              XMNet::getIp(m_clients[i]->tcpRemoteIP()).c_str(),
+              SDLNet_Read16(&(m_clients[i]->tcpRemoteIP())->port),
+              e.getMsg().c_str());
+    }
+    removeClient(i);
+    return false;
+  }
+
+  return true;
+}
+
+void ServerThread::removeClient(unsigned int i) {
+  // remove the client from its room (scene and rules)
+  if (m_clients[i]->room() < m_rooms.size()) {
+    m_rooms[m_clients[i]->room()]->removeClient(i);
   }
 
-  SDLNet_TCP_DelSocket(m_set, *(m_clients[i]->tcpSocket()));
+  if (m_epoll != NULL) {
+#if HAVE_EPOLL
+    m_epoll->removeClient(*(m_clients[i]->tcpSocket()));
+#endif
+  } else {
+    SDLNet_TCP_DelSocket(m_set, *(m_clients[i]->tcpSocket()));
+  }
   SDLNet_TCP_Close(*(m_clients[i]->tcpSocket()));
   if (m_clients[i]->isUdpBinded()) {
     m_clients[i]->unbindUdp();
   }
 
-  // trigger the rules actions by removing the player of the sp2
-  m_clients[i]->markToPlay(m_rules, false);
-
   // send new client to other clients
   NA_changeClients nacc;
   NetInfosClient nic;
@@ -1050,22 +825,6 @@ void ServerThread::sendToAllClients(NetAction *i_netAction,
     NETCLIENT_ANY_MODE, i_netAction, i_src, i_subsrc, i_except);
 }
 
-void ServerThread::sendToAllClientsMarkedToPlay(NetAction *i_netAction,
-                                                int i_src,
-                                                int i_subsrc,
-                                                int i_except) {
-  for (unsigned int i = 0; i < m_clients.size(); i++) {
-    if ((int)i != i_except && m_clients[i]->isMarkedToPlay()) {
-      try {
-        sendToClient(i_netAction, i, i_src, i_subsrc);
-      } catch (Exception &e) {
-        // don't remove the client while removeclient function can call
-        // sendToAllClients ...
-      }
-    }
-  }
-}
-
 void ServerThread::sendToAllClientsHavingProtocol(int i_protocol,
                                                   NetAction *i_netAction_lt,
                                                   NetAction *i_netAction_ge,
@@ -1123,34 +882,6 @@ void ServerThread::sendToAllClientsHavingModeAndProtocol(
   }
 }
 
-void ServerThread::sendPointsToSlavePlayers() {
-  for (unsigned int i = 0; i < m_clients.size(); i++) {
-    if (m_clients[i]->mode() == NETCLIENT_SLAVE_MODE) {
-      sendPointsToClient(i);
-    }
-  }
-}
-
-void ServerThread::sendPointsToClient(unsigned int i_client) {
-  NA_slaveClientsPoints nascp;
-  NetPointsClient npc;
-  try {
-    for (unsigned int i = 0; i < m_clients.size(); i++) {
-      if (m_clients[i]->mode() == NETCLIENT_SLAVE_MODE) {
-        if (i == i_client) {
-          npc.NetId = -1;
-        } else {
-          npc.NetId = m_clients[i]->id();
-        }
-        npc.Points = m_clients[i]->points();
-        nascp.add(&npc);
-      }
-    }
-    sendToClient(&nascp, i_client, -1, 0);
-  } catch (Exception &e) {
-  }
-}
-
 void ServerThread::acceptClient() {
   TCPsocket csd;
   IPaddress *tcpRemoteIP;
@@ -1200,11 +931,23 @@ void ServerThread::acceptClient() {
     return;
   }
 
-  scn = SDLNet_TCP_AddSocket(m_set, csd);
-  if (scn == -1) {
-    LogError("server: SDLNet_TCP_AddSocket: %s", SDLNet_GetError());
-    SDLNet_TCP_Close(csd);
-    return;
+  if (m_epoll != NULL) {
+#if HAVE_EPOLL
+    try {
+      m_epoll->addClient(csd, m_nextClientId);
+    } catch (Exception &e) {
+      LogError("server: %s", e.getMsg().c_str());
+      SDLNet_TCP_Close(csd);
+      return;
+    }
+#endif
+  } else {
+    scn = SDLNet_TCP_AddSocket(m_set, csd);
+    if (scn == -1) {
+      LogError("server: SDLNet_TCP_AddSocket: %s", SDLNet_GetError());
+      SDLNet_TCP_Close(csd);
+      return;
+    }
   }
 
   m_clients.push_back(new NetSClient(m_nextClientId++, csd, tcpRemoteIP));
@@ -1227,90 +970,95 @@ bool ServerThread::manageClientTCP(unsigned int i) {
 }
 
 void ServerThread::manageClientUDP() {
+  if (SDLNet_UDP_Recv(m_udpsd, m_udpPacket) == 1) {
+    manageUDPPacket();
+  }
+}
+
+void ServerThread::manageUDPPacket() {
   bool v_managedPacket;
 
-  if (SDLNet_UDP_Recv(m_udpsd, m_udpPacket) == 1) {
-    v_managedPacket = false;
-    for (unsigned int i = 0; i < m_clients.size(); i++) {
-      if (m_clients[i]->udpRemoteIP()->host == m_udpPacket->address.host &&
-          m_clients[i]->udpRemoteIP()->port == m_udpPacket->address.port) {
-        v_managedPacket = true;
-        try {
-          ActionReader::UDPReadAction(
-            m_udpPacket->data, m_udpPacket->len, &m_preAllocatedNA);
-          if (manageAction(m_preAllocatedNA.master, i) == false) {
-            removeClient(i);
-            return;
-          }
-        } catch (Exception &e) {
-          m_unmanagedActions++;
-
-          // ok, a bad packet received, forget it
-          LogWarning(
-            "server: bad UDP packet received by client %u (%s:%i) : %s",
-            i,
-            XMNet::getIp(&(m_udpPacket->address)).c_str(),
-            SDLNet_Read16(&(m_udpPacket->address.port)),
-            e.getMsg().c_str());
+  v_managedPacket = false;
+  for (unsigned int i = 0; i < m_clients.size(); i++) {
+    if (m_clients[i]->udpRemoteIP()->host == m_udpPacket->address.host &&
+        m_clients[i]->udpRemoteIP()->port == m_udpPacket->address.port) {
+      v_managedPacket = true;
+      try {
+        ActionReader::UDPReadAction(
+          m_udpPacket->data, m_udpPacket->len, &m_preAllocatedNA);
+        if (manageAction(m_preAllocatedNA.master, i) == false) {
+          removeClient(i);
+          return;
         }
-        break; // stop : only one client
+      } catch (Exception &e) {
+        m_unmanagedActions++;
+
+        // ok, a bad packet received, forget it
+        LogWarning(
+          "server: bad UDP packet received by client %u (%s:%i) : %s",
+          i,
+          XMNet::getIp(&(m_udpPacket->address)).c_str(),
+          SDLNet_Read16(&(m_udpPacket->address.port)),
+          e.getMsg().c_str());
       }
+      break; // stop : only one client
     }
+  }
 
-    // anonym packet ? find the associated client
-    if (v_managedPacket == false) {
-      try {
-        ActionReader::UDPReadAction(
-          m_udpPacket->data, m_udpPacket->len, &m_preAllocatedNA);
-        if (m_preAllocatedNA.master->actionType() == TNA_udpBind) {
-          for (unsigned int i = 0; i < m_clients.size(); i++) {
-            if (m_clients[i]->isUdpBinded() == false) {
-              if (m_clients[i]->udpBindKey() ==
-                  ((NA_udpBind *)m_preAllocatedNA.master)->key()) {
-                // LogInfo("UDP bind key received via UDP: %s",
-                // ((NA_udpBind*)v_netAction)->key().c_str());
-                m_clients[i]->bindUdp(m_udpPacket->address);
-                if (m_clients[i]->protocolVersion() >=
-                    3) { // don't send if the version is lower because the
-                  // client will not understand -- udp could not work in
-                  // that case
-                  LogInfo("server: i can receive udp from the client %i", i);
-
-                  NA_udpBindValidation nabv;
-                  try {
-                    sendToClient(&nabv, i, -1, 0);
-                  } catch (Exception &e) {
-                  }
+  // anonym packet ? find the associated client
+  if (v_managedPacket == false) {
+    try {
+      ActionReader::UDPReadAction(
+        m_udpPacket->data, m_udpPacket->len, &m_preAllocatedNA);
+      if (m_preAllocatedNA.master->actionType() == TNA_udpBind) {
+        for (unsigned int i = 0; i < m_clients.size(); i++) {
+          if (m_clients[i]->isUdpBinded() == false) {
+            if (m_clients[i]->udpBindKey() ==
+                ((NA_udpBind *)m_preAllocatedNA.master)->key()) {
+              // LogInfo("UDP bind key received via UDP: %s",
+              // ((NA_udpBind*)v_netAction)->key().c_str());
+              m_clients[i]->bindUdp(m_udpPacket->address);
+              if (m_clients[i]->protocolVersion() >=
+                  3) { // don't send if the version is lower because the
+                // client will not understand -- udp could not work in
+                // that case
+                LogInfo("server: i can receive udp from the client %i", i);
+
+                NA_udpBindValidation nabv;
+                try {
+                  sendToClient(&nabv, i, -1, 0);
+                } catch (Exception &e) {
+                }
 
-                  NA_udpBind nab("XMS");
-                  try {
-                    // send the packet 3 times to get more change it arrives
-                    for (unsigned int j = 0; j < 3; j++) {
-                      sendToClient(&nab, i, -1, 0, true);
-                    }
-                  } catch (Exception &e) {
+                NA_udpBind nab("XMS");
+                try {
+                  // send the packet 3 times to get more change it arrives
+                  for (unsigned int j = 0; j < 3; j++) {
+                    sendToClient(&nab, i, -1, 0, true);
                   }
+                } catch (Exception &e) {
                 }
-                break; // stop : only one client
               }
+              break; // stop : only one client
             }
           }
-        } else {
-          LogWarning("Packet of unknown client received");
         }
-      } catch (Exception &e) {
-        m_unmanagedActions++;
-
-        /* forget this bad packet */
-        LogWarning("server: bad anonym UDP packet received by %s:%i",
-                   XMNet::getIp(&(m_udpPacket->address)).c_str(),
-                   SDLNet_Read16(&(m_udpPacket->address.port)));
+      } else {
+        LogWarning("Packet of unknown client received");
       }
+    } catch (Exception &e) {
+      m_unmanagedActions++;
+
+      /* forget this bad packet */
+      LogWarning("server: bad anonym UDP packet received by %s:%i",
+                 XMNet::getIp(&(m_udpPacket->address)).c_str(),
+                 SDLNet_Read16(&(m_udpPacket->address.port)));
     }
   }
 }
 
 bool ServerThread::manageAction(NetAction *i_netAction, unsigned int i_client) {
+  Universe *v_universe;
   Scene *v_scene;
   unsigned int v_numPlayer;
 
@@ -1320,6 +1068,7 @@ bool ServerThread::manageAction(NetAction *i_netAction, unsigned int i_client) {
       break;
 
     case TNA_udpBindQuery:
+    case TNA_frames:
     case TNA_serverError:
     case TNA_changeClients:
     case TNA_slaveClientsPoints:
@@ -1511,6 +1260,11 @@ bool ServerThread::manageAction(NetAction *i_netAction, unsigned int i_client) {
       }
     } break;
 
+    case TNA_framesAck: {
+      m_clients[i_client]->framesHistory()->acknowledge(
+        ((NA_framesAck *)i_netAction)->seq());
+    } break;
+
     case TNA_changeName: {
       m_clients[i_client]->setName(((NA_changeName *)i_netAction)->getName());
       if (m_clients[i_client]->name() == "") {
@@ -1573,9 +1327,10 @@ bool ServerThread::manageAction(NetAction *i_netAction, unsigned int i_client) {
     } break;
 
     case TNA_playerControl: {
-      if (m_universe != NULL) {
+      v_universe = m_rooms[m_clients[i_client]->room()]->getUniverse();
+      if (v_universe != NULL && m_clients[i_client]->isMarkedToPlay()) {
         m_clients[i_client]->setLastActivTime(GameApp::getXMTimeInt());
-        v_scene = m_universe->getScenes()[m_clients[i_client]->getNumScene()];
+        v_scene = v_universe->getScenes()[m_clients[i_client]->getNumScene()];
         v_numPlayer = m_clients[i_client]->getNumPlayer();
 
         // apply the control on the client
@@ -1632,7 +1387,7 @@ bool ServerThread::manageAction(NetAction *i_netAction, unsigned int i_client) {
       if (((NA_clientMode *)i_netAction)->mode() == NETCLIENT_SLAVE_MODE) {
         // send current scores to the player
         if (m_clients[i_client]->protocolVersion() >= 5) {
-          sendPointsToClient(i_client);
+          m_rooms[m_clients[i_client]->room()]->sendPointsToClient(i_client);
         }
       }
     } break;
@@ -1682,6 +1437,8 @@ void ServerThread::manageSrvCmd(unsigned int i_client,
       v_answer += "help: invalid arguments\n";
     } else {
       v_answer += "help: list commands\n";
+      v_answer += "lsrooms: list rooms\n";
+      v_answer += "join <id room>: play in room <id room>\n";
       v_answer += "login [password]: connect on the server\n";
       v_answer += "logout: disconnect from the server\n";
       v_answer += "changepassword <password>: change your password\n";
@@ -1714,6 +1471,40 @@ void ServerThread::manageSrvCmd(unsigned int i_client,
       v_answer += "Type help to get more information";
     }
 
+  } else if (v_args[0] == "lsrooms") {
+    if (v_args.size() != 1) {
+      v_answer += "lsrooms: invalid arguments\n";
+    } else {
+      char v_roomstr[64];
+
+      for (unsigned int i = 0; i < m_rooms.size(); i++) {
+        snprintf(v_roomstr,
+                 64,
+                 "%5u: %3u player(s) %3u playing %-16s%s",
+                 m_rooms[i]->id(),
+                 m_rooms[i]->nbClients(),
+                 m_rooms[i]->nbClientsMarkedToPlay(),
+                 m_rooms[i]->playingLevelId().c_str(),
+                 m_clients[i_client]->room() == i ? " *" : "");
+        v_answer += v_roomstr;
+        v_answer += "\n";
+      }
+    }
+
+  } else if (v_args[0] == "join") {
+    if (v_args.size() != 2) {
+      v_answer += "join: invalid arguments\n";
+    } else {
+      unsigned int v_room = (unsigned int)atoi(v_args[1].c_str());
+
+      if (v_room >= m_rooms.size()) {
+        v_answer += "join: invalid room\n";
+      } else {
+        changeClientRoom(i_client, v_room);
+        v_answer += "You are now in room " + v_args[1] + "\n";
+      }
+    }
+
   } else if (v_args[0] == "login") {
     if (v_args.size() == 1) { // no arguments (local admins)
       if (XMNet::getIp(m_clients[i_client]->tcpRemoteIP()) == "127.0.0.1") {
@@ -1966,7 +1757,9 @@ void ServerThread::manageSrvCmd(unsigned int i_client,
     if (v_args.size() != 1) {
       v_answer += "reloadrules: invalid arguments\n";
     } else {
-      m_needToReloadRules = true;
+      for (unsigned int i = 0; i < m_rooms.size(); i++) {
+        m_rooms[i]->askToReloadRules();
+      }
       v_answer += "Rules will be reloaded just before the next round\n";
     }
 
@@ -2146,21 +1939,6 @@ unsigned int ServerThread::getClientById(unsigned int i_id) const {
   throw Exception("Client not found");
 }
 
-NetSClient *ServerThread::getNetSClientByScenePlayer(
-  unsigned int i_numScene,
-  unsigned int i_numPlayer) const {
-  for (unsigned int i = 0; i < m_clients.size(); i++) {
-    if (m_clients[i]->isMarkedToPlay()) {
-      if (m_clients[i]->getNumScene() == i_numScene) {
-        if (m_clients[i]->getNumPlayer() == i_numPlayer) {
-          return m_clients[i];
-        }
-      }
-    }
-  }
-  return NULL;
-}
-
 void ServerThread::cleanClientsMarkedToBeRemoved() {
   // main case : no client to remove
   if (m_clientMarkToBeRemoved.empty()) {
@@ -2205,114 +1983,3 @@ void ServerThread::sendMsgToClient(unsigned int i_client,
     }
   }
 }
-
-ServerRules *ServerThread::getRules() {
-  return m_rules;
-}
-
-Universe *ServerThread::getUniverse() {
-  return m_universe;
-}
-
-void ServerThread::reloadRules(const std::string &i_rulesFile) {
-  if (m_rules != NULL) {
-    delete m_rules;
-  }
-  m_rules = new ServerRules(this);
-
-  // init player points
-  for (unsigned int i = 0; i < m_clients.size(); i++) {
-    m_clients[i]->setPoints(0);
-  }
-
-  m_rules->loadScriptFile(i_rulesFile);
-  m_rules->scriptCallVoid("Global_init");
-
-  // simulate the Global_whenPlayer_added for players as the rule ignore these
-  // players
-  for (unsigned int i = 0; i < m_clients.size(); i++) {
-    if (m_clients[i]->mode() == NETCLIENT_SLAVE_MODE) {
-      m_rules->scriptCallVoidNumberArg("Global_whenPlayer_added",
-                                       m_clients[i]->id());
-    }
-  }
-}
-
-XMServerSceneHooks::XMServerSceneHooks(ServerThread *i_st) {
-  m_server = i_st;
-}
-
-XMServerSceneHooks::~XMServerSceneHooks() {}
-
-void XMServerSceneHooks::OnEntityToTakeTakenByPlayer(unsigned int i_player) {
-  // only one scene is managed on the server -- for the moment
-  NetSClient *v_client = m_server->getNetSClientByScenePlayer(0, i_player);
-
-  if (v_client != NULL) {
-    try {
-      m_server->getRules()->scriptCallVoidNumberArg(
-        "Round_whenPlayer_onEntityToTakeTaken", v_client->id());
-    } catch (Exception &e) {
-      // continue the game even if the rules are badly written
-      LogError(std::string("Rules: " + e.getMsg()).c_str());
-    }
-  }
-}
-
-void XMServerSceneHooks::OnEntityToTakeTakenExternal() {
-  try {
-    m_server->getRules()->scriptCallVoid(
-      "Round_whenExternal_onEntityToTakeTaken");
-  } catch (Exception &e) {
-    // continue the game even if the rules are badly written
-    LogError(std::string("Rules: " + e.getMsg()).c_str());
-  }
-}
-
-void XMServerSceneHooks::OnPlayerWins(unsigned int i_player) {
-  // only one scene is managed on the server -- for the moment
-  NetSClient *v_client = m_server->getNetSClientByScenePlayer(0, i_player);
-
-  if (v_client != NULL) {
-    try {
-      m_server->getRules()->scriptCallVoidNumberArg("Round_whenPlayer_wins",
-                                                    v_client->id());
-    } catch (Exception &e) {
-      // continue the game even if the rules are badly written
-      LogError(std::string("Rules: " + e.getMsg()).c_str());
-    }
-  }
-}
-
-void XMServerSceneHooks::OnPlayerDies(unsigned int i_player) {
-  // only one scene is managed on the server -- for the moment
-  NetSClient *v_client = m_server->getNetSClientByScenePlayer(0, i_player);
-
-  if (v_client != NULL) {
-    try {
-      m_server->getRules()->scriptCallVoidNumberArg("Round_whenPlayer_dies",
-                                                    v_client->id());
-    } catch (Exception &e) {
-      // continue the game even if the rules are badly written
-      LogError(std::string("Rules: " + e.getMsg()).c_str());
-    }
-  }
-}
-
-void XMServerSceneHooks::OnPlayerSomersault(unsigned int i_player,
-                                            bool i_counterclock) {
-  // only one scene is managed on the server -- for the moment
-  NetSClient *v_client = m_server->getNetSClientByScenePlayer(0, i_player);
-
-  if (v_client != NULL) {
-    try {
-      m_server->getRules()->scriptCallVoidNumberArg(
-        "Round_whenPlayer_DoesASomersault",
-        v_client->id(),
-        i_counterclock ? 1 : 0);
-    } catch (Exception &e) {
-      // continue the game even if the rules are badly written
-      LogError(std::string("Rules: " + e.getMsg()).c_str());
-    }
-  }
-}
@@ -23,9 +23,9 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "../../include/xm_SDL_net.h"
 #include "../../thread/XMThread.h"
-#include "../../xmscene/Scene.h"
 #include "../BasicStructures.h"
 #include "../NetActions.h"
+#include "../NetFramesHistory.h"
 #include <vector>
 
 class ActionReader;
@@ -33,13 +33,12 @@ class NetAction;
 class Universe;
 class DBuffer;
 class ServerRules;
-class XMServerSceneHooks;
+class ServerRoom;
+class ServerEpoll;
+class WorkersPool;
 
-enum ServerP2Phase {
-  SP2_PHASE_NONE,
-  SP2_PHASE_WAIT_CLIENTS,
-  SP2_PHASE_PLAYING
-};
+#define XM_SERVER_UPLOADING_FPS_PLAYER 40
+#define XM_SERVER_UPLOADING_FPS_OPLAYERS 15
 
 class NetSClient {
 public:
@@ -73,7 +72,11 @@ public:
   void setMode(NetClientMode i_mode);
   NetClientMode mode() const;
 
-  // indicates whether the client is in the current SP2 party
+  // room in which the client plays
+  void setRoom(unsigned int i_room);
+  unsigned int room() const;
+
+  // indicates whether the client is in the current SP2 party of its room
   void markToPlay(ServerRules *i_rules, bool i_value);
   bool isMarkedToPlay();
   void markScenePlayer(unsigned int i_numScene, unsigned int i_numPlayer);
@@ -102,9 +105,14 @@ public:
 
   NetPing *lastPing();
 
+  // frames of the players sent by NA_frames
+  NetFramesHistory *framesHistory();
+  unsigned int nextFramesSeq();
+
 private:
   unsigned int m_id; // uniq id of the client
   NetClientMode m_mode; // playing mode (simple ghost or slave)
+  unsigned int m_room;
   bool m_isMarkedToPlay;
   unsigned int m_numScene; // number of the scene in which the client plays (if
   // marked to play)
@@ -128,9 +136,13 @@ private:
   // this is your name at the moment you login
   int m_lastGhostFrameTime;
   NetPing m_lastPing;
+  NetFramesHistory m_framesHistory;
+  unsigned int m_framesSeq;
 };
 
 class ServerThread : public XMThread {
+  friend class ServerRoom;
+
 public:
   ServerThread(const std::string &i_dbKey,
                int i_port,
@@ -143,12 +155,7 @@ public:
   void close(); // close the server if an event need it (ctrl+c)
   int port() const;
 
-  NetSClient *getNetSClientByScenePlayer(unsigned int i_numScene,
-                                         unsigned int i_numPlayer) const;
   NetSClient *getNetSClientById(unsigned int i_id) const;
-  Universe *getUniverse(); // NULL if no party is currently playing
-  ServerRules *getRules();
-  void sendPointsToSlavePlayers();
 
 private:
   TCPsocket m_tcpsd;
@@ -160,17 +167,8 @@ private:
   int m_port;
   std::string m_adminPassword;
 
-  Universe *m_universe;
-  DBuffer *m_DBuffer;
-  ServerP2Phase m_sp2phase;
-  int m_lastPhysTime;
-  int m_lastFrameTimeStamp;
-  int m_frameLate;
-  int m_currentFrame;
-  int m_sceneStartTime;
-  int m_lastPrepareToGoAlert;
-  int m_firstFrameSent; // send the first frame only one time before the game
-  // starts
+  std::vector<ServerRoom *> m_rooms;
+  WorkersPool *m_workersPool; // the scenes of the rooms are updated in parallel
 
   unsigned int m_nFollowingUdp; // to avoid tcp famine
   std::string m_startTimeStr;
@@ -179,15 +177,15 @@ private:
   int m_unmanagedActions;
 
   SDLNet_SocketSet m_set;
+  ServerEpoll *m_epoll; // NULL when the sdl_net socket set is used
   std::vector<NetSClient *> m_clients;
-  ServerRules *m_rules;
-  bool m_needToReloadRules; // rules are reloaded only when out of a round, not
-  // immediatly when requested
-  XMServerSceneHooks *m_sceneHook;
 
   void acceptClient();
   bool manageClientTCP(unsigned int i);
+  // return false if the client has been removed
+  bool manageClientTCPReady(unsigned int i);
   void manageClientUDP();
+  void manageUDPPacket(); // manage the packet read in m_udpPacket
 
   // return false if the client must be deconnected
   bool manageAction(NetAction *i_netAction, unsigned int i_client);
@@ -199,6 +197,7 @@ private:
   bool manageNetworkOnePacket(int i_timeout); // return true if there is
   // possibly something else to
   // manage on network
+  bool manageNetworkEpoll(int i_timeout); // same, with the epoll backend
 
   // if i_execpt >= 0, send to all exept him
   void sendToAllClients(NetAction *i_netAction,
@@ -210,10 +209,6 @@ private:
                                   int i_src,
                                   int i_subsrc,
                                   int i_except = -1);
-  void sendToAllClientsMarkedToPlay(NetAction *i_netAction,
-                                    int i_src,
-                                    int i_subsrc,
-                                    int i_except = -1);
   void sendToAllClientsHavingProtocol(int i_protocol,
                                       NetAction *i_netAction_lt,
                                       NetAction *i_netAction_ge,
@@ -234,21 +229,12 @@ private:
                     bool i_forceUdp = false);
   void sendMsgToClient(unsigned int i_client, const std::string &i_msg);
   void removeClient(unsigned int i);
-  unsigned int nbClientsInMode(NetClientMode i_mode);
-
-  /* SP2 */
-  void sendPointsToClient(unsigned int i_client);
-  void SP2_initPlaying();
-  void SP2_uninitPlaying();
-  void SP2_updateScenePlaying();
-  void SP2_updateCheckScenePlaying();
-  void SP2_setPhase(ServerP2Phase i_sp2phase);
-  void SP2_unsetPhase();
-  void SP2_manageInactivity();
-  bool SP2_managePreplayTime();
-  std::string SP2_determineLevel();
-  void SP2_sendSceneEvents(DBuffer *i_buffer);
-  bool m_sp2_gameStarted;
+
+  /* rooms */
+  void initRooms(unsigned int i_nbRooms);
+  void uninitRooms();
+  void changeClientRoom(unsigned int i_client, unsigned int i_room);
+  bool isOneRoomPlaying() const;
   int m_sp2_lastLoopTime;
   int m_sp2_lastLoopDelta;
 
@@ -258,24 +244,6 @@ private:
 
   std::vector<unsigned int> m_clientMarkToBeRemoved;
   void cleanClientsMarkedToBeRemoved();
-
-  // rules
-  void reloadRules(const std::string &i_rulesFile);
-};
-
-class XMServerSceneHooks : public SceneHooks {
-public:
-  XMServerSceneHooks(ServerThread *i_st);
-  virtual ~XMServerSceneHooks();
-
-  void OnEntityToTakeTakenByPlayer(unsigned int i_player);
-  void OnEntityToTakeTakenExternal();
-  void OnPlayerWins(unsigned int i_player);
-  void OnPlayerDies(unsigned int i_player);
-  void OnPlayerSomersault(unsigned int i_player, bool i_counterclock);
-
-private:
-  ServerThread *m_server;
 };
 
 #endif
@@ -47,9 +47,13 @@ StateDeadMenu::StateDeadMenu(Universe *i_universe,
     StateManager::instance()->registerAsEmitter("NEXTLEVEL");
     StateManager::instance()->registerAsEmitter("ABORT");
   }
+
+  StateManager::instance()->registerAsObserver("REPLAY_FAILEDTOSAVE", this);
 }
 
-StateDeadMenu::~StateDeadMenu() {}
+StateDeadMenu::~StateDeadMenu() {
+  StateManager::instance()->unregisterAsObserver("REPLAY_FAILEDTOSAVE", this);
+}
 
 void StateDeadMenu::enter() {
   GameApp *gameApp = GameApp::instance();
@@ -215,12 +219,10 @@ void StateDeadMenu::executeOneCommand(std::string cmd, std::string args) {
            getName().c_str());
 
   if (cmd == "SAVEREPLAY") {
-    try {
-      m_universe->saveReplay(xmDatabase::instance("main"), m_replayName);
-    } catch (Exception &e) {
-      StateManager::instance()->pushState(
-        new StateMessageBox(NULL, e.getMsg(), UI_MSGBOX_OK));
-    }
+    m_universe->saveReplay(xmDatabase::instance("main"), m_replayName);
+  } else if (cmd == "REPLAY_FAILEDTOSAVE") {
+    StateManager::instance()->pushState(new StateMessageBox(
+      NULL, "Failed to save replay " + args, UI_MSGBOX_OK));
   } else {
     GameState::executeOneCommand(cmd, args);
   }
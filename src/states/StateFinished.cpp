@@ -52,9 +52,15 @@ StateFinished::StateFinished(Universe *i_universe,
     StateManager::instance()->registerAsEmitter("NEXTLEVEL");
     StateManager::instance()->registerAsEmitter("FINISH");
   }
+
+  StateManager::instance()->registerAsObserver("REPLAY_SAVED", this);
+  StateManager::instance()->registerAsObserver("REPLAY_FAILEDTOSAVE", this);
 }
 
-StateFinished::~StateFinished() {}
+StateFinished::~StateFinished() {
+  StateManager::instance()->unregisterAsObserver("REPLAY_SAVED", this);
+  StateManager::instance()->unregisterAsObserver("REPLAY_FAILEDTOSAVE", this);
+}
 
 void StateFinished::enter() {
   int v_finish_time = -1;
@@ -159,19 +165,10 @@ void StateFinished::enter() {
       /* autosave */
       if (v_is_a_room_highscore || v_is_a_personnal_highscore) {
         if (XMSession::instance()->autosaveHighscoreReplays()) {
-          std::string v_replayName;
-          char v_str[256];
-          v_replayName = Replay::giveAutomaticName();
-
-          try {
-            m_universe->saveReplay(xmDatabase::instance("main"), v_replayName);
-          } catch (Exception &e) {
-            StateManager::instance()->pushState(
-              new StateMessageBox(this, e.getMsg(), UI_MSGBOX_OK));
-          }
-
-          snprintf(v_str, 256, GAMETEXT_SAVE_AS, v_replayName.c_str());
-          v_pNewHighscoreSaved_str->setCaption(v_str);
+          // the caption is set once the replay is saved
+          m_autosavedReplayName = Replay::giveAutomaticName();
+          m_universe->saveReplay(xmDatabase::instance("main"),
+                                 m_autosavedReplayName);
         }
       }
     } else {
@@ -308,6 +305,11 @@ void StateFinished::checkEvents() {
 
     std::string v_replayPath = XMFS::getUserReplaysDir() + "/Latest.rpl";
 
+    // the replay of the highscore must be written before its upload
+    if (m_universe->isAReplayToSave()) {
+      m_universe->saveReplayTemporary(xmDatabase::instance("main"));
+    }
+
     if (m_universe->isAnErrorOnSaving()) {
       // fake upload
       SysMessage::instance()->displayError(SYS_MSG_UNSAVABLE_LEVEL);
@@ -371,12 +373,18 @@ void StateFinished::executeOneCommand(std::string cmd, std::string args) {
            getName().c_str());
 
   if (cmd == "SAVEREPLAY") {
-    try {
-      m_universe->saveReplay(xmDatabase::instance("main"), m_replayName);
-    } catch (Exception &e) {
-      StateManager::instance()->pushState(
-        new StateMessageBox(NULL, e.getMsg(), UI_MSGBOX_OK));
+    m_universe->saveReplay(xmDatabase::instance("main"), m_replayName);
+  } else if (cmd == "REPLAY_SAVED") {
+    if (args == m_autosavedReplayName) {
+      char v_str[256];
+      UIStatic *v_pNewHighscoreSaved_str = reinterpret_cast<UIStatic *>(
+        m_GUI->getChild("HIGHSCORESAVEDSTR_STATIC"));
+      snprintf(v_str, 256, GAMETEXT_SAVE_AS, args.c_str());
+      v_pNewHighscoreSaved_str->setCaption(v_str);
     }
+  } else if (cmd == "REPLAY_FAILEDTOSAVE") {
+    StateManager::instance()->pushState(new StateMessageBox(
+      NULL, "Failed to save replay " + args, UI_MSGBOX_OK));
   } else {
     GameState::executeOneCommand(cmd, args);
   }
@@ -68,6 +68,7 @@ private:
   static void createGUIIfNeeded(RenderSurface *i_screen);
 
   std::string m_replayName; // to save temporarly the replay name
+  std::string m_autosavedReplayName;
 };
 
 #endif
@@ -371,8 +371,6 @@ void StateLevelPackViewer::updateLevelsList() {
   UILevelList *pList =
     reinterpret_cast<UILevelList *>(m_GUI->getChild("FRAME:LEVEL_LIST"));
   int v_selected = pList->getSelected();
-  char **v_result;
-  unsigned int nrow;
   int v_totalProfileTime = 0;
   int v_totalHighscoreTime = 0;
 
@@ -406,19 +404,19 @@ void StateLevelPackViewer::updateLevelsList() {
     pList->hideRoomBestTime();
   }
 
-  v_result = pDb->readDB(
-    m_pActiveLevelPack->getLevelsWithHighscoresQuery(
-      XMSession::instance()->profile(), XMSession::instance()->idRoom(0)),
-    nrow);
-  for (unsigned int i = 0; i < nrow; i++) {
-    if (pDb->getResult(v_result, 4, i, 2) == NULL) {
+  xmDbQuery v_query(pDb, m_pActiveLevelPack->getLevelsWithHighscoresQuery());
+  LevelsPack::bindLevelsWithHighscoresQuery(v_query,
+                                            XMSession::instance()->profile(),
+                                            XMSession::instance()->idRoom(0));
+  while (v_query.next()) {
+    if (v_query.isNull(2)) {
       v_playerHighscore = -1;
     } else {
-      v_playerHighscore = atoi(pDb->getResult(v_result, 4, i, 2));
+      v_playerHighscore = v_query.getInt(2);
       v_totalProfileTime += v_playerHighscore;
     }
 
-    if (pDb->getResult(v_result, 4, i, 3) == NULL) {
+    if (v_query.isNull(3)) {
       v_roomHighscore = -1;
       if (v_playerHighscore > 0) {
         v_totalHighscoreTime +=
@@ -426,7 +424,7 @@ void StateLevelPackViewer::updateLevelsList() {
         // than room, to not have to update www
       }
     } else {
-      v_roomHighscore = atoi(pDb->getResult(v_result, 4, i, 3));
+      v_roomHighscore = v_query.getInt(3);
       if (v_playerHighscore > 0 && v_playerHighscore < v_roomHighscore) {
         v_totalHighscoreTime +=
           v_playerHighscore; // add player time in case he has a better score
@@ -439,12 +437,11 @@ void StateLevelPackViewer::updateLevelsList() {
       }
     }
 
-    pList->addLevel(pDb->getResult(v_result, 4, i, 0),
-                    pDb->getResult(v_result, 4, i, 1),
+    pList->addLevel(v_query.getString(0),
+                    v_query.getString(1),
                     v_playerHighscore,
                     v_roomHighscore);
   }
-  pDb->read_DB_free(v_result);
 
   /* reselect the previous level */
   if (v_selected_levelName != "") {
@@ -1784,8 +1784,8 @@ UILevelList *StateMainMenu::buildQuickStartList() {
   v_list->showWindow(false);
   v_list->setCanGetFocus(false);
 
-  createLevelListsSql(
-    v_list,
+  xmDbQuery v_query(
+    xmDatabase::instance("main"),
     LevelsManager::getQuickStartPackQuery(v_quickStart->getQualityMIN(),
                                           v_quickStart->getDifficultyMIN(),
                                           v_quickStart->getQualityMAX(),
@@ -1793,13 +1793,12 @@ UILevelList *StateMainMenu::buildQuickStartList() {
                                           XMSession::instance()->profile(),
                                           XMSession::instance()->idRoom(0),
                                           xmDatabase::instance("main")));
+  createLevelListsSql(v_list, v_query);
   return v_list;
 }
 
 void StateMainMenu::createLevelListsSql(UILevelList *io_levelsList,
-                                        const std::string &i_sql) {
-  char **v_result;
-  unsigned int nrow;
+                                        xmDbQuery &io_query) {
   int v_playerHighscore, v_roomHighscore;
 
   /* get selected item */
@@ -1815,29 +1814,24 @@ void StateMainMenu::createLevelListsSql(UILevelList *io_levelsList,
 
   io_levelsList->clear();
 
-  v_result = xmDatabase::instance("main")->readDB(i_sql, nrow);
-  for (unsigned int i = 0; i < nrow; i++) {
-    if (xmDatabase::instance("main")->getResult(v_result, 4, i, 2) == NULL) {
+  while (io_query.next()) {
+    if (io_query.isNull(2)) {
       v_playerHighscore = -1;
     } else {
-      v_playerHighscore =
-        atoi(xmDatabase::instance("main")->getResult(v_result, 4, i, 2));
+      v_playerHighscore = io_query.getInt(2);
     }
 
-    if (xmDatabase::instance("main")->getResult(v_result, 4, i, 3) == NULL) {
+    if (io_query.isNull(3)) {
       v_roomHighscore = -1;
     } else {
-      v_roomHighscore =
-        atoi(xmDatabase::instance("main")->getResult(v_result, 4, i, 3));
+      v_roomHighscore = io_query.getInt(3);
     }
 
-    io_levelsList->addLevel(
-      xmDatabase::instance("main")->getResult(v_result, 4, i, 0),
-      xmDatabase::instance("main")->getResult(v_result, 4, i, 1),
-      v_playerHighscore,
-      v_roomHighscore);
+    io_levelsList->addLevel(io_query.getString(0),
+                            io_query.getString(1),
+                            v_playerHighscore,
+                            v_roomHighscore);
   }
-  xmDatabase::instance("main")->read_DB_free(v_result);
 
   /* reselect the previous level */
   if (v_selected_levelName != "") {
@@ -2075,10 +2069,12 @@ void StateMainMenu::createLevelLists(UILevelList *i_list,
   LevelsPack *v_levelsPack =
     &(LevelsManager::instance()->LevelsPackByName(i_packageName));
   try {
-    createLevelListsSql(
-      i_list,
-      v_levelsPack->getLevelsWithHighscoresQuery(
-        XMSession::instance()->profile(), XMSession::instance()->idRoom(0)));
+    xmDbQuery v_query(xmDatabase::instance("main"),
+                      v_levelsPack->getLevelsWithHighscoresQuery());
+    LevelsPack::bindLevelsWithHighscoresQuery(v_query,
+                                              XMSession::instance()->profile(),
+                                              XMSession::instance()->idRoom(0));
+    createLevelListsSql(i_list, v_query);
     LevelsManager::instance()->unlockLevelsPacks();
   } catch (Exception &e) {
     LevelsManager::instance()->unlockLevelsPacks();
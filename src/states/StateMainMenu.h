@@ -28,6 +28,7 @@ class Texture;
 class UILevelList;
 class LevelsPacksCountUpdateThread;
 class CheckWwwThread;
+class xmDbQuery;
 
 class StateMainMenu : public StateMenu {
 public:
@@ -85,8 +86,7 @@ private:
   /* lists */
   UILevelList *m_quickStartList;
   UILevelList *buildQuickStartList();
-  void createLevelListsSql(UILevelList *io_levelsList,
-                           const std::string &i_sql);
+  void createLevelListsSql(UILevelList *io_levelsList, xmDbQuery &io_query);
   void createLevelLists(UILevelList *i_list, const std::string &i_packageName);
   void updateLevelsPackInPackList(const std::string &v_levelPack);
 
@@ -41,6 +41,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "drawlib/DrawLib.h"
 #include "helpers/Log.h"
 #include "thread/DownloadReplaysThread.h"
+#include "thread/SaveReplaysThread.h"
 #include "thread/XMThreadStats.h"
 #include "xmoto/Game.h"
 #include "xmoto/GameText.h"
@@ -105,6 +106,10 @@ StateManager::StateManager() {
   // create the replay downloader thread
   m_drt = new DownloadReplaysThread(this);
 
+  // create the replay saver thread, waiting for the replays to save
+  m_srt = new SaveReplaysThread(this);
+  m_srt->startThread();
+
   // mouse
   m_isCursorVisible = false;
   SDL_ShowCursor(SDL_DISABLE);
@@ -140,6 +145,15 @@ StateManager::~StateManager() {
     delete m_drt;
   }
 
+  if (m_srt != NULL) {
+    // the replays waiting are saved before closing xmoto
+    m_srt->askThreadToEnd();
+    if (m_srt->waitForThreadEnd()) {
+      LogError("replays saver thread failed");
+    }
+    delete m_srt;
+  }
+
   deleteToDeleteState();
 
   if (m_videoRecorder != NULL) {
@@ -1140,6 +1154,10 @@ DownloadReplaysThread *StateManager::getReplayDownloaderThread() {
   return m_drt;
 }
 
+SaveReplaysThread *StateManager::getReplaySaverThread() {
+  return m_srt;
+}
+
 void StateManager::setCursorVisible(bool visible) {
   if (m_isCursorVisible == visible)
     return;
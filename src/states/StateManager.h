@@ -36,6 +36,7 @@ class Texture;
 class RenderSurface;
 class XMThreadStats;
 class DownloadReplaysThread;
+class SaveReplaysThread;
 
 class StateManager : public Singleton<StateManager> {
   friend class Singleton<StateManager>;
@@ -113,6 +114,9 @@ public:
 
   DownloadReplaysThread *getReplayDownloaderThread();
 
+  // replays are saved in an other thread to reduce freezes
+  SaveReplaysThread *getReplaySaverThread();
+
   void setCursorVisible(bool visible);
 
   void connectOrDisconnect();
@@ -187,6 +191,9 @@ private:
   // replays downloader
   DownloadReplaysThread *m_drt;
 
+  // replays saver
+  SaveReplaysThread *m_srt;
+
   int m_currentUniqueId;
 
   RenderSurface m_screen;
@@ -226,14 +226,18 @@ void StateReplaying::xmKey(InputEventType i_type, const XMKey &i_xmkey) {
                                                 INPUT_REPLAYINGREWIND))) {
     if (m_universe != NULL) {
       if (m_universe->getScenes().size() > 0) {
-        if (m_universe->getScenes()[0]->getLevelSrc()->isScripted() == false &&
-            m_universe->getScenes()[0]->getLevelSrc()->isPhysics() == false) {
-          for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
-            m_universe->getScenes()[i]->fastrewind(100);
+        bool v_rewound = true;
+
+        for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+          if (m_universe->getScenes()[i]->fastrewind(100) == false) {
+            v_rewound = false;
           }
+        }
+
+        if (v_rewound) {
           m_stopToUpdate = false;
         } else {
-          // rerun the replay
+          // no snapshot so far in the past, rerun the replay
           restartLevel();
         }
       }
@@ -28,6 +28,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "drawlib/DrawLib.h"
 #include "helpers/Log.h"
 #include "helpers/Text.h"
+#include "helpers/WorkersPool.h"
 #include "net/NetActions.h"
 #include "net/NetClient.h"
 #include "thread/XMThreadStats.h"
@@ -53,6 +54,22 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #define STATS_LEVELS_NOTES_SIZE 15
 
+class SceneUpdateJob : public WorkersPoolJob {
+public:
+  SceneUpdateJob(Scene *i_scene, Replay *i_replay) {
+    m_scene = i_scene;
+    m_replay = i_replay;
+  }
+
+  virtual void run() {
+    m_scene->updateLevel(PHYS_STEP_SIZE, m_replay, m_replay);
+  }
+
+private:
+  Scene *m_scene;
+  Replay *m_replay;
+};
+
 void StateScene::init(bool i_doShade, bool i_doShadeAnim) {
   Sprite *v_sprite;
 
@@ -94,6 +111,7 @@ void StateScene::init(bool i_doShade, bool i_doShadeAnim) {
   }
 
   m_trackingShotMode = false;
+  m_workersPool = NULL;
 
   // message registering
   initMessageRegistering();
@@ -131,6 +149,10 @@ StateScene::~StateScene() {
   if (m_cameraAnim != NULL) {
     delete m_cameraAnim;
   }
+
+  if (m_workersPool != NULL) {
+    delete m_workersPool;
+  }
 }
 
 void StateScene::initMessageRegistering() {
@@ -214,12 +236,7 @@ bool StateScene::update() {
         (XMSession::instance()->enableVideoRecording() == false ||
          nPhysSteps == 0)) {
         if (m_universe != NULL) {
-          for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
-            m_universe->getScenes()[i]->updateLevel(
-              PHYS_STEP_SIZE,
-              m_universe->getCurrentReplay(),
-              m_universe->getCurrentReplay());
-          }
+          updateScenes();
         }
         m_fLastPhysTime += PHYS_STEP_SIZE / 100.0;
         nPhysSteps++;
@@ -253,6 +270,36 @@ bool StateScene::update() {
   return true;
 }
 
+void StateScene::updateScenes() {
+  std::vector<SceneUpdateJob> v_jobs;
+  std::vector<WorkersPoolJob *> v_pjobs;
+
+  if (m_universe->getScenes().size() < 2) {
+    for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+      m_universe->getScenes()[i]->updateLevel(PHYS_STEP_SIZE,
+                                              m_universe->getCurrentReplay(),
+                                              m_universe->getCurrentReplay());
+    }
+    return;
+  }
+
+  // the scenes only share the resources protected by
+  // Scene::lockSharedResources() ; they are all updated before the camera
+  // scrolling and the rendering
+  if (m_workersPool == NULL) {
+    m_workersPool = new WorkersPool();
+  }
+
+  v_jobs.reserve(m_universe->getScenes().size());
+  for (unsigned int i = 0; i < m_universe->getScenes().size(); i++) {
+    v_jobs.push_back(SceneUpdateJob(m_universe->getScenes()[i],
+                                    m_universe->getCurrentReplay()));
+    v_pjobs.push_back(&v_jobs[i]);
+  }
+
+  m_workersPool->run(v_pjobs);
+}
+
 bool StateScene::render() {
   GameApp *pGame = GameApp::instance();
 
@@ -26,6 +26,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 class CameraAnimation;
 class Universe;
 class GameRenderer;
+class WorkersPool;
 
 class StateScene : public GameState {
 public:
@@ -107,6 +108,10 @@ private:
   void initMessageRegistering();
   bool m_trackingShotMode;
 
+  /* the scenes of a multi scenes game are updated in parallel */
+  WorkersPool *m_workersPool;
+  void updateScenes();
+
   // shade
   bool m_doShade;
   bool m_doShadeAnim;
@@ -187,3 +187,11 @@ std::string CheckWwwThread::getMsg() const {
 void CheckWwwThread::setTaskProgress(float p_percent) {
   setThreadProgress((int)p_percent);
 }
+
+void CheckWwwThread::setFileProgress(const std::string &p_information,
+                                     float p_percent) {
+  char v_progress[16];
+
+  snprintf(v_progress, sizeof(v_progress), " (%i%%)", (int)p_percent);
+  setThreadCurrentMicroOperation(p_information + v_progress);
+}
@@ -38,6 +38,8 @@ public:
   std::string getMsg() const;
 
   void setTaskProgress(float p_percent);
+  virtual void setFileProgress(const std::string &p_information,
+                               float p_percent);
 
   virtual int realThreadFunction();
 
@@ -65,42 +65,66 @@ int DownloadReplaysThread::realThreadFunction() {
 }
 
 void DownloadReplaysThread::play() {
+  std::vector<std::string> v_urls;
+  std::vector<std::string> v_urlsToDownload;
+  std::vector<std::string> v_errors;
+
+  // the urls stay in the list while they are downloaded for the duplicate
+  // check of add(), but the mutex is released for the download
   SDL_LockMutex(m_urlsMutex);
+  v_urls = m_replaysUrls;
+  SDL_UnlockMutex(m_urlsMutex);
 
-  try {
-    while (m_replaysUrls.size() > 0) {
-      std::string v_replayName;
-
-      v_replayName = XMFS::getFileBaseName(m_replaysUrls[0]);
-
-      // prevent double download just before downloading - add() duplicate check
-      // is not enough while it's done in an other thread
-      if (m_pWebRoom->downloadReplayExists(m_replaysUrls[0]) == false) {
-        // dwd here
-        try {
-          ProxySettings *pProxySettings =
-            XMSession::instance()->proxySettings();
-
-          m_pWebRoom->setProxy(pProxySettings);
-          m_pWebRoom->downloadReplay(m_replaysUrls[0]);
-          GameApp::instance()->addReplay(v_replayName, m_pDb);
-
-          m_manager->sendAsynchronousMessage(std::string("REPLAY_DOWNLOADED"),
-                                             v_replayName);
-
-        } catch (Exception &e) {
-          m_manager->sendAsynchronousMessage(
-            std::string("REPLAY_FAILEDTODOWNLOAD"), v_replayName);
-          LogError("Unable to download replay : %s", e.getMsg().c_str());
+  while (v_urls.size() > 0) {
+    v_urlsToDownload.clear();
+
+    // prevent double download just before downloading - add() duplicate check
+    // is not enough while it's done in an other thread
+    for (unsigned int i = 0; i < v_urls.size(); i++) {
+      if (m_pWebRoom->downloadReplayExists(v_urls[i]) == false) {
+        v_urlsToDownload.push_back(v_urls[i]);
+      }
+    }
+
+    // dwd here
+    try {
+      ProxySettings *pProxySettings = XMSession::instance()->proxySettings();
+
+      m_pWebRoom->setProxy(pProxySettings);
+      m_pWebRoom->setNbParallelDownloads(
+        XMSession::instance()->webDownloadsParallel());
+      m_pWebRoom->downloadReplays(v_urlsToDownload, v_errors);
+    } catch (Exception &e) {
+      LogError("Unable to download replays : %s", e.getMsg().c_str());
+      v_errors.assign(v_urlsToDownload.size(), e.getMsg());
+    }
+
+    for (unsigned int i = 0; i < v_urlsToDownload.size(); i++) {
+      std::string v_replayName = XMFS::getFileBaseName(v_urlsToDownload[i]);
+
+      try {
+        if (v_errors[i] != "") {
+          throw Exception(v_errors[i]);
         }
+        GameApp::instance()->addReplay(v_replayName, m_pDb);
+
+        m_manager->sendAsynchronousMessage(std::string("REPLAY_DOWNLOADED"),
+                                           v_replayName);
+
+      } catch (Exception &e) {
+        m_manager->sendAsynchronousMessage(
+          std::string("REPLAY_FAILEDTODOWNLOAD"), v_replayName);
+        LogError("Unable to download replay : %s", e.getMsg().c_str());
       }
-      m_replaysUrls.erase(m_replaysUrls.begin());
     }
-  } catch (Exception &e) {
-    LogError("Unable to download replay");
-  }
 
-  SDL_UnlockMutex(m_urlsMutex);
+    // add() only appends urls
+    SDL_LockMutex(m_urlsMutex);
+    m_replaysUrls.erase(m_replaysUrls.begin(),
+                        m_replaysUrls.begin() + v_urls.size());
+    v_urls = m_replaysUrls;
+    SDL_UnlockMutex(m_urlsMutex);
+  }
 }
 
 void DownloadReplaysThread::doJob() {
@@ -0,0 +1,209 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "SaveReplaysThread.h"
+#include "common/VFileIO.h"
+#include "common/XMSession.h"
+#include "helpers/Log.h"
+#include "helpers/VExcept.h"
+#include "states/StateManager.h"
+#include "xmoto/Game.h"
+#include "xmoto/Replay.h"
+
+SaveReplaysThread::SaveReplaysThread(StateManager *i_manager)
+  : XMThread("SRT") {
+  m_manager = i_manager;
+  m_lastSaveFailed = false;
+  m_lastReplay = NULL;
+  m_lastReplayCopiesFormat = 0;
+  m_jobsMutex = SDL_CreateMutex();
+  m_jobsCond = SDL_CreateCond();
+
+  if (XMSession::instance()->debug() == true) {
+    m_manager->registerAsEmitter("REPLAY_SAVED");
+    m_manager->registerAsEmitter("REPLAY_FAILEDTOSAVE");
+  }
+}
+
+SaveReplaysThread::~SaveReplaysThread() {
+  // jobs not done if the thread has not been started
+  for (unsigned int i = 0; i < m_jobs.size(); i++) {
+    if (m_jobs[i].replay != NULL) {
+      delete m_jobs[i].replay;
+    }
+  }
+
+  if (m_lastReplay != NULL) {
+    delete m_lastReplay;
+  }
+
+  SDL_DestroyCond(m_jobsCond);
+  SDL_DestroyMutex(m_jobsMutex);
+}
+
+void SaveReplaysThread::saveReplay(Replay *i_replay,
+                                   int i_format,
+                                   int i_copiesFormat) {
+  ReplayToSave v_job;
+
+  v_job.replay = i_replay;
+  v_job.format = i_format;
+  v_job.copiesFormat = i_copiesFormat;
+  addJob(v_job);
+}
+
+void SaveReplaysThread::copyReplay(const std::string &i_file,
+                                   const std::string &i_name) {
+  ReplayToSave v_job;
+
+  v_job.replay = NULL;
+  v_job.format = 0;
+  v_job.copiesFormat = 0;
+  v_job.file = i_file;
+  v_job.name = i_name;
+  addJob(v_job);
+}
+
+void SaveReplaysThread::addJob(const ReplayToSave &i_job) {
+  SDL_LockMutex(m_jobsMutex);
+
+  // the game waits if the disk can't follow
+  while (m_jobs.size() >= SAVEREPLAYS_QUEUE_SIZE) {
+    SDL_CondWait(m_jobsCond, m_jobsMutex);
+  }
+
+  m_jobs.push_back(i_job);
+  SDL_CondBroadcast(m_jobsCond);
+  SDL_UnlockMutex(m_jobsMutex);
+}
+
+void SaveReplaysThread::waitForSaves() {
+  SDL_LockMutex(m_jobsMutex);
+  while (m_jobs.size() > 0) {
+    SDL_CondWait(m_jobsCond, m_jobsMutex);
+  }
+  SDL_UnlockMutex(m_jobsMutex);
+}
+
+void SaveReplaysThread::askThreadToEnd() {
+  SDL_LockMutex(m_jobsMutex);
+  XMThread::askThreadToEnd();
+  SDL_CondBroadcast(m_jobsCond);
+  SDL_UnlockMutex(m_jobsMutex);
+}
+
+int SaveReplaysThread::realThreadFunction() {
+  ReplayToSave v_job;
+
+  SDL_LockMutex(m_jobsMutex);
+
+  while (true) {
+    while (m_jobs.size() == 0 && m_askThreadToEnd == false) {
+      SDL_CondWait(m_jobsCond, m_jobsMutex);
+    }
+
+    if (m_jobs.size() == 0) { // asked to end
+      break;
+    }
+
+    // the job stays in the queue while it's done for waitForSaves()
+    v_job = m_jobs.front();
+    SDL_UnlockMutex(m_jobsMutex);
+
+    doJob(v_job);
+
+    SDL_LockMutex(m_jobsMutex);
+    m_jobs.pop_front();
+    SDL_CondBroadcast(m_jobsCond);
+  }
+
+  SDL_UnlockMutex(m_jobsMutex);
+
+  return 0;
+}
+
+void SaveReplaysThread::doJob(const ReplayToSave &i_job) {
+  std::string v_outputfile;
+
+  if (i_job.replay != NULL) {
+    if (m_lastReplay != NULL) {
+      delete m_lastReplay;
+      m_lastReplay = NULL;
+    }
+
+    m_lastSaveFailed = false;
+    try {
+      i_job.replay->saveReplayIfNot(i_job.format);
+    } catch (Exception &e) {
+      LogError("Unable to save the replay: %s", e.getMsg().c_str());
+      m_lastSaveFailed = true;
+    }
+
+    if (m_lastSaveFailed == false && i_job.copiesFormat != 0) {
+      m_lastReplay = i_job.replay;
+      m_lastReplayCopiesFormat = i_job.copiesFormat;
+    } else {
+      delete i_job.replay;
+    }
+    return;
+  }
+
+  // the file holds an other run if the replay has not been written
+  if (m_lastSaveFailed) {
+    LogError("Failed to save replay %s", i_job.name.c_str());
+    m_manager->sendAsynchronousMessage(
+      std::string("REPLAY_FAILEDTOSAVE"), i_job.name);
+    return;
+  }
+
+  if (!XMFS::copyFile(FDT_DATA,
+                      i_job.file,
+                      "Replays/" + i_job.name + ".rpl",
+                      v_outputfile)) {
+    LogError("Failed to save replay %s", i_job.name.c_str());
+    m_manager->sendAsynchronousMessage(
+      std::string("REPLAY_FAILEDTOSAVE"), i_job.name);
+    return;
+  }
+
+  /* the copied file stays if it can't be written in the other format */
+  if (m_lastReplay != NULL) {
+    try {
+      m_lastReplay->saveReplayAs(XMFS::getFileBaseName(v_outputfile, true),
+                                 m_lastReplayCopiesFormat);
+    } catch (Exception &e) {
+      LogWarning("Unable to write the replay %s in format %i: %s",
+                 i_job.name.c_str(),
+                 m_lastReplayCopiesFormat,
+                 e.getMsg().c_str());
+    }
+  }
+
+  /* Update replay list to reflect changes */
+  try {
+    GameApp::instance()->addReplay(v_outputfile, m_pDb);
+  } catch (Exception &e) {
+    LogError("Unable to add the replay %s: %s",
+             i_job.name.c_str(),
+             e.getMsg().c_str());
+  }
+
+  m_manager->sendAsynchronousMessage(std::string("REPLAY_SAVED"), i_job.name);
+}
@@ -0,0 +1,78 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __SAVEREPLAYSTHREAD_H__
+#define __SAVEREPLAYSTHREAD_H__
+
+#include "XMThread.h"
+#include <deque>
+
+#define SAVEREPLAYS_QUEUE_SIZE 4
+
+class Replay;
+class StateManager;
+
+struct SDL_mutex;
+struct SDL_cond;
+
+struct ReplayToSave {
+  Replay *replay; // written, then deleted ; NULL for a copy
+  int format;
+  int copiesFormat; // save : format of its copies, 0 to copy the file
+  std::string file; // copy : written replay file
+  std::string name; // copy : name of the new replay
+};
+
+/*
+  the replays are compressed and written in this thread to not make freeze the
+  game at the end of a level ; the jobs are done in the order they are added
+*/
+class SaveReplaysThread : public XMThread {
+public:
+  SaveReplaysThread(StateManager *i_manager);
+  virtual ~SaveReplaysThread();
+
+  // the thread takes the ownership of the replay ; if i_copiesFormat is not
+  // 0, the replay is kept to write its copies in this format
+  void saveReplay(Replay *i_replay, int i_format, int i_copiesFormat = 0);
+  // copy a written replay file into Replays/i_name.rpl and add it in the db ;
+  // REPLAY_SAVED or REPLAY_FAILEDTOSAVE is sent once done
+  void copyReplay(const std::string &i_file, const std::string &i_name);
+  // wait until all the jobs are done
+  void waitForSaves();
+
+  // the waiting jobs are done before the end
+  virtual void askThreadToEnd();
+  int realThreadFunction();
+
+private:
+  void addJob(const ReplayToSave &i_job);
+  void doJob(const ReplayToSave &i_job);
+
+  StateManager *m_manager; // for the communication
+  SDL_mutex *m_jobsMutex;
+  SDL_cond *m_jobsCond; // signaled when a job is added or done
+  std::deque<ReplayToSave> m_jobs; // the first one is the current one
+  bool m_lastSaveFailed; // the copies are of the last written replay
+  Replay *m_lastReplay; // kept for the copies in an other format
+  int m_lastReplayCopiesFormat;
+};
+
+#endif
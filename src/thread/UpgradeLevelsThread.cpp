@@ -48,6 +48,14 @@ void UpgradeLevelsThread::setBeingDownloadedInformation(
   setThreadCurrentMicroOperation(p_information);
 }
 
+void UpgradeLevelsThread::setFileProgress(const std::string &p_information,
+                                          float p_percent) {
+  char v_progress[16];
+
+  snprintf(v_progress, sizeof(v_progress), " (%i%%)", (int)p_percent);
+  setThreadCurrentMicroOperation(p_information + v_progress);
+}
+
 void UpgradeLevelsThread::setNbLevels(unsigned int i_nb_levels) {
   m_nb_levels = i_nb_levels;
 }
@@ -111,6 +119,8 @@ int UpgradeLevelsThread::realThreadFunction() {
     ProxySettings *pProxySettings = XMSession::instance()->proxySettings();
     std::string webLevelsUrl = XMSession::instance()->webLevelsUrl();
     m_pWebLevels->setWebsiteInfos(webLevelsUrl, pProxySettings);
+    m_pWebLevels->setNbParallelDownloads(
+      XMSession::instance()->webDownloadsParallel());
 
     LogInfo("WWW: Checking for new or updated levels...");
 
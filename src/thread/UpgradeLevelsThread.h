@@ -41,6 +41,8 @@ public:
 
   virtual void setBeingDownloadedInformation(const std::string &p_information,
                                              bool p_isNew = true);
+  virtual void setFileProgress(const std::string &p_information,
+                               float p_percent);
   virtual bool shouldLevelBeUpdated(const std::string &LevelID);
 
   virtual int realThreadFunction();
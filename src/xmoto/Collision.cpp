@@ -29,6 +29,15 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "xmscene/Zone.h"
 #include <algorithm>
 
+#if defined(__SSE__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define XM_COLLISION_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define XM_COLLISION_NEON 1
+#include <arm_neon.h>
+#endif
+
 /*
    Prior to version 0.1.11, the far largest time sink in the game was the
    collision detection. Yup, it was actually just brute force search for
@@ -44,6 +53,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 */
 
 #define CD_EPSILON 0.01f
+/* how much collideCirclePath() lets the circle enter the lines */
+#define CD_PATH_PENETRATION 0.001f
 
 #define EMPTY_AND_CLEAR_VECTOR(v)                 \
   for (unsigned int i = 0; i < (v).size(); i++) { \
@@ -54,6 +65,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 CollisionSystem::CollisionSystem() {
   m_pGrid = NULL;
   m_bDebugFlag = false;
+  m_curCheck = 0;
 }
 
 CollisionSystem::~CollisionSystem() {
@@ -71,12 +83,11 @@ void CollisionSystem::reset(void) {
   }
 
   EMPTY_AND_CLEAR_VECTOR(m_Lines);
+  m_linesCheck.clear();
 
   m_entitiesHandler.reset();
   m_dynBlocksHandler.reset();
-  /* TODO::zone
   m_zonesHandler.reset();
-  */
   m_staticBlocksHandler.reset();
   m_staticBlocksHandlerSecondLayer.reset();
 
@@ -126,11 +137,10 @@ void CollisionSystem::setDims(float fMinX,
                              Vector2f(m_fMaxX, m_fMaxY),
                              m_nGridWidth,
                              m_nGridHeight);
-  /*TODO
   m_zonesHandler.setDims(Vector2f(m_fMinX, m_fMinY),
                          Vector2f(m_fMaxX, m_fMaxY),
-                         m_nGridWidth, m_nGridHeight);
-  */
+                         m_nGridWidth,
+                         m_nGridHeight);
   m_staticBlocksHandler.setDims(Vector2f(m_fMinX, m_fMinY),
                                 Vector2f(m_fMaxX, m_fMaxY),
                                 m_nGridWidth,
@@ -178,6 +188,9 @@ void CollisionSystem::defineLine(float x1,
   pNewLine->y2 = y2;
   pNewLine->fGrip = grip;
   m_Lines.push_back(pNewLine);
+  m_linesCheck.push_back(0);
+
+  float fLength2 = (x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1);
 
   /* Calculate cell coordinates */
   int nMinCX =
@@ -208,6 +221,13 @@ void CollisionSystem::defineLine(float x1,
       int i = cx + cy * m_nGridWidth;
 
       m_pGrid[i].Lines.push_back(pNewLine);
+      m_pGrid[i].LinesIndexes.push_back(m_Lines.size() - 1);
+      m_pGrid[i].X1.push_back(x1);
+      m_pGrid[i].Y1.push_back(y1);
+      m_pGrid[i].DX.push_back(x2 - x1);
+      m_pGrid[i].DY.push_back(y2 - y1);
+      m_pGrid[i].InvLength2.push_back(fLength2 > 0.0f ? 1.0f / fLength2
+                                                      : 0.0f);
     }
   }
 
@@ -223,6 +243,113 @@ bool CollisionSystem::checkLine(float x1, float y1, float x2, float y2) {
   return false;
 }
 
+/*===========================================================================
+Lines of a cell which can touch a circle
+===========================================================================*/
+/* fill m_nearLines with the indexes of the lines of the cell whose distance
+   to the center is not more than the radius, and which were not already
+   returned for this query (m_curCheck). The test is a bit larger than the
+   precise ones, which are still done on the returned lines, so that they
+   keep the same results. */
+unsigned int CollisionSystem::_getNearLines(GridCell &i_cell,
+                                            float x,
+                                            float y,
+                                            float r) {
+  unsigned int n = i_cell.Lines.size();
+  unsigned int nNear = 0;
+  unsigned int j = 0;
+  float fMaxDist2 = (r + CD_EPSILON) * (r + CD_EPSILON) + CD_EPSILON;
+
+  if (m_nearLines.size() < n) {
+    m_nearLines.resize(n);
+  }
+
+#if XM_COLLISION_SSE
+  __m128 px = _mm_set1_ps(x);
+  __m128 py = _mm_set1_ps(y);
+  __m128 maxDist2 = _mm_set1_ps(fMaxDist2);
+  __m128 zero = _mm_setzero_ps();
+  __m128 one = _mm_set1_ps(1.0f);
+
+  for (; j + 4 <= n; j += 4) {
+    __m128 dx = _mm_loadu_ps(&i_cell.DX[j]);
+    __m128 dy = _mm_loadu_ps(&i_cell.DY[j]);
+    __m128 wx = _mm_sub_ps(px, _mm_loadu_ps(&i_cell.X1[j]));
+    __m128 wy = _mm_sub_ps(py, _mm_loadu_ps(&i_cell.Y1[j]));
+
+    /* nearest point of the segment */
+    __m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(wx, dx), _mm_mul_ps(wy, dy)),
+                          _mm_loadu_ps(&i_cell.InvLength2[j]));
+    t = _mm_min_ps(_mm_max_ps(t, zero), one);
+    __m128 ex = _mm_sub_ps(wx, _mm_mul_ps(t, dx));
+    __m128 ey = _mm_sub_ps(wy, _mm_mul_ps(t, dy));
+    __m128 dist2 = _mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey));
+
+    int mask = _mm_movemask_ps(_mm_cmple_ps(dist2, maxDist2));
+    for (unsigned int k = 0; mask != 0; k++, mask >>= 1) {
+      if (mask & 1) {
+        m_nearLines[nNear++] = j + k;
+      }
+    }
+  }
+#elif XM_COLLISION_NEON
+  float32x4_t px = vdupq_n_f32(x);
+  float32x4_t py = vdupq_n_f32(y);
+  float32x4_t maxDist2 = vdupq_n_f32(fMaxDist2);
+  float32x4_t zero = vdupq_n_f32(0.0f);
+  float32x4_t one = vdupq_n_f32(1.0f);
+  uint32_t mask[4];
+
+  for (; j + 4 <= n; j += 4) {
+    float32x4_t dx = vld1q_f32(&i_cell.DX[j]);
+    float32x4_t dy = vld1q_f32(&i_cell.DY[j]);
+    float32x4_t wx = vsubq_f32(px, vld1q_f32(&i_cell.X1[j]));
+    float32x4_t wy = vsubq_f32(py, vld1q_f32(&i_cell.Y1[j]));
+
+    /* nearest point of the segment */
+    float32x4_t t = vmulq_f32(vaddq_f32(vmulq_f32(wx, dx), vmulq_f32(wy, dy)),
+                              vld1q_f32(&i_cell.InvLength2[j]));
+    t = vminq_f32(vmaxq_f32(t, zero), one);
+    float32x4_t ex = vsubq_f32(wx, vmulq_f32(t, dx));
+    float32x4_t ey = vsubq_f32(wy, vmulq_f32(t, dy));
+    float32x4_t dist2 = vaddq_f32(vmulq_f32(ex, ex), vmulq_f32(ey, ey));
+
+    vst1q_u32(mask, vcleq_f32(dist2, maxDist2));
+    for (unsigned int k = 0; k < 4; k++) {
+      if (mask[k] != 0) {
+        m_nearLines[nNear++] = j + k;
+      }
+    }
+  }
+#endif
+
+  /* remaining lines, or all of them without simd */
+  for (; j < n; j++) {
+    float wx = x - i_cell.X1[j];
+    float wy = y - i_cell.Y1[j];
+    float t = (wx * i_cell.DX[j] + wy * i_cell.DY[j]) * i_cell.InvLength2[j];
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    float ex = wx - t * i_cell.DX[j];
+    float ey = wy - t * i_cell.DY[j];
+
+    if (ex * ex + ey * ey <= fMaxDist2) {
+      m_nearLines[nNear++] = j;
+    }
+  }
+
+  /* remove the lines already returned for another cell */
+  unsigned int nUnique = 0;
+  for (unsigned int k = 0; k < nNear; k++) {
+    int nLine = i_cell.LinesIndexes[m_nearLines[k]];
+    if (m_linesCheck[nLine] != m_curCheck) {
+      m_linesCheck[nLine] = m_curCheck;
+      m_nearLines[nUnique++] = m_nearLines[k];
+    }
+  }
+
+  return nUnique;
+}
+
 /*===========================================================================
 Boolean check of collision between circle and system
 ===========================================================================*/
@@ -308,6 +435,9 @@ bool CollisionSystem::checkCircle(float x, float y, float r) {
     m_CheckedCells.clear();
   }
 
+  /* new query for _getNearLines() */
+  m_curCheck++;
+
   /* get dynamic blocks around */
   AABB BBox;
   BBox.addPointToAABB2f(fMinX, fMinY);
@@ -344,15 +474,16 @@ bool CollisionSystem::checkCircle(float x, float y, float r) {
       if (m_pGrid[i].Lines.empty())
         continue;
 
-      /* TODO: currently we will probably check the same lines several times
-       * each... AVOID THAT! */
-
-      /* Check all lines in cell */
-      for (unsigned int j = 0; j < m_pGrid[i].Lines.size(); j++) {
-        if (m_bDebugFlag)
+      if (m_bDebugFlag) {
+        for (unsigned int j = 0; j < m_pGrid[i].Lines.size(); j++) {
           m_CheckedLines.push_back(m_pGrid[i].Lines[j]);
+        }
+      }
 
-        if (_CheckCircleAndLine(m_pGrid[i].Lines[j], x, y, r))
+      /* Check the lines of the cell near the circle */
+      unsigned int nNearLines = _getNearLines(m_pGrid[i], x, y, r);
+      for (unsigned int j = 0; j < nNearLines; j++) {
+        if (_CheckCircleAndLine(m_pGrid[i].Lines[m_nearLines[j]], x, y, r))
           return true;
       }
     }
@@ -706,6 +837,9 @@ int CollisionSystem::collideCircle(float x,
     m_CheckedCellsW.clear();
   }
 
+  /* new query for _getNearLines() */
+  m_curCheck++;
+
   /* get dynamic blocks around */
   AABB BBox;
   BBox.addPointToAABB2f(fMinX, fMinY);
@@ -752,19 +886,18 @@ int CollisionSystem::collideCircle(float x,
       if (m_pGrid[i].Lines.empty())
         continue;
 
-      /* TODO: currently we will probably check the same lines several times
-       * each... AVOID THAT! */
-
-      /* Check all lines in cell */
-      for (unsigned int j = 0; j < m_pGrid[i].Lines.size(); j++) {
-        nNumC = _CollideCircleAndLine(m_pGrid[i].Lines[j],
+      /* Check the lines of the cell near the circle */
+      unsigned int nNearLines = _getNearLines(m_pGrid[i], x, y, r);
+      for (unsigned int j = 0; j < nNearLines; j++) {
+        Line *pLine = m_pGrid[i].Lines[m_nearLines[j]];
+        nNumC = _CollideCircleAndLine(pLine,
                                       x,
                                       y,
                                       r,
                                       pContacts,
                                       nNumC,
                                       nMaxC,
-                                      m_pGrid[i].Lines[j]->fGrip,
+                                      pLine->fGrip,
                                       i_physicsSettings);
       }
     }
@@ -777,6 +910,12 @@ int CollisionSystem::collideCircle(float x,
 /*===========================================================================
 Calculate precise intersections between circle-path and geometry, if any
 ===========================================================================*/
+/* fill cx, cy with the positions of the center where the circle first
+   touches the geometry while moving from (x1, y1) to (x2, y2), ordered from
+   the start of the path. The circle is stopped a bit inside the lines
+   (CD_PATH_PENETRATION) so that collideCircle() at this position gives the
+   contacts. Lines are one-sided, as in collideCircle() : lines the circle
+   starts behind are ignored. */
 int CollisionSystem::collideCirclePath(float x1,
                                        float y1,
                                        float x2,
@@ -785,7 +924,185 @@ int CollisionSystem::collideCirclePath(float x1,
                                        float *cx,
                                        float *cy,
                                        int nMaxC) {
-  return 0;
+  float t;
+
+  if (nMaxC <= 0) {
+    return 0;
+  }
+  m_pathHits.clear();
+
+  /* Calculate bounding box of the path */
+  float fMinX = std::min(x1, x2) - r;
+  float fMinY = std::min(y1, y2) - r;
+  float fMaxX = std::max(x1, x2) + r;
+  float fMaxY = std::max(y1, y2) + r;
+
+  /* Calculate cell coordinates */
+  int nMinCX =
+    (int)floor(((fMinX - m_fMinX - CD_EPSILON) * (float)m_nGridWidth) /
+               (m_fMaxX - m_fMinX));
+  int nMinCY =
+    (int)floor(((fMinY - m_fMinY - CD_EPSILON) * (float)m_nGridHeight) /
+               (m_fMaxY - m_fMinY));
+  int nMaxCX =
+    (int)floor(((fMaxX - m_fMinX + CD_EPSILON) * (float)m_nGridWidth) /
+               (m_fMaxX - m_fMinX));
+  int nMaxCY =
+    (int)floor(((fMaxY - m_fMinY + CD_EPSILON) * (float)m_nGridHeight) /
+               (m_fMaxY - m_fMinY));
+
+  if (nMinCX < 0)
+    nMinCX = 0;
+  if (nMinCY < 0)
+    nMinCY = 0;
+  if (nMaxCX > m_nGridWidth - 1)
+    nMaxCX = m_nGridWidth - 1;
+  if (nMaxCY > m_nGridHeight - 1)
+    nMaxCY = m_nGridHeight - 1;
+
+  /* get dynamic blocks around */
+  AABB BBox;
+  BBox.addPointToAABB2f(fMinX, fMinY);
+  BBox.addPointToAABB2f(fMaxX, fMaxY);
+  std::vector<Block *> &blocks = getDynBlocksNearPosition(BBox);
+
+  for (unsigned int i = 0; i < blocks.size(); i++) {
+    Block *pBlock = blocks[i];
+    if (pBlock->isBackground() == true)
+      continue;
+    std::vector<Line *> &blockLines = pBlock->getCollisionLines();
+    for (unsigned int j = 0; j < blockLines.size(); j++) {
+      if (_CirclePathAndLine(blockLines[j], x1, y1, x2, y2, r, t)) {
+        m_pathHits.push_back(t);
+        m_bDynamicTouched = true;
+      }
+    }
+  }
+
+  /* a line can be in several cells */
+  m_curCheck++;
+
+  /* For each cell we might have crossed... */
+  for (int ncx = nMinCX; ncx <= nMaxCX; ncx++) {
+    for (int ncy = nMinCY; ncy <= nMaxCY; ncy++) {
+      GridCell &cell = m_pGrid[ncx + ncy * m_nGridWidth];
+
+      for (unsigned int j = 0; j < cell.Lines.size(); j++) {
+        int nLine = cell.LinesIndexes[j];
+        if (m_linesCheck[nLine] == m_curCheck)
+          continue;
+        m_linesCheck[nLine] = m_curCheck;
+
+        if (_CirclePathAndLine(cell.Lines[j], x1, y1, x2, y2, r, t)) {
+          m_pathHits.push_back(t);
+        }
+      }
+    }
+  }
+
+  std::sort(m_pathHits.begin(), m_pathHits.end());
+
+  int nNumC = std::min((int)m_pathHits.size(), nMaxC);
+  for (int i = 0; i < nNumC; i++) {
+    cx[i] = x1 + (x2 - x1) * m_pathHits[i];
+    cy[i] = y1 + (y2 - y1) * m_pathHits[i];
+  }
+
+  return nNumC;
+}
+
+/* first time in [0, 1] where the center moving from (x1, y1) to (x2, y2) is
+   at the distance r from the point (px, py) */
+static bool _CirclePathAndPoint(float x1,
+                                float y1,
+                                float dx,
+                                float dy,
+                                float px,
+                                float py,
+                                float r,
+                                float &t) {
+  float fx = x1 - px;
+  float fy = y1 - py;
+  float a = dx * dx + dy * dy;
+  float b = 2.0f * (fx * dx + fy * dy);
+  float c = fx * fx + fy * fy - r * r;
+
+  if (a < 0.000001f) {
+    return false;
+  }
+
+  float fDisc = b * b - 4.0f * a * c;
+  if (fDisc < 0.0f) {
+    return false;
+  }
+
+  t = (-b - sqrt(fDisc)) / (2.0f * a);
+  return t >= 0.0f && t <= 1.0f;
+}
+
+bool CollisionSystem::_CirclePathAndLine(Line *pLine,
+                                         float x1,
+                                         float y1,
+                                         float x2,
+                                         float y2,
+                                         float r,
+                                         float &t) {
+  float vx = pLine->x2 - pLine->x1;
+  float vy = pLine->y2 - pLine->y1;
+
+  /* Too small? */
+  if (fabs(vx) < 0.0001f && fabs(vy) < 0.0001f) {
+    return false;
+  }
+
+  float fLength = sqrt(vx * vx + vy * vy);
+  float enx = -vy / fLength;
+  float eny = vx / fLength;
+
+  /* distances of the path ends to the line, in front of it */
+  float s1 = (x1 - pLine->x1) * enx + (y1 - pLine->y1) * eny;
+  float s2 = (x2 - pLine->x1) * enx + (y2 - pLine->y1) * eny;
+
+  /* Is the beginning "behind" the line? */
+  if (s1 < 0.0f) {
+    return false;
+  }
+
+  float fDist = r - CD_PATH_PENETRATION;
+  bool bHit = false;
+  float t1;
+
+  /* against the line itself */
+  if (s2 < fDist) {
+    t1 = s1 <= fDist ? 0.0f : (s1 - fDist) / (s1 - s2);
+
+    /* is the touching point on the segment? */
+    float px = x1 + (x2 - x1) * t1 - enx * fDist - pLine->x1;
+    float py = y1 + (y2 - y1) * t1 - eny * fDist - pLine->y1;
+    float u = (px * vx + py * vy) / (fLength * fLength);
+    if (u >= 0.0f && u <= 1.0f) {
+      t = t1;
+      bHit = true;
+    }
+  }
+
+  /* against the line endings */
+  if (_CirclePathAndPoint(
+        x1, y1, x2 - x1, y2 - y1, pLine->x1, pLine->y1, fDist, t1)) {
+    if (bHit == false || t1 < t) {
+      t = t1;
+      bHit = true;
+    }
+  }
+  if (_CirclePathAndPoint(
+        x1, y1, x2 - x1, y2 - y1, pLine->x2, pLine->y2, fDist, t1)) {
+    if (bHit == false || t1 < t) {
+      t = t1;
+      bHit = true;
+    }
+  }
+
+  return bHit;
 }
 
 /*===========================================================================
@@ -902,27 +1219,22 @@ std::vector<Entity *> &CollisionSystem::getEntitiesNearPosition(AABB &BBox) {
   return m_entitiesHandler.getElementsNearPosition(BBox);
 }
 
-/* TODO::zones
-void CollisionSystem::addZone(Zone* id)
-{
+/* zones */
+void CollisionSystem::addZone(Zone *id) {
   m_zonesHandler.addElement(id);
 }
 
-void CollisionSystem::removeZone(Zone* id)
-{
+void CollisionSystem::removeZone(Zone *id) {
   m_zonesHandler.removeElement(id);
 }
 
-void CollisionSystem::moveZone(Zone* id)
-{
+void CollisionSystem::moveZone(Zone *id) {
   m_zonesHandler.moveElement(id);
 }
 
-std::vector<Zone*> CollisionSystem::getZonesNearPosition(AABB& BBox)
-{
+std::vector<Zone *> &CollisionSystem::getZonesNearPosition(AABB &BBox) {
   return m_zonesHandler.getElementsNearPosition(BBox);
 }
-*/
 
 /* dynamic blocks */
 ColElement<Block> *CollisionSystem::addDynBlock(Block *id) {
@@ -119,6 +119,10 @@ private:
 /* Grid cell */
 struct GridCell {
   std::vector<Line *> Lines;
+  /* the same lines, as arrays of floats to test them by batches */
+  std::vector<int> LinesIndexes; /* in CollisionSystem::m_Lines */
+  std::vector<float> X1, Y1, DX, DY;
+  std::vector<float> InvLength2; /* 0.0 for a point */
 };
 
 /* Stats */
@@ -177,6 +181,7 @@ public:
   void setDebug(bool b) {
     m_bDebugFlag = b;
     m_entitiesHandler.setDebug(b);
+    m_zonesHandler.setDebug(b);
   }
 
   /* check this to see if we can remove this two functions */
@@ -200,12 +205,10 @@ public:
   void moveEntity(Entity *id);
   std::vector<Entity *> &getEntitiesNearPosition(AABB &BBox);
 
-  /* TODO::zones
-  void addZone(Zone* id);
-  void removeZone(Zone* id);
-  void moveZone(Zone* id);
-  std::vector<Zone*> getZonesNearPosition(AABB& BBox);
-  */
+  void addZone(Zone *id);
+  void removeZone(Zone *id);
+  void moveZone(Zone *id);
+  std::vector<Zone *> &getZonesNearPosition(AABB &BBox);
 
   struct ColElement<Block> *addDynBlock(Block *id);
   void removeDynBlock(Block *id);
@@ -227,9 +230,7 @@ private:
 
   ElementHandler<Entity> m_entitiesHandler;
   ElementHandler<Block> m_dynBlocksHandler;
-  /* TODO::zones
-  ElementHandler<Zone>   m_zonesHandler;
-  */
+  ElementHandler<Zone> m_zonesHandler;
   ElementHandler<Block> m_staticBlocksHandler;
   ElementHandler<Block> m_staticBlocksHandlerSecondLayer;
   std::vector<ElementHandler<Block> *> m_layerBlocksHandlers;
@@ -241,10 +242,26 @@ private:
 
   GridCell *m_pGrid;
 
+  /* a line can be in several cells ; check it once by query */
+  std::vector<unsigned int> m_linesCheck;
+  unsigned int m_curCheck;
+  /* lines of a cell returned by _getNearLines() */
+  std::vector<unsigned int> m_nearLines;
+  /* times of impact found by collideCirclePath() */
+  std::vector<float> m_pathHits;
+
   bool m_bDynamicTouched;
 
   /* Helpers */
+  unsigned int _getNearLines(GridCell &i_cell, float x, float y, float r);
   bool _CheckCircleAndLine(Line *pLine, float x, float y, float r);
+  bool _CirclePathAndLine(Line *pLine,
+                          float x1,
+                          float y1,
+                          float x2,
+                          float y2,
+                          float r,
+                          float &t);
   int _CollideCircleAndLine(Line *pLine,
                             float x,
                             float y,
@@ -46,6 +46,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "xmscene/Entity.h"
 
 #include "Replay.h"
+#include "ReplaysScanner.h"
 #include "VirtualLevelsList.h"
 #include "common/XMotoLoadReplaysInterface.h"
 #include "states/StateDeadMenu.h"
@@ -496,23 +497,82 @@ void GameApp::initReplaysFromDir(
   xmDatabase *threadDb,
   XMotoLoadReplaysInterface *pLoadReplaysInterface) {
   std::vector<std::string> ReplayFiles;
+  HashNamespace::unordered_map<std::string, xmDbReplayFile> v_indexed;
+  HashNamespace::unordered_map<std::string, bool> v_found;
+  HashNamespace::unordered_map<std::string, xmDbReplayFile>::iterator v_it;
+  std::vector<std::string> v_toRead;
+  std::vector<xmDbReplayFile> v_toReadFiles;
+  xmDbReplayFile v_file;
+  std::string v_name;
 
   ReplayFiles = XMFS::findPhysFiles(FDT_DATA, "Replays/*.rpl");
   threadDb->replays_add_begin();
 
+  /* only the replays whose file changed since they were indexed are read */
+  threadDb->replays_getFiles(v_indexed);
+
   for (unsigned int i = 0; i < ReplayFiles.size(); i++) {
-    try {
-      if (XMFS::getFileBaseName(ReplayFiles[i]) == "Latest") {
+    v_name = XMFS::getFileBaseName(ReplayFiles[i]);
+
+    // the first file found is the one opened by the name of the replay
+    if (v_name == "Latest" || v_found.find(v_name) != v_found.end()) {
+      continue;
+    }
+
+    v_file.filepath = ReplayFiles[i];
+    if (XMFS::getFileSizeAndTimeStamp(
+          v_file.filepath, v_file.fileSize, v_file.fileTimeStamp) == false) {
+      continue;
+    }
+    v_found[v_name] = true;
+
+    v_it = v_indexed.find(v_name);
+    if (v_it != v_indexed.end()) {
+      if (v_it->second.filepath == v_file.filepath &&
+          v_it->second.fileSize == v_file.fileSize &&
+          v_it->second.fileTimeStamp == v_file.fileTimeStamp) {
         continue;
       }
-      addReplay(ReplayFiles[i], threadDb, false);
-      if (pLoadReplaysInterface != NULL) {
-        pLoadReplaysInterface->loadReplayHook(
-          ReplayFiles[i], (int)((i * 100) / ((float)ReplayFiles.size())));
+      threadDb->replays_delete(v_name);
+    }
+
+    v_toRead.push_back(v_name);
+    v_toReadFiles.push_back(v_file);
+  }
+
+  /* replays removed from the disk */
+  for (v_it = v_indexed.begin(); v_it != v_indexed.end(); v_it++) {
+    if (v_found.find(v_it->first) == v_found.end()) {
+      threadDb->replays_delete(v_it->first);
+    }
+  }
+
+  LogInfo("Replays index: %u replays to read, %u up to date",
+          (unsigned int)v_toRead.size(),
+          (unsigned int)(v_found.size() - v_toRead.size()));
+
+  ReplaysScanner v_scanner(v_toRead);
+
+  for (unsigned int i = 0; i < v_toRead.size(); i++) {
+    ReplayInfo *rplInfos = v_scanner.getReplayInfos(i);
+
+    if (rplInfos != NULL) {
+      try {
+        threadDb->replays_add(rplInfos->Level,
+                              rplInfos->Name,
+                              rplInfos->Player,
+                              rplInfos->IsFinished,
+                              rplInfos->finishTime,
+                              v_toReadFiles[i]);
+      } catch (Exception &e) {
+        // ok, forget this replay
       }
+      delete rplInfos;
+    }
 
-    } catch (Exception &e) {
-      // ok, forget this replay
+    if (pLoadReplaysInterface != NULL) {
+      pLoadReplaysInterface->loadReplayHook(
+        v_toRead[i], (int)((i * 100) / ((float)v_toRead.size())));
     }
   }
   threadDb->replays_add_end();
@@ -522,18 +582,29 @@ void GameApp::addReplay(const std::string &i_file,
                         xmDatabase *pDb,
                         bool sendMessage) {
   ReplayInfo *rplInfos;
+  xmDbReplayFile v_file;
 
   rplInfos = Replay::getReplayInfos(XMFS::getFileBaseName(i_file));
   if (rplInfos == NULL) {
     throw Exception("Unable to extract data from replay file");
   }
 
+  // the file the replay is opened from, as found by initReplaysFromDir()
+  v_file.filepath =
+    XMFS::FullPath(FDT_DATA, "Replays/" + rplInfos->Name + ".rpl");
+  if (XMFS::getFileSizeAndTimeStamp(
+        v_file.filepath, v_file.fileSize, v_file.fileTimeStamp) == false) {
+    v_file.fileSize = -1; // read again on the next update of the index
+    v_file.fileTimeStamp = -1;
+  }
+
   try {
     pDb->replays_add(rplInfos->Level,
                      rplInfos->Name,
                      rplInfos->Player,
                      rplInfos->IsFinished,
-                     rplInfos->finishTime);
+                     rplInfos->finishTime,
+                     v_file);
     if (sendMessage == true)
       StateManager::instance()->sendAsynchronousMessage("REPLAYS_UPDATED");
 
@@ -2194,6 +2194,7 @@ void MGE_PlaySound::doAction(Scene *p_pScene) {
     return;
   }
 
+  p_pScene->lockSharedResources();
   try {
     Sound::playSampleByName(
       Theme::instance()->getSound(m_soundName)->FilePath(), m_volume);
@@ -2201,6 +2202,7 @@ void MGE_PlaySound::doAction(Scene *p_pScene) {
     LogWarning(
       "PlaySound(\"%s\") failed: %s", m_soundName.c_str(), e.getMsg().c_str());
   }
+  p_pScene->unlockSharedResources();
 }
 
 void MGE_PlaySound::serialize(DBuffer &Buffer) {
@@ -2240,12 +2242,14 @@ MGE_PlayMusic::MGE_PlayMusic(int p_eventTime, const std::string &p_name)
 MGE_PlayMusic::~MGE_PlayMusic() {}
 
 void MGE_PlayMusic::doAction(Scene *p_pScene) {
+  p_pScene->lockSharedResources();
   try {
     GameApp::instance()->playGameMusic(m_musicName);
   } catch (Exception &e) {
     LogWarning(
       "PlayMusic(\"%s\") failed: %s", m_musicName.c_str(), e.getMsg().c_str());
   }
+  p_pScene->unlockSharedResources();
 }
 
 void MGE_PlayMusic::serialize(DBuffer &Buffer) {
@@ -2276,11 +2280,13 @@ MGE_StopMusic::MGE_StopMusic(int p_eventTime)
 MGE_StopMusic::~MGE_StopMusic() {}
 
 void MGE_StopMusic::doAction(Scene *p_pScene) {
+  p_pScene->lockSharedResources();
   try {
     GameApp::instance()->playGameMusic("");
   } catch (Exception &e) {
     LogWarning("StopMusic failed: %s", e.getMsg().c_str());
   }
+  p_pScene->unlockSharedResources();
 }
 
 void MGE_StopMusic::serialize(DBuffer &Buffer) {
@@ -39,6 +39,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "GeomsManager.h"
 #include "LuaLibBase.h"
 #include "Replay.h"
+#include "SimulationBenchmark.h"
 #include "SysMessage.h"
 #include "XMDemo.h"
 #include "common/Packager.h"
@@ -118,6 +119,7 @@ int main(int nNumArgs, char **ppcArgs) {
   } catch (Exception &e) {
     if (Logger::isInitialized()) {
       LogError((std::string("Exception: ") + e.getMsg()).c_str());
+      Logger::flush();
     }
 
     printf("fatal exception : %s\n", e.getMsg().c_str());
@@ -256,6 +258,9 @@ void GameApp::run_load(int nNumArgs, char **ppcArgs) {
     XMSession::instance()->isVerbose()); /* apply verbose mode */
   Logger::setActiv(XMSession::instance()->noLog() ==
                    false); /* apply log activ mode */
+  if (v_xmArgs.isOptLogSampling()) {
+    Logger::setSampling(v_xmArgs.getOptLogSampling_value());
+  }
 
   LogInfo(std::string("X-Moto " + XMBuild::getVersionString(true)).c_str());
   LogInfo("Started at %s", iso8601Date().c_str());
@@ -269,7 +274,7 @@ void GameApp::run_load(int nNumArgs, char **ppcArgs) {
 
   if (v_xmArgs.isOptListLevels() || v_xmArgs.isOptListReplays() ||
       v_xmArgs.isOptReplayInfos() || v_xmArgs.isOptServerOnly() ||
-      v_xmArgs.isOptUpdateLevelsOnly()) {
+      v_xmArgs.isOptUpdateLevelsOnly() || v_xmArgs.isOptBenchSimulation()) {
     v_useGraphics = false;
   }
 
@@ -429,6 +434,9 @@ void GameApp::run_load(int nNumArgs, char **ppcArgs) {
   if (v_useGraphics || v_xmArgs.isOptServerOnly()) {
     initNetwork(v_xmArgs.isOptServerOnly(),
                 v_xmArgs.isOptServerOnly() || v_graphicAutomaticMode);
+  } else if (v_xmArgs.isOptBenchSimulation()) {
+    // the scene sends its events through the net client
+    initNetwork(true, true);
   }
 
   /* Init renderer */
@@ -445,7 +453,8 @@ void GameApp::run_load(int nNumArgs, char **ppcArgs) {
     v_updateAfterInitDone = true;
   }
 
-  if (v_xmArgs.isOptServerOnly() == false) {
+  if (v_xmArgs.isOptServerOnly() == false &&
+      v_xmArgs.isOptBenchSimulation() == false) {
     try {
       reloadTheme();
     } catch (Exception &e) {
@@ -557,12 +566,13 @@ void GameApp::run_load(int nNumArgs, char **ppcArgs) {
   }
 
   /* requires graphics now */
-  if (v_useGraphics == false && v_xmArgs.isOptServerOnly() == false) {
+  if (v_useGraphics == false && v_xmArgs.isOptServerOnly() == false &&
+      v_xmArgs.isOptBenchSimulation() == false) {
     quit();
     return;
   }
 
-  if (v_xmArgs.isOptServerOnly() == false) {
+  if (v_useGraphics) {
     _UpdateLoadingScreen();
 
     /* Find all files in the textures dir and load them */
@@ -612,7 +622,7 @@ void GameApp::run_load(int nNumArgs, char **ppcArgs) {
   LevelsManager::checkPrerequires();
 
   // don't need to create packs in server mode
-  if (v_xmArgs.isOptServerOnly() == false) {
+  if (v_useGraphics) {
     LevelsManager::instance()->makePacks(XMSession::instance()->profile(),
                                          XMSession::instance()->idRoom(0),
                                          XMSession::instance()->debug(),
@@ -621,7 +631,7 @@ void GameApp::run_load(int nNumArgs, char **ppcArgs) {
   }
 
   /* Update stats */
-  if (v_xmArgs.isOptServerOnly() == false) {
+  if (v_useGraphics) {
     if (XMSession::instance()->profile() != "") {
       pDb->stats_xmotoStarted(XMSession::instance()->sitekey(),
                               XMSession::instance()->profile());
@@ -633,6 +643,33 @@ void GameApp::run_load(int nNumArgs, char **ppcArgs) {
     _UpdateLoadingShell(); // no more loading screen
   }
 
+  if (v_xmArgs.isOptBenchSimulation()) {
+    try {
+      SimulationBenchmark v_bench;
+
+      if (v_xmArgs.getOptBenchSimulation_replay() != "") {
+        v_bench.setReplay(v_xmArgs.getOptBenchSimulation_replay());
+      } else {
+        v_bench.setLevel(v_xmArgs.getOptBenchSimulation_level());
+      }
+      if (v_xmArgs.isOptBenchSimulationInputs()) {
+        v_bench.loadInputs(v_xmArgs.getOptBenchSimulationInputs_file());
+      }
+      if (v_xmArgs.isOptBenchSimulationTime()) {
+        v_bench.setMaxTime(v_xmArgs.getOptBenchSimulationTime_value());
+      }
+      if (v_xmArgs.isOptBenchSimulationStep()) {
+        v_bench.setStepSize(v_xmArgs.getOptBenchSimulationStep_value());
+      }
+      v_bench.run(xmDatabase::instance("main"));
+    } catch (Exception &e) {
+      LogError((std::string("Exception: ") + e.getMsg()).c_str());
+    }
+
+    quit();
+    return;
+  }
+
   if (v_xmArgs.isOptServerOnly()) {
     try {
       // start the server
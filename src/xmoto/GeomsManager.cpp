@@ -20,17 +20,48 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 
 #include "GeomsManager.h"
 #include "Game.h"
+#include "common/Theme.h"
 #ifdef ENABLE_OPENGL
 #include "drawlib/DrawLibOpenGL.h"
 #endif
 #include "helpers/Log.h"
 #include "xmscene/Block.h"
+#include <algorithm>
+#include <math.h>
+
+/* to sort the batches in their drawing order */
+struct GeomBatchDrawingOrderSort {
+  bool operator()(GeomBatch *b1, GeomBatch *b2) {
+    // block textures first, then the lower edges and the upper edges
+    if (b1->isEdge != b2->isEdge) {
+      return b2->isEdge;
+    }
+    if (b1->isUpper != b2->isUpper) {
+      return b2->isUpper;
+    }
+    if (b1->pSprite == NULL || b2->pSprite == NULL) {
+      return b2->pSprite != NULL;
+    }
+    return b1->pSprite->getName() < b2->pSprite->getName();
+  }
+};
 
 Geom::Geom() {
   pTexture = NULL;
   pSprite = NULL;
 }
 
+GeomBatch::GeomBatch() {
+  layer = -1;
+  isLayer = false;
+  isBackground = false;
+  isEdge = false;
+  isUpper = false;
+  pSprite = NULL;
+  chunkX = chunkY = 0;
+  nVertexBufferID = nTexCoordBufferID = 0;
+}
+
 LevelGeoms::LevelGeoms(const std::string &i_levelId) {
   m_levelId = i_levelId;
   m_geomsLoaded = false;
@@ -40,6 +71,7 @@ LevelGeoms::~LevelGeoms() {
   // printf("~LevelGeoms(%25s) : blockGeoms = %4i, edgeGeoms = %4i\n",
   // m_levelId.c_str(), m_blockGeoms.size(), m_edgeGeoms.size());
 
+  deleteBatches();
   deleteGeoms(m_blockGeoms);
   deleteGeoms(m_edgeGeoms, true);
 }
@@ -58,6 +90,7 @@ void LevelGeoms::register_scene(Scene *i_scene) {
   if (m_geomsLoaded == false) {
     m_geomsLoaded = true;
     saveGeoms(i_scene);
+    buildBatches(i_scene);
   }
 }
 
@@ -84,6 +117,202 @@ void LevelGeoms::unregister_scene(Scene *i_scene) {
   }
 }
 
+void LevelGeoms::buildBatches(Scene *i_scene) {
+  std::vector<Block *> &v_blocks = i_scene->getLevelSrc()->Blocks();
+
+  for (unsigned int i = 0; i < v_blocks.size(); i++) {
+    Block *pBlock = v_blocks[i];
+    Geom *pGeom = pBlock->getGeom();
+
+    // dynamic blocks move, they are sent to the graphic card at each frame
+    if (pBlock->isDynamic() && pBlock->getLayer() == -1) {
+      continue;
+    }
+    // blocks which are not drawn
+    if (pBlock->getLayer() != -1 && pBlock->isLayer() == false) {
+      continue;
+    }
+    if (pGeom == NULL) {
+      continue;
+    }
+
+    // the square of the block is the one of the center of its geom
+    AABB v_aabb;
+    for (unsigned int j = 0; j < pGeom->Polys.size(); j++) {
+      for (unsigned int k = 0; k < pGeom->Polys[j]->nNumVertices; k++) {
+        v_aabb.addPointToAABB2f(pGeom->Polys[j]->pVertices[k].x,
+                                pGeom->Polys[j]->pVertices[k].y);
+      }
+    }
+    Vector2f v_center = (v_aabb.getBMin() + v_aabb.getBMax()) / 2.0;
+    int v_chunkX = (int)floorf(v_center.x / GEOMBATCH_CHUNK_SIZE);
+    int v_chunkY = (int)floorf(v_center.y / GEOMBATCH_CHUNK_SIZE);
+
+    addGeomToBatches(pBlock, pGeom, false, v_chunkX, v_chunkY);
+    for (unsigned int j = 0; j < pBlock->getEdgeGeoms().size(); j++) {
+      addGeomToBatches(
+        pBlock, pBlock->getEdgeGeoms()[j], true, v_chunkX, v_chunkY);
+    }
+  }
+
+  std::stable_sort(
+    m_batches.begin(), m_batches.end(), GeomBatchDrawingOrderSort());
+
+#ifdef ENABLE_OPENGL
+  /* Use VBO optimization? */
+  if (GameApp::instance()->getDrawLib()->useVBOs()) {
+    for (unsigned int i = 0; i < m_batches.size(); i++) {
+      GeomBatch *pBatch = m_batches[i];
+      if (pBatch->Vertices.size() == 0) {
+        continue;
+      }
+
+      /* Copy static coordinates unto video memory */
+      glGenBuffersARB(1, (GLuint *)&pBatch->nVertexBufferID);
+      glBindBufferARB(GL_ARRAY_BUFFER_ARB, pBatch->nVertexBufferID);
+      glBufferDataARB(GL_ARRAY_BUFFER_ARB,
+                      pBatch->Vertices.size() * sizeof(GeomCoord),
+                      (void *)&pBatch->Vertices[0],
+                      GL_STATIC_DRAW_ARB);
+
+      glGenBuffersARB(1, (GLuint *)&pBatch->nTexCoordBufferID);
+      glBindBufferARB(GL_ARRAY_BUFFER_ARB, pBatch->nTexCoordBufferID);
+      glBufferDataARB(GL_ARRAY_BUFFER_ARB,
+                      pBatch->TexCoords.size() * sizeof(GeomCoord),
+                      (void *)&pBatch->TexCoords[0],
+                      GL_STATIC_DRAW_ARB);
+    }
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+  }
+#endif
+
+  LogInfo("%i static geom batches", (int)m_batches.size());
+}
+
+void LevelGeoms::addGeomToBatches(Block *pBlock,
+                                  Geom *pGeom,
+                                  bool i_isEdge,
+                                  int i_chunkX,
+                                  int i_chunkY) {
+  Sprite *pSprite;
+  TColor v_blendColor;
+
+  if (i_isEdge) {
+    pSprite = pGeom->pSprite;
+    v_blendColor = pGeom->edgeBlendColor;
+  } else {
+    pSprite = pBlock->getSprite();
+    v_blendColor = pBlock->getBlendColor();
+  }
+
+  GeomBatchKey v_key;
+  v_key.layer = pBlock->getLayer();
+  v_key.isLayer = pBlock->isLayer();
+  v_key.isBackground = pBlock->isBackground();
+  v_key.isEdge = i_isEdge;
+  v_key.isUpper = i_isEdge && pGeom->isUpper;
+  v_key.pSprite = pSprite;
+  v_key.blendColor = v_blendColor.getColor();
+  v_key.chunkX = i_chunkX;
+  v_key.chunkY = i_chunkY;
+
+  GeomBatch *pBatch;
+  std::map<GeomBatchKey, GeomBatch *>::iterator v_batch =
+    m_batchesByKey.find(v_key);
+  if (v_batch != m_batchesByKey.end()) {
+    pBatch = v_batch->second;
+  } else {
+    pBatch = new GeomBatch;
+    m_batches.push_back(pBatch);
+    m_batchesByKey[v_key] = pBatch;
+
+    pBatch->layer = pBlock->getLayer();
+    pBatch->isLayer = pBlock->isLayer();
+    pBatch->isBackground = pBlock->isBackground();
+    pBatch->isEdge = i_isEdge;
+    pBatch->isUpper = i_isEdge && pGeom->isUpper;
+    pBatch->pSprite = pSprite;
+    pBatch->blendColor = v_blendColor;
+    pBatch->chunkX = i_chunkX;
+    pBatch->chunkY = i_chunkY;
+  }
+
+  for (unsigned int j = 0; j < pGeom->Polys.size(); j++) {
+    GeomPoly *pPoly = pGeom->Polys[j];
+
+    if (i_isEdge) {
+      // edges are quads
+      for (unsigned int k = 0; k + 3 < pPoly->nNumVertices; k += 4) {
+        unsigned int v_triangles[6] = { k, k + 1, k + 2, k, k + 2, k + 3 };
+        for (unsigned int l = 0; l < 6; l++) {
+          pBatch->Vertices.push_back(pPoly->pVertices[v_triangles[l]]);
+          pBatch->TexCoords.push_back(pPoly->pTexCoords[v_triangles[l]]);
+        }
+      }
+    } else {
+      // polygons are convex, make them a fan of triangles
+      for (unsigned int k = 1; k + 1 < pPoly->nNumVertices; k++) {
+        unsigned int v_triangle[3] = { 0, k, k + 1 };
+        for (unsigned int l = 0; l < 3; l++) {
+          pBatch->Vertices.push_back(pPoly->pVertices[v_triangle[l]]);
+          pBatch->TexCoords.push_back(pPoly->pTexCoords[v_triangle[l]]);
+        }
+      }
+    }
+
+    for (unsigned int k = 0; k < pPoly->nNumVertices; k++) {
+      pBatch->aabb.addPointToAABB2f(pPoly->pVertices[k].x,
+                                    pPoly->pVertices[k].y);
+    }
+  }
+}
+
+bool GeomBatchKey::operator<(const GeomBatchKey &i_key) const {
+  if (layer != i_key.layer) {
+    return layer < i_key.layer;
+  }
+  if (isLayer != i_key.isLayer) {
+    return isLayer < i_key.isLayer;
+  }
+  if (isBackground != i_key.isBackground) {
+    return isBackground < i_key.isBackground;
+  }
+  if (isEdge != i_key.isEdge) {
+    return isEdge < i_key.isEdge;
+  }
+  if (isUpper != i_key.isUpper) {
+    return isUpper < i_key.isUpper;
+  }
+  if (pSprite != i_key.pSprite) {
+    return pSprite < i_key.pSprite;
+  }
+  if (blendColor != i_key.blendColor) {
+    return blendColor < i_key.blendColor;
+  }
+  if (chunkX != i_key.chunkX) {
+    return chunkX < i_key.chunkX;
+  }
+  return chunkY < i_key.chunkY;
+}
+
+void LevelGeoms::deleteBatches() {
+  for (unsigned int i = 0; i < m_batches.size(); i++) {
+#ifdef ENABLE_OPENGL
+    if (m_batches[i]->nVertexBufferID) {
+      glDeleteBuffersARB(1, (GLuint *)&m_batches[i]->nVertexBufferID);
+      glDeleteBuffersARB(1, (GLuint *)&m_batches[i]->nTexCoordBufferID);
+    }
+#endif
+    delete m_batches[i];
+  }
+  m_batches.clear();
+  m_batchesByKey.clear();
+}
+
+std::vector<GeomBatch *> &LevelGeoms::getBatches() {
+  return m_batches;
+}
+
 unsigned int LevelGeoms::getNumberOfBlockGeoms() const {
   return m_blockGeoms.size();
 }
@@ -171,25 +400,6 @@ Geom *LevelGeoms::loadBlockGeom(Block *pBlock,
     }
 
     o_geomBytes += pPoly->nNumVertices * (4 * sizeof(float));
-#ifdef ENABLE_OPENGL
-    /* Use VBO optimization? */
-    if (GameApp::instance()->getDrawLib()->useVBOs()) {
-      /* Copy static coordinates unto video memory */
-      glGenBuffersARB(1, (GLuint *)&pPoly->nVertexBufferID);
-      glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nVertexBufferID);
-      glBufferDataARB(GL_ARRAY_BUFFER_ARB,
-                      pPoly->nNumVertices * 2 * sizeof(float),
-                      (void *)pPoly->pVertices,
-                      GL_STATIC_DRAW_ARB);
-
-      glGenBuffersARB(1, (GLuint *)&pPoly->nTexCoordBufferID);
-      glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nTexCoordBufferID);
-      glBufferDataARB(GL_ARRAY_BUFFER_ARB,
-                      pPoly->nNumVertices * 2 * sizeof(float),
-                      (void *)pPoly->pTexCoords,
-                      GL_STATIC_DRAW_ARB);
-    }
-#endif
   }
 
   return pSuitableGeom;
@@ -655,31 +865,6 @@ std::vector<Geom *> LevelGeoms::loadBlockEdgeGeom(Block *pBlock,
                    v_upperBlockGeomsIndex.end());
   v_geoms = v_tempVec;
 
-#ifdef ENABLE_OPENGL
-  /* Use VBO optimization? */
-  if (GameApp::instance()->getDrawLib()->useVBOs()) {
-    for (unsigned int k = 0; k < v_geoms.size(); k++) {
-      for (unsigned int l = 0; l < v_geoms[k]->Polys.size(); l++) {
-        GeomPoly *pPoly = v_geoms[k]->Polys[l];
-
-        glGenBuffersARB(1, (GLuint *)&pPoly->nVertexBufferID);
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nVertexBufferID);
-        glBufferDataARB(GL_ARRAY_BUFFER_ARB,
-                        pPoly->nNumVertices * 2 * sizeof(float),
-                        (void *)pPoly->pVertices,
-                        GL_STATIC_DRAW_ARB);
-
-        glGenBuffersARB(1, (GLuint *)&pPoly->nTexCoordBufferID);
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nTexCoordBufferID);
-        glBufferDataARB(GL_ARRAY_BUFFER_ARB,
-                        pPoly->nNumVertices * 2 * sizeof(float),
-                        (void *)pPoly->pTexCoords,
-                        GL_STATIC_DRAW_ARB);
-      }
-    }
-  }
-#endif
-
   return v_geoms;
 }
 
@@ -712,13 +897,6 @@ void LevelGeoms::deleteGeoms(std::vector<Geom *> &geom, bool useFree) {
   /* Clean up optimized scene */
   for (unsigned int i = 0; i < geom.size(); i++) {
     for (unsigned int j = 0; j < geom[i]->Polys.size(); j++) {
-#ifdef ENABLE_OPENGL
-      if (geom[i]->Polys[j]->nVertexBufferID) {
-        glDeleteBuffersARB(1, (GLuint *)&geom[i]->Polys[j]->nVertexBufferID);
-        glDeleteBuffersARB(1, (GLuint *)&geom[i]->Polys[j]->nTexCoordBufferID);
-      }
-#endif
-
       if (useFree == true) {
         free(geom[i]->Polys[j]->pTexCoords);
         free(geom[i]->Polys[j]->pVertices);
@@ -782,6 +960,16 @@ unsigned int GeomsManager::getNumberOfBlockGeoms() const {
   return n;
 }
 
+std::vector<GeomBatch *> &GeomsManager::getBatches(Scene *i_scene) {
+  LevelGeoms *v_levelGeoms = getLevelGeom(i_scene);
+
+  // the geoms of the scene are not loaded : nothing to draw
+  if (v_levelGeoms == NULL) {
+    return m_noBatches;
+  }
+  return v_levelGeoms->getBatches();
+}
+
 unsigned int GeomsManager::getNumberOfEdgeGeoms() const {
   unsigned int n = 0;
   for (unsigned int i = 0; i < m_levelGeoms.size(); i++) {
@@ -21,6 +21,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "helpers/Color.h"
 #include "helpers/Singleton.h"
 #include "helpers/VMath.h"
+#include <map>
 #include <string>
 #include <vector>
 
@@ -30,6 +31,7 @@ class Block;
 class ConvexBlock;
 class BlockVertex;
 class EdgeEffectSprite;
+class Sprite;
 
 struct GeomCoord {
   float x, y;
@@ -39,14 +41,11 @@ struct GeomPoly {
   GeomPoly() {
     nNumVertices = 0;
     pVertices = pTexCoords = NULL;
-    nVertexBufferID = nTexCoordBufferID = 0;
   }
 
   unsigned int nNumVertices;
   GeomCoord *pVertices;
   GeomCoord *pTexCoords;
-
-  unsigned int nVertexBufferID, nTexCoordBufferID;
 };
 
 struct Geom {
@@ -61,6 +60,47 @@ struct Geom {
   bool isUpper;
 };
 
+/* size of the squares of the level in which the static geoms are merged */
+#define GEOMBATCH_CHUNK_SIZE 32.0
+
+/*
+  the static geoms of a square of the level sharing the same texture and the
+  same color, merged into triangles to be drawn in one call
+*/
+struct GeomBatch {
+  GeomBatch();
+
+  /* where the blocks are drawn */
+  int layer; // -1 for the main layers
+  bool isLayer;
+  bool isBackground;
+
+  bool isEdge;
+  bool isUpper; // only used for edge batches
+  Sprite *pSprite;
+  TColor blendColor;
+  int chunkX, chunkY;
+  AABB aabb;
+
+  std::vector<GeomCoord> Vertices;
+  std::vector<GeomCoord> TexCoords;
+  unsigned int nVertexBufferID, nTexCoordBufferID;
+};
+
+/* geoms with the same key are drawn in the same batch */
+struct GeomBatchKey {
+  int layer;
+  bool isLayer;
+  bool isBackground;
+  bool isEdge;
+  bool isUpper;
+  Sprite *pSprite;
+  Color blendColor;
+  int chunkX, chunkY;
+
+  bool operator<(const GeomBatchKey &i_key) const;
+};
+
 struct BlockGeoms {
   Geom *gmain;
   std::vector<Geom *> gedges;
@@ -78,6 +118,7 @@ public:
   unsigned int getNumberOfRegisteredScenes();
   unsigned int getNumberOfBlockGeoms() const;
   unsigned int getNumberOfEdgeGeoms() const;
+  std::vector<GeomBatch *> &getBatches();
 
   // for GeomsMangager use only :
   void register_scene(Scene *i_scene);
@@ -97,6 +138,14 @@ private:
   void deleteGeoms(std::vector<Geom *> &geom, bool useFree = false);
   void saveGeoms(Scene *i_scene);
 
+  void buildBatches(Scene *i_scene);
+  void addGeomToBatches(Block *pBlock,
+                        Geom *pGeom,
+                        bool i_isEdge,
+                        int i_chunkX,
+                        int i_chunkY);
+  void deleteBatches();
+
   static void calculateEdgePosition(Block *pBlock,
                                     BlockVertex *vertexA1,
                                     BlockVertex *vertexB1,
@@ -134,6 +183,8 @@ private:
   bool m_geomsLoaded; // once a level has load all the geoms, this is true and
   // all geoms can be reused for new levels
   std::vector<BlockGeoms> m_savedBlockGeoms;
+  std::vector<GeomBatch *> m_batches;
+  std::map<GeomBatchKey, GeomBatch *> m_batchesByKey;
 };
 
 class GeomsManager : public Singleton<GeomsManager> {
@@ -151,7 +202,11 @@ public:
   unsigned int getNumberOfBlockGeoms() const;
   unsigned int getNumberOfEdgeGeoms() const;
 
+  // static geoms batches of the level of the scene
+  std::vector<GeomBatch *> &getBatches(Scene *i_scene);
+
 private:
   LevelGeoms *getLevelGeom(Scene *i_scene);
   std::vector<LevelGeoms *> m_levelGeoms;
+  std::vector<GeomBatch *> m_noBatches; // for the scenes not registered
 };
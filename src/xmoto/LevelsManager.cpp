@@ -19,6 +19,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 =============================================================================*/
 
 #include "LevelsManager.h"
+#include "LevelsScanner.h"
 #include "GameText.h"
 #include "SysMessage.h"
 #include "common/VFileIO.h"
@@ -46,37 +47,28 @@ LevelsPack::LevelsPack(std::string i_name,
 LevelsPack::~LevelsPack() {}
 
 void LevelsPack::updateCount(xmDatabase *i_db, const std::string &i_profile) {
-  char **v_result;
-  unsigned int nrow;
-
   /* number of levels*/
-  v_result =
-    i_db->readDB("SELECT count(id_level) FROM (" + m_sql_levels + ");", nrow);
+  xmDbQuery v_levelsQuery(
+    i_db, "SELECT count(id_level) FROM (" + m_sql_levels + ");");
 
-  if (i_db->getResult(v_result, 1, 0, 0) == NULL) {
-    i_db->read_DB_free(v_result);
+  if (v_levelsQuery.next() == false || v_levelsQuery.isNull(0)) {
     throw Exception("Unable to update level pack count");
   }
-
-  m_nbLevels = atoi(i_db->getResult(v_result, 1, 0, 0));
-  i_db->read_DB_free(v_result);
+  m_nbLevels = v_levelsQuery.getInt(0);
 
   /* finished levels */
-  v_result = i_db->readDB(
+  xmDbQuery v_finishedQuery(
+    i_db,
     "SELECT count(1) FROM (SELECT a.id_level FROM (" + m_sql_levels +
       ") AS a INNER JOIN stats_profiles_levels AS b ON a.id_level=b.id_level "
-      "WHERE b.id_profile=\"" +
-      xmDatabase::protectString(i_profile) +
-      "\" AND b.nbCompleted+0 > 0 "
-      "GROUP BY a.id_level);",
-    nrow);
+      "WHERE b.id_profile=? AND b.nbCompleted+0 > 0 "
+      "GROUP BY a.id_level);");
+  v_finishedQuery.bind(i_profile);
 
-  if (nrow != 1) {
-    i_db->read_DB_free(v_result);
+  if (v_finishedQuery.next() == false) {
     throw Exception("Unable to update level pack count");
   }
-  m_nbFinishedLevels = atoi(i_db->getResult(v_result, 1, 0, 0));
-  i_db->read_DB_free(v_result);
+  m_nbFinishedLevels = v_finishedQuery.getInt(0);
 }
 
 int LevelsPack::getNumberOfLevels() {
@@ -89,26 +81,26 @@ std::string LevelsPack::getLevelsQuery() const {
          ";";
 }
 
-std::string LevelsPack::getLevelsWithHighscoresQuery(
-  const std::string &i_profile,
-  const std::string &i_id_room) const {
+std::string LevelsPack::getLevelsWithHighscoresQuery() const {
   return "SELECT a.id_level AS id_level, MIN(a.name) AS name, "
          "MIN(c.finishTime+0), MIN(b.finishTime+0) "
          "FROM (" +
          m_sql_levels +
          ") AS a "
          "LEFT OUTER JOIN webhighscores AS b "
-         "ON (a.id_level = b.id_level AND b.id_room=" +
-         i_id_room +
-         ") "
+         "ON (a.id_level = b.id_level AND b.id_room=?) "
          "LEFT OUTER JOIN profile_completedLevels AS c "
-         "ON (a.id_level=c.id_level AND c.id_profile=\"" +
-         xmDatabase::protectString(i_profile) +
-         "\") "
+         "ON (a.id_level=c.id_level AND c.id_profile=?) "
          "GROUP BY a.id_level ORDER BY MIN(a.sort_field) " +
          std::string(m_ascSort ? "ASC" : "DESC") + ";";
 }
 
+void LevelsPack::bindLevelsWithHighscoresQuery(xmDbQuery &io_query,
+                                               const std::string &i_profile,
+                                               const std::string &i_id_room) {
+  io_query.bind(atoi(i_id_room.c_str())).bind(i_profile);
+}
+
 int LevelsPack::getNumberOfFinishedLevels() {
   return m_nbFinishedLevels;
 }
@@ -904,7 +896,9 @@ void LevelsManager::reloadExternalLevels(
   XMotoLoadLevelsInterface *i_loadLevelsInterface) {
   std::vector<std::string> LvlFiles =
     XMFS::findPhysFiles(FDT_DATA, "Levels/MyLevels/*.lvl", true);
+  std::vector<std::string> v_toLoad;
   std::string v_levelName;
+  unsigned int v_nbDone = 0;
 
   // main case : no external level
   if (LvlFiles.size() == 0) {
@@ -915,37 +909,55 @@ void LevelsManager::reloadExternalLevels(
   for (unsigned int i = 0; i < LvlFiles.size(); i++) {
     /* add the level from the unloaded levels if possible to make it faster */
     if (i_db->levels_add_fast(LvlFiles[i], v_levelName, true) == false) {
-      Level *v_level = new Level();
-
-      try {
-        v_level->setFileName(LvlFiles[i]);
-        v_level->loadReducedFromFile(i_loadMainLayerOnly);
+      v_toLoad.push_back(LvlFiles[i]);
+      continue;
+    }
 
-        v_levelName = v_level->Name();
+    v_nbDone++;
+    if (i_loadLevelsInterface != NULL) {
+      i_loadLevelsInterface->loadLevelHook(v_levelName,
+                                           (v_nbDone * 100) / LvlFiles.size());
+    }
+  }
 
-        // Check for ID conflict
-        if (doesLevelExist(v_level->Id(), i_db)) {
-          throw Exception("Duplicate level ID");
+  /* load the other ones in parallel ; only this thread writes into the db */
+  if (v_toLoad.size() != 0) {
+    LevelsScanner v_scanner(v_toLoad, i_loadMainLayerOnly);
+
+    for (unsigned int i = 0; i < v_toLoad.size(); i++) {
+      std::string v_error;
+      Level *v_level = v_scanner.getLevel(i, v_error);
+
+      v_levelName = "";
+      if (v_level != NULL) {
+        try {
+          v_levelName = v_level->Name();
+
+          // Check for ID conflict
+          if (doesLevelExist(v_level->Id(), i_db)) {
+            throw Exception("Duplicate level ID");
+          }
+          i_db->levels_add(v_level->Id(),
+                           v_level->FileName(),
+                           v_level->Name(),
+                           v_level->Checksum(),
+                           v_level->Author(),
+                           v_level->Description(),
+                           v_level->Date(),
+                           v_level->Music(),
+                           v_level->isScripted(),
+                           v_level->isPhysics(),
+                           true);
+        } catch (Exception &e) {
         }
-        i_db->levels_add(v_level->Id(),
-                         v_level->FileName(),
-                         v_level->Name(),
-                         v_level->Checksum(),
-                         v_level->Author(),
-                         v_level->Description(),
-                         v_level->Date(),
-                         v_level->Music(),
-                         v_level->isScripted(),
-                         v_level->isPhysics(),
-                         true);
-      } catch (Exception &e) {
+        delete v_level;
       }
-      delete v_level;
-    }
 
-    if (i_loadLevelsInterface != NULL) {
-      i_loadLevelsInterface->loadLevelHook(v_levelName,
-                                           ((i + 1) * 100) / LvlFiles.size());
+      v_nbDone++;
+      if (i_loadLevelsInterface != NULL) {
+        i_loadLevelsInterface->loadLevelHook(
+          v_levelName, (v_nbDone * 100) / LvlFiles.size());
+      }
     }
   }
 
@@ -998,7 +1010,9 @@ void LevelsManager::reloadInternalLevels(
   XMotoLoadLevelsInterface *i_loadLevelsInterface) {
   std::vector<std::string> LvlFiles =
     XMFS::findPhysFiles(FDT_DATA, "Levels/*.lvl", true);
+  std::vector<std::string> v_toLoad;
   std::string v_levelName;
+  unsigned int v_nbDone = 0;
 
   i_db->levels_add_begin(false);
 
@@ -1007,16 +1021,37 @@ void LevelsManager::reloadInternalLevels(
 
     v_isExternal = LvlFiles[i].find("Levels/MyLevels/") != std::string::npos;
     if (v_isExternal) {
+      v_nbDone++;
       continue; // don't load external levels now
     }
 
     /* add the level from the unloaded levels if possible to make it faster */
     if (i_db->levels_add_fast(LvlFiles[i], v_levelName, false) == false) {
-      Level *v_level = new Level();
+      v_toLoad.push_back(LvlFiles[i]);
+      continue;
+    }
+
+    v_nbDone++;
+    if (i_loadLevelsInterface != NULL) {
+      i_loadLevelsInterface->loadLevelHook(v_levelName,
+                                           (v_nbDone * 100) / LvlFiles.size());
+    }
+  }
 
+  /* load the other ones in parallel ; only this thread writes into the db */
+  if (v_toLoad.size() != 0) {
+    LevelsScanner v_scanner(v_toLoad, i_loadMainLayerOnly);
+
+    for (unsigned int i = 0; i < v_toLoad.size(); i++) {
+      std::string v_error;
+      Level *v_level = v_scanner.getLevel(i, v_error);
+
+      v_levelName = "";
       try {
-        v_level->setFileName(LvlFiles[i]);
-        v_level->loadReducedFromFile(i_loadMainLayerOnly);
+        if (v_level == NULL) {
+          throw Exception(v_error);
+        }
+        v_levelName = v_level->Name();
 
         // Check for ID conflict
         if (doesLevelExist(v_level->Id(), i_db)) {
@@ -1037,16 +1072,16 @@ void LevelsManager::reloadInternalLevels(
         LogWarning("(just mean that the level has been updated if the level is "
                    "in xmoto.bin) ** : %s (%s - %s)",
                    e.getMsg().c_str(),
-                   v_level->Name().c_str(),
-                   v_level->FileName().c_str());
+                   v_levelName.c_str(),
+                   v_toLoad[i].c_str());
       }
-      v_levelName = v_level->Name();
       delete v_level;
-    }
 
-    if (i_loadLevelsInterface != NULL) {
-      i_loadLevelsInterface->loadLevelHook(v_levelName,
-                                           ((i + 1) * 100) / LvlFiles.size());
+      v_nbDone++;
+      if (i_loadLevelsInterface != NULL) {
+        i_loadLevelsInterface->loadLevelHook(
+          v_levelName, (v_nbDone * 100) / LvlFiles.size());
+      }
     }
   }
 
@@ -1131,23 +1166,32 @@ void LevelsManager::updateLevelsFromLvl(
   WWWAppInterface *pCaller,
   xmDatabase *i_db) {
   Level *v_level;
+  std::string v_error;
   int current = 0;
   float total = 100.0 / (float)(NewLvl.size() + UpdatedLvl.size());
 
+  /* new levels first, then the updated ones */
+  std::vector<std::string> v_files = NewLvl;
+  v_files.insert(v_files.end(), UpdatedLvl.begin(), UpdatedLvl.end());
+
   try {
     i_db->levels_addToNew_begin();
     i_db->levels_cleanNew();
 
+    /* load the levels in parallel ; only this thread writes into the db */
+    LevelsScanner v_scanner(v_files, i_loadMainLayerOnly);
+
     /* new */
     for (unsigned int i = 0; i < NewLvl.size(); i++) {
-      v_level = new Level();
+      pCaller->setTaskProgress(current * total);
+      current++;
 
-      try {
-        pCaller->setTaskProgress(current * total);
-        current++;
+      v_level = v_scanner.getLevel(i, v_error);
 
-        v_level->setFileName(NewLvl[i]);
-        v_level->loadReducedFromFile(i_loadMainLayerOnly);
+      try {
+        if (v_level == NULL) {
+          throw Exception(v_error);
+        }
 
         // Check for ID conflict
         if (doesLevelExist(v_level->Id(), i_db)) {
@@ -1173,11 +1217,12 @@ void LevelsManager::updateLevelsFromLvl(
 
     /* updated */
     for (unsigned int i = 0; i < UpdatedLvl.size(); i++) {
-      v_level = new Level();
+      v_level = v_scanner.getLevel(NewLvl.size() + i, v_error);
 
       try {
-        v_level->setFileName(UpdatedLvl[i]);
-        v_level->loadReducedFromFile(i_loadMainLayerOnly);
+        if (v_level == NULL) {
+          throw Exception(v_error);
+        }
 
         pCaller->setTaskProgress(current * total);
         pCaller->setBeingDownloadedInformation(v_level->Name());
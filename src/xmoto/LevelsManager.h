@@ -50,8 +50,11 @@ public:
   std::string Group() const;
   void setGroup(std::string i_group);
   std::string getLevelsQuery() const;
-  std::string getLevelsWithHighscoresQuery(const std::string &i_profile,
-                                           const std::string &i_id_room) const;
+  /* the query has parameters, to bind with bindLevelsWithHighscoresQuery() */
+  std::string getLevelsWithHighscoresQuery() const;
+  static void bindLevelsWithHighscoresQuery(xmDbQuery &io_query,
+                                            const std::string &i_profile,
+                                            const std::string &i_id_room);
   int getNumberOfLevels();
   int getNumberOfFinishedLevels();
 
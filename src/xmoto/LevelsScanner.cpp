@@ -0,0 +1,75 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "LevelsScanner.h"
+#include "helpers/VExcept.h"
+#include "xmscene/Level.h"
+#include <libxml/parser.h>
+
+LevelsScanner::LevelsScanner(const std::vector<std::string> &i_files,
+                             bool i_loadMainLayerOnly)
+  : ParallelReader(i_files.size(), "LevelsScanner") {
+  m_files = i_files;
+  m_loadMainLayerOnly = i_loadMainLayerOnly;
+  m_levels.resize(m_files.size(), NULL);
+  m_errors.resize(m_files.size());
+
+  // libxml2 must be initialized by the main thread
+  xmlInitParser();
+
+  startThreads();
+}
+
+LevelsScanner::~LevelsScanner() {
+  stopThreads();
+
+  // levels not taken by the caller
+  for (unsigned int i = 0; i < m_levels.size(); i++) {
+    if (m_levels[i] != NULL) {
+      delete m_levels[i];
+    }
+  }
+}
+
+void LevelsScanner::readItem(unsigned int i) {
+  Level *v_level = new Level();
+
+  try {
+    v_level->setFileName(m_files[i]);
+    v_level->loadReducedFromFile(m_loadMainLayerOnly);
+  } catch (Exception &e) {
+    m_errors[i] = e.getMsg();
+    delete v_level;
+    v_level = NULL;
+  }
+
+  m_levels[i] = v_level;
+}
+
+Level *LevelsScanner::getLevel(unsigned int i, std::string &o_error) {
+  Level *v_level;
+
+  waitItem(i);
+  v_level = m_levels[i];
+  o_error = m_errors[i];
+  m_levels[i] = NULL;
+
+  return v_level;
+}
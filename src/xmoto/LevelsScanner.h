@@ -0,0 +1,57 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __LEVELSSCANNER_H__
+#define __LEVELSSCANNER_H__
+
+#include "helpers/ParallelReader.h"
+#include <string>
+#include <vector>
+
+class Level;
+
+/**
+ * load the reduced levels of a files list (xml parse, checksum and cache
+ * export) with several threads. The levels are given back in the order of the
+ * list, so that the caller stays the only one writing into the database.
+ */
+class LevelsScanner : public ParallelReader {
+public:
+  LevelsScanner(const std::vector<std::string> &i_files,
+                bool i_loadMainLayerOnly);
+  virtual ~LevelsScanner();
+
+  /* wait for the level of the file i ; return NULL if it can't be loaded
+     (o_error is then set). The caller owns the level. Call it in the order
+     of the list */
+  Level *getLevel(unsigned int i, std::string &o_error);
+
+protected:
+  virtual void readItem(unsigned int i);
+
+private:
+  std::vector<std::string> m_files;
+  bool m_loadMainLayerOnly;
+
+  std::vector<Level *> m_levels;
+  std::vector<std::string> m_errors;
+};
+
+#endif
@@ -29,9 +29,15 @@ lua_Number LuaLibBase::X_luaL_check_number(lua_State *L, int narg) {
   return d;
 }
 
+const char LuaLibBase::m_registryKey = 0;
+
 LuaLibBase::LuaLibBase(const std::string &i_libname, luaL_Reg i_reg[]) {
   m_pL = luaL_newstate();
 
+  lua_pushlightuserdata(m_pL, (void *)&m_registryKey);
+  lua_pushlightuserdata(m_pL, this);
+  lua_rawset(m_pL, LUA_REGISTRYINDEX);
+
 #if LUA_VERSION_NUM < 502
   luaopen_base(m_pL);
   luaopen_math(m_pL);
@@ -61,12 +67,21 @@ LuaLibBase::~LuaLibBase() {
   lua_close(m_pL);
 }
 
+LuaLibBase *LuaLibBase::getInstance(lua_State *pL) {
+  LuaLibBase *v_instance;
+
+  lua_pushlightuserdata(pL, (void *)&m_registryKey);
+  lua_rawget(pL, LUA_REGISTRYINDEX);
+  v_instance = (LuaLibBase *)lua_touserdata(pL, -1);
+  lua_pop(pL, 1);
+
+  return v_instance;
+}
+
 /*===========================================================================
   Simple lua interaction
   ===========================================================================*/
 bool LuaLibBase::scriptCallBool(const std::string &FuncName, bool bDefault) {
-  setInstance();
-
   bool bRet = bDefault;
 
   /* Fetch global function */
@@ -96,8 +111,6 @@ bool LuaLibBase::scriptCallBool(const std::string &FuncName, bool bDefault) {
 }
 
 void LuaLibBase::scriptCallVoid(const std::string &FuncName) {
-  setInstance();
-
   /* Fetch global function */
   lua_getglobal(m_pL, FuncName.c_str());
 
@@ -116,8 +129,6 @@ void LuaLibBase::scriptCallVoid(const std::string &FuncName) {
 }
 
 void LuaLibBase::scriptCallVoidNumberArg(const std::string &FuncName, int n) {
-  setInstance();
-
   /* Fetch global function */
   lua_getglobal(m_pL, FuncName.c_str());
 
@@ -139,8 +150,6 @@ void LuaLibBase::scriptCallVoidNumberArg(const std::string &FuncName, int n) {
 void LuaLibBase::scriptCallVoidNumberArg(const std::string &FuncName,
                                          int n1,
                                          int n2) {
-  setInstance();
-
   /* Fetch global function */
   lua_getglobal(m_pL, FuncName.c_str());
 
@@ -162,8 +171,6 @@ void LuaLibBase::scriptCallVoidNumberArg(const std::string &FuncName,
 
 void LuaLibBase::scriptCallTblVoid(const std::string &Table,
                                    const std::string &FuncName) {
-  setInstance();
-
   /* Fetch global table */
   lua_getglobal(m_pL, Table.c_str());
 
@@ -190,8 +197,6 @@ void LuaLibBase::scriptCallTblVoid(const std::string &Table,
 void LuaLibBase::scriptCallTblVoid(const std::string &Table,
                                    const std::string &FuncName,
                                    int n) {
-  setInstance();
-
   /* Fetch global table */
   lua_getglobal(m_pL, Table.c_str());
 
@@ -245,8 +250,6 @@ void LuaLibBase::loadScript(const std::string &i_scriptCode,
   /* Use the Lua aux lib to load the buffer */
   int nRet;
 
-  setInstance();
-
   nRet = luaL_loadbuffer(m_pL,
                          i_scriptCode.c_str(),
                          i_scriptCode.length(),
@@ -48,10 +48,9 @@ public:
   void scriptCallVoidNumberArg(const std::string &FuncName, int n1, int n2);
 
 protected:
-  // lua requires static values due to the static functions. So, set the
-  // instance used if needed.
-  // setInstance must be set before lua call
-  virtual void setInstance() = 0;
+  // lua calls static functions ; they get the instance of their lua state
+  // with getInstance(), so that several libs can run at the same time
+  static LuaLibBase *getInstance(lua_State *pL);
 
   /* get the number of arguments */
   static int args_numberOfArguments(lua_State *pL);
@@ -65,6 +64,8 @@ protected:
 
 private:
   lua_State *m_pL;
+
+  static const char m_registryKey; // its address is the key of the instance
 };
 
 #endif
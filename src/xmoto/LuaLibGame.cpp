@@ -106,9 +106,6 @@ luaL_Reg LuaLibGame::m_gameFuncs[] = {
   { NULL, NULL }
 };
 
-Scene *LuaLibGame::m_exec_world = NULL;
-Input *LuaLibGame::m_exec_activeInputHandler = NULL;
-
 LuaLibGame::LuaLibGame(Scene *i_pScene)
   : LuaLibBase("Game", m_gameFuncs) {
   m_pScene = i_pScene;
@@ -117,9 +114,12 @@ LuaLibGame::LuaLibGame(Scene *i_pScene)
 
 LuaLibGame::~LuaLibGame() {}
 
-void LuaLibGame::setInstance() {
-  m_exec_world = m_pScene;
-  m_exec_activeInputHandler = m_pActiveInputHandler;
+Scene *LuaLibGame::world(lua_State *pL) {
+  return ((LuaLibGame *)getInstance(pL))->m_pScene;
+}
+
+Input *LuaLibGame::inputHandler(lua_State *pL) {
+  return ((LuaLibGame *)getInstance(pL))->m_pActiveInputHandler;
 }
 
 /*===========================================================================
@@ -143,14 +143,14 @@ int LuaLibGame::L_Game_ClearMessages(lua_State *pL) {
   args_CheckNumberOfArguments(pL, 0);
 
   /* event for this */
-  m_exec_world->createGameEvent(new MGE_ClearMessages(m_exec_world->getTime()));
+  world(pL)->createGameEvent(new MGE_ClearMessages(world(pL)->getTime()));
   return 0;
 }
 
 int LuaLibGame::L_Game_PlaceInGameArrow(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_PlaceInGameArrow(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_PlaceInGameArrow(world(pL)->getTime(),
                              X_luaL_check_number(pL, 1),
                              X_luaL_check_number(pL, 2),
                              X_luaL_check_number(pL, 3)));
@@ -159,8 +159,8 @@ int LuaLibGame::L_Game_PlaceInGameArrow(lua_State *pL) {
 
 int LuaLibGame::L_Game_PlaceScreenArrow(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_PlaceScreenarrow(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_PlaceScreenarrow(world(pL)->getTime(),
                              X_luaL_check_number(pL, 1),
                              X_luaL_check_number(pL, 2),
                              X_luaL_check_number(pL, 3)));
@@ -169,7 +169,7 @@ int LuaLibGame::L_Game_PlaceScreenArrow(lua_State *pL) {
 
 int LuaLibGame::L_Game_HideArrow(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(new MGE_HideArrow(m_exec_world->getTime()));
+  world(pL)->createGameEvent(new MGE_HideArrow(world(pL)->getTime()));
   return 0;
 }
 
@@ -179,7 +179,7 @@ int LuaLibGame::L_Game_GetTime(lua_State *pL) {
   /* no event for this */
 
   /* Get current game time */
-  lua_pushnumber(pL, m_exec_world->getTime() / 100.0);
+  lua_pushnumber(pL, world(pL)->getTime() / 100.0);
   return 1;
 }
 
@@ -196,7 +196,7 @@ int LuaLibGame::L_Game_Message(lua_State *pL) {
     }
   }
 
-  m_exec_world->createGameEvent(new MGE_Message(m_exec_world->getTime(), Out));
+  world(pL)->createGameEvent(new MGE_Message(world(pL)->getTime(), Out));
   return 0;
 }
 
@@ -206,10 +206,10 @@ int LuaLibGame::L_Game_IsPlayerInZone(lua_State *pL) {
   Zone *v_zone;
 
   try {
-    v_zone = m_exec_world->getLevelSrc()->getZoneById(luaL_checkstring(pL, 1));
+    v_zone = world(pL)->getLevelSrc()->getZoneById(luaL_checkstring(pL, 1));
 
-    for (unsigned int i = 0; i < m_exec_world->Players().size(); i++) {
-      if (m_exec_world->Players()[i]->isTouching(v_zone)) {
+    for (unsigned int i = 0; i < world(pL)->Players().size(); i++) {
+      if (world(pL)->Players()[i]->isTouching(v_zone)) {
         res = true;
       }
     }
@@ -224,7 +224,7 @@ int LuaLibGame::L_Game_IsPlayerInZone(lua_State *pL) {
 int LuaLibGame::L_Game_MoveBlock(lua_State *pL) {
   /* event for this */
 
-  m_exec_world->createGameEvent(new MGE_MoveBlock(m_exec_world->getTime(),
+  world(pL)->createGameEvent(new MGE_MoveBlock(world(pL)->getTime(),
                                                   luaL_checkstring(pL, 1),
                                                   X_luaL_check_number(pL, 2),
                                                   X_luaL_check_number(pL, 3)));
@@ -238,7 +238,7 @@ int LuaLibGame::L_Game_GetBlockPos(lua_State *pL) {
   Block *pBlock;
 
   try {
-    pBlock = m_exec_world->getLevelSrc()->getBlockById(luaL_checkstring(pL, 1));
+    pBlock = world(pL)->getLevelSrc()->getBlockById(luaL_checkstring(pL, 1));
     lua_pushnumber(pL, pBlock->DynamicPosition().x);
     lua_pushnumber(pL, pBlock->DynamicPosition().y);
   } catch (Exception &e) {
@@ -252,8 +252,8 @@ int LuaLibGame::L_Game_GetBlockPos(lua_State *pL) {
 int LuaLibGame::L_Game_SetBlockPos(lua_State *pL) {
   /* event for this */
 
-  m_exec_world->createGameEvent(
-    new MGE_SetBlockPos(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetBlockPos(world(pL)->getTime(),
                         luaL_checkstring(pL, 1),
                         X_luaL_check_number(pL, 2),
                         X_luaL_check_number(pL, 3)));
@@ -263,7 +263,7 @@ int LuaLibGame::L_Game_SetBlockPos(lua_State *pL) {
 int LuaLibGame::L_Game_SetGravity(lua_State *pL) {
   /* event for this */
 
-  m_exec_world->createGameEvent(new MGE_SetGravity(m_exec_world->getTime(),
+  world(pL)->createGameEvent(new MGE_SetGravity(world(pL)->getTime(),
                                                    X_luaL_check_number(pL, 1),
                                                    X_luaL_check_number(pL, 2)));
   return 0;
@@ -273,16 +273,16 @@ int LuaLibGame::L_Game_GetGravity(lua_State *pL) {
   /* no event for this */
 
   /* Get gravity */
-  lua_pushnumber(pL, m_exec_world->getGravity().x);
-  lua_pushnumber(pL, m_exec_world->getGravity().y);
+  lua_pushnumber(pL, world(pL)->getGravity().x);
+  lua_pushnumber(pL, world(pL)->getGravity().y);
   return 2;
 }
 
 int LuaLibGame::L_Game_SetPlayerPosition(lua_State *pL) {
   /* event for this */
   bool bRight = X_luaL_check_number(pL, 3) > 0.0f;
-  m_exec_world->createGameEvent(
-    new MGE_SetPlayersPosition(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetPlayersPosition(world(pL)->getTime(),
                                X_luaL_check_number(pL, 1),
                                X_luaL_check_number(pL, 2),
                                bRight));
@@ -294,10 +294,10 @@ int LuaLibGame::L_Game_GetPlayerPosition(lua_State *pL) {
   float x = 0.0, y = 0.0;
   DriveDir v_direction = DD_RIGHT;
 
-  if (m_exec_world->Players().size() > 0) {
-    x = m_exec_world->Players()[0]->getState()->CenterP.x;
-    y = m_exec_world->Players()[0]->getState()->CenterP.y;
-    v_direction = m_exec_world->Players()[0]->getState()->Dir;
+  if (world(pL)->Players().size() > 0) {
+    x = world(pL)->Players()[0]->getState()->CenterP.x;
+    y = world(pL)->Players()[0]->getState()->CenterP.y;
+    v_direction = world(pL)->Players()[0]->getState()->Dir;
   }
 
   lua_pushnumber(pL, x);
@@ -314,7 +314,7 @@ int LuaLibGame::L_Game_GetEntityPos(lua_State *pL) {
   Entity *p;
 
   try {
-    p = m_exec_world->getLevelSrc()->getEntityById(luaL_checkstring(pL, 1));
+    p = world(pL)->getLevelSrc()->getEntityById(luaL_checkstring(pL, 1));
   } catch (Exception &e) {
     p = NULL;
   }
@@ -335,7 +335,7 @@ int LuaLibGame::L_Game_GetEntityRadius(lua_State *pL) {
   /* no event for this */
   try {
     lua_pushnumber(pL,
-                   m_exec_world->getLevelSrc()
+                   world(pL)->getLevelSrc()
                      ->getEntityById(luaL_checkstring(pL, 1))
                      ->Size());
   } catch (Exception &e) {
@@ -348,10 +348,10 @@ int LuaLibGame::L_Game_IsEntityTouched(lua_State *pL) {
   /* no event for this */
 
   bool v_touch = false;
-  if (m_exec_world->Players().size() > 0) {
+  if (world(pL)->Players().size() > 0) {
     try {
-      v_touch = m_exec_world->Players()[0]->isTouching(
-        m_exec_world->getLevelSrc()->getEntityById(luaL_checkstring(pL, 1)));
+      v_touch = world(pL)->Players()[0]->isTouching(
+        world(pL)->getLevelSrc()->getEntityById(luaL_checkstring(pL, 1)));
     } catch (Exception &e) {
       /* v_touch will be false */
     }
@@ -363,8 +363,8 @@ int LuaLibGame::L_Game_IsEntityTouched(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetEntityPos(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetEntityPos(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetEntityPos(world(pL)->getTime(),
                          luaL_checkstring(pL, 1),
                          X_luaL_check_number(pL, 2),
                          X_luaL_check_number(pL, 3)));
@@ -374,15 +374,24 @@ int LuaLibGame::L_Game_SetEntityPos(lua_State *pL) {
 int LuaLibGame::L_Game_SetKeyHook(lua_State *pL) {
   /* no event for this */
 
-  if (m_exec_activeInputHandler != NULL) {
+  if (inputHandler(pL) != NULL) {
+    std::string v_key = luaL_checkstring(pL, 1);
+    std::string v_func = luaL_checkstring(pL, 2);
+    std::string v_error;
+
+    // the input handler is shared by the scenes
+    Scene::lockSharedResources();
     try {
-      m_exec_activeInputHandler->addScriptKeyHook(
-        m_exec_world, luaL_checkstring(pL, 1), luaL_checkstring(pL, 2));
+      inputHandler(pL)->addScriptKeyHook(world(pL), v_key, v_func);
     } catch (Exception &e) {
-      std::string v_key = luaL_checkstring(pL, 1);
-      std::string v_func = luaL_checkstring(pL, 2);
+      v_error = e.getMsg();
+    }
+    Scene::unlockSharedResources();
+
+    if (v_error != "") {
+      // luaL_error doesn't return, the lock must be released before
       std::string v_msg = "SetKeyHook(key=" + v_key + ", function=" + v_func +
-                          ") failed\n" + e.getMsg();
+                          ") failed\n" + v_error;
       luaL_error(pL, v_msg.c_str());
     }
   }
@@ -392,10 +401,10 @@ int LuaLibGame::L_Game_SetKeyHook(lua_State *pL) {
 int LuaLibGame::L_Game_GetKeyByAction(lua_State *pL) {
   /* no event for this */
 
-  if (m_exec_activeInputHandler != NULL) {
+  if (inputHandler(pL) != NULL) {
     lua_pushstring(
       pL,
-      m_exec_activeInputHandler->getKeyByAction(luaL_checkstring(pL, 1))
+      inputHandler(pL)->getKeyByAction(luaL_checkstring(pL, 1))
         .c_str());
     return 1;
   }
@@ -405,10 +414,10 @@ int LuaLibGame::L_Game_GetKeyByAction(lua_State *pL) {
 int LuaLibGame::L_Game_GetKeyByActionTech(lua_State *pL) {
   /* no event for this */
 
-  if (m_exec_activeInputHandler != NULL) {
+  if (inputHandler(pL) != NULL) {
     lua_pushstring(
       pL,
-      m_exec_activeInputHandler->getKeyByAction(luaL_checkstring(pL, 1), true)
+      inputHandler(pL)->getKeyByAction(luaL_checkstring(pL, 1), true)
         .c_str());
     return 1;
   }
@@ -417,8 +426,8 @@ int LuaLibGame::L_Game_GetKeyByActionTech(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetBlockCenter(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetBlockCenter(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetBlockCenter(world(pL)->getTime(),
                            luaL_checkstring(pL, 1),
                            X_luaL_check_number(pL, 2),
                            X_luaL_check_number(pL, 3)));
@@ -427,8 +436,8 @@ int LuaLibGame::L_Game_SetBlockCenter(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetBlockRotation(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetBlockRotation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetBlockRotation(world(pL)->getTime(),
                              luaL_checkstring(pL, 1),
                              X_luaL_check_number(pL, 2)));
   return 0;
@@ -436,8 +445,8 @@ int LuaLibGame::L_Game_SetBlockRotation(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetDynamicEntityRotation(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetDynamicEntityRotation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetDynamicEntityRotation(world(pL)->getTime(),
                                      luaL_checkstring(pL, 1),
                                      X_luaL_check_number(pL, 2),
                                      X_luaL_check_number(pL, 3),
@@ -449,8 +458,8 @@ int LuaLibGame::L_Game_SetDynamicEntityRotation(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetDynamicEntitySelfRotation(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetDynamicEntitySelfRotation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetDynamicEntitySelfRotation(world(pL)->getTime(),
                                          luaL_checkstring(pL, 1),
                                          (int)(X_luaL_check_number(pL, 2)),
                                          (int)X_luaL_check_number(pL, 3),
@@ -460,8 +469,8 @@ int LuaLibGame::L_Game_SetDynamicEntitySelfRotation(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetDynamicEntityTranslation(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetDynamicEntityTranslation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetDynamicEntityTranslation(world(pL)->getTime(),
                                         luaL_checkstring(pL, 1),
                                         X_luaL_check_number(pL, 2),
                                         X_luaL_check_number(pL, 3),
@@ -473,15 +482,15 @@ int LuaLibGame::L_Game_SetDynamicEntityTranslation(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetDynamicEntityNone(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(new MGE_SetDynamicEntityNone(
-    m_exec_world->getTime(), luaL_checkstring(pL, 1)));
+  world(pL)->createGameEvent(new MGE_SetDynamicEntityNone(
+    world(pL)->getTime(), luaL_checkstring(pL, 1)));
   return 0;
 }
 
 int LuaLibGame::L_Game_SetDynamicBlockRotation(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetDynamicBlockRotation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetDynamicBlockRotation(world(pL)->getTime(),
                                     luaL_checkstring(pL, 1),
                                     X_luaL_check_number(pL, 2),
                                     X_luaL_check_number(pL, 3),
@@ -493,8 +502,8 @@ int LuaLibGame::L_Game_SetDynamicBlockRotation(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetDynamicBlockSelfRotation(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetDynamicBlockSelfRotation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetDynamicBlockSelfRotation(world(pL)->getTime(),
                                         luaL_checkstring(pL, 1),
                                         (int)(X_luaL_check_number(pL, 2)),
                                         (int)X_luaL_check_number(pL, 3),
@@ -504,8 +513,8 @@ int LuaLibGame::L_Game_SetDynamicBlockSelfRotation(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetPhysicsBlockSelfRotation(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetPhysicsBlockSelfRotation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetPhysicsBlockSelfRotation(world(pL)->getTime(),
                                         luaL_checkstring(pL, 1),
                                         (int)(X_luaL_check_number(pL, 2)),
                                         (int)X_luaL_check_number(pL, 3),
@@ -514,8 +523,8 @@ int LuaLibGame::L_Game_SetPhysicsBlockSelfRotation(lua_State *pL) {
 }
 
 int LuaLibGame::L_Game_SetPhysicsBlockTranslation(lua_State *pL) {
-  m_exec_world->createGameEvent(
-    new MGE_SetPhysicsBlockTranslation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetPhysicsBlockTranslation(world(pL)->getTime(),
                                        luaL_checkstring(pL, 1),
                                        X_luaL_check_number(pL, 2),
                                        X_luaL_check_number(pL, 3),
@@ -528,8 +537,8 @@ int LuaLibGame::L_Game_SetPhysicsBlockTranslation(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetDynamicBlockTranslation(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_SetDynamicBlockTranslation(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetDynamicBlockTranslation(world(pL)->getTime(),
                                        luaL_checkstring(pL, 1),
                                        X_luaL_check_number(pL, 2),
                                        X_luaL_check_number(pL, 3),
@@ -541,21 +550,21 @@ int LuaLibGame::L_Game_SetDynamicBlockTranslation(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetDynamicBlockNone(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(new MGE_SetDynamicBlockNone(
-    m_exec_world->getTime(), luaL_checkstring(pL, 1)));
+  world(pL)->createGameEvent(new MGE_SetDynamicBlockNone(
+    world(pL)->getTime(), luaL_checkstring(pL, 1)));
   return 0;
 }
 
 int LuaLibGame::L_Game_CameraZoom(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_CameraZoom(m_exec_world->getTime(), X_luaL_check_number(pL, 1)));
+  world(pL)->createGameEvent(
+    new MGE_CameraZoom(world(pL)->getTime(), X_luaL_check_number(pL, 1)));
   return 0;
 }
 
 int LuaLibGame::L_Game_CameraMove(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(new MGE_CameraMove(m_exec_world->getTime(),
+  world(pL)->createGameEvent(new MGE_CameraMove(world(pL)->getTime(),
                                                    X_luaL_check_number(pL, 1),
                                                    X_luaL_check_number(pL, 2)));
   return 0;
@@ -563,41 +572,40 @@ int LuaLibGame::L_Game_CameraMove(lua_State *pL) {
 
 int LuaLibGame::L_Game_SetCameraPosition(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(
-    new MGE_CameraSetPos(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_CameraSetPos(world(pL)->getTime(),
                          X_luaL_check_number(pL, 1),
                          X_luaL_check_number(pL, 2)));
   return 0;
 }
 
 int LuaLibGame::L_Game_KillPlayer(lua_State *pL) {
-  m_exec_world->createGameEvent(
-    new MGE_PlayersDie(m_exec_world->getTime(), false));
+  world(pL)->createGameEvent(new MGE_PlayersDie(world(pL)->getTime(), false));
   return 0;
 }
 
 int LuaLibGame::L_Game_KillEntity(lua_State *pL) {
-  m_exec_world->createExternalKillEntityEvent(luaL_checkstring(pL, 1));
+  world(pL)->createExternalKillEntityEvent(luaL_checkstring(pL, 1));
   return 0;
 }
 
 int LuaLibGame::L_Game_RemainingStrawberries(lua_State *pL) {
   /* no event for this */
-  lua_pushnumber(pL, m_exec_world->getNbRemainingStrawberries());
+  lua_pushnumber(pL, world(pL)->getNbRemainingStrawberries());
   return 1;
 }
 
 int LuaLibGame::L_Game_WinPlayer(lua_State *pL) {
-  for (unsigned int i = 0; i < m_exec_world->Players().size(); i++) {
-    m_exec_world->makePlayerWin(i);
+  for (unsigned int i = 0; i < world(pL)->Players().size(); i++) {
+    world(pL)->makePlayerWin(i);
   }
   return 0;
 }
 
 int LuaLibGame::L_Game_PenaltyTime(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(new MGE_PenaltyTime(
-    m_exec_world->getTime(), (int)(X_luaL_check_number(pL, 1) * 100)));
+  world(pL)->createGameEvent(new MGE_PenaltyTime(
+    world(pL)->getTime(), (int)(X_luaL_check_number(pL, 1) * 100)));
   return 0;
 }
 
@@ -607,16 +615,15 @@ int LuaLibGame::L_Game_IsAPlayerInZone(lua_State *pL) {
   int v_player;
 
   try {
-    v_zone = m_exec_world->getLevelSrc()->getZoneById(luaL_checkstring(pL, 1));
+    v_zone = world(pL)->getLevelSrc()->getZoneById(luaL_checkstring(pL, 1));
     v_player = (int)X_luaL_check_number(pL, 2);
 
-    if (v_player < 0 ||
-        (unsigned int)v_player >= m_exec_world->Players().size()) {
+    if (v_player < 0 || (unsigned int)v_player >= world(pL)->Players().size()) {
       luaL_error(pL, "Invalid player number");
     }
 
     lua_pushboolean(
-      pL, m_exec_world->Players()[v_player]->isTouching(v_zone) ? 1 : 0);
+      pL, world(pL)->Players()[v_player]->isTouching(v_zone) ? 1 : 0);
   } catch (Exception &e) {
     lua_pushboolean(pL, 0);
   }
@@ -629,13 +636,12 @@ int LuaLibGame::L_Game_SetAPlayerPosition(lua_State *pL) {
   bool bRight = X_luaL_check_number(pL, 3) > 0.0f;
   int v_player = (int)X_luaL_check_number(pL, 4);
 
-  if (v_player < 0 ||
-      (unsigned int)v_player >= m_exec_world->Players().size()) {
+  if (v_player < 0 || (unsigned int)v_player >= world(pL)->Players().size()) {
     luaL_error(pL, "Invalid player number");
   }
 
-  m_exec_world->createGameEvent(
-    new MGE_SetPlayerPosition(m_exec_world->getTime(),
+  world(pL)->createGameEvent(
+    new MGE_SetPlayerPosition(world(pL)->getTime(),
                               X_luaL_check_number(pL, 1),
                               X_luaL_check_number(pL, 2),
                               bRight,
@@ -650,14 +656,13 @@ int LuaLibGame::L_Game_GetAPlayerPosition(lua_State *pL) {
 
   int v_player = (int)X_luaL_check_number(pL, 1);
 
-  if (v_player < 0 ||
-      (unsigned int)v_player >= m_exec_world->Players().size()) {
+  if (v_player < 0 || (unsigned int)v_player >= world(pL)->Players().size()) {
     luaL_error(pL, "Invalid player number");
   }
 
-  x = m_exec_world->Players()[v_player]->getState()->CenterP.x;
-  y = m_exec_world->Players()[v_player]->getState()->CenterP.y;
-  v_direction = m_exec_world->Players()[v_player]->getState()->Dir;
+  x = world(pL)->Players()[v_player]->getState()->CenterP.x;
+  y = world(pL)->Players()[v_player]->getState()->CenterP.y;
+  v_direction = world(pL)->Players()[v_player]->getState()->Dir;
 
   lua_pushnumber(pL, x);
   lua_pushnumber(pL, y);
@@ -669,49 +674,47 @@ int LuaLibGame::L_Game_GetAPlayerPosition(lua_State *pL) {
 int LuaLibGame::L_Game_KillAPlayer(lua_State *pL) {
   int v_player = (int)X_luaL_check_number(pL, 1);
 
-  if (v_player < 0 ||
-      (unsigned int)v_player >= m_exec_world->Players().size()) {
+  if (v_player < 0 || (unsigned int)v_player >= world(pL)->Players().size()) {
     luaL_error(pL, "Invalid player number");
   }
 
-  m_exec_world->createGameEvent(
-    new MGE_PlayerDies(m_exec_world->getTime(), false, v_player));
+  world(pL)->createGameEvent(
+    new MGE_PlayerDies(world(pL)->getTime(), false, v_player));
   return 0;
 }
 
 int LuaLibGame::L_Game_WinAPlayer(lua_State *pL) {
   int v_player = (int)X_luaL_check_number(pL, 1);
 
-  if (v_player < 0 ||
-      (unsigned int)v_player >= m_exec_world->Players().size()) {
+  if (v_player < 0 || (unsigned int)v_player >= world(pL)->Players().size()) {
     luaL_error(pL, "Invalid player number");
   }
 
-  m_exec_world->makePlayerWin(v_player);
+  world(pL)->makePlayerWin(v_player);
   return 0;
 }
 
 int LuaLibGame::L_Game_NumberOfPlayers(lua_State *pL) {
-  lua_pushnumber(pL, m_exec_world->Players().size());
+  lua_pushnumber(pL, world(pL)->Players().size());
   return 1;
 }
 
 int LuaLibGame::L_Game_CameraRotate(lua_State *pL) {
-  m_exec_world->createGameEvent(
-    new MGE_CameraRotate(m_exec_world->getTime(), X_luaL_check_number(pL, 1)));
+  world(pL)->createGameEvent(
+    new MGE_CameraRotate(world(pL)->getTime(), X_luaL_check_number(pL, 1)));
   return 0;
 }
 
 int LuaLibGame::L_Game_CameraAdaptToGravity(lua_State *pL) {
-  m_exec_world->createGameEvent(
-    new MGE_CameraAdaptToGravity(m_exec_world->getTime()));
+  world(pL)->createGameEvent(
+    new MGE_CameraAdaptToGravity(world(pL)->getTime()));
   return 0;
 }
 
 int LuaLibGame::L_Game_AddForceToPlayer(lua_State *pL) {
   /* event for this */
-  m_exec_world->createGameEvent(new MGE_AddForceToPlayer(
-    m_exec_world->getTime(),
+  world(pL)->createGameEvent(new MGE_AddForceToPlayer(
+    world(pL)->getTime(),
     Vector2f(X_luaL_check_number(pL, 1), X_luaL_check_number(pL, 2)),
     (int)X_luaL_check_number(pL, 3),
     (int)X_luaL_check_number(pL, 4),
@@ -720,18 +723,18 @@ int LuaLibGame::L_Game_AddForceToPlayer(lua_State *pL) {
 }
 
 int LuaLibGame::L_Game_SetCameraRotationSpeed(lua_State *pL) {
-  m_exec_world->createGameEvent(new MGE_SetCameraRotationSpeed(
-    m_exec_world->getTime(), X_luaL_check_number(pL, 1)));
+  world(pL)->createGameEvent(new MGE_SetCameraRotationSpeed(
+    world(pL)->getTime(), X_luaL_check_number(pL, 1)));
   return 0;
 }
 
 int LuaLibGame::L_Game_PlaySound(lua_State *pL) {
   if (lua_gettop(pL) == 1) { // if there are 2 arguments, consider the 2nd one
-    m_exec_world->createGameEvent(
-      new MGE_PlaySound(m_exec_world->getTime(), luaL_checkstring(pL, 1)));
+    world(pL)->createGameEvent(
+      new MGE_PlaySound(world(pL)->getTime(), luaL_checkstring(pL, 1)));
   } else {
-    m_exec_world->createGameEvent(
-      new MGE_PlaySound(m_exec_world->getTime(),
+    world(pL)->createGameEvent(
+      new MGE_PlaySound(world(pL)->getTime(),
                         luaL_checkstring(pL, 1),
                         X_luaL_check_number(pL, 2)));
   }
@@ -740,13 +743,13 @@ int LuaLibGame::L_Game_PlaySound(lua_State *pL) {
 }
 
 int LuaLibGame::L_Game_PlayMusic(lua_State *pL) {
-  m_exec_world->createGameEvent(
-    new MGE_PlayMusic(m_exec_world->getTime(), luaL_checkstring(pL, 1)));
+  world(pL)->createGameEvent(
+    new MGE_PlayMusic(world(pL)->getTime(), luaL_checkstring(pL, 1)));
   return 0;
 }
 
 int LuaLibGame::L_Game_StopMusic(lua_State *pL) {
-  m_exec_world->createGameEvent(new MGE_StopMusic(m_exec_world->getTime()));
+  world(pL)->createGameEvent(new MGE_StopMusic(world(pL)->getTime()));
   return 0;
 }
 
@@ -755,11 +758,10 @@ int LuaLibGame::L_Game_GetPlayerVelocity(lua_State *pL) {
   /* no event for this */
   int v_player = (int)X_luaL_check_number(pL, 1);
 
-  if (v_player < 0 ||
-      (unsigned int)v_player >= m_exec_world->Players().size()) {
+  if (v_player < 0 || (unsigned int)v_player >= world(pL)->Players().size()) {
     luaL_error(pL, "Invalid player number");
   }
-  lua_pushnumber(pL, m_exec_world->Players()[v_player]->getBikeLinearVel());
+  lua_pushnumber(pL, world(pL)->Players()[v_player]->getBikeLinearVel());
 
   return 1;
 }
@@ -768,11 +770,10 @@ int LuaLibGame::L_Game_GetPlayerSpeed(lua_State *pL) {
   /* no event for this */
   int v_player = (int)X_luaL_check_number(pL, 1);
 
-  if (v_player < 0 ||
-      (unsigned int)v_player >= m_exec_world->Players().size()) {
+  if (v_player < 0 || (unsigned int)v_player >= world(pL)->Players().size()) {
     luaL_error(pL, "Invalid player number");
   }
-  lua_pushnumber(pL, m_exec_world->Players()[v_player]->getBikeEngineSpeed());
+  lua_pushnumber(pL, world(pL)->Players()[v_player]->getBikeEngineSpeed());
 
   return 1;
 }
@@ -781,11 +782,10 @@ int LuaLibGame::L_Game_GetPlayerAngle(lua_State *pL) {
   /* no event for this */
   int v_player = (int)X_luaL_check_number(pL, 1);
 
-  if (v_player < 0 ||
-      (unsigned int)v_player >= m_exec_world->Players().size()) {
+  if (v_player < 0 || (unsigned int)v_player >= world(pL)->Players().size()) {
     luaL_error(pL, "Invalid player number");
   }
-  lua_pushnumber(pL, m_exec_world->Players()[v_player]->getAngle());
+  lua_pushnumber(pL, world(pL)->Players()[v_player]->getAngle());
 
   return 1; // return 1 value
 }
@@ -815,7 +815,7 @@ int LuaLibGame::L_Game_StartTimer(lua_State *pL) {
   ScriptTimer *v_timer = NULL;
   // get parameters
   v_name = (std::string)luaL_checkstring(pL, 1);
-  v_timer = m_exec_world->getScriptTimerByName(v_name);
+  v_timer = world(pL)->getScriptTimerByName(v_name);
   // check the optional args
   if (v_numargs > 1) {
     v_delay = (int)luaL_checknumber(pL, 2);
@@ -831,12 +831,12 @@ int LuaLibGame::L_Game_StartTimer(lua_State *pL) {
   }
   // if timer is not found
   if (v_timer == NULL) {
-    m_exec_world->createScriptTimer(v_name, v_delay, v_loops); // create timer
+    world(pL)->createScriptTimer(v_name, v_delay, v_loops); // create timer
   } else {
     if (v_numargs == 1) { // only name given
       v_timer->StartTimer(); // start the timer
     } else { // numarg is not 1 so it can only be 2 or 3 which is okay
-      v_timer->ResetTimer(v_delay, v_loops, m_exec_world->getTime());
+      v_timer->ResetTimer(v_delay, v_loops, world(pL)->getTime());
       /* For example: if only delay is given then the loops=0 (default) */
     }
   }
@@ -847,7 +847,7 @@ int LuaLibGame::L_Game_SetTimerDelay(lua_State *pL) {
   args_CheckNumberOfArguments(pL, 2, 2); // exactly 2 args needed
   std::string v_name = (std::string)luaL_checkstring(pL, 1);
   int v_delay = (int)luaL_checknumber(pL, 2);
-  ScriptTimer *v_timer = m_exec_world->getScriptTimerByName(v_name);
+  ScriptTimer *v_timer = world(pL)->getScriptTimerByName(v_name);
   if (v_timer != NULL) {
     v_timer->SetTimerDelay(v_delay);
   } else {
@@ -859,7 +859,7 @@ int LuaLibGame::L_Game_SetTimerDelay(lua_State *pL) {
 int LuaLibGame::L_Game_StopTimer(lua_State *pL) {
   args_CheckNumberOfArguments(pL, 1, 1); // exactly 1 arg needed
   std::string v_name = (std::string)luaL_checkstring(pL, 1); // get name
-  ScriptTimer *v_timer = m_exec_world->getScriptTimerByName(v_name);
+  ScriptTimer *v_timer = world(pL)->getScriptTimerByName(v_name);
   if (v_timer != NULL) { // timer is found
     v_timer->PauseTimer(); // pause it
   } else {
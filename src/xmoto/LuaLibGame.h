@@ -32,21 +32,16 @@ public:
   LuaLibGame(Scene *i_pScene);
   ~LuaLibGame();
 
-protected:
-  /*
-    static lua lib calls are share between the lulibgame instances
-    then, setInstance must be set before lua call
-  */
-  void setInstance();
-
 private:
   Scene *m_pScene;
   Input *m_pActiveInputHandler;
 
-  static Input *m_exec_activeInputHandler;
-  static Scene *m_exec_world;
   static luaL_Reg m_gameFuncs[];
 
+  /* scene and input of the instance running the lua state */
+  static Scene *world(lua_State *pL);
+  static Input *inputHandler(lua_State *pL);
+
   /* Lua library prototypes */
   static int L_Game_GetTime(lua_State *pL);
   static int L_Game_Message(lua_State *pL);
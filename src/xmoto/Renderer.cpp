@@ -119,6 +119,7 @@ GameRenderer::GameRenderer() {
   m_currentSkySprite2 = NULL;
   m_showGhostsText = true;
   m_graphicsLevel = GFX_HIGH; // not used anymore
+  m_dynBlocksVertexBufferID = m_dynBlocksTexCoordBufferID = 0;
 }
 
 GameRenderer::~GameRenderer() {
@@ -356,6 +357,14 @@ Texture *GameRenderer::loadTexture(std::string textureName) {
 void GameRenderer::unprepareForNewLevel(Universe *i_universe) {
   Theme::instance()->getTextureManager()->unregister(m_registeringValue);
 
+#ifdef ENABLE_OPENGL
+  if (m_dynBlocksVertexBufferID != 0) {
+    glDeleteBuffersARB(1, (GLuint *)&m_dynBlocksVertexBufferID);
+    glDeleteBuffersARB(1, (GLuint *)&m_dynBlocksTexCoordBufferID);
+    m_dynBlocksVertexBufferID = m_dynBlocksTexCoordBufferID = 0;
+  }
+#endif
+
   if (i_universe != NULL) {
     for (unsigned int u = 0; u < i_universe->getScenes().size(); u++) {
       GeomsManager::instance()->unregister(i_universe->getScenes()[u]);
@@ -873,6 +882,9 @@ void GameRenderer::_RenderGhostTrail(Scene *i_scene,
   if (v_ghostTrail == NULL) {
     return;
   }
+  if (v_ghostTrail->isReady() == false) { // not computed yet
+    return;
+  }
   std::vector<Vector2f> *v_ghostTrailData = v_ghostTrail->getGhostTrailData();
 
   // setup colors and declare vars
@@ -2053,91 +2065,27 @@ void GameRenderer::_RenderDynamicBlocks(Scene *i_scene, bool bBackground) {
   std::sort(Blocks.begin(), Blocks.end(), AscendingTextureSort());
 
   if (XMSession::instance()->ugly() == false) {
-    for (unsigned int i = 0; i < Blocks.size(); i++) {
-      /* Are we rendering background blocks or what? */
-      if (Blocks[i]->isBackground() != bBackground)
-        continue;
-
-      Block *block = Blocks[i];
-      /* Build rotation matrix for block */
-      float fR[4];
-      float rotation = block->DynamicRotation();
-      fR[0] = cosf(rotation);
-      fR[2] = sinf(rotation);
-      fR[1] = -fR[2];
-      fR[3] = fR[0];
-
-      Vector2f dynRotCenter = block->DynamicRotationCenter();
-      Vector2f dynPos = block->DynamicPosition();
-      Geom *geom = block->getGeom();
-
-      if (pDrawlib->getBackend() == DrawLib::backend_OpenGl) {
-#ifdef ENABLE_OPENGL
-        glEnableClientState(GL_VERTEX_ARRAY);
-        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-        /* we're working with modelview matrix*/
-        glPushMatrix();
-
-        glTranslatef(dynPos.x, dynPos.y, 0);
-        if (rotation != 0.0) {
-          glTranslatef(dynRotCenter.x, dynRotCenter.y, 0);
-          glRotatef(rad2deg(rotation), 0, 0, 1);
-          glTranslatef(-dynRotCenter.x, -dynRotCenter.y, 0);
-        }
-
-        if (XMSession::instance()->gameGraphics() != GFX_LOW) {
-          if (block->getSprite() != NULL) {
-            pDrawlib->setTexture(block->getSprite()->getTexture() != NULL
-                                   ? block->getSprite()->getTexture()
-                                   : NULL,
-                                 BLEND_MODE_A);
-          } else {
-            pDrawlib->setTexture(NULL, BLEND_MODE_A);
-          }
-          /* set flashy blendColor */
-          TColor v_blendColor = TColor(block->getBlendColor());
-          pDrawlib->setColorRGBA(v_blendColor.Red(),
-                                 v_blendColor.Green(),
-                                 v_blendColor.Blue(),
-                                 v_blendColor.Alpha());
-        } else {
-          pDrawlib->setTexture(NULL, BLEND_MODE_A);
-          pDrawlib->setColorRGBA(90, 90, 90, 255);
-        }
-
-        /* VBO optimized? */
-        if (pDrawlib->useVBOs()) {
-          for (unsigned int j = 0; j < geom->Polys.size(); j++) {
-            GeomPoly *pPoly = geom->Polys[j];
-
-            glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nVertexBufferID);
-            glVertexPointer(2, GL_FLOAT, 0, (char *)NULL);
-
-            glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nTexCoordBufferID);
-            glTexCoordPointer(2, GL_FLOAT, 0, (char *)NULL);
-
-            glDrawArrays(GL_POLYGON, 0, pPoly->nNumVertices);
-          }
-        } else {
-          for (unsigned int j = 0; j < geom->Polys.size(); j++) {
-            GeomPoly *pPoly = geom->Polys[j];
-            glVertexPointer(2, GL_FLOAT, 0, pPoly->pVertices);
-            glTexCoordPointer(2, GL_FLOAT, 0, pPoly->pTexCoords);
-            glDrawArrays(GL_POLYGON, 0, pPoly->nNumVertices);
-          }
-        }
+    if (pDrawlib->getBackend() == DrawLib::backend_OpenGl) {
+      _RenderDynamicBlocksBatch(Blocks, bBackground);
+    } else if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
+      for (unsigned int i = 0; i < Blocks.size(); i++) {
+        /* Are we rendering background blocks or what? */
+        if (Blocks[i]->isBackground() != bBackground)
+          continue;
 
-        if (XMSession::instance()->gameGraphics() != GFX_LOW) {
-          _RenderBlockEdges(block);
-        }
+        Block *block = Blocks[i];
+        /* Build rotation matrix for block */
+        float fR[4];
+        float rotation = block->DynamicRotation();
+        fR[0] = cosf(rotation);
+        fR[2] = sinf(rotation);
+        fR[1] = -fR[2];
+        fR[3] = fR[0];
 
-        glPopMatrix();
+        Vector2f dynRotCenter = block->DynamicRotationCenter();
+        Vector2f dynPos = block->DynamicPosition();
+        Geom *geom = block->getGeom();
 
-        glDisableClientState(GL_VERTEX_ARRAY);
-        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-#endif
-      } else if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
         if (geom->Polys.size() > 0) {
           if (block->getSprite() != NULL) {
             pDrawlib->setTexture(block->getSprite()->getTexture() != NULL
@@ -2171,8 +2119,7 @@ void GameRenderer::_RenderDynamicBlocks(Scene *i_scene, bool bBackground) {
           pDrawlib->removePropertiesAfterEnd();
         }
       }
-    }
-    if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
+
       /* Render all special edges (if quality!=low) */
       if (XMSession::instance()->gameGraphics() != GFX_LOW) {
         for (unsigned int i = 0; i < Blocks.size(); i++) {
@@ -2246,6 +2193,193 @@ void GameRenderer::_RenderDynamicBlocks(Scene *i_scene, bool bBackground) {
   }
 }
 
+/* all the visible dynamic blocks are sent in one buffer, and drawn with one
+   call by texture */
+void GameRenderer::_RenderDynamicBlocksBatch(std::vector<Block *> &i_blocks,
+                                             bool bBackground) {
+#ifdef ENABLE_OPENGL
+  DrawLib *pDrawlib = GameApp::instance()->getDrawLib();
+  bool v_lowGfx = XMSession::instance()->gameGraphics() == GFX_LOW;
+
+  m_dynBlocksVertices.clear();
+  m_dynBlocksTexCoords.clear();
+  m_dynBlocksDraws.clear();
+
+  for (unsigned int i = 0; i < i_blocks.size(); i++) {
+    Block *block = i_blocks[i];
+    if (block->isBackground() != bBackground)
+      continue;
+
+    if (v_lowGfx) {
+      _AddDynamicBlockGeom(
+        block, block->getGeom(), NULL, TColor(90, 90, 90, 255), false);
+    } else {
+      _AddDynamicBlockGeom(block,
+                           block->getGeom(),
+                           block->getSprite() != NULL
+                             ? block->getSprite()->getTexture()
+                             : NULL,
+                           block->getBlendColor(),
+                           false);
+    }
+  }
+
+  /* edges over the blocks */
+  if (v_lowGfx == false) {
+    for (unsigned int i = 0; i < i_blocks.size(); i++) {
+      Block *block = i_blocks[i];
+      if (block->isBackground() != bBackground)
+        continue;
+
+      for (unsigned int j = 0; j < block->getEdgeGeoms().size(); j++) {
+        Geom *geom = block->getEdgeGeoms()[j];
+        _AddDynamicBlockGeom(
+          block, geom, geom->pTexture, geom->edgeBlendColor, true);
+      }
+    }
+  }
+
+  if (m_dynBlocksDraws.size() == 0) {
+    return;
+  }
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+  /* VBO optimized? */
+  if (pDrawlib->useVBOs()) {
+    if (m_dynBlocksVertexBufferID == 0) {
+      glGenBuffersARB(1, (GLuint *)&m_dynBlocksVertexBufferID);
+      glGenBuffersARB(1, (GLuint *)&m_dynBlocksTexCoordBufferID);
+    }
+
+    /* the buffers are refilled at each frame */
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_dynBlocksVertexBufferID);
+    glBufferDataARB(GL_ARRAY_BUFFER_ARB,
+                    m_dynBlocksVertices.size() * sizeof(float),
+                    (void *)&m_dynBlocksVertices[0],
+                    GL_STREAM_DRAW_ARB);
+    glVertexPointer(2, GL_FLOAT, 0, (char *)NULL);
+
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, m_dynBlocksTexCoordBufferID);
+    glBufferDataARB(GL_ARRAY_BUFFER_ARB,
+                    m_dynBlocksTexCoords.size() * sizeof(float),
+                    (void *)&m_dynBlocksTexCoords[0],
+                    GL_STREAM_DRAW_ARB);
+    glTexCoordPointer(2, GL_FLOAT, 0, (char *)NULL);
+  } else {
+    glVertexPointer(2, GL_FLOAT, 0, &m_dynBlocksVertices[0]);
+    glTexCoordPointer(2, GL_FLOAT, 0, &m_dynBlocksTexCoords[0]);
+  }
+
+  for (unsigned int i = 0; i < m_dynBlocksDraws.size(); i++) {
+    DynBlocksDraw &v_draw = m_dynBlocksDraws[i];
+
+    pDrawlib->setTexture(v_draw.pTexture, BLEND_MODE_A);
+    pDrawlib->setColorRGBA(v_draw.color.Red(),
+                           v_draw.color.Green(),
+                           v_draw.color.Blue(),
+                           v_draw.color.Alpha());
+    glDrawArrays(GL_TRIANGLES, v_draw.first, v_draw.count);
+  }
+
+  if (pDrawlib->useVBOs()) {
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+  }
+
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+#endif
+}
+
+/* add the triangles of the geom, placed where the block is, to the dynamic
+   blocks buffer */
+void GameRenderer::_AddDynamicBlockGeom(Block *block,
+                                        Geom *geom,
+                                        Texture *pTexture,
+                                        const TColor &i_color,
+                                        bool i_isEdge) {
+  unsigned int v_first = m_dynBlocksVertices.size() / 2;
+
+  /* Build rotation matrix for block */
+  float fR[4];
+  float rotation = block->DynamicRotation();
+  fR[0] = cosf(rotation);
+  fR[2] = sinf(rotation);
+  fR[1] = -fR[2];
+  fR[3] = fR[0];
+
+  Vector2f dynRotCenter = block->DynamicRotationCenter();
+  Vector2f dynPos = block->DynamicPosition();
+
+  for (unsigned int j = 0; j < geom->Polys.size(); j++) {
+    GeomPoly *pPoly = geom->Polys[j];
+
+    for (unsigned int k = 0; k < pPoly->nNumVertices; k++) {
+      unsigned int v_triangles[6];
+      unsigned int v_nVertices;
+
+      if (i_isEdge) {
+        /* edges are quads */
+        if (k % 4 != 0 || k + 3 >= pPoly->nNumVertices) {
+          continue;
+        }
+        v_triangles[0] = v_triangles[3] = k;
+        v_triangles[1] = k + 1;
+        v_triangles[2] = v_triangles[4] = k + 2;
+        v_triangles[5] = k + 3;
+        v_nVertices = 6;
+      } else {
+        /* polygons are convex, make them a fan of triangles */
+        if (k == 0 || k + 1 >= pPoly->nNumVertices) {
+          continue;
+        }
+        v_triangles[0] = 0;
+        v_triangles[1] = k;
+        v_triangles[2] = k + 1;
+        v_nVertices = 3;
+      }
+
+      for (unsigned int l = 0; l < v_nVertices; l++) {
+        GeomCoord &v_vertex = pPoly->pVertices[v_triangles[l]];
+        GeomCoord &v_texCoord = pPoly->pTexCoords[v_triangles[l]];
+
+        /* transform vertex */
+        m_dynBlocksVertices.push_back((v_vertex.x - dynRotCenter.x) * fR[0] +
+                                      (v_vertex.y - dynRotCenter.y) * fR[1] +
+                                      dynPos.x + dynRotCenter.x);
+        m_dynBlocksVertices.push_back((v_vertex.x - dynRotCenter.x) * fR[2] +
+                                      (v_vertex.y - dynRotCenter.y) * fR[3] +
+                                      dynPos.y + dynRotCenter.y);
+        m_dynBlocksTexCoords.push_back(v_texCoord.x);
+        m_dynBlocksTexCoords.push_back(v_texCoord.y);
+      }
+    }
+  }
+
+  unsigned int v_count = m_dynBlocksVertices.size() / 2 - v_first;
+  if (v_count == 0) {
+    return;
+  }
+
+  /* continue the previous draw if it has the same texture and color */
+  if (m_dynBlocksDraws.size() > 0) {
+    DynBlocksDraw &v_last = m_dynBlocksDraws[m_dynBlocksDraws.size() - 1];
+    if (v_last.pTexture == pTexture &&
+        v_last.color.getColor() == i_color.getColor()) {
+      v_last.count += v_count;
+      return;
+    }
+  }
+
+  DynBlocksDraw v_draw;
+  v_draw.pTexture = pTexture;
+  v_draw.color = i_color;
+  v_draw.first = v_first;
+  v_draw.count = v_count;
+  m_dynBlocksDraws.push_back(v_draw);
+}
+
 void GameRenderer::_RenderStaticBlock(Block *block) {
   float v_begin, v_end;
 
@@ -2274,41 +2408,7 @@ void GameRenderer::_RenderStaticBlock(Block *block) {
     pDrawlib->setColorRGBA(0, 0, 0, 255);
   }
 
-  if (pDrawlib->getBackend() == DrawLib::backend_OpenGl) {
-#ifdef ENABLE_OPENGL
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-    /* VBO optimized? */
-    if (pDrawlib->useVBOs()) {
-      for (unsigned int j = 0; j < geom->Polys.size(); j++) {
-        GeomPoly *pPoly = geom->Polys[j];
-
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nVertexBufferID);
-        glVertexPointer(2, GL_FLOAT, 0, (char *)NULL);
-
-        glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nTexCoordBufferID);
-        glTexCoordPointer(2, GL_FLOAT, 0, (char *)NULL);
-
-        glDrawArrays(GL_POLYGON, 0, pPoly->nNumVertices);
-      }
-    } else {
-      for (unsigned int j = 0; j < geom->Polys.size(); j++) {
-        GeomPoly *pPoly = geom->Polys[j];
-        glVertexPointer(2, GL_FLOAT, 0, pPoly->pVertices);
-        glTexCoordPointer(2, GL_FLOAT, 0, pPoly->pTexCoords);
-        glDrawArrays(GL_POLYGON, 0, pPoly->nNumVertices);
-      }
-    }
-
-    if (XMSession::instance()->gameGraphics() != GFX_LOW) {
-      _RenderBlockEdges(block);
-    }
-
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-#endif
-  } else if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
+  if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
     for (unsigned int j = 0; j < geom->Polys.size(); j++) {
       if (block->getSprite() != NULL) {
         pDrawlib->setTexture(block->getSprite()->getTexture() != NULL
@@ -2358,42 +2458,9 @@ void GameRenderer::_RenderStaticBlock(Block *block) {
 
 void GameRenderer::_RenderBlockEdges(Block *pBlock) {
   DrawLib *pDrawlib = GameApp::instance()->getDrawLib();
-  if (pDrawlib->getBackend() == DrawLib::backend_OpenGl) {
-    for (unsigned int i = 0; i < pBlock->getEdgeGeoms().size(); i++) {
-      pDrawlib->setTexture(pBlock->getEdgeGeoms()[i]->pTexture, BLEND_MODE_A);
-
-      TColor v_blendColor = pBlock->getEdgeGeoms()[i]->edgeBlendColor;
-      pDrawlib->setColorRGBA(v_blendColor.Red(),
-                             v_blendColor.Green(),
-                             v_blendColor.Blue(),
-                             v_blendColor.Alpha());
-
-      /* VBO optimized? */
-      if (pDrawlib->useVBOs()) {
-        for (unsigned int j = 0; j < pBlock->getEdgeGeoms()[i]->Polys.size();
-             j++) {
-          GeomPoly *pPoly = pBlock->getEdgeGeoms()[i]->Polys[j];
-
-          glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nVertexBufferID);
-          glVertexPointer(2, GL_FLOAT, 0, (char *)NULL);
-
-          glBindBufferARB(GL_ARRAY_BUFFER_ARB, pPoly->nTexCoordBufferID);
-          glTexCoordPointer(2, GL_FLOAT, 0, (char *)NULL);
-
-          glDrawArrays(GL_QUADS, 0, pPoly->nNumVertices);
-        }
-      } else {
-        for (unsigned int j = 0; j < pBlock->getEdgeGeoms()[i]->Polys.size();
-             j++) {
-          GeomPoly *pPoly = pBlock->getEdgeGeoms()[i]->Polys[j];
-          glVertexPointer(2, GL_FLOAT, 0, pPoly->pVertices);
-          glTexCoordPointer(2, GL_FLOAT, 0, pPoly->pTexCoords);
-          glDrawArrays(GL_QUADS, 0, pPoly->nNumVertices);
-        }
-      }
-    }
-  } else if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
+  if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
     // SDLGFX::TODO
+    // (with opengl, edges are drawn with the other geoms of their batch)
   }
 }
 
@@ -2417,12 +2484,14 @@ void GameRenderer::_RenderStaticBlocks(Scene *i_scene) {
     if (XMSession::instance()->ugly() == false) {
       /* Render all non-background blocks */
       /* Static geoms... */
-      for (unsigned int i = 0; i < Blocks.size(); i++) {
-        if (Blocks[i]->isBackground() == false) {
-          _RenderStaticBlock(Blocks[i]);
+      if (pDrawlib->getBackend() == DrawLib::backend_OpenGl) {
+        _RenderGeomBatches(i_scene, m_screenBBox, -1, layer == 0, false);
+      } else if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
+        for (unsigned int i = 0; i < Blocks.size(); i++) {
+          if (Blocks[i]->isBackground() == false) {
+            _RenderStaticBlock(Blocks[i]);
+          }
         }
-      }
-      if (pDrawlib->getBackend() == DrawLib::backend_SdlGFX) {
         /* Render all special edges (if quality!=low) */
         if (XMSession::instance()->gameGraphics() != GFX_LOW) {
           for (unsigned int i = 0; i < Blocks.size(); i++) {
@@ -2595,6 +2664,12 @@ void GameRenderer::_RenderSky(Scene *i_scene,
 And background rendering
 ===========================================================================*/
 void GameRenderer::_RenderBackground(Scene *i_scene) {
+  if (GameApp::instance()->getDrawLib()->getBackend() ==
+      DrawLib::backend_OpenGl) {
+    _RenderGeomBatches(i_scene, m_screenBBox, -1, false, true);
+    return;
+  }
+
   /* Render STATIC background blocks */
   std::vector<Block *> Blocks =
     i_scene->getCollisionHandler()->getStaticBlocksNearPosition(m_screenBBox);
@@ -2660,23 +2735,86 @@ void GameRenderer::_RenderLayer(Scene *i_scene, int layer) {
   layerBBox.addPointToAABB2f(levelLeftTop.x + translationInLayer.x + size.x,
                              levelLeftTop.y + translationInLayer.y - size.y);
 
-  std::vector<Block *> Blocks =
-    i_scene->getCollisionHandler()->getBlocksNearPositionInLayer(layerBBox,
-                                                                 layer);
-  /* sort blocks on their texture */
-  std::sort(Blocks.begin(), Blocks.end(), AscendingTextureSort());
-
 #ifdef ENABLE_OPENGL
   glPushMatrix();
   glTranslatef(translateVector.x, translateVector.y, 0);
 
-  for (unsigned int i = 0; i < Blocks.size(); i++) {
-    _RenderStaticBlock(Blocks[i]);
-  }
+  _RenderGeomBatches(i_scene, layerBBox, layer, true, false);
   glPopMatrix();
 #endif
 }
 
+/* draw the static geoms batches of a layer touching the bounding box */
+void GameRenderer::_RenderGeomBatches(Scene *i_scene,
+                                      AABB &i_bbox,
+                                      int i_layer,
+                                      bool i_isLayer,
+                                      bool i_isBackground) {
+#ifdef ENABLE_OPENGL
+  DrawLib *pDrawlib = GameApp::instance()->getDrawLib();
+  std::vector<GeomBatch *> &v_batches =
+    GeomsManager::instance()->getBatches(i_scene);
+  bool v_lowGfx = XMSession::instance()->gameGraphics() == GFX_LOW;
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+  for (unsigned int i = 0; i < v_batches.size(); i++) {
+    GeomBatch *pBatch = v_batches[i];
+
+    if (pBatch->layer != i_layer || pBatch->isLayer != i_isLayer) {
+      continue;
+    }
+    // all the blocks of the layers are drawn, background or not
+    if (i_layer == -1 && pBatch->isBackground != i_isBackground) {
+      continue;
+    }
+    if (pBatch->Vertices.size() == 0 || (pBatch->isEdge && v_lowGfx)) {
+      continue;
+    }
+    if (pBatch->aabb.AABBTouchAABB2f(i_bbox.getBMin(), i_bbox.getBMax()) ==
+        false) {
+      continue;
+    }
+
+    if (v_lowGfx) {
+      pDrawlib->setTexture(NULL, BLEND_MODE_A);
+      pDrawlib->setColorRGBA(0, 0, 0, 255);
+    } else {
+      pDrawlib->setTexture(
+        pBatch->pSprite != NULL ? pBatch->pSprite->getTexture() : NULL,
+        BLEND_MODE_A);
+      /* set flashy blendColor */
+      pDrawlib->setColorRGBA(pBatch->blendColor.Red(),
+                             pBatch->blendColor.Green(),
+                             pBatch->blendColor.Blue(),
+                             pBatch->blendColor.Alpha());
+    }
+
+    /* VBO optimized? */
+    if (pDrawlib->useVBOs()) {
+      glBindBufferARB(GL_ARRAY_BUFFER_ARB, pBatch->nVertexBufferID);
+      glVertexPointer(2, GL_FLOAT, 0, (char *)NULL);
+
+      glBindBufferARB(GL_ARRAY_BUFFER_ARB, pBatch->nTexCoordBufferID);
+      glTexCoordPointer(2, GL_FLOAT, 0, (char *)NULL);
+    } else {
+      glVertexPointer(2, GL_FLOAT, 0, &pBatch->Vertices[0]);
+      glTexCoordPointer(2, GL_FLOAT, 0, &pBatch->TexCoords[0]);
+    }
+
+    glDrawArrays(GL_TRIANGLES, 0, pBatch->Vertices.size());
+  }
+
+  if (pDrawlib->useVBOs()) {
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+  }
+
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+#endif
+}
+
 void GameRenderer::_RenderLayers(Scene *i_scene, bool renderFront) {
   /* Render background level blocks */
   for (int layer = 0; layer < i_scene->getLevelSrc()->getNumberLayer();
@@ -3185,19 +3323,96 @@ void GameRenderer::_RenderParticleDraw(Vector2f position,
     true);
 }
 
+/* with opengl, the particles of the source are drawn at once, as a single
+   array of quads */
 void GameRenderer::_RenderParticle(Scene *i_scene,
                                    ParticlesSource *i_source,
                                    unsigned int sprite) {
-  for (unsigned int j = 0; j < i_source->Particles().size(); j++) {
-    EntityParticle *v_particle = i_source->Particles()[j];
-    if (v_particle->spriteIndex() == sprite) {
-      _RenderParticleDraw(v_particle->DynamicPosition(),
-                          NULL,
-                          v_particle->Size(),
-                          v_particle->Angle(),
-                          v_particle->Color());
+  const EntityParticles &v_particles = i_source->Particles();
+  unsigned int n = v_particles.size();
+  DrawLib *pDrawlib = GameApp::instance()->getDrawLib();
+
+  if (pDrawlib->getBackend() != DrawLib::backend_OpenGl) {
+    for (unsigned int j = 0; j < n; j++) {
+      if (v_particles.SpriteIndex[j] == sprite) {
+        _RenderParticleDraw(Vector2f(v_particles.PosX[j], v_particles.PosY[j]),
+                            NULL,
+                            v_particles.Size[j],
+                            v_particles.Angle[j],
+                            TColor(v_particles.Red[j],
+                                   v_particles.Green[j],
+                                   v_particles.Blue[j],
+                                   v_particles.Alpha[j]));
+      }
+    }
+    return;
+  }
+
+#ifdef ENABLE_OPENGL
+  /* as drawImageTextureSet() for rotated images */
+  float v_absorb = 0.001;
+  float v_texCoords[8] = { v_absorb,        v_absorb,        1.0f - v_absorb,
+                           v_absorb,        1.0f - v_absorb, 1.0f - v_absorb,
+                           v_absorb,        1.0f - v_absorb };
+  unsigned int nQuads = 0;
+
+  m_particlesVertices.clear();
+  m_particlesTexCoords.clear();
+  m_particlesColors.clear();
+
+  for (unsigned int j = 0; j < n; j++) {
+    if (v_particles.SpriteIndex[j] != sprite) {
+      continue;
+    }
+
+    /* corners at 0, 90, 180 and 270 degrees from the angle */
+    float x = v_particles.PosX[j];
+    float y = v_particles.PosY[j];
+    float v_rads = v_particles.Angle[j] * ((float)M_PI / 180.0f);
+    float c = cos(v_rads) * v_particles.Size[j];
+    float s = sin(v_rads) * v_particles.Size[j];
+    float v_vertices[8] = { x + c, y + s, x - s, y + c,
+                            x - c, y - s, x + s, y - c };
+
+    m_particlesVertices.insert(
+      m_particlesVertices.end(), v_vertices, v_vertices + 8);
+    m_particlesTexCoords.insert(
+      m_particlesTexCoords.end(), v_texCoords, v_texCoords + 8);
+    for (unsigned int k = 0; k < 4; k++) {
+      m_particlesColors.push_back(v_particles.Red[j]);
+      m_particlesColors.push_back(v_particles.Green[j]);
+      m_particlesColors.push_back(v_particles.Blue[j]);
+      m_particlesColors.push_back(v_particles.Alpha[j]);
     }
+    nQuads++;
   }
+
+  if (nQuads == 0) {
+    return;
+  }
+  m_nParticlesRendered += nQuads;
+
+  /* the arrays are in memory, not in a buffer object */
+  if (pDrawlib->useVBOs()) {
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+  }
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+
+  glVertexPointer(2, GL_FLOAT, 0, &m_particlesVertices[0]);
+  glTexCoordPointer(2, GL_FLOAT, 0, &m_particlesTexCoords[0]);
+  glColorPointer(4, GL_UNSIGNED_BYTE, 0, &m_particlesColors[0]);
+  glDrawArrays(GL_QUADS, 0, nQuads * 4);
+
+  glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+  /* the current color is undefined after using a color array */
+  pDrawlib->setColor(MAKE_COLOR(255, 255, 255, 255));
+#endif
 }
 
 void GameRenderer::_RenderParticles(Scene *i_scene, bool bFront) {
@@ -48,6 +48,15 @@ struct GraphDebugInfo {
   std::vector<std::string> Args;
 };
 
+/*===========================================================================
+Triangles of the dynamic blocks drawn with the same texture and color
+===========================================================================*/
+struct DynBlocksDraw {
+  Texture *pTexture;
+  TColor color;
+  unsigned int first, count;
+};
+
 /*===========================================================================
 Special effects overlay
 ===========================================================================*/
@@ -196,6 +205,15 @@ private:
   float m_sizeMultOfEntitiesToTake;
   float m_sizeMultOfEntitiesWhichMakeWin;
   int m_nParticlesRendered;
+  /* quads of the particles drawn at once */
+  std::vector<float> m_particlesVertices;
+  std::vector<float> m_particlesTexCoords;
+  std::vector<unsigned char> m_particlesColors;
+  /* triangles of the dynamic blocks, sent to the graphic card at each frame */
+  std::vector<float> m_dynBlocksVertices;
+  std::vector<float> m_dynBlocksTexCoords;
+  std::vector<DynBlocksDraw> m_dynBlocksDraws;
+  unsigned int m_dynBlocksVertexBufferID, m_dynBlocksTexCoordBufferID;
   Sprite *m_currentSkySprite;
   Sprite *m_currentSkySprite2;
 
@@ -251,7 +269,19 @@ private:
   void _RenderStaticBlocks(Scene *i_scene);
   void _RenderStaticBlock(Block *block);
   void _RenderBlockEdges(Block *block);
+  void _RenderGeomBatches(Scene *i_scene,
+                          AABB &i_bbox,
+                          int i_layer,
+                          bool i_isLayer,
+                          bool i_isBackground);
   void _RenderDynamicBlocks(Scene *i_scene, bool bBackground = false);
+  void _RenderDynamicBlocksBatch(std::vector<Block *> &i_blocks,
+                                 bool bBackground);
+  void _AddDynamicBlockGeom(Block *block,
+                            Geom *geom,
+                            Texture *pTexture,
+                            const TColor &i_color,
+                            bool i_isEdge);
   void _RenderBackground(Scene *i_scene);
   void _RenderLayers(Scene *i_scene, bool renderFront);
   void _RenderLayer(Scene *i_scene, int layer);
@@ -29,6 +29,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include <zlib.h>
 #endif
 
+#include <cmath>
+#include <cstdio>
 #include <ctime>
 #include <iostream>
 #include <time.h>
@@ -61,6 +63,135 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define RMOVINGBLOCK_MIN_LONGDIFFMOVE 0.05
 #define RMOVINGBLOCK_MIN_LONGDIFFROTATION 0.05
 
+/* format 4 : the states of a chunk are stored field by field, each column
+   coded as the differences between consecutive values in variable length
+   integers */
+#define REPLAY_V4_NB_FIELDS 22
+#define REPLAY_V4_FIRST_FLOAT_FIELD 1
+#define REPLAY_V4_LAST_FLOAT_FIELD 5
+#define REPLAY_V4_MAX_VARINT_SIZE 5 // bytes for 32 bits
+#define REPLAY_V4_MAX_DATA_SIZE (64 * 1024 * 1024) // events and moving blocks
+
+static unsigned int floatToBits(float f) {
+  unsigned int n;
+  memcpy(&n, &f, sizeof(n));
+  return n;
+}
+
+static float bitsToFloat(unsigned int n) {
+  float f;
+  memcpy(&f, &n, sizeof(f));
+  return f;
+}
+
+static void stateToFields(const SerializedBikeState &i_state,
+                          unsigned int *o_fields) {
+  o_fields[0] = i_state.cFlags;
+  o_fields[1] = floatToBits(i_state.fGameTime);
+  o_fields[2] = floatToBits(i_state.fFrameX);
+  o_fields[3] = floatToBits(i_state.fFrameY);
+  o_fields[4] = floatToBits(i_state.fMaxXDiff);
+  o_fields[5] = floatToBits(i_state.fMaxYDiff);
+  o_fields[6] = i_state.nRearWheelRot;
+  o_fields[7] = i_state.nFrontWheelRot;
+  o_fields[8] = i_state.nFrameRot;
+  o_fields[9] = i_state.cBikeEngineRPM;
+  o_fields[10] = (int)i_state.cRearWheelX;
+  o_fields[11] = (int)i_state.cRearWheelY;
+  o_fields[12] = (int)i_state.cFrontWheelX;
+  o_fields[13] = (int)i_state.cFrontWheelY;
+  o_fields[14] = (int)i_state.cElbowX;
+  o_fields[15] = (int)i_state.cElbowY;
+  o_fields[16] = (int)i_state.cShoulderX;
+  o_fields[17] = (int)i_state.cShoulderY;
+  o_fields[18] = (int)i_state.cLowerBodyX;
+  o_fields[19] = (int)i_state.cLowerBodyY;
+  o_fields[20] = (int)i_state.cKneeX;
+  o_fields[21] = (int)i_state.cKneeY;
+}
+
+static void fieldsToState(const unsigned int *i_fields,
+                          SerializedBikeState &o_state) {
+  memset(&o_state, 0, sizeof(SerializedBikeState));
+  o_state.cFlags = (unsigned char)i_fields[0];
+  o_state.fGameTime = bitsToFloat(i_fields[1]);
+  o_state.fFrameX = bitsToFloat(i_fields[2]);
+  o_state.fFrameY = bitsToFloat(i_fields[3]);
+  o_state.fMaxXDiff = bitsToFloat(i_fields[4]);
+  o_state.fMaxYDiff = bitsToFloat(i_fields[5]);
+  o_state.nRearWheelRot = (unsigned short)i_fields[6];
+  o_state.nFrontWheelRot = (unsigned short)i_fields[7];
+  o_state.nFrameRot = (unsigned short)i_fields[8];
+  o_state.cBikeEngineRPM = (unsigned char)i_fields[9];
+  o_state.cRearWheelX = (signed char)i_fields[10];
+  o_state.cRearWheelY = (signed char)i_fields[11];
+  o_state.cFrontWheelX = (signed char)i_fields[12];
+  o_state.cFrontWheelY = (signed char)i_fields[13];
+  o_state.cElbowX = (signed char)i_fields[14];
+  o_state.cElbowY = (signed char)i_fields[15];
+  o_state.cShoulderX = (signed char)i_fields[16];
+  o_state.cShoulderY = (signed char)i_fields[17];
+  o_state.cLowerBodyX = (signed char)i_fields[18];
+  o_state.cLowerBodyY = (signed char)i_fields[19];
+  o_state.cKneeX = (signed char)i_fields[20];
+  o_state.cKneeY = (signed char)i_fields[21];
+}
+
+/* close floats share their sign, exponent and high mantissa bits, so they are
+   xor-ed ; integers are coded as zigzag differences */
+static unsigned int encodeField(unsigned int i_field,
+                                unsigned int i_value,
+                                unsigned int i_previous) {
+  int v_diff;
+
+  if (i_field >= REPLAY_V4_FIRST_FLOAT_FIELD &&
+      i_field <= REPLAY_V4_LAST_FLOAT_FIELD) {
+    return i_value ^ i_previous;
+  }
+
+  v_diff = (int)(i_value - i_previous);
+  return ((unsigned int)v_diff << 1) ^ (unsigned int)(v_diff >> 31);
+}
+
+static unsigned int decodeField(unsigned int i_field,
+                                unsigned int i_code,
+                                unsigned int i_previous) {
+  if (i_field >= REPLAY_V4_FIRST_FLOAT_FIELD &&
+      i_field <= REPLAY_V4_LAST_FLOAT_FIELD) {
+    return i_code ^ i_previous;
+  }
+
+  return i_previous + ((i_code >> 1) ^ (0 - (i_code & 1)));
+}
+
+static void writeVarint(std::string &o_buffer, unsigned int i_value) {
+  while (i_value >= 0x80) {
+    o_buffer += (char)((i_value & 0x7F) | 0x80);
+    i_value >>= 7;
+  }
+  o_buffer += (char)i_value;
+}
+
+static unsigned int readVarint(const char *i_buffer,
+                               unsigned int i_size,
+                               unsigned int &io_pos) {
+  unsigned int v_value = 0;
+  unsigned char c;
+
+  for (unsigned int v_shift = 0; v_shift < 32; v_shift += 7) {
+    if (io_pos >= i_size) {
+      throw Exception("Invalid replay chunk");
+    }
+    c = (unsigned char)i_buffer[io_pos++];
+    v_value |= ((unsigned int)(c & 0x7F)) << v_shift;
+    if ((c & 0x80) == 0) {
+      return v_value;
+    }
+  }
+
+  throw Exception("Invalid replay chunk");
+}
+
 Replay::Replay() {
   m_bFinished = false;
   m_bEndOfFile = false;
@@ -87,6 +218,9 @@ void Replay::_FreeReplay(void) {
     if (m_Chunks[i]->pcChunkData != NULL) {
       delete[] m_Chunks[i]->pcChunkData;
     }
+    if (m_Chunks[i]->pcCompressedData != NULL) {
+      delete[] m_Chunks[i]->pcCompressedData;
+    }
     delete m_Chunks[i];
   }
   m_Chunks.clear();
@@ -121,31 +255,64 @@ void Replay::saveReplayIfNot(int i_format) {
     return;
   }
 
-  FileHandle *pfh =
-    XMFS::openOFile(FDT_DATA, std::string("Replays/") + m_FileName);
-  if (pfh == NULL) {
-    LogWarning("Failed to open replay file for output: %s",
-               (std::string("Replays/") + m_FileName).c_str());
-    return;
+  saveReplayAs(m_FileName, i_format);
+  m_saved = true;
+}
+
+void Replay::saveReplayAs(const std::string &i_fileName, int i_format) {
+  /* the format 4 stores the states field by field */
+  if (i_format == 4 && m_nStateSize != sizeof(SerializedBikeState)) {
+    throw Exception("Invalid replay state size");
   }
 
-  switch (i_format) {
-    // case 0: do not use format 0 anymore, it's the same as 1 + events
-    case 1:
-      saveReplay_1(pfh);
-      break;
+  /* write a temporary file and replace the replay only once it's complete,
+     so that a failure doesn't leave a truncated replay behind */
+  std::string v_file = std::string("Replays/") + i_fileName;
+  std::string v_tmpFile = v_file + ".tmp";
+  std::string v_userDir = XMFS::getUserDir(FDT_DATA) + std::string("/");
 
-    case 3:
-      saveReplay_3(pfh);
-      break;
+  FileHandle *pfh = XMFS::openOFile(FDT_DATA, v_tmpFile);
+  if (pfh == NULL) {
+    LogWarning("Failed to open replay file for output: %s",
+               v_tmpFile.c_str());
+    throw Exception("Unable to save the replay");
+  }
 
-    default:
-      XMFS::closeFile(pfh);
-      throw Exception("Invalid replay format");
+  try {
+    switch (i_format) {
+      // case 0: do not use format 0 anymore, it's the same as 1 + events
+      case 1:
+        saveReplay_1(pfh);
+        break;
+
+      case 3:
+        saveReplay_3(pfh);
+        break;
+
+      case 4:
+        saveReplay_4(pfh);
+        break;
+
+      default:
+        throw Exception("Invalid replay format");
+    }
+  } catch (...) {
+    XMFS::closeFile(pfh);
+    remove((v_userDir + v_tmpFile).c_str());
+    throw;
   }
 
   XMFS::closeFile(pfh);
-  m_saved = true;
+
+#if defined(WIN32)
+  /* rename doesn't replace an existing file on windows */
+  remove((v_userDir + v_file).c_str());
+#endif
+  if (XMFS::moveFile(v_userDir + v_tmpFile, v_userDir + v_file) == false) {
+    LogWarning("Failed to rename the replay file %s", v_tmpFile.c_str());
+    remove((v_userDir + v_tmpFile).c_str());
+    throw Exception("Unable to save the replay");
+  }
 }
 
 void Replay::saveReplay_3(FileHandle *pfh) {
@@ -157,16 +324,7 @@ void Replay::saveReplay_3(FileHandle *pfh) {
   DBuffer v_replay;
 
   /* keep header uncompressed to be faster to read just it */
-
-  /* Header */
-  XMFS::writeByte(pfh, 3); /* Version: 3 */
-  XMFS::writeInt_LE(pfh, 0x12345678); /* Endianness guard */
-  XMFS::writeString(pfh, m_LevelID);
-  XMFS::writeString(pfh, m_PlayerName);
-  XMFS::writeFloat_LE(pfh, m_fFrameRate);
-  XMFS::writeInt_LE(pfh, m_nStateSize);
-  XMFS::writeBool(pfh, m_bFinished);
-  XMFS::writeFloat_LE(pfh, GameApp::timeToFloat(m_finishTime));
+  saveHeader(pfh, 3);
 
   /* ***** ***** ***** ***** ***** **/
   /* compress all except the header */
@@ -185,11 +343,39 @@ void Replay::saveReplay_3(FileHandle *pfh) {
   v_replay << (unsigned int)m_Chunks.size();
   for (unsigned int i = 0; i < m_Chunks.size(); i++) {
     v_replay << m_Chunks[i]->nNumStates;
-    v_replay.writeBuf(m_Chunks[i]->pcChunkData,
-                      m_nStateSize * m_Chunks[i]->nNumStates);
+    v_replay.writeBuf(chunkData(i), m_nStateSize * m_Chunks[i]->nNumStates);
   }
 
   /* Moving blocks */
+  saveMovingBlocks(v_replay);
+
+  /* zip and write into the file */
+  pcData = v_replay.convertOutputToInput();
+  nDataSize = v_replay.numRemainingBytes();
+  pcCompressedData =
+    FileCompression::zcompress(pcData, nDataSize, nCompressedDataSize);
+  XMFS::writeInt_LE(pfh, nDataSize);
+  XMFS::writeInt_LE(pfh, nCompressedDataSize);
+  XMFS::writeBuf(pfh, (char *)pcCompressedData, nCompressedDataSize);
+  free(pcCompressedData);
+  LogInfo("Replay - uncompressed = %iKB ; compressed = %iKB (ratio = %.2f%%)",
+          nDataSize / 1024,
+          nCompressedDataSize / 1024,
+          (((float)nCompressedDataSize * 100.0)) / ((float)nDataSize));
+}
+
+void Replay::saveHeader(FileHandle *pfh, int nVersion) {
+  XMFS::writeByte(pfh, nVersion);
+  XMFS::writeInt_LE(pfh, 0x12345678); /* Endianness guard */
+  XMFS::writeString(pfh, m_LevelID);
+  XMFS::writeString(pfh, m_PlayerName);
+  XMFS::writeFloat_LE(pfh, m_fFrameRate);
+  XMFS::writeInt_LE(pfh, m_nStateSize);
+  XMFS::writeBool(pfh, m_bFinished);
+  XMFS::writeFloat_LE(pfh, GameApp::timeToFloat(m_finishTime));
+}
+
+void Replay::saveMovingBlocks(DBuffer &o_buffer) {
   int nstates = 0;
   unsigned int nmovingBlocks = 0;
 
@@ -200,18 +386,18 @@ void Replay::saveReplay_3(FileHandle *pfh) {
       nmovingBlocks++;
     }
   }
-  v_replay << nmovingBlocks;
+  o_buffer << nmovingBlocks;
   for (unsigned int i = 0; i < m_movingBlocksForSaving.size(); i++) {
     if (m_movingBlocksForSaving[i].states.size() >
         1) { // > 1 because if there is only one state, the block has not moved
-      v_replay << m_movingBlocksForSaving[i].name;
-      v_replay << m_movingBlocksForSaving[i].states.size();
+      o_buffer << m_movingBlocksForSaving[i].name;
+      o_buffer << m_movingBlocksForSaving[i].states.size();
       for (unsigned int j = 0; j < m_movingBlocksForSaving[i].states.size();
            j++) {
-        v_replay << m_movingBlocksForSaving[i].states[j].time;
-        v_replay << m_movingBlocksForSaving[i].states[j].position.x;
-        v_replay << m_movingBlocksForSaving[i].states[j].position.y;
-        v_replay << m_movingBlocksForSaving[i].states[j].rotation;
+        o_buffer << m_movingBlocksForSaving[i].states[j].time;
+        o_buffer << m_movingBlocksForSaving[i].states[j].position.x;
+        o_buffer << m_movingBlocksForSaving[i].states[j].position.y;
+        o_buffer << m_movingBlocksForSaving[i].states[j].rotation;
         nstates++;
       }
     }
@@ -223,8 +409,58 @@ void Replay::saveReplay_3(FileHandle *pfh) {
           m_movingBlocksForSaving.size(),
           nstates,
           sizeof(rmblockState));
+}
+
+void Replay::saveReplay_4(FileHandle *pfh) {
+  const char *pcData;
+  int nDataSize;
+  char *pcCompressedData;
+  int nCompressedDataSize;
+  std::vector<std::string> v_chunks;
+  std::string v_columns;
+  float v_chunkTime;
+  uLong v_crc;
+  int v_offset = 0;
+  int v_statesSize = 0;
+
+  DBuffer v_replay;
+
+  /* keep header and chunks index uncompressed to be faster to read them */
+  saveHeader(pfh, 4);
+
+  /* Chunks index ; each chunk is compressed alone to be decoded only when it
+     is played */
+  XMFS::writeInt_LE(pfh, m_Chunks.size());
+  for (unsigned int i = 0; i < m_Chunks.size(); i++) {
+    v_columns.clear();
+    v_chunkTime = encodeChunk_4(i, v_columns);
+    pcCompressedData = FileCompression::zcompress(
+      v_columns.c_str(), v_columns.size(), nCompressedDataSize);
+    v_chunks.push_back(std::string(pcCompressedData, nCompressedDataSize));
+    v_crc = crc32(0L, (const Bytef *)pcCompressedData, nCompressedDataSize);
+    free(pcCompressedData);
+
+    XMFS::writeInt_LE(pfh, m_Chunks[i]->nNumStates);
+    XMFS::writeFloat_LE(pfh, v_chunkTime);
+    XMFS::writeInt_LE(pfh, v_offset);
+    XMFS::writeInt_LE(pfh, nCompressedDataSize);
+    XMFS::writeInt_LE(pfh, v_columns.size());
+    XMFS::writeInt_LE(pfh, (int)v_crc);
+
+    v_offset += nCompressedDataSize;
+    v_statesSize += m_nStateSize * m_Chunks[i]->nNumStates;
+  }
+
+  /* Events and moving blocks, compressed together */
+  v_replay.initOutput(32);
+
+  pcData = convertOutputToInput();
+  nDataSize = numRemainingBytes();
+  v_replay << nDataSize;
+  v_replay.writeBuf(pcData, nDataSize);
+
+  saveMovingBlocks(v_replay);
 
-  /* zip and write into the file */
   pcData = v_replay.convertOutputToInput();
   nDataSize = v_replay.numRemainingBytes();
   pcCompressedData =
@@ -233,10 +469,42 @@ void Replay::saveReplay_3(FileHandle *pfh) {
   XMFS::writeInt_LE(pfh, nCompressedDataSize);
   XMFS::writeBuf(pfh, (char *)pcCompressedData, nCompressedDataSize);
   free(pcCompressedData);
-  LogInfo("Replay - uncompressed = %iKB ; compressed = %iKB (ratio = %.2f%%)",
-          nDataSize / 1024,
-          nCompressedDataSize / 1024,
-          (((float)nCompressedDataSize * 100.0)) / ((float)nDataSize));
+
+  /* Chunks, at the offsets of the index */
+  for (unsigned int i = 0; i < v_chunks.size(); i++) {
+    XMFS::writeBuf(pfh, (char *)v_chunks[i].c_str(), v_chunks[i].size());
+  }
+
+  LogInfo("Replay - states = %iKB ; compressed = %iKB (ratio = %.2f%%)",
+          v_statesSize / 1024,
+          v_offset / 1024,
+          (((float)v_offset * 100.0)) / ((float)v_statesSize));
+}
+
+float Replay::encodeChunk_4(unsigned int i_chunk, std::string &o_columns) {
+  int v_nNumStates = m_Chunks[i_chunk]->nNumStates;
+  const char *v_pcChunkData = chunkData(i_chunk);
+  std::vector<unsigned int> v_fields(v_nNumStates * REPLAY_V4_NB_FIELDS);
+  SerializedBikeState v_state;
+  unsigned int v_previous;
+
+  for (int i = 0; i < v_nNumStates; i++) {
+    memcpy((char *)&v_state, &v_pcChunkData[i * m_nStateSize], m_nStateSize);
+    SwapEndian::LittleSerializedBikeState(v_state);
+    stateToFields(v_state, &v_fields[i * REPLAY_V4_NB_FIELDS]);
+  }
+
+  for (unsigned int f = 0; f < REPLAY_V4_NB_FIELDS; f++) {
+    v_previous = 0;
+    for (int i = 0; i < v_nNumStates; i++) {
+      writeVarint(
+        o_columns,
+        encodeField(f, v_fields[i * REPLAY_V4_NB_FIELDS + f], v_previous));
+      v_previous = v_fields[i * REPLAY_V4_NB_FIELDS + f];
+    }
+  }
+
+  return bitsToFloat(v_fields[1]); /* game time of the first state */
 }
 
 void Replay::saveReplay_1(FileHandle *pfh) {
@@ -290,14 +558,13 @@ void Replay::saveReplay_1(FileHandle *pfh) {
     uLongf nSrcLen = m_nStateSize * m_Chunks[i]->nNumStates;
     int nZRet = compress2((Bytef *)pcCompressed,
                           &nDestLen,
-                          (Bytef *)m_Chunks[i]->pcChunkData,
+                          (Bytef *)chunkData(i),
                           nSrcLen,
                           9);
     if (nZRet != Z_OK) {
       /* Failed to compress... Save uncompressed chunk then */
       XMFS::writeBool(pfh, false); /* compression: false */
-      XMFS::writeBuf(
-        pfh, m_Chunks[i]->pcChunkData, m_nStateSize * m_Chunks[i]->nNumStates);
+      XMFS::writeBuf(pfh, chunkData(i), m_nStateSize * m_Chunks[i]->nNumStates);
     } else {
       /* Compressed ok */
       XMFS::writeBool(pfh, true); /* compression: true */
@@ -308,6 +575,25 @@ void Replay::saveReplay_1(FileHandle *pfh) {
   }
 }
 
+/* game time of a state stored in a chunk */
+static float storedStateTime(const char *i_pcState, int i_stateSize) {
+  SerializedBikeState v_state;
+
+  if (i_stateSize <= 0) {
+    return 0.0;
+  }
+
+  memset((char *)&v_state, 0, sizeof(SerializedBikeState));
+  memcpy((char *)&v_state,
+         i_pcState,
+         i_stateSize < (int)sizeof(SerializedBikeState)
+           ? i_stateSize
+           : sizeof(SerializedBikeState));
+  SwapEndian::LittleSerializedBikeState(v_state);
+
+  return v_state.fGameTime;
+}
+
 void Replay::openReplay_3(FileHandle *pfh, bool bDisplayInformation) {
   DBuffer v_replay;
   int v_nDataSize;
@@ -315,43 +601,7 @@ void Replay::openReplay_3(FileHandle *pfh, bool bDisplayInformation) {
   int v_nCompressedDataSize;
   char *v_pcCompressedData;
 
-  /* Little/big endian safety check */
-  if (XMFS::readInt_LE(pfh) != 0x12345678) {
-    LogWarning("Sorry, the replay you're trying to open are not "
-               "endian-compatible with your computer!");
-    throw Exception("Unable to open the replay");
-  }
-
-  /* Header */
-  m_LevelID = XMFS::readString(pfh);
-  if (bDisplayInformation) {
-    printf("%-30s: %s\n", "Level Id", m_LevelID.c_str());
-  }
-
-  m_PlayerName = XMFS::readString(pfh);
-  if (bDisplayInformation) {
-    printf("%-30s: %s\n", "Player", m_PlayerName.c_str());
-  }
-
-  m_fFrameRate = XMFS::readFloat_LE(pfh);
-
-  m_nStateSize = XMFS::readInt_LE(pfh);
-  if (bDisplayInformation) {
-    printf("%-30s: %i\n", "State size", m_nStateSize);
-  }
-
-  m_bFinished = XMFS::readBool(pfh);
-  m_finishTime = GameApp::floatToTime(XMFS::readFloat_LE(pfh));
-  if (bDisplayInformation) {
-    if (m_bFinished) {
-      printf("%-30s: %.2f (%f)\n",
-             "Finish time",
-             m_finishTime / 100.0,
-             m_finishTime / 100.0);
-    } else {
-      printf("%-30s: %s\n", "Finish time", "unfinished");
-    }
-  }
+  openHeader(pfh, bDisplayInformation);
 
   /* zuncompressed */
   v_nDataSize = XMFS::readInt_LE(pfh);
@@ -415,35 +665,300 @@ void Replay::openReplay_3(FileHandle *pfh, bool bDisplayInformation) {
     Chunk->pcChunkData = new char[Chunk->nNumStates * m_nStateSize];
 
     v_replay.readBuf(Chunk->pcChunkData, m_nStateSize * Chunk->nNumStates);
+    Chunk->fTime = storedStateTime(Chunk->pcChunkData,
+                                   Chunk->nNumStates > 0 ? m_nStateSize : 0);
     m_Chunks.push_back(Chunk);
   }
 
   /* moving blocks */
+  openMovingBlocks(v_replay);
+
+  free(v_pcData);
+}
+
+void Replay::openHeader(FileHandle *pfh, bool bDisplayInformation) {
+  /* Little/big endian safety check */
+  if (XMFS::readInt_LE(pfh) != 0x12345678) {
+    LogWarning("Sorry, the replay you're trying to open are not "
+               "endian-compatible with your computer!");
+    throw Exception("Unable to open the replay");
+  }
+
+  /* Header */
+  m_LevelID = XMFS::readString(pfh);
+  if (bDisplayInformation) {
+    printf("%-30s: %s\n", "Level Id", m_LevelID.c_str());
+  }
+
+  m_PlayerName = XMFS::readString(pfh);
+  if (bDisplayInformation) {
+    printf("%-30s: %s\n", "Player", m_PlayerName.c_str());
+  }
+
+  m_fFrameRate = XMFS::readFloat_LE(pfh);
+
+  m_nStateSize = XMFS::readInt_LE(pfh);
+  if (bDisplayInformation) {
+    printf("%-30s: %i\n", "State size", m_nStateSize);
+  }
+
+  m_bFinished = XMFS::readBool(pfh);
+  m_finishTime = GameApp::floatToTime(XMFS::readFloat_LE(pfh));
+  if (bDisplayInformation) {
+    if (m_bFinished) {
+      printf("%-30s: %.2f (%f)\n",
+             "Finish time",
+             m_finishTime / 100.0,
+             m_finishTime / 100.0);
+    } else {
+      printf("%-30s: %s\n", "Finish time", "unfinished");
+    }
+  }
+}
+
+void Replay::openMovingBlocks(DBuffer &i_buffer) {
   unsigned int v_nmovingBlocks;
   unsigned int v_nstates;
   rmtime t;
   rmtimeState s;
 
-  v_replay >> v_nmovingBlocks;
+  i_buffer >> v_nmovingBlocks;
 
   for (unsigned int i = 0; i < v_nmovingBlocks; i++) {
-    v_replay >> t.name;
+    i_buffer >> t.name;
     t.block = NULL; // don't initialize now, the level is not loaded
     t.readPos = 0;
     m_movingBlocksForLoading.push_back(t);
 
-    v_replay >> v_nstates;
+    i_buffer >> v_nstates;
     for (unsigned int j = 0; j < v_nstates; j++) {
-      v_replay >> s.time;
-      v_replay >> s.position.x;
-      v_replay >> s.position.y;
-      v_replay >> s.rotation;
+      i_buffer >> s.time;
+      i_buffer >> s.position.x;
+      i_buffer >> s.position.y;
+      i_buffer >> s.rotation;
 
       m_movingBlocksForLoading[m_movingBlocksForLoading.size() - 1]
         .states.push_back(s);
     }
   }
+}
+
+void Replay::openReplay_4(FileHandle *pfh, bool bDisplayInformation) {
+  DBuffer v_replay;
+  int v_nDataSize;
+  int v_nEventsDataSize = -1;
+  char *v_pcData;
+  int v_nCompressedDataSize;
+  char *v_pcCompressedData;
+  std::vector<int> v_offsets;
+  std::vector<unsigned int> v_crcs;
+  long long v_chunkEnd;
+  long long v_nChunksDataSize = 0;
+  char *v_pcChunksData;
+
+  openHeader(pfh, bDisplayInformation);
+
+  /* the states are decoded field by field */
+  if (m_nStateSize != sizeof(SerializedBikeState)) {
+    LogWarning("Invalid state size (%i) in replay", m_nStateSize);
+    throw Exception("Unable to open the replay");
+  }
+
+  /* Chunks index */
+  unsigned int nNumChunks = XMFS::readInt_LE(pfh);
+  if (bDisplayInformation) {
+    printf("%-30s: %i\n", "Number of chunks", nNumChunks);
+  }
+  if (nNumChunks == 0) {
+    _FreeReplay();
+    LogWarning("try to open a replay with no chunk");
+    throw Exception("Replay with no chunk !");
+  }
+
+  for (unsigned int i = 0; i < nNumChunks; i++) {
+    ReplayStateChunk *Chunk = new ReplayStateChunk();
+    m_Chunks.push_back(Chunk);
+
+    Chunk->nNumStates = XMFS::readInt_LE(pfh);
+    Chunk->fTime = XMFS::readFloat_LE(pfh);
+    v_offsets.push_back(XMFS::readInt_LE(pfh));
+    Chunk->nCompressedSize = XMFS::readInt_LE(pfh);
+    Chunk->nColumnsSize = XMFS::readInt_LE(pfh);
+    v_crcs.push_back((unsigned int)XMFS::readInt_LE(pfh));
+
+    if (bDisplayInformation) {
+      printf("Chunk %02i\n", i);
+      printf("   %-27s: %i\n", "Number of states", Chunk->nNumStates);
+      printf("   %-27s: %.2f\n", "Time", Chunk->fTime);
+      printf(
+        "   %-27s: %i\n", "Compressed states size", Chunk->nCompressedSize);
+    }
+
+    /* the sizes come from the file : the chunks must lie in it, and the
+       columns can't be larger than their varints */
+    v_chunkEnd = (long long)v_offsets[i] + (long long)Chunk->nCompressedSize;
+    if (Chunk->nNumStates <= 0 || Chunk->nNumStates > STATES_PER_CHUNK ||
+        v_offsets[i] < 0 || Chunk->nCompressedSize <= 0 ||
+        v_chunkEnd > XMFS::getLength(pfh) || Chunk->nColumnsSize <= 0 ||
+        Chunk->nColumnsSize > Chunk->nNumStates * REPLAY_V4_NB_FIELDS *
+                                REPLAY_V4_MAX_VARINT_SIZE) {
+      _FreeReplay();
+      LogWarning("Invalid chunk %d in replay", i);
+      throw Exception("Unable to open the replay");
+    }
+
+    if (v_chunkEnd > v_nChunksDataSize) {
+      v_nChunksDataSize = v_chunkEnd;
+    }
+  }
+
+  /* Events and moving blocks */
+  v_nDataSize = XMFS::readInt_LE(pfh);
+  v_nCompressedDataSize = XMFS::readInt_LE(pfh);
+  if (v_nDataSize <= 0 || v_nDataSize > REPLAY_V4_MAX_DATA_SIZE ||
+      v_nCompressedDataSize <= 0 ||
+      v_nCompressedDataSize > XMFS::getLength(pfh)) {
+    _FreeReplay();
+    LogWarning("Invalid events size in replay");
+    throw Exception("Unable to open the replay");
+  }
+
+  v_pcData = (char *)malloc(v_nDataSize);
+  if (v_pcData == NULL) {
+    throw Exception("Unable to malloc for decompression");
+  }
+  v_pcCompressedData = (char *)malloc(v_nCompressedDataSize);
+  if (v_pcCompressedData == NULL) {
+    free(v_pcData);
+    throw Exception("Unable to malloc for decompression");
+  }
+  try {
+    if (XMFS::readBuf(pfh, v_pcCompressedData, v_nCompressedDataSize) ==
+        false) {
+      throw Exception("Failed to read the events of the replay");
+    }
+    FileCompression::zuncompress(
+      v_pcCompressedData, v_nCompressedDataSize, v_pcData, v_nDataSize);
+  } catch (Exception &e) {
+    free(v_pcData);
+    free(v_pcCompressedData);
+    _FreeReplay();
+    LogWarning("%s", e.getMsg().c_str());
+    throw Exception("Unable to open the replay");
+  }
+  free(v_pcCompressedData);
+  v_replay.initInput(v_pcData, v_nDataSize);
+
+  if (v_nDataSize >= (int)sizeof(int)) {
+    v_replay >> v_nEventsDataSize;
+  }
+  if (bDisplayInformation) {
+    printf("%-30s: %i\n", "Events data size", v_nEventsDataSize);
+  }
+  if (v_nEventsDataSize < 0 ||
+      v_nEventsDataSize > v_nDataSize - (int)sizeof(int)) {
+    free(v_pcData);
+    _FreeReplay();
+    LogWarning("Invalid events data size in replay");
+    throw Exception("Unable to open the replay");
+  }
+  m_nInputEventsDataSize = v_nEventsDataSize;
+  m_pcInputEventsData = new char[m_nInputEventsDataSize];
+  v_replay.readBuf(m_pcInputEventsData, m_nInputEventsDataSize);
+  initInput(m_pcInputEventsData, m_nInputEventsDataSize);
+
+  openMovingBlocks(v_replay);
+
   free(v_pcData);
+
+  /* Chunks, kept compressed until they are played ; their checksum is
+     checked now so that a corrupted replay doesn't fail while it is played,
+     without decoding them twice */
+  v_pcChunksData = new char[v_nChunksDataSize];
+  if (XMFS::readBuf(pfh, v_pcChunksData, v_nChunksDataSize) == false) {
+    delete[] v_pcChunksData;
+    _FreeReplay();
+    LogWarning("Failed to read the chunks of the replay");
+    throw Exception("Unable to open the replay");
+  }
+
+  for (unsigned int i = 0; i < m_Chunks.size(); i++) {
+    if (crc32(0L,
+              (const Bytef *)v_pcChunksData + v_offsets[i],
+              m_Chunks[i]->nCompressedSize) != v_crcs[i]) {
+      delete[] v_pcChunksData;
+      _FreeReplay();
+      LogWarning("Invalid checksum for the chunk %d in replay", i);
+      throw Exception("Unable to open the replay");
+    }
+
+    m_Chunks[i]->pcCompressedData = new char[m_Chunks[i]->nCompressedSize];
+    memcpy(m_Chunks[i]->pcCompressedData,
+           v_pcChunksData + v_offsets[i],
+           m_Chunks[i]->nCompressedSize);
+  }
+  delete[] v_pcChunksData;
+}
+
+char *Replay::chunkData(unsigned int i_chunk) {
+  if (m_Chunks[i_chunk]->pcChunkData == NULL) {
+    decodeChunk_4(m_Chunks[i_chunk]);
+  }
+  return m_Chunks[i_chunk]->pcChunkData;
+}
+
+void Replay::decodeFields_4(const ReplayStateChunk *i_chunk,
+                            std::vector<unsigned int> &o_fields) {
+  char *v_pcColumns = new char[i_chunk->nColumnsSize];
+  unsigned int v_value;
+  unsigned int v_pos = 0;
+
+  o_fields.resize(i_chunk->nNumStates * REPLAY_V4_NB_FIELDS);
+
+  try {
+    FileCompression::zuncompress(i_chunk->pcCompressedData,
+                                 i_chunk->nCompressedSize,
+                                 v_pcColumns,
+                                 i_chunk->nColumnsSize);
+
+    for (unsigned int f = 0; f < REPLAY_V4_NB_FIELDS; f++) {
+      v_value = 0;
+      for (int i = 0; i < i_chunk->nNumStates; i++) {
+        v_value = decodeField(
+          f, readVarint(v_pcColumns, i_chunk->nColumnsSize, v_pos), v_value);
+        o_fields[i * REPLAY_V4_NB_FIELDS + f] = v_value;
+      }
+    }
+  } catch (Exception &e) {
+    delete[] v_pcColumns;
+    throw e;
+  }
+  delete[] v_pcColumns;
+}
+
+void Replay::decodeChunk_4(ReplayStateChunk *io_chunk) {
+  std::vector<unsigned int> v_fields;
+  SerializedBikeState v_state;
+
+  try {
+    decodeFields_4(io_chunk, v_fields);
+  } catch (Exception &e) {
+    LogWarning("Failed to decode a chunk of the replay");
+    throw e;
+  }
+
+  io_chunk->pcChunkData = new char[io_chunk->nNumStates * m_nStateSize];
+  for (int i = 0; i < io_chunk->nNumStates; i++) {
+    fieldsToState(&v_fields[i * REPLAY_V4_NB_FIELDS], v_state);
+    SwapEndian::LittleSerializedBikeState(v_state);
+    memcpy(&io_chunk->pcChunkData[i * m_nStateSize],
+           (const char *)&v_state,
+           m_nStateSize);
+  }
+
+  /* the compressed states are not needed anymore */
+  delete[] io_chunk->pcCompressedData;
+  io_chunk->pcCompressedData = NULL;
 }
 
 void Replay::openReplay_1(FileHandle *pfh,
@@ -604,6 +1119,8 @@ void Replay::openReplay_1(FileHandle *pfh,
       XMFS::readBuf(pfh, Chunk->pcChunkData, m_nStateSize * Chunk->nNumStates);
     }
 
+    Chunk->fTime = storedStateTime(Chunk->pcChunkData,
+                                   Chunk->nNumStates > 0 ? m_nStateSize : 0);
     m_Chunks.push_back(Chunk);
   }
 }
@@ -655,6 +1172,15 @@ std::string Replay::openReplay(const std::string &FileName,
       }
       break;
 
+    case 4:
+      try {
+        openReplay_4(pfh, bDisplayInformation);
+      } catch (Exception &e) {
+        XMFS::closeFile(pfh);
+        throw e;
+      }
+      break;
+
     default:
       XMFS::closeFile(pfh);
       LogWarning("Unsupported replay file version (%d): %s",
@@ -839,6 +1365,7 @@ void Replay::storeState(const SerializedBikeState &state) {
     ReplayStateChunk *Chunk = new ReplayStateChunk();
     Chunk->pcChunkData = new char[STATES_PER_CHUNK * m_nStateSize];
     Chunk->nNumStates = 1;
+    Chunk->fTime = state.fGameTime;
     addr = Chunk->pcChunkData;
     m_Chunks.push_back(Chunk);
   } else {
@@ -850,6 +1377,7 @@ void Replay::storeState(const SerializedBikeState &state) {
       ReplayStateChunk *Chunk = new ReplayStateChunk();
       Chunk->pcChunkData = new char[STATES_PER_CHUNK * m_nStateSize];
       Chunk->nNumStates = 1;
+      Chunk->fTime = state.fGameTime;
       addr = Chunk->pcChunkData;
       m_Chunks.push_back(Chunk);
     }
@@ -960,7 +1488,7 @@ void Replay::peekState(BikeState *state, PhysicsSettings *i_physicsSettings) {
   /* Like loadState() but this one does not advance the cursor... it just takes
    * a peek */
   memcpy((char *)&v_bs,
-         &m_Chunks[m_nCurChunk]->pcChunkData[((int)m_nCurState) * m_nStateSize],
+         &chunkData(m_nCurChunk)[((int)m_nCurState) * m_nStateSize],
          m_nStateSize);
   SwapEndian::LittleSerializedBikeState(v_bs);
 
@@ -1013,7 +1541,7 @@ ReplayInfo *Replay::getReplayInfos(const std::string p_ReplayName) {
   }
 
   int nVersion = XMFS::readByte(pfh);
-  if (nVersion != 0 && nVersion != 1 && nVersion != 3) {
+  if (nVersion != 0 && nVersion != 1 && nVersion != 3 && nVersion != 4) {
     XMFS::closeFile(pfh);
     return NULL;
   }
@@ -1056,13 +1584,58 @@ ReplayInfo *Replay::getReplayInfos(const std::string p_ReplayName) {
 void Replay::fastforward(int i_time) {
   /* How many states should we move forward? */
   int nNumStates = (int)((i_time * m_fFrameRate) / 100);
-  nextState(nNumStates);
+  if (nNumStates <= 0) {
+    return;
+  }
+
+  m_bEndOfFile = false;
+  seekTime(cursorTime() + nNumStates / m_fFrameRate);
 }
 
 void Replay::fastrewind(int i_time, int i_minimumNbFrame) {
-  /* How many states should we move forward? */
+  /* How many states should we move backward? */
   int nNumStates = (int)((i_time * m_fFrameRate) / 100);
-  nextState(nNumStates < i_minimumNbFrame ? -i_minimumNbFrame : -nNumStates);
+  if (nNumStates < i_minimumNbFrame) {
+    nNumStates = i_minimumNbFrame;
+  }
+  if (nNumStates <= 0) {
+    return;
+  }
+
+  m_bEndOfFile = false;
+  seekTime(cursorTime() - nNumStates / m_fFrameRate);
+}
+
+float Replay::cursorTime() const {
+  return m_Chunks[m_nCurChunk]->fTime + ((int)m_nCurState) / m_fFrameRate;
+}
+
+void Replay::seekTime(float i_time) {
+  unsigned int v_min = 0;
+  unsigned int v_max = m_Chunks.size() - 1;
+  unsigned int v_middle;
+  float v_state;
+
+  /* last chunk starting before i_time */
+  while (v_min < v_max) {
+    v_middle = (v_min + v_max + 1) / 2;
+    if (m_Chunks[v_middle]->fTime <= i_time) {
+      v_min = v_middle;
+    } else {
+      v_max = v_middle - 1;
+    }
+  }
+
+  v_state = floorf((i_time - m_Chunks[v_min]->fTime) * m_fFrameRate + 0.5);
+  if (v_state > m_Chunks[v_min]->nNumStates - 1) {
+    v_state = m_Chunks[v_min]->nNumStates - 1;
+  }
+  if ((v_state >= 0.0) == false) { /* negative or nan */
+    v_state = 0.0;
+  }
+
+  m_nCurChunk = v_min;
+  m_nCurState = v_state;
 }
 
 void Replay::cleanReplays(xmDatabase *i_db) {}
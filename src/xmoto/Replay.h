@@ -47,8 +47,12 @@ struct ReplayInfo {
 /* Replays states (frames) are grouped together in chunks for easy
    processing */
 struct ReplayStateChunk {
-  char *pcChunkData;
+  char *pcChunkData; /* NULL until a compressed chunk is decoded (format 4) */
   int nNumStates;
+  char *pcCompressedData; /* format 4 */
+  int nCompressedSize;
+  int nColumnsSize; /* uncompressed size */
+  float fTime; /* game time of the first state, to seek without decoding */
 };
 
 /* to be able to rewind exactly at the same position */
@@ -147,6 +151,8 @@ public:
   static ReplayInfo *getReplayInfos(const std::string p_ReplayName);
 
   void saveReplayIfNot(int i_format);
+  /* write the replay again into Replays/i_fileName, in an other format */
+  void saveReplayAs(const std::string &i_fileName, int i_format);
 
   // store and restore replay position
   void rewindAtPosition(ReplayPosition i_rs);
@@ -179,9 +185,29 @@ private:
 
   void saveReplay_1(FileHandle *pfh);
   void saveReplay_3(FileHandle *pfh);
+  void saveReplay_4(FileHandle *pfh);
+  void saveHeader(FileHandle *pfh, int nVersion);
+  void saveMovingBlocks(DBuffer &o_buffer);
 
   void openReplay_1(FileHandle *pfh, bool bDisplayInformation, int nVersion);
   void openReplay_3(FileHandle *pfh, bool bDisplayInformation);
+  void openReplay_4(FileHandle *pfh, bool bDisplayInformation);
+  void openHeader(FileHandle *pfh, bool bDisplayInformation);
+  void openMovingBlocks(DBuffer &i_buffer);
+
+  /* game time of the current state, from the time of its chunk */
+  float cursorTime() const;
+  /* move the cursor on the state at i_time, searching its chunk by time */
+  void seekTime(float i_time);
+
+  /* chunk states, decoded the first time they are used */
+  char *chunkData(unsigned int i_chunk);
+  /* return the game time of the first state */
+  float encodeChunk_4(unsigned int i_chunk, std::string &o_columns);
+  void decodeChunk_4(ReplayStateChunk *io_chunk);
+  /* throw if the chunk is corrupted */
+  void decodeFields_4(const ReplayStateChunk *i_chunk,
+                      std::vector<unsigned int> &o_fields);
 
   /* moving blocks (physics) */
   std::vector<rmblock> m_movingBlocksForSaving;
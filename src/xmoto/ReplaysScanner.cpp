@@ -0,0 +1,60 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "ReplaysScanner.h"
+#include "Replay.h"
+#include "helpers/VExcept.h"
+
+ReplaysScanner::ReplaysScanner(const std::vector<std::string> &i_replays)
+  : ParallelReader(i_replays.size(), "ReplaysScanner") {
+  m_replays = i_replays;
+  m_infos.resize(m_replays.size(), NULL);
+
+  startThreads();
+}
+
+ReplaysScanner::~ReplaysScanner() {
+  stopThreads();
+
+  // infos not taken by the caller
+  for (unsigned int i = 0; i < m_infos.size(); i++) {
+    if (m_infos[i] != NULL) {
+      delete m_infos[i];
+    }
+  }
+}
+
+void ReplaysScanner::readItem(unsigned int i) {
+  try {
+    m_infos[i] = Replay::getReplayInfos(m_replays[i]);
+  } catch (Exception &e) {
+    m_infos[i] = NULL; // truncated header
+  }
+}
+
+ReplayInfo *ReplaysScanner::getReplayInfos(unsigned int i) {
+  ReplayInfo *v_infos;
+
+  waitItem(i);
+  v_infos = m_infos[i];
+  m_infos[i] = NULL;
+
+  return v_infos;
+}
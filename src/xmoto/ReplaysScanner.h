@@ -0,0 +1,52 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __REPLAYSSCANNER_H__
+#define __REPLAYSSCANNER_H__
+
+#include "helpers/ParallelReader.h"
+#include <string>
+#include <vector>
+
+struct ReplayInfo;
+
+/**
+ * read the headers of a list of replays with several threads. The infos are
+ * given back in the order of the list, so that the caller stays the only one
+ * writing into the database.
+ */
+class ReplaysScanner : public ParallelReader {
+public:
+  ReplaysScanner(const std::vector<std::string> &i_replays);
+  virtual ~ReplaysScanner();
+
+  /* wait for the infos of the replay i ; return NULL if its header can't be
+     read. The caller owns the infos. Call it in the order of the list */
+  ReplayInfo *getReplayInfos(unsigned int i);
+
+protected:
+  virtual void readItem(unsigned int i);
+
+private:
+  std::vector<std::string> m_replays;
+  std::vector<ReplayInfo *> m_infos;
+};
+
+#endif
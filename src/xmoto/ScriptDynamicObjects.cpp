@@ -241,11 +241,19 @@ void SDynamicEntityRotation::performXY(float *vx, float *vy, float *vAngle) {
   SDynamicRotation::performXY(vx, vy);
 }
 
+SDynamicObject *SDynamicEntityRotation::clone() const {
+  return new SDynamicEntityRotation(*this);
+}
+
 void SDynamicEntityTranslation::performXY(float *vx, float *vy, float *vAngle) {
   *vAngle = 0.0;
   SDynamicTranslation::performXY(vx, vy);
 }
 
+SDynamicObject *SDynamicEntityTranslation::clone() const {
+  return new SDynamicEntityTranslation(*this);
+}
+
 /* block */
 
 SDynamicBlockMove::SDynamicBlockMove(std::string pBlock,
@@ -311,11 +319,19 @@ void SDynamicBlockRotation::performXY(float *vx, float *vy, float *vAngle) {
   SDynamicRotation::performXY(vx, vy);
 }
 
+SDynamicObject *SDynamicBlockRotation::clone() const {
+  return new SDynamicBlockRotation(*this);
+}
+
 void SDynamicBlockTranslation::performXY(float *vx, float *vy, float *vAngle) {
   *vAngle = 0.0;
   SDynamicTranslation::performXY(vx, vy);
 }
 
+SDynamicObject *SDynamicBlockTranslation::clone() const {
+  return new SDynamicBlockTranslation(*this);
+}
+
 SDynamicBlockSelfRotation::SDynamicBlockSelfRotation(std::string pBlock,
                                                      int pPeriod,
                                                      int p_startTime,
@@ -330,6 +346,10 @@ void SDynamicBlockSelfRotation::performXY(float *vx, float *vy, float *vAngle) {
   SDynamicSelfRotation::performXY(vAngle);
 }
 
+SDynamicObject *SDynamicBlockSelfRotation::clone() const {
+  return new SDynamicBlockSelfRotation(*this);
+}
+
 SDynamicEntitySelfRotation::SDynamicEntitySelfRotation(std::string pEntity,
                                                        int pPeriod,
                                                        int p_startTime,
@@ -346,6 +366,10 @@ void SDynamicEntitySelfRotation::performXY(float *vx,
   SDynamicSelfRotation::performXY(vAngle);
 }
 
+SDynamicObject *SDynamicEntitySelfRotation::clone() const {
+  return new SDynamicEntitySelfRotation(*this);
+}
+
 SPhysicBlockMove::SPhysicBlockMove(std::string blockName,
                                    int startTime,
                                    int endTime,
@@ -386,6 +410,10 @@ void SPhysicBlockSelfRotation::applyForce() {
   body->t += m_torque;
 }
 
+SDynamicObject *SPhysicBlockSelfRotation::clone() const {
+  return new SPhysicBlockSelfRotation(*this);
+}
+
 SPhysicBlockTranslation::SPhysicBlockTranslation(std::string blockName,
                                                  float x,
                                                  float y,
@@ -438,3 +466,7 @@ void SPhysicBlockTranslation::applyForce() {
   float mult = 25000.0f;
   cpBodyApplyForce(body, cpv(x * mult, y * mult), cpvzero);
 }
+
+SDynamicObject *SPhysicBlockTranslation::clone() const {
+  return new SPhysicBlockTranslation(*this);
+}
@@ -36,6 +36,9 @@ public:
   bool nextState(Scene *v_motoGame, int i_nbCents);
   inline std::string &getObjectId() { return m_objectId; }
 
+  /* copy of the object in its current state */
+  virtual SDynamicObject *clone() const = 0;
+
 protected:
   bool isTimeToMove();
   virtual void performMove(Scene *v_motoGame, int i_nbCents) = 0;
@@ -130,6 +133,7 @@ public:
   virtual ~SDynamicEntityRotation();
 
   void performXY(float *vx, float *vy, float *vAngle);
+  SDynamicObject *clone() const;
 
 private:
 };
@@ -147,6 +151,7 @@ public:
   virtual ~SDynamicEntityTranslation();
 
   void performXY(float *vx, float *vy, float *vAngle);
+  SDynamicObject *clone() const;
 
 private:
 };
@@ -162,6 +167,7 @@ public:
   virtual ~SDynamicEntitySelfRotation();
 
   void performXY(float *vx, float *vy, float *vAngle);
+  SDynamicObject *clone() const;
 
 private:
 };
@@ -198,6 +204,7 @@ public:
   virtual ~SDynamicBlockRotation();
 
   void performXY(float *vx, float *vy, float *vAngle);
+  SDynamicObject *clone() const;
 
 private:
 };
@@ -213,6 +220,7 @@ public:
   virtual ~SDynamicBlockSelfRotation();
 
   void performXY(float *vx, float *vy, float *vAngle);
+  SDynamicObject *clone() const;
 
 private:
 };
@@ -230,6 +238,7 @@ public:
   virtual ~SDynamicBlockTranslation();
 
   void performXY(float *vx, float *vy, float *vAngle);
+  SDynamicObject *clone() const;
 
 private:
 };
@@ -263,6 +272,7 @@ public:
   virtual ~SPhysicBlockSelfRotation() {}
 
   void applyForce();
+  SDynamicObject *clone() const;
 
 protected:
   float m_torque;
@@ -279,6 +289,7 @@ public:
   virtual ~SPhysicBlockTranslation() {}
 
   void applyForce();
+  SDynamicObject *clone() const;
 
 protected:
   float m_Speed;
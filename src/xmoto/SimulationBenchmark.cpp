@@ -0,0 +1,224 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "SimulationBenchmark.h"
+#include "Game.h"
+#include "Replay.h"
+#include "Universe.h"
+#include "common/BuildConfig.h"
+#include "common/Theme.h"
+#include "common/VFileIO.h"
+#include "helpers/Log.h"
+#include "helpers/Random.h"
+#include "helpers/VExcept.h"
+#include "xmscene/Bike.h"
+#include "xmscene/BikeController.h"
+#include "xmscene/BikeGhost.h"
+#include "xmscene/BikePlayer.h"
+#include "xmscene/Level.h"
+#include "xmscene/Scene.h"
+#include "xmscene/SceneProfiler.h"
+#include <chrono>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIMULATION_BENCHMARK_SEED 42
+#define SIMULATION_BENCHMARK_DEFAULT_TIME 6000
+
+SimulationBenchmark::SimulationBenchmark() {
+  m_maxTime = SIMULATION_BENCHMARK_DEFAULT_TIME;
+  m_stepSize = PHYS_STEP_SIZE;
+}
+
+SimulationBenchmark::~SimulationBenchmark() {}
+
+void SimulationBenchmark::setLevel(const std::string &i_id_level) {
+  m_id_level = i_id_level;
+}
+
+void SimulationBenchmark::setReplay(const std::string &i_replay) {
+  ReplayInfo *v_info = Replay::getReplayInfos(i_replay);
+
+  if (v_info == NULL) {
+    throw Exception("Unable to retrieve infos about replay " + i_replay);
+  }
+
+  m_replay = i_replay;
+  m_id_level = v_info->Level;
+  delete v_info;
+}
+
+void SimulationBenchmark::setMaxTime(int i_time) {
+  m_maxTime = i_time;
+}
+
+void SimulationBenchmark::setStepSize(int i_step) {
+  m_stepSize = i_step;
+}
+
+/* one input per line: TIME THROTTLE BRAKE PULL [CHANGEDIR]
+   time in cent of seconds, lines starting with # are ignored */
+void SimulationBenchmark::loadInputs(const std::string &i_file) {
+  FileHandle *pfh = XMFS::openIFile(FDT_DATA, i_file, true);
+  std::string v_line;
+  int v_nline = 0;
+
+  if (pfh == NULL) {
+    throw Exception("Unable to open inputs file " + i_file);
+  }
+
+  m_inputs.clear();
+  while (XMFS::readNextLine(pfh, v_line)) {
+    v_nline++;
+    if (v_line.empty() || v_line[0] == '#') {
+      continue;
+    }
+
+    std::istringstream v_stream(v_line);
+    SimulationInput v_input;
+    int v_changeDir = 0;
+
+    if (!(v_stream >> v_input.time >> v_input.throttle >> v_input.brake >>
+          v_input.pull)) {
+      XMFS::closeFile(pfh);
+      std::ostringstream v_err;
+      v_err << "Invalid input at line " << v_nline << " of " << i_file;
+      throw Exception(v_err.str());
+    }
+    v_stream >> v_changeDir;
+    v_input.changeDir = v_changeDir != 0;
+
+    if (m_inputs.size() > 0 && v_input.time < m_inputs.back().time) {
+      XMFS::closeFile(pfh);
+      throw Exception("Inputs of " + i_file + " are not sorted by time");
+    }
+    m_inputs.push_back(v_input);
+  }
+
+  XMFS::closeFile(pfh);
+  LogInfo("%i inputs loaded from %s", (int)m_inputs.size(), i_file.c_str());
+}
+
+void SimulationBenchmark::run(xmDatabase *i_db) {
+  Universe *v_universe = new Universe();
+  SceneProfiler v_profiler;
+  Scene *v_scene;
+  Biker *v_biker;
+  unsigned int v_nextInput = 0;
+  int v_startTime;
+
+  /* same random numbers for each run */
+  srand(SIMULATION_BENCHMARK_SEED);
+  NotSoRandom::init();
+
+  try {
+    v_universe->initPlayServer();
+    v_scene = v_universe->getScenes()[0];
+
+    v_scene->loadLevel(i_db, m_id_level, true);
+    if (v_scene->getLevelSrc()->isXMotoTooOld()) {
+      throw Exception("Level " + m_id_level + " is too old");
+    }
+
+    if (m_replay != "") {
+      v_scene->prePlayLevel(NULL, false, true, false);
+      v_biker = v_scene->addReplayFromFile(m_replay,
+                                           Theme::instance(),
+                                           Theme::instance()->getPlayerTheme(),
+                                           false);
+    } else {
+      v_scene->prePlayLevel(NULL, true, true, false);
+      v_biker = v_scene->addPlayerLocalBiker(
+        0,
+        v_scene->getLevelSrc()->PlayerStart(),
+        DD_RIGHT,
+        Theme::instance(),
+        Theme::instance()->getPlayerTheme(),
+        GameApp::getColorFromPlayerNumber(0),
+        GameApp::getUglyColorFromPlayerNumber(0),
+        false);
+    }
+    v_scene->playInitLevel();
+  } catch (Exception &e) {
+    delete v_universe;
+    throw Exception("Unable to load level " + m_id_level + ": " + e.getMsg());
+  }
+
+  v_scene->setProfiler(&v_profiler);
+  v_startTime = v_scene->getTime();
+
+  auto v_begin = std::chrono::steady_clock::now();
+
+  while (v_scene->getTime() - v_startTime < m_maxTime &&
+         v_biker->isDead() == false && v_biker->isFinished() == false) {
+    while (v_nextInput < m_inputs.size() &&
+           m_inputs[v_nextInput].time <= v_scene->getTime() - v_startTime) {
+      BikeController *v_controller = v_biker->getControler();
+      if (v_controller != NULL) {
+        v_controller->setThrottle(m_inputs[v_nextInput].throttle);
+        v_controller->setBreak(m_inputs[v_nextInput].brake);
+        v_controller->setPull(m_inputs[v_nextInput].pull);
+        v_controller->setChangeDir(m_inputs[v_nextInput].changeDir);
+      }
+      v_nextInput++;
+    }
+
+    v_scene->updateLevel(m_stepSize,
+                         NULL,
+                         NULL,
+                         false,
+                         false /* no particles */,
+                         false /* don't update died players */);
+  }
+
+  double v_wallTime = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - v_begin)
+                        .count();
+
+  v_scene->setProfiler(NULL);
+
+  printf(" * level: %s\n", m_id_level.c_str());
+  if (m_replay != "") {
+    printf(" * replay: %s\n", m_replay.c_str());
+  }
+  printf(" * %u steps of %i simulated (%.2f seconds of game time, %s)\n",
+         v_profiler.nbSteps(),
+         m_stepSize,
+         (v_scene->getTime() - v_startTime) / 100.0,
+         v_biker->isFinished() ? "finished"
+                               : (v_biker->isDead() ? "dead" : "time limit"));
+  printf(" * %.3f seconds of wall time, %.1f steps/s\n",
+         v_wallTime,
+         v_wallTime > 0.0 ? v_profiler.nbSteps() / v_wallTime : 0.0);
+
+  for (unsigned int i = 0; i < SPS_NB; i++) {
+    SceneProfilerSection v_section = (SceneProfilerSection)i;
+    printf("   %-16s %8.3f ms %6.2f %%\n",
+           SceneProfiler::sectionName(v_section),
+           v_profiler.sectionTime(v_section) * 1000.0,
+           v_profiler.totalTime() > 0.0
+             ? 100.0 * v_profiler.sectionTime(v_section) /
+                 v_profiler.totalTime()
+             : 0.0);
+  }
+
+  delete v_universe;
+}
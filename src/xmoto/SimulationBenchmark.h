@@ -0,0 +1,68 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __SIMULATIONBENCHMARK_H__
+#define __SIMULATIONBENCHMARK_H__
+
+#include <string>
+#include <vector>
+
+class xmDatabase;
+
+/*===========================================================================
+  Runs the simulation of a level without graphics, as fast as possible, and
+  reports how much time each part of the scene update took. The biker is
+  either driven by a scripted input track or replaced by a replay.
+  The allocations are not counted here ; run the benchmark under an
+  allocation profiler for that, for example:
+    heaptrack xmoto --benchSimulation ID
+    valgrind --tool=massif xmoto --benchSimulation ID
+  ===========================================================================*/
+class SimulationBenchmark {
+public:
+  SimulationBenchmark();
+  ~SimulationBenchmark();
+
+  void setLevel(const std::string &i_id_level);
+  void setReplay(const std::string &i_replay); /* the level is the replay's */
+  void loadInputs(const std::string &i_file);
+  void setMaxTime(int i_time); /* in cent of seconds of game time */
+  void setStepSize(int i_step); /* in cent of seconds, PHYS_STEP_SIZE */
+
+  void run(xmDatabase *i_db);
+
+private:
+  /* controls applied from m_time until the next input */
+  struct SimulationInput {
+    int time;
+    float throttle;
+    float brake;
+    float pull;
+    bool changeDir;
+  };
+
+  std::string m_id_level;
+  std::string m_replay;
+  std::vector<SimulationInput> m_inputs;
+  int m_maxTime;
+  int m_stepSize;
+};
+
+#endif
@@ -31,6 +31,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "helpers/Log.h"
 #include "helpers/RenderSurface.h"
 #include "states/GameState.h"
+#include "states/StateManager.h"
+#include "thread/SaveReplaysThread.h"
 #include "xmscene/Camera.h"
 #include "xmscene/Level.h"
 
@@ -68,6 +70,7 @@ XMSceneHooks::~XMSceneHooks() {}
 
 Universe::Universe() {
   m_pJustPlayReplay = NULL;
+  m_isTemporaryReplaySaved = false;
   m_waitingForGhosts = false;
 }
 
@@ -256,6 +259,7 @@ void Universe::deleteCurrentReplay() {
     delete m_pJustPlayReplay;
     m_pJustPlayReplay = NULL;
   }
+  m_isTemporaryReplaySaved = false;
 }
 
 void Universe::TeleportationCheatTo(int i_player, Vector2f i_position) {
@@ -375,7 +379,12 @@ void Universe::isTheCurrentPlayAHighscore(xmDatabase *pDb,
 }
 
 bool Universe::isAReplayToSave() const {
-  return m_pJustPlayReplay != NULL;
+  if (m_pJustPlayReplay != NULL) {
+    return true;
+  }
+
+  // given to the saver thread, it can still be copied under a name
+  return m_isTemporaryReplaySaved;
 }
 
 bool Universe::isAnErrorOnSaving() const {
@@ -393,6 +402,10 @@ void Universe::finalizeReplay(bool i_finished) {
     return;
   }
 
+  if (m_pJustPlayReplay == NULL) { // already given to the saver thread
+    return;
+  }
+
   /* save the last state because scene don't record each frame */
   SerializedBikeState BikeState;
   Scene::getSerializedBikeState(m_scenes[0]->Players()[0]->getState(),
@@ -418,6 +431,7 @@ void Universe::initReplay() {
   if (m_pJustPlayReplay != NULL)
     delete m_pJustPlayReplay;
   m_pJustPlayReplay = NULL;
+  m_isTemporaryReplaySaved = false;
 
   if (m_scenes.size() != 1) {
     return;
@@ -438,35 +452,44 @@ std::string Universe::getTemporaryReplayName() const {
   return "Replays/Latest.rpl";
 }
 
-void Universe::saveReplayTemporary(xmDatabase *pDb) {
+void Universe::queueReplayTemporary() {
+  if (m_isTemporaryReplaySaved || m_pJustPlayReplay == NULL) {
+    return;
+  }
+
   /*
     use old format if level is not physics to allow people having an old version
     to read replays
     in the future (today is 28/06/2009), once everybody can read 3 version, use
     always 3 version
+    the 4 version is smaller, but only on demand while it's new ; the
+    temporary replay is the one uploaded, so only the replays saved under a
+    name use it
   */
-  m_pJustPlayReplay->saveReplayIfNot(
-    m_scenes[0]->getLevelSrc()->isPhysics() ? 3 : 1);
+  int v_format = m_scenes[0]->getLevelSrc()->isPhysics() ? 3 : 1;
+  int v_copiesFormat = XMSession::instance()->compactReplays() ? 4 : 0;
+
+  // the saver thread deletes the replay once written
+  StateManager::instance()->getReplaySaverThread()->saveReplay(
+    m_pJustPlayReplay, v_format, v_copiesFormat);
+  m_pJustPlayReplay = NULL;
+  m_isTemporaryReplaySaved = true;
 }
 
-void Universe::saveReplay(xmDatabase *pDb, const std::string &Name) {
-  /* This is simply a job of copying the Replays/Latest.rpl file into
-     Replays/Name.rpl */
+void Universe::saveReplayTemporary(xmDatabase *pDb) {
+  queueReplayTemporary();
 
-  saveReplayTemporary(pDb);
+  // the file is read just after
+  StateManager::instance()->getReplaySaverThread()->waitForSaves();
+}
 
-  /* Try saving */
-  std::string v_outputfile;
+void Universe::saveReplay(xmDatabase *pDb, const std::string &Name) {
+  /* This is simply a job of copying the Replays/Latest.rpl file into
+     Replays/Name.rpl, once it is written */
+  queueReplayTemporary();
 
-  if (!XMFS::copyFile(FDT_DATA,
-                      getTemporaryReplayName(),
-                      std::string("Replays/") + Name + std::string(".rpl"),
-                      v_outputfile)) {
-    throw Exception("Failed to save replay " + Name);
-  } else {
-    /* Update replay list to reflect changes */
-    GameApp::instance()->addReplay(v_outputfile, pDb);
-  }
+  StateManager::instance()->getReplaySaverThread()->copyReplay(
+    getTemporaryReplayName(), Name);
 }
 
 std::vector<Scene *> &Universe::getScenes() {
@@ -52,6 +52,7 @@ public:
   void deleteCurrentReplay();
   void initReplay();
   void finalizeReplay(bool i_finished); /* call to close the replay */
+  // saved in an other thread, REPLAY_SAVED is sent once done
   void saveReplay(xmDatabase *pDb, const std::string &Name);
   void saveReplayTemporary(xmDatabase *pDb); // save in the Latest.rpl file
   std::string getTemporaryReplayName() const;
@@ -76,6 +77,9 @@ private:
   std::vector<Scene *> m_scenes; /* Game objects */
   std::vector<XMSceneHooks *> m_motoGameHooks;
   Replay *m_pJustPlayReplay;
+  bool m_isTemporaryReplaySaved; // m_pJustPlayReplay given to the saver
+
+  void queueReplayTemporary();
 
   void removeAllWorlds();
   void switchFollowCameraScene(Scene *i_scene);
@@ -489,8 +489,13 @@ void Biker::setDead(bool i_value, int i_deadTime) {
     if (v_deathVolume > 1.0) {
       v_deathVolume = 1.0;
     }
-    Sound::playSampleByName(
-      Theme::instance()->getSound("Headcrash")->FilePath(), v_deathVolume);
+    Scene::lockSharedResources();
+    try {
+      Sound::playSampleByName(
+        Theme::instance()->getSound("Headcrash")->FilePath(), v_deathVolume);
+    } catch (Exception &e) {
+    }
+    Scene::unlockSharedResources();
   } catch (Exception &e) {
   }
 }
@@ -199,6 +199,8 @@ public:
   virtual void initToPosition(Vector2f i_position,
                               DriveDir i_direction,
                               Vector2f i_gravity);
+  /* the scene has been restored to the state it had at i_time */
+  virtual void onSnapshotRestored(int i_time, Scene *i_motogame) {}
   virtual void
   resetAutoDisabler(); /* a player can have a disabler when nothing append */
 
@@ -84,6 +84,7 @@ FileGhost::FileGhost(std::string i_replayFile,
   std::string v_levelId;
   std::string v_playerName;
 
+  m_replayFile = i_replayFile;
   m_replay = new Replay();
   v_levelId = m_replay->openReplay(i_replayFile, v_playerName);
 
@@ -278,6 +279,30 @@ void FileGhost::initToPosition(Vector2f i_position,
   m_linearVelocity = 0.0;
 }
 
+void FileGhost::onSnapshotRestored(int i_time, Scene *i_motogame) {
+  std::vector<RecordedGameEvent *> *v_replayEvents;
+  v_replayEvents = m_replay->getEvents();
+
+  /* the events from i_time are not part of the restored state, replay them
+     again */
+  for (int i = v_replayEvents->size() - 1; i >= 0; i--) {
+    if ((*v_replayEvents)[i]->bPassed &&
+        (*v_replayEvents)[i]->Event->getEventTime() >= i_time) {
+      (*v_replayEvents)[i]->Event->revert(i_motogame);
+      (*v_replayEvents)[i]->bPassed = false;
+    }
+  }
+
+  // read the moving blocks again from i_time
+  std::vector<rmtime> *v_mb = m_replay->getMovingBlocks();
+  for (unsigned int i = 0; i < v_mb->size(); i++) {
+    while ((*v_mb)[i].readPos > 0 &&
+           (*v_mb)[i].states[(*v_mb)[i].readPos - 1].time >= i_time) {
+      (*v_mb)[i].readPos--;
+    }
+  }
+}
+
 void FileGhost::updateToTime(int i_time,
                              int i_timeStep,
                              CollisionSystem *i_collisionSystem,
@@ -80,13 +80,16 @@ public:
   float getTorsoVelocity();
   double getAngle();
   Replay *getReplay() { return m_replay; };
+  const std::string &getReplayFile() const { return m_replayFile; };
 
   virtual void initToPosition(Vector2f i_position,
                               DriveDir i_direction,
                               Vector2f i_gravity);
+  virtual void onSnapshotRestored(int i_time, Scene *i_motogame);
 
 protected:
   Replay *m_replay;
+  std::string m_replayFile;
 
 private:
   std::vector<float> m_lastToTakeEntities;
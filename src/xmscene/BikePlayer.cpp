@@ -162,6 +162,7 @@ double PlayerLocalBiker::getAngle() {
 
 void PlayerLocalBiker::initPhysics(Vector2f i_gravity) {
   m_bFirstPhysicsUpdate = true;
+  m_lastPhysicsStep = PHYS_STEP_SIZE;
 
   /* Setup ODE */
   m_WorldID = dWorldCreate();
@@ -194,7 +195,7 @@ float PlayerLocalBiker::getTorsoVelocity() { // basically stolen from
   Vector2f delta = curpos - lastpos;
   float speed =
     (3.6 * 100 * sqrt(delta.x * delta.x + delta.y * delta.y)) /
-    PHYS_STEP_SIZE; /* *100 because PHYS_STEP_SIZE is in hundreaths */
+    m_lastPhysicsStep; /* *100 because the step is in hundreaths */
 
   /* protection against invalid values */
   if (speed > 500)
@@ -207,6 +208,8 @@ void PlayerLocalBiker::updatePhysics(int i_time,
                                      int i_timeStep,
                                      CollisionSystem *v_collisionSystem,
                                      Vector2f i_gravity) {
+  m_lastPhysicsStep = i_timeStep;
+
   /* No wheel spin per default */
   m_bWheelSpin = false;
 
@@ -477,13 +480,10 @@ void PlayerLocalBiker::updatePhysics(int i_time,
   int nNumContacts;
   dContact Contacts[100];
 
-  static int nSlipFrameInterlace =
-    0; /* Okay, lazy approach again. Front wheel can generate particles
-          even frames, rear wheel odd frames */
-  nSlipFrameInterlace++;
-
   nNumContacts = intersectWheelLevel(m_bikeState->FrontWheelP,
                                      m_bikeState->Parameters()->WheelRadius(),
+                                     m_PrevFrontWheelP,
+                                     m_FrontWheelBodyID,
                                      Contacts,
                                      v_collisionSystem);
   if (nNumContacts > 0) {
@@ -562,6 +562,8 @@ void PlayerLocalBiker::updatePhysics(int i_time,
 
   nNumContacts = intersectWheelLevel(m_bikeState->RearWheelP,
                                      m_bikeState->Parameters()->WheelRadius(),
+                                     m_PrevRearWheelP,
+                                     m_RearWheelBodyID,
                                      Contacts,
                                      v_collisionSystem);
   if (nNumContacts > 0) {
@@ -881,6 +883,16 @@ bool PlayerLocalBiker::intersectHeadLevel(Vector2f Cp,
     if (nNumContacts > 0) {
       return true;
     }
+
+    // with large physics steps, the head can cross a thin block between two
+    // steps
+    if (m_lastPhysicsStep > PHYS_STEP_SIZE) {
+      float cx, cy;
+      if (v_collisionSystem->collideCirclePath(
+            LastCp.x, LastCp.y, Cp.x, Cp.y, Cr, &cx, &cy, 1) > 0) {
+        return true;
+      }
+    }
   }
 
   return false;
@@ -900,17 +912,33 @@ int PlayerLocalBiker::intersectBodyLevel(Vector2f Cp,
   return nNumContacts;
 }
 
-int PlayerLocalBiker::intersectWheelLevel(Vector2f Cp,
+int PlayerLocalBiker::intersectWheelLevel(Vector2f &Cp,
                                           float Cr,
+                                          const Vector2f &LastCp,
+                                          dBodyID i_wheelBodyID,
                                           dContact *pContacts,
                                           CollisionSystem *v_collisionSystem) {
   int nNumContacts = v_collisionSystem->collideCircle(
     Cp.x, Cp.y, Cr, pContacts, 100, m_physicsSettings);
   if (nNumContacts == 0) {
     /* Nothing... but what if we are moving so fast that the circle has moved
-       all the way through some geometry? Check it's path. */
-    // nNumContacts = m_Collision.collideLine(
-  } else {
+       all the way through some geometry? Check it's path. It can only happen
+       with steps larger than the default one ; keep the default physics
+       unchanged. */
+    if (m_lastPhysicsStep > PHYS_STEP_SIZE && m_bFirstPhysicsUpdate == false) {
+      float cx, cy;
+      if (v_collisionSystem->collideCirclePath(
+            LastCp.x, LastCp.y, Cp.x, Cp.y, Cr, &cx, &cy, 1) > 0) {
+        /* put the wheel back where it hit the geometry */
+        dBodySetPosition(i_wheelBodyID, cx, cy, 0.0);
+        Cp = Vector2f(cx, cy);
+        nNumContacts = v_collisionSystem->collideCircle(
+          Cp.x, Cp.y, Cr, pContacts, 100, m_physicsSettings);
+      }
+    }
+  }
+
+  if (nNumContacts > 0) {
     // detach the wheel if the player is dead and the velocity is too much
     if (isDead() &&
         getBikeLinearVel() > m_physicsSettings->DeadWheelDetachSpeed()) {
@@ -984,7 +1012,7 @@ float PlayerLocalBiker::getBikeLinearVel() {
   Vector2f delta = curpos - lastpos;
   float speed =
     (3.6 * 100 * sqrt(delta.x * delta.x + delta.y * delta.y)) /
-    PHYS_STEP_SIZE; /* *100 because PHYS_STEP_SIZE is in hundreaths */
+    m_lastPhysicsStep; /* *100 because the step is in hundreaths */
 
   /* protection against invalid values */
   if (speed > 500)
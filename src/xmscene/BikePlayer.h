@@ -98,6 +98,10 @@ private:
 
   SomersaultCounter m_somersaultCounter;
   bool m_bFirstPhysicsUpdate;
+  /* duration of the last physics step ; when larger than PHYS_STEP_SIZE, the
+     wheels and the head are swept along their path to not go through thin
+     blocks */
+  int m_lastPhysicsStep;
 
   float m_fAttitudeCon;
   float m_fNextAttitudeCon;
@@ -187,8 +191,10 @@ private:
                           float Cr,
                           const Vector2f &LastCp,
                           CollisionSystem *v_collisionSystem);
-  int intersectWheelLevel(Vector2f Cp,
+  int intersectWheelLevel(Vector2f &Cp,
                           float Cr,
+                          const Vector2f &LastCp,
+                          dBodyID i_wheelBodyID,
                           dContact *pContacts,
                           CollisionSystem *v_collisionSystem);
   int intersectBodyLevel(Vector2f Cp,
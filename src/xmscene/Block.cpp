@@ -115,6 +115,8 @@ Block::Block(std::string i_id) {
   // colors if no edge material is
   // added
   m_sprite = NULL;
+  m_BSPPolysComputed = false;
+  m_BSPErrors = 0;
 
   m_previousSavedPosition = DynamicPosition();
   m_previousSavedRotation = DynamicRotation();
@@ -331,10 +333,6 @@ int Block::loadToPlay(CollisionSystem *io_collisionSystem,
   float tx = 0;
   float ty = 0;
 
-  /* Do the "convexifying" the BSP-way. It might be overkill, but we'll
-     probably appreciate it when the input data is very complex. It'll also
-     let us handle crossing edges, and other kinds of weird input. */
-  BSP v_BSPTree;
   cpBody *myBody = NULL;
   cpVect *myVerts = NULL;
 
@@ -397,11 +395,6 @@ int Block::loadToPlay(CollisionSystem *io_collisionSystem,
       // collect vertice count to find middle
       tx += Vertices()[i]->Position().x;
       ty += Vertices()[i]->Position().y;
-    } else {
-      if (i_loadBSP) {
-        v_BSPTree.addLineDefinition(Vertices()[i]->Position(),
-                                    Vertices()[inext]->Position());
-      }
     }
   }
 
@@ -417,19 +410,6 @@ int Block::loadToPlay(CollisionSystem *io_collisionSystem,
                                           Vertices()[i]->Position().y - mdy));
     }
 
-    // then BSP-ify them
-    if (i_loadBSP) {
-      for (unsigned int i = 0; i < Vertices().size(); i++) {
-        unsigned int inext = i + 1;
-        if (inext == Vertices().size())
-          inext = 0;
-
-        /* Add line to BSP generator */
-        v_BSPTree.addLineDefinition(Vertices()[i]->Position(),
-                                    Vertices()[inext]->Position());
-      }
-    }
-
     // modify the object coords with the midpoint
     m_dynamicPosition.x += mdx;
     m_dynamicPosition.y += mdy;
@@ -456,11 +436,10 @@ int Block::loadToPlay(CollisionSystem *io_collisionSystem,
   //  layer.");
   //}
 
-  /* Compute */
-  std::vector<BSPPoly *> *v_BSPPolys;
-
-  if (i_loadBSP) {
-    v_BSPPolys = v_BSPTree.compute();
+  /* Compute, if it was not read from the level cache ; vertices of physics
+     blocks are already centered here */
+  if (i_loadBSP && m_BSPPolysComputed == false) {
+    computeBSPPolys(Vector2f(0.0, 0.0));
   }
 
   float scale;
@@ -495,8 +474,8 @@ int Block::loadToPlay(CollisionSystem *io_collisionSystem,
 
   /* Create convex blocks */
   if (i_loadBSP) {
-    for (unsigned int i = 0; i < v_BSPPolys->size(); i++) {
-      addPoly((*v_BSPPolys)[i], io_collisionSystem, scale);
+    for (unsigned int i = 0; i < m_BSPPolys.size(); i++) {
+      addPoly(m_BSPPolys[i], io_collisionSystem, scale);
     }
   }
 
@@ -545,24 +524,21 @@ int Block::loadToPlay(CollisionSystem *io_collisionSystem,
 
         // go through calculated BSP polys, adding one or more shape to the
         if (i_loadBSP) {
-          m_shapes.reserve(v_BSPPolys->size());
-          for (unsigned int i = 0; i < v_BSPPolys->size(); i++) {
-            unsigned int size =
-              2 * sizeof(cpVect) * (*v_BSPPolys)[i]->Vertices().size();
+          m_shapes.reserve(m_BSPPolys.size());
+          for (unsigned int i = 0; i < m_BSPPolys.size(); i++) {
+            unsigned int size = 2 * sizeof(cpVect) * m_BSPPolys[i].size();
             myVerts = (cpVect *)malloc(size);
 
             // translate for chipmunk
-            for (unsigned int j = 0; j < (*v_BSPPolys)[i]->Vertices().size();
-                 j++) {
-              cpVect ma =
-                cpv((*v_BSPPolys)[i]->Vertices()[j].x * CHIP_SCALE_RATIO,
-                    (*v_BSPPolys)[i]->Vertices()[j].y * CHIP_SCALE_RATIO);
+            for (unsigned int j = 0; j < m_BSPPolys[i].size(); j++) {
+              cpVect ma = cpv(m_BSPPolys[i][j].x * CHIP_SCALE_RATIO,
+                              m_BSPPolys[i][j].y * CHIP_SCALE_RATIO);
               myVerts[j] = ma;
             }
 
             // collision shape
             m_shape = cpPolyShapeNew(
-              myBody, (*v_BSPPolys)[i]->Vertices().size(), myVerts, cpvzero);
+              myBody, m_BSPPolys[i].size(), myVerts, cpvzero);
             m_shape->u = m_friction;
             m_shape->e = m_elasticity;
             if (isBackground()) {
@@ -583,24 +559,72 @@ int Block::loadToPlay(CollisionSystem *io_collisionSystem,
   updateCollisionLines(true);
 
   if (i_loadBSP) {
-    if (v_BSPTree.getNumErrors() > 0) {
+    if (m_BSPErrors > 0) {
       LogError("Error due to the block %s", Id().c_str());
     }
-    return v_BSPTree.getNumErrors();
+    return m_BSPErrors;
   } else {
     return 0;
   }
 }
 
-void Block::addPoly(BSPPoly *i_poly,
+void Block::computeBSPPolys(const Vector2f &i_center) {
+  /* Do the "convexifying" the BSP-way. It might be overkill, but we'll
+     probably appreciate it when the input data is very complex. It'll also
+     let us handle crossing edges, and other kinds of weird input. */
+  BSP v_BSPTree;
+  std::vector<BSPPoly *> *v_BSPPolys;
+
+  for (unsigned int i = 0; i < Vertices().size(); i++) {
+    unsigned int inext = i + 1;
+    if (inext == Vertices().size())
+      inext = 0;
+
+    /* Add line to BSP generator */
+    v_BSPTree.addLineDefinition(
+      Vector2f(Vertices()[i]->Position().x - i_center.x,
+               Vertices()[i]->Position().y - i_center.y),
+      Vector2f(Vertices()[inext]->Position().x - i_center.x,
+               Vertices()[inext]->Position().y - i_center.y));
+  }
+
+  v_BSPPolys = v_BSPTree.compute();
+
+  m_BSPPolys.clear();
+  m_BSPPolys.reserve(v_BSPPolys->size());
+  for (unsigned int i = 0; i < v_BSPPolys->size(); i++) {
+    m_BSPPolys.push_back((*v_BSPPolys)[i]->Vertices());
+  }
+  m_BSPErrors = v_BSPTree.getNumErrors();
+  m_BSPPolysComputed = true;
+}
+
+/* the center of gravity used for the physics blocks, see loadToPlay() */
+Vector2f Block::verticesCenter() {
+  float tx = 0;
+  float ty = 0;
+
+  if (Vertices().size() == 0) {
+    return Vector2f(0.0, 0.0);
+  }
+
+  for (unsigned int i = 0; i < Vertices().size(); i++) {
+    tx += Vertices()[i]->Position().x;
+    ty += Vertices()[i]->Position().y;
+  }
+
+  return Vector2f(tx / Vertices().size(), ty / Vertices().size());
+}
+
+void Block::addPoly(const std::vector<Vector2f> &i_poly,
                     CollisionSystem *io_collisionSystem,
                     float scale) {
   ConvexBlock *v_block = new ConvexBlock(this);
-  for (unsigned int i = 0; i < i_poly->Vertices().size(); i++) {
+  for (unsigned int i = 0; i < i_poly.size(); i++) {
     v_block->addVertex(
-      i_poly->Vertices()[i],
-      Vector2f((InitialPosition().x + i_poly->Vertices()[i].x) * scale,
-               (InitialPosition().y + i_poly->Vertices()[i].y) * scale));
+      i_poly[i],
+      Vector2f((InitialPosition().x + i_poly[i].x) * scale,
+               (InitialPosition().y + i_poly[i].y) * scale));
   }
   m_convexBlocks.push_back(v_block);
 }
@@ -1000,6 +1024,20 @@ void Block::saveBinary(FileHandle *i_pfh) {
     XMFS::writeFloat_LE(i_pfh, Vertices()[j]->Position().y);
     XMFS::writeString(i_pfh, Vertices()[j]->EdgeEffect());
   }
+
+  /* convex decomposition, so that it is not computed at each level start */
+  if (m_BSPPolysComputed == false) {
+    computeBSPPolys(isPhysics() ? verticesCenter() : Vector2f(0.0, 0.0));
+  }
+  XMFS::writeInt_LE(i_pfh, m_BSPErrors);
+  XMFS::writeInt_LE(i_pfh, m_BSPPolys.size());
+  for (unsigned int i = 0; i < m_BSPPolys.size(); i++) {
+    XMFS::writeShort_LE(i_pfh, m_BSPPolys[i].size());
+    for (unsigned int j = 0; j < m_BSPPolys[i].size(); j++) {
+      XMFS::writeFloat_LE(i_pfh, m_BSPPolys[i][j].x);
+      XMFS::writeFloat_LE(i_pfh, m_BSPPolys[i][j].y);
+    }
+  }
 }
 
 Block *Block::readFromBinary(FileHandle *i_pfh) {
@@ -1061,6 +1099,21 @@ Block *Block::readFromBinary(FileHandle *i_pfh) {
     pBlock->Vertices().push_back(new BlockVertex(v_Position, v_EdgeEffect));
   }
 
+  pBlock->m_BSPErrors = XMFS::readInt_LE(i_pfh);
+  int nNumPolys = XMFS::readInt_LE(i_pfh);
+  pBlock->m_BSPPolys.resize(nNumPolys);
+  for (int i = 0; i < nNumPolys; i++) {
+    int nNumPolyVertices = XMFS::readShort_LE(i_pfh);
+    pBlock->m_BSPPolys[i].reserve(nNumPolyVertices);
+    for (int j = 0; j < nNumPolyVertices; j++) {
+      Vector2f v_Position;
+      v_Position.x = XMFS::readFloat_LE(i_pfh);
+      v_Position.y = XMFS::readFloat_LE(i_pfh);
+      pBlock->m_BSPPolys[i].push_back(v_Position);
+    }
+  }
+  pBlock->m_BSPPolysComputed = true;
+
   return pBlock;
 }
 
@@ -317,7 +317,14 @@ private:
   Vector2f m_dynamicPosition; /* Block position */
   std::vector<Line *> m_collisionLines; /* Line to collide against */
 
-  void addPoly(BSPPoly *i_poly,
+  /* convex decomposition of the block, saved in the level cache */
+  std::vector<std::vector<Vector2f> > m_BSPPolys;
+  bool m_BSPPolysComputed;
+  int m_BSPErrors;
+  void computeBSPPolys(const Vector2f &i_center);
+  Vector2f verticesCenter();
+
+  void addPoly(const std::vector<Vector2f> &i_poly,
                CollisionSystem *io_collisionSystem,
                float scale);
   // dynamic background blocks only need to compute the collision lines once.
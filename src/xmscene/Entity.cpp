@@ -694,7 +694,7 @@ unsigned int Joint::m_currentCollisionGroup = 2;
                                 Particle Effects
 ===========================================*/
 
-int ParticlesSource::m_totalOfParticles = 0;
+SDL_atomic_t ParticlesSource::m_totalOfParticles = { 0 };
 bool ParticlesSource::m_allowParticleGeneration = true;
 
 void ParticlesSource::setAllowParticleGeneration(bool i_value) {
@@ -729,25 +729,14 @@ bool ParticlesSource::updateToTime(int i_time,
                                    Vector2f &i_gravity,
                                    PhysicsSettings *i_physicsSettings,
                                    bool i_allowParticules) {
-  unsigned int i;
-
   if (i_allowParticules == false) {
     return false;
   }
 
   if (i_time > m_lastParticleTime + m_particleTime_increment) {
-    i = 0;
-    while (i < m_particles.size()) {
-      if (i_time > m_particles[i]->KillTime()) {
-        addDeadParticle(m_particles[i]);
-        m_particles.erase(m_particles.begin() + i);
-        m_totalOfParticles--;
-      } else {
-        m_particles[i]->updateToTime(
-          i_time, i_gravity, i_physicsSettings, i_allowParticules);
-        i++;
-      }
-    }
+    SDL_AtomicAdd(&m_totalOfParticles, -(int)m_particles.removeDead(i_time));
+    m_particles.move(0.025);
+    updateParticles(i_time, i_gravity, i_physicsSettings);
     m_lastParticleTime = i_time;
     return true;
   } else {
@@ -759,37 +748,19 @@ bool ParticlesSource::updateToTime(int i_time,
   return false;
 }
 
+void ParticlesSource::updateParticles(int i_time,
+                                      Vector2f &i_gravity,
+                                      PhysicsSettings *i_physicsSettings) {}
+
 bool ParticlesSource::hasReachedMaxParticles() {
-  return m_totalOfParticles >= PARTICLESSOURCE_TOTAL_MAX_PARTICLES ||
+  return SDL_AtomicGet(&m_totalOfParticles) >=
+           PARTICLESSOURCE_TOTAL_MAX_PARTICLES ||
          m_allowParticleGeneration == false;
 }
 
 void ParticlesSource::deleteParticles() {
-  for (unsigned int i = 0; i < m_particles.size(); i++) {
-    delete m_particles[i];
-  }
-  m_totalOfParticles -= m_particles.size();
+  SDL_AtomicAdd(&m_totalOfParticles, -(int)m_particles.size());
   m_particles.clear();
-
-  for (unsigned int i = 0; i < m_deadParticles.size(); i++) {
-    delete m_deadParticles[i];
-  }
-  m_deadParticles.clear();
-}
-
-EntityParticle *ParticlesSource::getExistingParticle() {
-  if (m_deadParticles.size() > 0) {
-    EntityParticle *pEntityParticle = m_deadParticles.back();
-    m_deadParticles.pop_back();
-
-    return pEntityParticle;
-  } else {
-    return NULL;
-  }
-}
-
-void ParticlesSource::addDeadParticle(EntityParticle *pEntityParticle) {
-  m_deadParticles.push_back(pEntityParticle);
 }
 
 /*===========================================
@@ -843,25 +814,18 @@ void ParticlesSourceSmoke::addParticle(int i_curTime) {
   Vector2f v_velocity(NotSoRandom::randomNum(-0.6, 0.6),
                       NotSoRandom::randomNum(0.2, 0.6));
   int v_killTime = i_curTime + 1000;
-  std::string v_spriteName = "Smoke1";
   unsigned int v_spriteIndex = 0;
   if (NotSoRandom::randomNum(0, 1) < 0.5) {
-    v_spriteName = "Smoke2";
     v_spriteIndex = 1;
   }
 
-  EntityParticle *pEntityParticle = getExistingParticle();
-  if (pEntityParticle == NULL) {
-    pEntityParticle = new SmokeParticle(
-      DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  } else {
-    ((SmokeParticle *)pEntityParticle)
-      ->init(DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  }
-
-  pEntityParticle->setSpriteIndex(v_spriteIndex);
-  m_particles.push_back(pEntityParticle);
-  m_totalOfParticles++;
+  unsigned int i = m_particles.add(DynamicPosition(), v_velocity, v_killTime);
+  int cc = (int)NotSoRandom::randomNum(0, 50);
+  m_particles.setColor(i, TColor(cc, cc, cc, 255));
+  m_particles.Size[i] = NotSoRandom::randomNum(0, 0.2);
+  m_particles.AngVel[i] = NotSoRandom::randomNum(-60, 60);
+  m_particles.SpriteIndex[i] = v_spriteIndex;
+  SDL_AtomicIncRef(&m_totalOfParticles);
 }
 
 bool ParticlesSourceSmoke::updateToTime(int i_time,
@@ -879,6 +843,32 @@ bool ParticlesSourceSmoke::updateToTime(int i_time,
   return false;
 }
 
+void ParticlesSourceSmoke::updateParticles(int i_time,
+                                           Vector2f &i_gravity,
+                                           PhysicsSettings *i_physicsSettings) {
+  float v_timeStep = 0.025;
+  unsigned int n = m_particles.size();
+
+  for (unsigned int i = 0; i < n; i++) {
+    /* grow */
+    m_particles.Size[i] += v_timeStep * 1.0f;
+    /* accelerate upwards */
+    m_particles.AccX[i] = 0.2;
+    m_particles.AccY[i] = 0.5;
+
+    int v_c = (m_particles.Red[i] +
+               (int)(NotSoRandom::randomNum(40, 50) * v_timeStep)) &
+              0xFF;
+
+    int v_a = m_particles.Alpha[i] - (int)(120.0f * v_timeStep);
+    if (v_a >= 0) {
+      m_particles.setColor(i, TColor(v_c, v_c, v_c, v_a));
+    } else {
+      m_particles.KillTime[i] = i_time;
+    }
+  }
+}
+
 /*===========================================
                                  Fire Effect
 ===========================================*/
@@ -896,19 +886,12 @@ void ParticlesSourceFire::addParticle(int i_curTime) {
   Vector2f v_velocity(NotSoRandom::randomNum(-1, 1),
                       NotSoRandom::randomNum(0.1, 0.3));
   int v_killTime = i_curTime + 500;
-  std::string v_spriteName = SpriteName();
-
-  EntityParticle *pEntityParticle = getExistingParticle();
-  if (pEntityParticle == NULL) {
-    pEntityParticle =
-      new FireParticle(DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  } else {
-    ((FireParticle *)pEntityParticle)
-      ->init(DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  }
 
-  m_particles.push_back(pEntityParticle);
-  m_totalOfParticles++;
+  unsigned int i = m_particles.add(DynamicPosition(), v_velocity, v_killTime);
+  m_particles.Seed[i] = NotSoRandom::randomNum(0, 100);
+  m_particles.Size[i] = 0.17;
+  m_particles.setColor(i, TColor(255, 255, 0, 255));
+  SDL_AtomicIncRef(&m_totalOfParticles);
 }
 
 bool ParticlesSourceFire::updateToTime(int i_time,
@@ -924,6 +907,38 @@ bool ParticlesSourceFire::updateToTime(int i_time,
   }
   return false;
 }
+
+void ParticlesSourceFire::updateParticles(int i_time,
+                                          Vector2f &i_gravity,
+                                          PhysicsSettings *i_physicsSettings) {
+  float v_timeStep = 0.040;
+  unsigned int n = m_particles.size();
+
+  for (unsigned int i = 0; i < n; i++) {
+    int v_g = m_particles.Green[i] -
+              (int)(NotSoRandom::randomNum(190, 210) * v_timeStep);
+    int v_b = m_particles.Blue[i] -
+              (int)(NotSoRandom::randomNum(400, 400) * v_timeStep);
+
+    int v_a = m_particles.Alpha[i] - (int)(250.0f * v_timeStep);
+    if (v_a >= 0) {
+      m_particles.setColor(i,
+                           TColor(m_particles.Red[i],
+                                  v_g < 0 ? 0 : v_g,
+                                  v_b < 0 ? 0 : v_b,
+                                  v_a));
+    } else {
+      m_particles.KillTime[i] = i_time;
+    }
+
+    float v_seed = m_particles.Seed[i];
+    m_particles.VelX[i] =
+      sin((i_time + v_seed) * NotSoRandom::randomNum(5, 15)) * 0.004f +
+      sin((i_time - v_seed) * 0.1) * 0.3;
+    m_particles.AccY[i] = 3.0;
+  }
+}
+
 /*===========================================
                                  Star Effect
 ===========================================*/
@@ -941,20 +956,13 @@ void ParticlesSourceStar::addParticle(int i_curTime) {
 
   Vector2f v_velocity(randomNum(-2, 2), randomNum(0, 2));
   int v_killTime = i_curTime + 500;
-  std::string v_spriteName = SpriteName();
 
-  EntityParticle *pEntityParticle = getExistingParticle();
-  if (pEntityParticle == NULL) {
-    pEntityParticle =
-      new StarParticle(DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  } else {
-    ((StarParticle *)pEntityParticle)
-      ->init(DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  }
-
-  m_particles.push_back(pEntityParticle);
-  m_totalOfParticles++;
+  unsigned int i = m_particles.add(DynamicPosition(), v_velocity, v_killTime);
+  m_particles.AngVel[i] = NotSoRandom::randomNum(-60, 60);
+  m_particles.AccY[i] = -4;
+  SDL_AtomicIncRef(&m_totalOfParticles);
 }
+
 /*===========================================
                                  Debris Effect
 ===========================================*/
@@ -974,19 +982,19 @@ void ParticlesSourceDebris::addParticle(int i_curTime) {
 
   Vector2f v_velocity(randomNum(-2, 2), randomNum(0, 2));
   int v_killTime = i_curTime + 300;
-  std::string v_spriteName = SpriteName();
 
-  EntityParticle *pEntityParticle = getExistingParticle();
-  if (pEntityParticle == NULL) {
-    pEntityParticle = new DebrisParticle(
-      DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  } else {
-    ((DebrisParticle *)pEntityParticle)
-      ->init(DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  }
-
-  m_particles.push_back(pEntityParticle);
-  m_totalOfParticles++;
+  unsigned int i = m_particles.add(DynamicPosition(), v_velocity, v_killTime);
+  m_particles.AngVel[i] = NotSoRandom::randomNum(-60, 60);
+  m_particles.AccY[i] = -4;
+  int cc = (int)NotSoRandom::randomNum(0, 250);
+  m_particles.setColor(i, TColor(cc, cc, cc, 255));
+  v_velocity *= NotSoRandom::randomNum(1.5, 0.5);
+  v_velocity += Vector2f(NotSoRandom::randomNum(-0.2, 0.2),
+                         NotSoRandom::randomNum(-0.2, 0.2));
+  m_particles.VelX[i] = v_velocity.x;
+  m_particles.VelY[i] = v_velocity.y;
+  m_particles.Size[i] = NotSoRandom::randomNum(0.02f, 0.04f);
+  SDL_AtomicIncRef(&m_totalOfParticles);
 }
 
 bool ParticlesSourceDebris::updateToTime(int i_time,
@@ -997,6 +1005,29 @@ bool ParticlesSourceDebris::updateToTime(int i_time,
     i_time, i_gravity, i_physicsSettings, i_allowParticules);
 }
 
+void ParticlesSourceDebris::updateParticles(
+  int i_time,
+  Vector2f &i_gravity,
+  PhysicsSettings *i_physicsSettings) {
+  float v_timeStep = 0.025;
+  unsigned int n = m_particles.size();
+  Vector2f v_acceleration =
+    i_gravity * (-5.5f / -(i_physicsSettings->WorldGravity()));
+  int v_alphaStep = (int)(120.0f * v_timeStep);
+
+  for (unsigned int i = 0; i < n; i++) {
+    m_particles.AccX[i] = v_acceleration.x;
+    m_particles.AccY[i] = v_acceleration.y;
+
+    int v_a = m_particles.Alpha[i] - v_alphaStep;
+    if (v_a >= 0) {
+      m_particles.Alpha[i] = v_a;
+    } else {
+      m_particles.KillTime[i] = i_time;
+    }
+  }
+}
+
 /*===========================================
                                  Sparkle Effect
 ===========================================*/
@@ -1015,19 +1046,12 @@ void ParticlesSourceSparkle::addParticle(int i_curTime) {
   Vector2f v_velocity(NotSoRandom::randomNum(-4, 4),
                       NotSoRandom::randomNum(0, 2));
   int v_killTime = i_curTime + 500;
-  std::string v_spriteName = SpriteName();
 
-  EntityParticle *pEntityParticle = getExistingParticle();
-  if (pEntityParticle == NULL) {
-    pEntityParticle = new SparkleParticle(
-      DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  } else {
-    ((SparkleParticle *)pEntityParticle)
-      ->init(DynamicPosition(), v_velocity, v_killTime, v_spriteName);
-  }
-
-  m_particles.push_back(pEntityParticle);
-  m_totalOfParticles++;
+  unsigned int i = m_particles.add(DynamicPosition(), v_velocity, v_killTime);
+  m_particles.Seed[i] = NotSoRandom::randomNum(0, 100);
+  m_particles.Size[i] = 0.05;
+  m_particles.setColor(i, TColor(255, 255, 0, 255));
+  SDL_AtomicIncRef(&m_totalOfParticles);
 }
 
 bool ParticlesSourceSparkle::updateToTime(int i_time,
@@ -1052,310 +1076,170 @@ return true;
   return false;
 }
 
-/*===========================================
-                                 Base for an single particle
-===========================================*/
-EntityParticle::EntityParticle()
-  : Entity("") {
-  m_spriteIndex = 0;
-}
-
-EntityParticle::~EntityParticle() {}
-
-void EntityParticle::init(const Vector2f &i_position,
-                          const Vector2f &i_velocity,
-                          int i_killTime) {
-  setDynamicPosition(i_position);
-  m_velocity = i_velocity;
-  m_killTime = i_killTime;
-  m_acceleration = Vector2f(0, 0);
-  m_ang = 0;
-  m_angAcc = 0;
-  m_angVel = 0;
-  setColor(TColor(255, 255, 255, 255));
-  setSize(0.5);
-}
-
-bool EntityParticle::updateToTime(int i_time,
-                                  Vector2f &i_gravity,
-                                  PhysicsSettings *i_physicsSettings,
-                                  bool i_allowParticules) {
-  if (i_allowParticules == false) {
-    return false;
-  }
-
-  float v_timeStep = 0.025;
-
-  m_velocity += m_acceleration * v_timeStep;
-  setDynamicPosition(DynamicPosition() + m_velocity * v_timeStep);
-  m_angVel += m_angAcc * v_timeStep;
-  m_ang += m_angVel * v_timeStep;
-
-  return true;
-}
-
-/*===========================================
-                                Single Smoke Particle
-===========================================*/
-SmokeParticle::SmokeParticle(const Vector2f &i_position,
-                             const Vector2f &i_velocity,
-                             int i_killTime,
-                             std::string i_spriteName)
-  : EntityParticle() {
-  init(i_position, i_velocity, i_killTime, i_spriteName);
-}
-
-SmokeParticle::~SmokeParticle() {}
-
-void SmokeParticle::init(const Vector2f &i_position,
-                         const Vector2f &i_velocity,
-                         int i_killTime,
-                         std::string i_spriteName) {
-  EntityParticle::init(i_position, i_velocity, i_killTime);
-
-  int cc = (int)NotSoRandom::randomNum(0, 50);
-  setColor(TColor(cc, cc, cc, 255));
-  setSize(NotSoRandom::randomNum(0, 0.2));
-  m_angVel = NotSoRandom::randomNum(-60, 60);
-  setSpriteName(i_spriteName);
-}
-
-bool SmokeParticle::updateToTime(int i_time,
-                                 Vector2f &i_gravity,
-                                 PhysicsSettings *i_physicsSettings,
-                                 bool i_allowParticules) {
-  EntityParticle::updateToTime(
-    i_time, i_gravity, i_physicsSettings, i_allowParticules);
-
-  if (i_allowParticules == false) {
-    return false;
-  }
-
-  float v_timeStep = 0.025;
-  TColor v_color(Color());
-
-  /* grow */
-  setSize(Size() + v_timeStep * 1.0f);
-  /* accelerate upwards */
-  m_acceleration = Vector2f(0.2, 0.5);
-
-  int v_c =
-    (Color().Red() + (int)(NotSoRandom::randomNum(40, 50) * v_timeStep)) & 0xFF;
-  v_color.setRed(v_c);
-  v_color.setBlue(v_c);
-  v_color.setGreen(v_c);
-
-  int v_a = Color().Alpha() - (int)(120.0f * v_timeStep);
-  if (v_a >= 0) {
-    v_color.setAlpha(v_a);
-    setColor(v_color);
-  } else {
-    m_killTime = i_time;
-  }
-
-  return false;
-}
-
-/*===========================================
-                                Single Fire Particle
-===========================================*/
-FireParticle::FireParticle(const Vector2f &i_position,
-                           const Vector2f &i_velocity,
-                           int i_killTime,
-                           std::string i_spriteName)
-  : EntityParticle() {
-  init(i_position, i_velocity, i_killTime, i_spriteName);
-}
-
-FireParticle::~FireParticle() {}
-
-void FireParticle::init(const Vector2f &i_position,
-                        const Vector2f &i_velocity,
-                        int i_killTime,
-                        std::string i_spriteName) {
-  EntityParticle::init(i_position, i_velocity, i_killTime);
-
-  m_fireSeed = NotSoRandom::randomNum(0, 100);
-  setSize(0.17);
-  setColor(TColor(255, 255, 0, 255));
-  setSpriteName(i_spriteName);
-}
-
-bool FireParticle::updateToTime(int i_time,
-                                Vector2f &i_gravity,
-                                PhysicsSettings *i_physicsSettings,
-                                bool i_allowParticules) {
-  EntityParticle::updateToTime(
-    i_time, i_gravity, i_physicsSettings, i_allowParticules);
-
-  if (i_allowParticules == false) {
-    return false;
-  }
-
+void ParticlesSourceSparkle::updateParticles(
+  int i_time,
+  Vector2f &i_gravity,
+  PhysicsSettings *i_physicsSettings) {
   float v_timeStep = 0.040;
-  TColor v_color(Color());
-
-  int v_g =
-    Color().Green() - (int)(NotSoRandom::randomNum(190, 210) * v_timeStep);
-  v_color.setGreen(v_g < 0 ? 0 : v_g);
-
-  int v_b =
-    Color().Blue() - (int)(NotSoRandom::randomNum(400, 400) * v_timeStep);
-  v_color.setBlue(v_b < 0 ? 0 : v_b);
+  unsigned int n = m_particles.size();
+
+  for (unsigned int i = 0; i < n; i++) {
+    int v_g = m_particles.Green[i] -
+              (int)(NotSoRandom::randomNum(190, 210) * v_timeStep);
+    int v_b = m_particles.Blue[i] -
+              (int)(NotSoRandom::randomNum(400, 400) * v_timeStep);
+
+    int v_a = m_particles.Alpha[i] - (int)(250.0f * (v_timeStep / 1.5));
+    if (v_a >= 0) {
+      m_particles.setColor(i,
+                           TColor(m_particles.Red[i],
+                                  v_g < 0 ? 0 : v_g,
+                                  v_b < 0 ? 0 : v_b,
+                                  v_a));
+    } else {
+      m_particles.KillTime[i] = i_time;
+    }
 
-  int v_a = Color().Alpha() - (int)(250.0f * v_timeStep);
-  if (v_a >= 0) {
-    v_color.setAlpha(v_a);
-    setColor(v_color);
-  } else {
-    m_killTime = i_time;
+    m_particles.AccY[i] = -1.0;
   }
-
-  m_velocity.x =
-    sin((i_time + m_fireSeed) * NotSoRandom::randomNum(5, 15)) * 0.004f +
-    sin((i_time - m_fireSeed) * 0.1) * 0.3;
-  m_acceleration.y = 3.0;
-
-  return false;
 }
 
 /*===========================================
-                                Single Star Particle
+                                 Particles arrays
 ===========================================*/
-StarParticle::StarParticle(const Vector2f &i_position,
-                           const Vector2f &i_velocity,
-                           int i_killTime,
-                           std::string i_spriteName)
-  : EntityParticle() {
-  init(i_position, i_velocity, i_killTime, i_spriteName);
-}
-
-StarParticle::~StarParticle() {}
-
-void StarParticle::init(const Vector2f &i_position,
-                        const Vector2f &i_velocity,
-                        int i_killTime,
-                        std::string i_spriteName) {
-  EntityParticle::init(i_position, i_velocity, i_killTime);
-
-  m_angVel = NotSoRandom::randomNum(-60, 60);
-  m_acceleration = Vector2f(0, -4);
-  setSpriteName(i_spriteName);
-}
-/*===========================================
-                                Single Debris Particle
-===========================================*/
-DebrisParticle::DebrisParticle(const Vector2f &i_position,
-                               const Vector2f &i_velocity,
-                               int i_killTime,
-                               std::string i_spriteName)
-  : EntityParticle() {
-  init(i_position, i_velocity, i_killTime, i_spriteName);
-}
-
-DebrisParticle::~DebrisParticle() {}
-
-void DebrisParticle::init(const Vector2f &i_position,
-                          const Vector2f &i_velocity,
-                          int i_killTime,
-                          std::string i_spriteName) {
-  EntityParticle::init(i_position, i_velocity, i_killTime);
-
-  m_angVel = NotSoRandom::randomNum(-60, 60);
-  m_acceleration = Vector2f(0, -4);
-  int cc = (int)NotSoRandom::randomNum(0, 250);
-  setColor(TColor(cc, cc, cc, 255));
-  m_velocity *= NotSoRandom::randomNum(1.5, 0.5);
-  m_velocity += Vector2f(NotSoRandom::randomNum(-0.2, 0.2),
-                         NotSoRandom::randomNum(-0.2, 0.2));
-  setSize(NotSoRandom::randomNum(0.02f, 0.04f));
-  setSpriteName(i_spriteName);
-}
-
-bool DebrisParticle::updateToTime(int i_time,
-                                  Vector2f &i_gravity,
-                                  PhysicsSettings *i_physicsSettings,
-                                  bool i_allowParticules) {
-  EntityParticle::updateToTime(
-    i_time, i_gravity, i_physicsSettings, i_allowParticules);
+unsigned int EntityParticles::add(const Vector2f &i_position,
+                                  const Vector2f &i_velocity,
+                                  int i_killTime) {
+  PosX.push_back(i_position.x);
+  PosY.push_back(i_position.y);
+  VelX.push_back(i_velocity.x);
+  VelY.push_back(i_velocity.y);
+  AccX.push_back(0.0);
+  AccY.push_back(0.0);
+  Angle.push_back(0.0);
+  AngVel.push_back(0.0);
+  AngAcc.push_back(0.0);
+  Size.push_back(0.5);
+  Seed.push_back(0.0);
+  Red.push_back(255);
+  Green.push_back(255);
+  Blue.push_back(255);
+  Alpha.push_back(255);
+  KillTime.push_back(i_killTime);
+  SpriteIndex.push_back(0);
+
+  return KillTime.size() - 1;
+}
+
+/* the vectors keep their memory for the next particles */
+void EntityParticles::clear() {
+  PosX.clear();
+  PosY.clear();
+  VelX.clear();
+  VelY.clear();
+  AccX.clear();
+  AccY.clear();
+  Angle.clear();
+  AngVel.clear();
+  AngAcc.clear();
+  Size.clear();
+  Seed.clear();
+  Red.clear();
+  Green.clear();
+  Blue.clear();
+  Alpha.clear();
+  KillTime.clear();
+  SpriteIndex.clear();
+}
+
+unsigned int EntityParticles::removeDead(int i_time) {
+  unsigned int n = size();
+  unsigned int j = 0;
+
+  for (unsigned int i = 0; i < n; i++) {
+    if (i_time > KillTime[i]) {
+      continue;
+    }
 
-  if (i_allowParticules == false) {
-    return false;
+    if (i != j) {
+      PosX[j] = PosX[i];
+      PosY[j] = PosY[i];
+      VelX[j] = VelX[i];
+      VelY[j] = VelY[i];
+      AccX[j] = AccX[i];
+      AccY[j] = AccY[i];
+      Angle[j] = Angle[i];
+      AngVel[j] = AngVel[i];
+      AngAcc[j] = AngAcc[i];
+      Size[j] = Size[i];
+      Seed[j] = Seed[i];
+      Red[j] = Red[i];
+      Green[j] = Green[i];
+      Blue[j] = Blue[i];
+      Alpha[j] = Alpha[i];
+      KillTime[j] = KillTime[i];
+      SpriteIndex[j] = SpriteIndex[i];
+    }
+    j++;
   }
 
-  float v_timeStep = 0.025;
-  TColor v_color(Color());
-
-  m_acceleration = i_gravity * (-5.5f / -(i_physicsSettings->WorldGravity()));
-
-  int v_a = v_color.Alpha() - (int)(120.0f * v_timeStep);
-  if (v_a >= 0) {
-    v_color.setAlpha(v_a);
-    setColor(v_color);
-  } else {
-    m_killTime = i_time;
+  if (j != n) {
+    PosX.resize(j);
+    PosY.resize(j);
+    VelX.resize(j);
+    VelY.resize(j);
+    AccX.resize(j);
+    AccY.resize(j);
+    Angle.resize(j);
+    AngVel.resize(j);
+    AngAcc.resize(j);
+    Size.resize(j);
+    Seed.resize(j);
+    Red.resize(j);
+    Green.resize(j);
+    Blue.resize(j);
+    Alpha.resize(j);
+    KillTime.resize(j);
+    SpriteIndex.resize(j);
   }
 
-  return true;
-}
-/*===========================================
-                                Single Sparkle Particle
-===========================================*/
-SparkleParticle::SparkleParticle(const Vector2f &i_position,
-                                 const Vector2f &i_velocity,
-                                 int i_killTime,
-                                 std::string i_spriteName)
-  : EntityParticle() {
-  init(i_position, i_velocity, i_killTime, i_spriteName);
-}
-
-SparkleParticle::~SparkleParticle() {}
-
-void SparkleParticle::init(const Vector2f &i_position,
-                           const Vector2f &i_velocity,
-                           int i_killTime,
-                           std::string i_spriteName) {
-  EntityParticle::init(i_position, i_velocity, i_killTime);
-
-  m_SparkleSeed = NotSoRandom::randomNum(0, 100);
-  setSize(0.05);
-  setColor(TColor(255, 255, 0, 255));
-  setSpriteName(i_spriteName);
+  return n - j;
 }
 
-bool SparkleParticle::updateToTime(int i_time,
-                                   Vector2f &i_gravity,
-                                   PhysicsSettings *i_physicsSettings,
-                                   bool i_allowParticules) {
-  EntityParticle::updateToTime(
-    i_time, i_gravity, i_physicsSettings, i_allowParticules);
+/* plain loops on the arrays, that the compiler can vectorize */
+void EntityParticles::move(float i_timeStep) {
+  unsigned int n = size();
 
-  if (i_allowParticules == false) {
-    return false;
+  if (n == 0) {
+    return;
   }
 
-  float v_timeStep = 0.040;
-  TColor v_color(Color());
-
-  int v_g =
-    Color().Green() - (int)(NotSoRandom::randomNum(190, 210) * v_timeStep);
-  v_color.setGreen(v_g < 0 ? 0 : v_g);
-
-  int v_b =
-    Color().Blue() - (int)(NotSoRandom::randomNum(400, 400) * v_timeStep);
-  v_color.setBlue(v_b < 0 ? 0 : v_b);
-
-  int v_a = Color().Alpha() - (int)(250.0f * (v_timeStep / 1.5));
-  if (v_a >= 0) {
-    v_color.setAlpha(v_a);
-    setColor(v_color);
-  } else {
-    m_killTime = i_time;
+  float *v_posX = &PosX[0];
+  float *v_posY = &PosY[0];
+  float *v_velX = &VelX[0];
+  float *v_velY = &VelY[0];
+  const float *v_accX = &AccX[0];
+  const float *v_accY = &AccY[0];
+  float *v_angle = &Angle[0];
+  float *v_angVel = &AngVel[0];
+  const float *v_angAcc = &AngAcc[0];
+
+  for (unsigned int i = 0; i < n; i++) {
+    v_velX[i] += v_accX[i] * i_timeStep;
+    v_velY[i] += v_accY[i] * i_timeStep;
+    v_posX[i] += v_velX[i] * i_timeStep;
+    v_posY[i] += v_velY[i] * i_timeStep;
   }
 
-  // m_velocity.x = cos((i_time + m_SparkleSeed)) * 0.1f;
-
-  m_acceleration.y = -1.0;
+  for (unsigned int i = 0; i < n; i++) {
+    v_angVel[i] += v_angAcc[i] * i_timeStep;
+    v_angle[i] += v_angVel[i] * i_timeStep;
+  }
+}
 
-  return false;
+void EntityParticles::setColor(unsigned int i, const TColor &i_color) {
+  Red[i] = i_color.Red();
+  Green[i] = i_color.Green();
+  Blue[i] = i_color.Blue();
+  Alpha[i] = i_color.Alpha();
 }
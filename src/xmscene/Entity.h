@@ -25,10 +25,10 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "../helpers/VMath.h"
 #include "BasicSceneStructs.h"
 #include "common/VXml.h"
+#include "include/xm_SDL.h"
 #include <string>
 #include <vector>
 
-class EntityParticle;
 class FileHandle;
 class Sprite;
 class Block;
@@ -234,6 +234,36 @@ typedef enum particleSourceType {
   Sparkle
 } particleSourceType;
 
+/**
+  Particles of a source. They are not entities : each property is stored in
+  its own array, so that the particles are updated in a row and the memory is
+  reused from one particle to the next one.
+*/
+struct EntityParticles {
+  std::vector<float> PosX, PosY; /* Position */
+  std::vector<float> VelX, VelY; /* Velocity */
+  std::vector<float> AccX, AccY; /* Acceleration */
+  std::vector<float> Angle, AngVel, AngAcc; /* Angular version of the above */
+  std::vector<float> Size;
+  std::vector<float> Seed;
+  std::vector<unsigned char> Red, Green, Blue, Alpha;
+  std::vector<int> KillTime;
+  std::vector<unsigned int> SpriteIndex;
+
+  inline unsigned int size() const { return KillTime.size(); }
+
+  /* return the index of the new particle */
+  unsigned int add(const Vector2f &i_position,
+                   const Vector2f &i_velocity,
+                   int i_killTime);
+  void clear();
+  /* remove the particles killed before i_time, keeping the order of the
+     other ones ; return the number of removed particles */
+  unsigned int removeDead(int i_time);
+  void move(float i_timeStep);
+  void setColor(unsigned int i, const TColor &i_color);
+};
+
 class ParticlesSource : public Entity {
 public:
   ParticlesSource(const std::string &i_id, int i_particleTime_increment);
@@ -245,7 +275,7 @@ public:
                             Vector2f &i_gravity,
                             PhysicsSettings *i_physicsSettings,
                             bool i_allowParticules);
-  inline std::vector<EntityParticle *> &Particles() { return m_particles; }
+  inline const EntityParticles &Particles() const { return m_particles; }
   virtual void addParticle(int i_curTime) = 0;
 
   static void setAllowParticleGeneration(bool i_value);
@@ -253,16 +283,17 @@ public:
   inline particleSourceType getType() { return m_type; }
 
 protected:
-  std::vector<EntityParticle *> m_particles;
-  std::vector<EntityParticle *> m_deadParticles;
+  EntityParticles m_particles;
   particleSourceType m_type;
 
-  static int m_totalOfParticles;
+  static SDL_atomic_t m_totalOfParticles; // of all the scenes
   static bool hasReachedMaxParticles();
 
-  // return NULL if no dead particle exists
-  EntityParticle *getExistingParticle();
-  void addDeadParticle(EntityParticle *pEntityParticle);
+  /* update the particles once they moved ; the kind of particle specific
+     part */
+  virtual void updateParticles(int i_time,
+                               Vector2f &i_gravity,
+                               PhysicsSettings *i_physicsSettings);
 
 private:
   int m_lastParticleTime;
@@ -298,6 +329,11 @@ public:
                     PhysicsSettings *i_physicsSettings,
                     bool i_allowParticules);
   void addParticle(int i_curTime);
+
+protected:
+  void updateParticles(int i_time,
+                       Vector2f &i_gravity,
+                       PhysicsSettings *i_physicsSettings);
 };
 
 class ParticlesSourceFire : public ParticlesSource {
@@ -310,6 +346,11 @@ public:
                     PhysicsSettings *i_physicsSettings,
                     bool i_allowParticules);
   void addParticle(int i_curTime);
+
+protected:
+  void updateParticles(int i_time,
+                       Vector2f &i_gravity,
+                       PhysicsSettings *i_physicsSettings);
 };
 
 class ParticlesSourceStar : public ParticlesSource {
@@ -330,6 +371,11 @@ public:
                     PhysicsSettings *i_physicsSettings,
                     bool i_allowParticules);
   void addParticle(int i_curTime);
+
+protected:
+  void updateParticles(int i_time,
+                       Vector2f &i_gravity,
+                       PhysicsSettings *i_physicsSettings);
 };
 
 class ParticlesSourceSparkle : public ParticlesSource {
@@ -342,137 +388,11 @@ public:
                     PhysicsSettings *i_physicsSettings,
                     bool i_allowParticules);
   void addParticle(int i_curTime);
-};
-
-/**
-  An EntityParticle is an entity which as a movement and which dies
-*/
-class EntityParticle : public Entity {
-public:
-  EntityParticle();
-  virtual ~EntityParticle();
-
-  virtual bool updateToTime(int i_time,
-                            Vector2f &i_gravity,
-                            PhysicsSettings *i_physicsSettings,
-                            bool i_allowParticules);
-  inline int KillTime() const { return m_killTime; }
-
-  inline float Angle() const { return m_ang; }
-
-  // for fast spriteName check
-  inline unsigned int spriteIndex() { return m_spriteIndex; }
-  inline void setSpriteIndex(unsigned int spriteIndex) {
-    m_spriteIndex = spriteIndex;
-  }
 
 protected:
-  void init(const Vector2f &i_position,
-            const Vector2f &i_velocity,
-            int i_killTime);
-  /* Position, velocity, and acceleration */
-  Vector2f m_velocity, m_acceleration;
-  /* Angular version of the above */
-  float m_ang, m_angVel, m_angAcc;
-  int m_killTime;
-  unsigned int m_spriteIndex;
-};
-
-class SmokeParticle : public EntityParticle {
-public:
-  SmokeParticle(const Vector2f &i_position,
-                const Vector2f &i_velocity,
-                int i_killTime,
-                std::string i_spriteName);
-  virtual ~SmokeParticle();
-  void init(const Vector2f &i_position,
-            const Vector2f &i_velocity,
-            int i_killTime,
-            std::string i_spriteName);
-
-  virtual bool updateToTime(int i_time,
-                            Vector2f &i_gravity,
-                            PhysicsSettings *i_physicsSettings,
-                            bool i_allowParticules);
-
-private:
-};
-
-class FireParticle : public EntityParticle {
-public:
-  FireParticle(const Vector2f &i_position,
-               const Vector2f &i_velocity,
-               int i_killTime,
-               std::string i_spriteName);
-  virtual ~FireParticle();
-  void init(const Vector2f &i_position,
-            const Vector2f &i_velocity,
-            int i_killTime,
-            std::string i_spriteName);
-
-  virtual bool updateToTime(int i_time,
-                            Vector2f &i_gravity,
-                            PhysicsSettings *i_physicsSettings,
-                            bool i_allowParticules);
-
-private:
-  float m_fireSeed;
-};
-
-class StarParticle : public EntityParticle {
-public:
-  StarParticle(const Vector2f &i_position,
-               const Vector2f &i_velocity,
-               int i_killTime,
-               std::string i_spriteName);
-  virtual ~StarParticle();
-  void init(const Vector2f &i_position,
-            const Vector2f &i_velocity,
-            int i_killTime,
-            std::string i_spriteName);
-
-private:
-};
-
-class DebrisParticle : public EntityParticle {
-public:
-  DebrisParticle(const Vector2f &i_position,
-                 const Vector2f &i_velocity,
-                 int i_killTime,
-                 std::string i_spriteName);
-  virtual ~DebrisParticle();
-  void init(const Vector2f &i_position,
-            const Vector2f &i_velocity,
-            int i_killTime,
-            std::string i_spriteName);
-
-  virtual bool updateToTime(int i_time,
-                            Vector2f &i_gravity,
-                            PhysicsSettings *i_physicsSettings,
-                            bool i_allowParticules);
-
-private:
-};
-
-class SparkleParticle : public EntityParticle {
-public:
-  SparkleParticle(const Vector2f &i_position,
-                  const Vector2f &i_velocity,
-                  int i_killTime,
-                  std::string i_spriteName);
-  virtual ~SparkleParticle();
-  void init(const Vector2f &i_position,
-            const Vector2f &i_velocity,
-            int i_killTime,
-            std::string i_spriteName);
-
-  virtual bool updateToTime(int i_time,
-                            Vector2f &i_gravity,
-                            PhysicsSettings *i_physicsSettings,
-                            bool i_allowParticules);
-
-private:
-  float m_SparkleSeed;
+  void updateParticles(int i_time,
+                       Vector2f &i_gravity,
+                       PhysicsSettings *i_physicsSettings);
 };
 
 #endif /* __ENTITY_H__ */
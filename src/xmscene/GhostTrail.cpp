@@ -19,127 +19,160 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 =============================================================================*/
 
 #include "GhostTrail.h"
+#include "helpers/Log.h"
 #include "xmoto/Replay.h"
 
 #define TRAIL_INTERPOLATED_TRAIL_INTERNODE_LENGTH 0.3
 #define TRAIL_INTERPOLATION_STEP 0.1
 
 GhostTrail::GhostTrail(FileGhost *i_ghost) {
-  m_ghost = i_ghost;
-  m_initialized = false;
+  m_physicsSettings = NULL;
+  m_thread = NULL;
+  SDL_AtomicSet(&m_ready, 0);
+  SDL_AtomicSet(&m_cancel, 0);
+
+  if (i_ghost == NULL) {
+    return;
+  }
+
+  // the thread reads its own replay, the ghost one is played meanwhile
+  m_replayFile = i_ghost->getReplayFile();
+  m_physicsSettings = i_ghost->getPhysicsSettings();
+
+  m_thread = SDL_CreateThread(&GhostTrail::computeThread, "GhostTrail", this);
+  if (m_thread == NULL) {
+    LogWarning("Unable to create the ghost trail thread: %s", SDL_GetError());
+  }
 }
 
 GhostTrail::~GhostTrail() {
-  m_trailData.clear();
-  m_simplifiedTrailData.clear();
-  m_interpolatedTrailData.clear();
+  if (m_thread != NULL) {
+    SDL_AtomicSet(&m_cancel, 1);
+    SDL_WaitThread(m_thread, NULL);
+  }
 }
 
-void GhostTrail::initialize() {
-  if (m_initialized) {
-    return;
+int GhostTrail::computeThread(void *i_ghostTrail) {
+  GhostTrail *v_ghostTrail = (GhostTrail *)i_ghostTrail;
+
+  try {
+    v_ghostTrail->compute();
+  } catch (Exception &e) {
+    LogWarning("Unable to compute the ghost trail: %s", e.getMsg().c_str());
+    return 1;
   }
 
-  if (m_ghost == NULL) {
+  return 0;
+}
+
+void GhostTrail::compute() {
+  std::string v_playerName;
+  Replay v_replay;
+
+  v_replay.openReplay(m_replayFile, v_playerName);
+
+  // all states for Ghost Trail
+  BikeState v_bs(m_physicsSettings);
+  while (!v_replay.endOfFile()) {
+    if (SDL_AtomicGet(&m_cancel) != 0) {
+      return;
+    }
+    v_replay.loadState(&v_bs, m_physicsSettings);
+    m_trailData.push_back(v_bs.CenterP);
+  }
+
+  if (m_trailData.empty()) {
     return;
   }
 
-  m_initialized = true;
+  // now lets try real linear interpolation
+  Vector2f v_P_old = m_trailData[0], v_P_new, v_vecTmp;
+  float v_time = TRAIL_INTERPOLATION_STEP;
 
-  try {
-    m_trailData.clear();
-    m_interpolatedTrailData.clear();
-    m_simplifiedTrailData.clear();
-
-    // all states for Ghost Trail
-    BikeState v_bs(m_ghost->getPhysicsSettings());
-    ReplayPosition v_rp = m_ghost->getReplay()->getReplayPosition();
-    m_ghost->getReplay()->rewindAtBeginning();
-    while (!m_ghost->getReplay()->endOfFile()) {
-      m_ghost->getReplay()->loadState(&v_bs, m_ghost->getPhysicsSettings());
-      m_trailData.push_back(v_bs.CenterP);
+  for (unsigned int i = 1; i < m_trailData.size(); i++) {
+    if (SDL_AtomicGet(&m_cancel) != 0) {
+      return;
     }
-    m_ghost->getReplay()->rewindAtPosition(v_rp);
-
-    // now lets try real linear interpolation
-    Vector2f v_P_old = m_trailData[0], v_P_new, v_vecTmp;
-    float v_time = TRAIL_INTERPOLATION_STEP;
-
-    for (unsigned int i = 1; i < m_trailData.size(); i++) {
-      // calculate the rise of the function (m) from our current two trail
-      // points: p1 to p0
-      float dx = m_trailData[i].x - m_trailData[i - 1].x;
-      float dy = m_trailData[i].y - m_trailData[i - 1].y;
-      v_P_old = m_trailData[i - 1];
-      v_vecTmp = Vector2f(dx, dy);
-
-      // this is very ugly code, to clean, to clean
-      // check if teleportation occurred, lets assume that 7 is a size big
-      // enough for beeing usable as marker
-      Vector2f v_checkTeleport =
-        Vector2f(m_trailData[i].x - v_P_old.x, m_trailData[i].y - v_P_old.y);
+
+    // calculate the rise of the function (m) from our current two trail
+    // points: p1 to p0
+    float dx = m_trailData[i].x - m_trailData[i - 1].x;
+    float dy = m_trailData[i].y - m_trailData[i - 1].y;
+    v_P_old = m_trailData[i - 1];
+    v_vecTmp = Vector2f(dx, dy);
+
+    // this is very ugly code, to clean, to clean
+    // check if teleportation occurred, lets assume that 7 is a size big
+    // enough for beeing usable as marker
+    Vector2f v_checkTeleport =
+      Vector2f(m_trailData[i].x - v_P_old.x, m_trailData[i].y - v_P_old.y);
+    if (v_checkTeleport.length() > 5) {
+      continue;
+    }
+
+    // this is very ugly code, to clean, to clean
+    // check if new position vector is very near the next simplifiedtrailData,
+    // else pushback vectors in its direction, assume 0.2
+    int j = 0;
+    do {
+      // so lets push back new vector2fsm untilk we're near the next point on
+      // the simplified trail
+      v_P_new.x = (v_vecTmp.x / v_vecTmp.length()) * v_time + v_P_old.x;
+      v_P_new.y = (v_vecTmp.y / v_vecTmp.length()) * v_time + v_P_old.y;
+
+      m_interpolatedTrailData.push_back(v_P_new);
+      v_P_old = v_P_new;
+
+      j++;
+      v_checkTeleport =
+        Vector2f(m_trailData[j].x - v_P_old.x, m_trailData[j].y - v_P_old.y);
       if (v_checkTeleport.length() > 5) {
         continue;
       }
 
-      // this is very ugly code, to clean, to clean
-      // check if new position vector is very near the next simplifiedtrailData,
-      // else pushback vectors in its direction, assume 0.2
-      int j = 0;
-      do {
-        // so lets push back new vector2fsm untilk we're near the next point on
-        // the simplified trail
-        v_P_new.x = (v_vecTmp.x / v_vecTmp.length()) * v_time + v_P_old.x;
-        v_P_new.y = (v_vecTmp.y / v_vecTmp.length()) * v_time + v_P_old.y;
-
-        m_interpolatedTrailData.push_back(v_P_new);
-        v_P_old = v_P_new;
-
-        j++;
-        v_checkTeleport =
-          Vector2f(m_trailData[j].x - v_P_old.x, m_trailData[j].y - v_P_old.y);
-        if (v_checkTeleport.length() > 5) {
-          continue;
-        }
-
-      } while (j < int(v_vecTmp.length() / v_time));
-    }
+    } while (j < int(v_vecTmp.length() / v_time));
+  }
 
-    // now smoothen path in time: cumulate Vector.length, every n length
-    // pushBack median
-    // interpolated in time, not position
-    float v_cumulum = 0;
-    for (unsigned int i = 1; i < m_interpolatedTrailData.size(); i++) {
-      Vector2f v_vec = Vector2f(
-        fabs(m_interpolatedTrailData[i].x - m_interpolatedTrailData[i - 1].x),
-        fabs(m_interpolatedTrailData[i].y - m_interpolatedTrailData[i - 1].y));
-      v_cumulum += v_vec.length();
-      if (v_cumulum > TRAIL_INTERPOLATED_TRAIL_INTERNODE_LENGTH) {
-        m_simplifiedTrailData.push_back(m_interpolatedTrailData[i - 1]);
-        v_cumulum = 0;
-      }
+  // now smoothen path in time: cumulate Vector.length, every n length
+  // pushBack median
+  // interpolated in time, not position
+  float v_cumulum = 0;
+  for (unsigned int i = 1; i < m_interpolatedTrailData.size(); i++) {
+    Vector2f v_vec = Vector2f(
+      fabs(m_interpolatedTrailData[i].x - m_interpolatedTrailData[i - 1].x),
+      fabs(m_interpolatedTrailData[i].y - m_interpolatedTrailData[i - 1].y));
+    v_cumulum += v_vec.length();
+    if (v_cumulum > TRAIL_INTERPOLATED_TRAIL_INTERNODE_LENGTH) {
+      m_simplifiedTrailData.push_back(m_interpolatedTrailData[i - 1]);
+      v_cumulum = 0;
     }
+  }
 
-    m_trailAvailable = true;
-  } catch (Exception &e) {
+  // publish the data
+  SDL_MemoryBarrierRelease();
+  SDL_AtomicSet(&m_ready, 1);
+}
+
+bool GhostTrail::isReady() {
+  if (SDL_AtomicGet(&m_ready) == 0) {
+    return false;
   }
+  SDL_MemoryBarrierAcquire();
+  return true;
 }
 
 std::vector<Vector2f> *GhostTrail::getGhostTrailData() {
-  initialize();
-  return &m_trailData;
+  return isReady() ? &m_trailData : &m_noTrailData;
 }
 
 std::vector<Vector2f> *GhostTrail::getSimplifiedGhostTrailData() {
-  initialize();
-  return &m_simplifiedTrailData;
+  return isReady() ? &m_simplifiedTrailData : &m_noTrailData;
 }
 
 std::vector<Vector2f> *GhostTrail::getInterpolatedGhostTrailData() {
-  initialize();
-  return &m_interpolatedTrailData;
+  return isReady() ? &m_interpolatedTrailData : &m_noTrailData;
 }
 
 bool GhostTrail::getGhostTrailAvailable() {
-  return m_ghost != NULL;
+  return m_thread != NULL;
 }
@@ -22,7 +22,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #define __GHOSTTRAIL_H__
 
 #include "BikeGhost.h"
+#include "include/xm_SDL.h"
 
+/*
+  the trail is computed in a thread while the ghost is loaded ; the data are
+  empty until the computation is over, and then never change anymore
+*/
 class GhostTrail {
 public:
   GhostTrail(FileGhost *i_ghost);
@@ -31,15 +36,20 @@ public:
   std::vector<Vector2f> *getSimplifiedGhostTrailData();
   std::vector<Vector2f> *getInterpolatedGhostTrailData();
   bool getGhostTrailAvailable();
+  bool isReady();
 
 private:
-  void initialize(); // lazy mode : initialize only the first time it's used
-
-  FileGhost *m_ghost;
-  bool m_initialized;
+  static int computeThread(void *i_ghostTrail);
+  void compute();
+
+  std::string m_replayFile;
+  PhysicsSettings *m_physicsSettings;
+  SDL_Thread *m_thread;
+  SDL_atomic_t m_ready;
+  SDL_atomic_t m_cancel;
   std::vector<Vector2f> m_trailData;
   std::vector<Vector2f> m_simplifiedTrailData;
   std::vector<Vector2f> m_interpolatedTrailData;
-  bool m_trailAvailable;
+  std::vector<Vector2f> m_noTrailData;
 };
 #endif
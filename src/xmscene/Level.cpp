@@ -55,6 +55,7 @@ Level::Level() {
   m_isScripted = false;
   m_isPhysics = false;
   m_sky = new SkyApparence();
+  m_indexesUpToDate = false;
 
   m_rSpriteForStrawberry = "Strawberry";
   m_rSpriteForWecker = "Wrecker";
@@ -186,41 +187,80 @@ void Level::updatePhysics(int i_time,
   }
 }
 
-Block *Level::getBlockById(const std::string &i_id) {
+void Level::invalidateIndexes() {
+  m_indexesUpToDate = false;
+  m_blocksIndex.clear();
+  m_entitiesIndex.clear();
+  m_zonesIndex.clear();
+}
+
+void Level::buildIndexes() {
+  invalidateIndexes();
+
+  /* insert() keeps the first object of a given id, as the old linear
+     searches did */
   for (unsigned int i = 0; i < m_blocks.size(); i++) {
-    if (m_blocks[i]->Id() == i_id) {
-      return m_blocks[i];
-    }
+    m_blocksIndex.insert(std::make_pair(m_blocks[i]->Id(), m_blocks[i]));
   }
-  throw Exception("Block '" + i_id + "'" + " doesn't exist");
-}
 
-Entity *Level::getEntityById(const std::string &i_id) {
+  /* killing or reverting an entity only moves it from a list to the other
+     one, so that the index remains valid */
   for (unsigned int i = 0; i < m_entities.size(); i++) {
-    if (m_entities[i]->Id() == i_id) {
-      return m_entities[i];
-    }
+    m_entitiesIndex.insert(std::make_pair(m_entities[i]->Id(), m_entities[i]));
   }
   for (unsigned int i = 0; i < m_entitiesDestroyed.size(); i++) {
-    if (m_entitiesDestroyed[i]->Id() == i_id) {
-      return m_entitiesDestroyed[i];
-    }
+    m_entitiesIndex.insert(
+      std::make_pair(m_entitiesDestroyed[i]->Id(), m_entitiesDestroyed[i]));
   }
   for (unsigned int i = 0; i < m_entitiesExterns.size(); i++) {
-    if (m_entitiesExterns[i]->Id() == i_id) {
-      return m_entitiesExterns[i];
-    }
+    m_entitiesIndex.insert(
+      std::make_pair(m_entitiesExterns[i]->Id(), m_entitiesExterns[i]));
   }
-  throw Exception("Entity '" + i_id + "'" + " doesn't exist");
+
+  for (unsigned int i = 0; i < m_zones.size(); i++) {
+    m_zonesIndex.insert(std::make_pair(m_zones[i]->Id(), m_zones[i]));
+  }
+
+  m_indexesUpToDate = true;
+}
+
+Block *Level::getBlockById(const std::string &i_id) {
+  if (m_indexesUpToDate == false) {
+    buildIndexes();
+  }
+
+  HashNamespace::unordered_map<std::string, Block *>::const_iterator it =
+    m_blocksIndex.find(i_id);
+  if (it == m_blocksIndex.end()) {
+    throw Exception("Block '" + i_id + "'" + " doesn't exist");
+  }
+  return it->second;
+}
+
+Entity *Level::getEntityById(const std::string &i_id) {
+  if (m_indexesUpToDate == false) {
+    buildIndexes();
+  }
+
+  HashNamespace::unordered_map<std::string, Entity *>::const_iterator it =
+    m_entitiesIndex.find(i_id);
+  if (it == m_entitiesIndex.end()) {
+    throw Exception("Entity '" + i_id + "'" + " doesn't exist");
+  }
+  return it->second;
 }
 
 Zone *Level::getZoneById(const std::string &i_id) {
-  for (unsigned int i = 0; i < m_zones.size(); i++) {
-    if (m_zones[i]->Id() == i_id) {
-      return m_zones[i];
-    }
+  if (m_indexesUpToDate == false) {
+    buildIndexes();
+  }
+
+  HashNamespace::unordered_map<std::string, Zone *>::const_iterator it =
+    m_zonesIndex.find(i_id);
+  if (it == m_zonesIndex.end()) {
+    throw Exception("Zone '" + i_id + "'" + " doesn't exist");
   }
-  throw Exception("Zone '" + i_id + "'" + " doesn't exist");
+  return it->second;
 }
 
 Entity *Level::getStartEntity() {
@@ -1213,6 +1253,7 @@ bool Level::importBinary(FileDataType i_fdt,
   }
 
   m_isBodyLoaded = bRet;
+  invalidateIndexes();
   return bRet;
 }
 
@@ -1327,6 +1368,11 @@ int Level::loadToPlay(ChipmunkWorld *i_chipmunkWorld,
     }
   }
 
+  /* zones */
+  for (unsigned int i = 0; i < m_zones.size(); i++) {
+    m_pCollisionSystem->addZone(m_zones[i]);
+  }
+
   // create joints
   for (unsigned int i = 0; i < m_joints.size(); i++) {
     m_joints[i]->loadToPlay(this, i_chipmunkWorld);
@@ -1356,6 +1402,7 @@ void Level::unloadToPlay() {
     delete m_entitiesExterns[i];
   }
   m_entitiesExterns.clear();
+  invalidateIndexes();
 
   m_nbEntitiesToTake = 0;
 
@@ -1368,6 +1415,8 @@ void Level::addLimits() {
   Block *pBlock;
   Vector2f v_P;
 
+  invalidateIndexes();
+
   /* Create level surroundings (by limits) */
   float fVMargin = 20, fHMargin = 20;
 
@@ -1435,6 +1484,9 @@ void Level::addLimits() {
 
 void Level::spawnEntity(Entity *v_entity) {
   m_entitiesExterns.push_back(v_entity);
+  if (m_indexesUpToDate) {
+    m_entitiesIndex.insert(std::make_pair(v_entity->Id(), v_entity));
+  }
   if (v_entity->IsToTake()) {
     m_nbEntitiesToTake++;
   }
@@ -1452,6 +1504,7 @@ void Level::unloadLevelBody() {
   unloadToPlay();
 
   m_isBodyLoaded = false;
+  invalidateIndexes();
 
   /* zones */
   for (unsigned int i = 0; i < m_zones.size(); i++) {
@@ -21,11 +21,12 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #ifndef __LEVELSRC_H__
 #define __LEVELSRC_H__
 
-#define CACHE_LEVEL_FORMAT_VERSION 36
+#define CACHE_LEVEL_FORMAT_VERSION 37
 
 #include "BasicSceneStructs.h"
 #include "common/VFileIO_types.h"
 #include "helpers/VMath.h"
+#include "include/xm_hashmap.h"
 #include <string>
 #include <vector>
 
@@ -221,6 +222,16 @@ private:
   std::vector<Entity *> m_entitiesDestroyed;
   std::vector<Entity *> m_entitiesExterns;
   std::vector<Joint *> m_joints;
+
+  /* indexes for the ...ById() methods called by scripts at each step ;
+     rebuilt on demand when the lists change */
+  HashNamespace::unordered_map<std::string, Block *> m_blocksIndex;
+  HashNamespace::unordered_map<std::string, Entity *> m_entitiesIndex;
+  HashNamespace::unordered_map<std::string, Zone *> m_zonesIndex;
+  bool m_indexesUpToDate;
+  void invalidateIndexes();
+  void buildIndexes();
+
   Entity *m_startEntity; /* entity where the player start */
   bool m_isBodyLoaded;
   CollisionSystem *m_pCollisionSystem;
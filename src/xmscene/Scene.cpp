@@ -28,6 +28,8 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "Entity.h"
 #include "GhostTrail.h"
 #include "PhysicsSettings.h"
+#include "SceneProfiler.h"
+#include "SceneSnapshot.h"
 #include "ScriptTimer.h"
 #include "common/VFileIO.h"
 #include "helpers/Log.h"
@@ -43,6 +45,7 @@ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 #include "xmoto/Replay.h"
 #include "xmoto/ScriptDynamicObjects.h"
 #include "xmoto/Sound.h"
+#include <algorithm>
 
 #define GAMEMESSAGES_PACKTIME 40
 #define XM_PHYSICS_MD5 "b6822d58d992fbb0a7ef45eed71141e4"
@@ -73,9 +76,12 @@ Scene::Scene() {
   m_chipmunkWorld = NULL;
 
   m_halfUpdate = true;
+  m_randomCursor = 0;
   m_physicsSettings = NULL;
   m_ghostTrail = NULL;
   m_checkpoint = NULL;
+  m_profiler = NULL;
+  m_snapshots = NULL;
 }
 
 Scene::~Scene() {
@@ -311,6 +317,14 @@ void Scene::updateLevel(int timeStep,
     // however be true
     return;
 
+  /* the scenes are updated by any thread of the workers pool : each one
+     keeps its own random cursor */
+  NotSoRandom::setCursor(m_randomCursor);
+
+  if (m_profiler != NULL) {
+    m_profiler->start();
+  }
+
   if (m_halfUpdate == true) {
     getLevelSrc()->updateToTime(*this, m_physicsSettings, i_allowParticules);
     m_halfUpdate = false;
@@ -341,12 +355,25 @@ void Scene::updateLevel(int timeStep,
     m_time += timeStep;
   }
 
+  if (m_profiler != NULL) {
+    m_profiler->lap(SPS_LEVEL);
+  }
+
   /* Update misc stuff (only when not playing a replay) */
   if (m_playEvents) {
     getLevelSrc()->updatePhysics(
       m_time, timeStep, &m_Collision, m_chipmunkWorld, i_eventRecorder);
+    if (m_profiler != NULL) {
+      m_profiler->lap(SPS_PHYSICS);
+    }
     _UpdateZones();
+    if (m_profiler != NULL) {
+      m_profiler->lap(SPS_ZONES);
+    }
     _UpdateEntities();
+    if (m_profiler != NULL) {
+      m_profiler->lap(SPS_ENTITIES);
+    }
   }
 
   /* update ScriptTimers */
@@ -381,11 +408,19 @@ void Scene::updateLevel(int timeStep,
   }
   nextStateScriptDynamicObjects(v_nbCents);
 
+  if (m_profiler != NULL) {
+    m_profiler->lap(SPS_SCRIPTS);
+  }
+
   for (unsigned int i = 0; i < m_ghosts.size(); i++) {
     m_ghosts[i]->updateToTime(
       getTime(), timeStep, &m_Collision, m_PhysGravity, this);
   }
 
+  if (m_profiler != NULL) {
+    m_profiler->lap(SPS_GHOSTS);
+  }
+
   updatePlayers(timeStep, i_updateDiedPlayers);
 
   if (m_chipmunkWorld != NULL) {
@@ -393,10 +428,18 @@ void Scene::updateLevel(int timeStep,
     m_chipmunkWorld->updateWheelsPosition(m_players);
   }
 
+  if (m_profiler != NULL) {
+    m_profiler->lap(SPS_PLAYERS);
+  }
+
   // last thing is to execute all collected events. don't create events after
   // here
   executeEvents(i_eventRecorder);
 
+  if (m_profiler != NULL) {
+    m_profiler->lap(SPS_EVENTS);
+  }
+
   // record the replay only if
   v_recordReplay =
     i_frameRecorder != NULL &&
@@ -437,10 +480,12 @@ void Scene::updateLevel(int timeStep,
 
         if (v_uploadFrame && Players()[i]->localNetId() >= 0) {
           NA_frame na(&BikeState);
+          lockSharedResources();
           try {
             NetClient::instance()->send(&na, Players()[i]->localNetId());
           } catch (Exception &e) {
           }
+          unlockSharedResources();
         }
 
         if (v_recordReplay && i == 0) {
@@ -459,6 +504,16 @@ void Scene::updateLevel(int timeStep,
     _KillEntity(m_DelSchedule[i]);
   }
   m_DelSchedule.clear();
+
+  if (m_snapshots != NULL && m_snapshots->isTimeToSnapshot(m_time)) {
+    m_snapshots->add(takeSnapshot());
+  }
+
+  if (m_profiler != NULL) {
+    m_profiler->lap(SPS_RECORDING);
+  }
+
+  m_randomCursor = NotSoRandom::cursor();
 }
 
 void Scene::executeEvents_step(SceneEvent *pEvent, DBuffer *i_recorder) {
@@ -748,6 +803,10 @@ bool Scene::playInitLevelDone() const {
   return m_playInitLevel_done;
 }
 
+void Scene::setProfiler(SceneProfiler *i_profiler) {
+  m_profiler = i_profiler;
+}
+
 void Scene::playInitLevel() {
   /* Invoke the OnLoad() script function */
   if (m_playEvents) {
@@ -768,6 +827,13 @@ void Scene::playInitLevel() {
     }
   }
 
+  /* replay events can't be reverted, keep the state to be able to rewind */
+  if (m_playEvents == false &&
+      (m_pLevelSrc->isScripted() || m_pLevelSrc->isPhysics())) {
+    m_snapshots = new SceneSnapshots();
+    m_snapshots->add(takeSnapshot());
+  }
+
   m_playInitLevel_done = true;
 }
 
@@ -797,6 +863,11 @@ void Scene::endLevel(void) {
   /* clean Sdynamic objects for scripts */
   cleanScriptDynamicObjects();
 
+  if (m_snapshots != NULL) {
+    delete m_snapshots;
+    m_snapshots = NULL;
+  }
+
   /* clean event queue */
   cleanEventsQueue();
 
@@ -804,6 +875,12 @@ void Scene::endLevel(void) {
   cleanGhosts();
   cleanScriptTimers();
 
+  // the trail computation uses the physics settings
+  if (m_ghostTrail != NULL) {
+    delete m_ghostTrail;
+    m_ghostTrail = NULL;
+  }
+
   removeCameras();
 
   if (m_chipmunkWorld != NULL) {
@@ -1033,24 +1110,38 @@ bool Scene::touchEntityBodyExceptHead(const BikeState &pBike,
   Update zone specific stuff -- call scripts where needed
   ===========================================================================*/
 void Scene::_UpdateZones(void) {
-  /* Check player touching for each zone */
-  for (unsigned int i = 0; i < m_pLevelSrc->Zones().size(); i++) {
-    Zone *pZone = m_pLevelSrc->Zones()[i];
+  for (unsigned int j = 0; j < m_players.size(); j++) {
+    Biker *v_player = m_players[j];
 
-    for (unsigned int j = 0; j < m_players.size(); j++) {
-      Biker *v_player = m_players[j];
+    if (m_players[j]->isDead() == false) {
+      BikeState *v_state = v_player->getState();
+      float headSize = v_state->Parameters()->HeadSize();
+      float wheelRadius = v_state->Parameters()->WheelRadius();
+
+      /* Get the bounding box of the wheels and the head */
+      AABB BBox;
+      BBox.addPointToAABB2f(v_state->HeadP[0] - headSize,
+                            v_state->HeadP[1] - headSize);
+      BBox.addPointToAABB2f(v_state->HeadP[0] + headSize,
+                            v_state->HeadP[1] + headSize);
+      BBox.addPointToAABB2f(v_state->FrontWheelP[0] - wheelRadius,
+                            v_state->FrontWheelP[1] - wheelRadius);
+      BBox.addPointToAABB2f(v_state->FrontWheelP[0] + wheelRadius,
+                            v_state->FrontWheelP[1] + wheelRadius);
+      BBox.addPointToAABB2f(v_state->RearWheelP[0] - wheelRadius,
+                            v_state->RearWheelP[1] - wheelRadius);
+      BBox.addPointToAABB2f(v_state->RearWheelP[0] + wheelRadius,
+                            v_state->RearWheelP[1] + wheelRadius);
+
+      std::vector<Zone *> &zones = m_Collision.getZonesNearPosition(BBox);
+
+      for (unsigned int i = 0; i < zones.size(); i++) {
+        Zone *pZone = zones[i];
 
-      if (m_players[j]->isDead() == false) {
         /* Check it against the wheels and the head */
-        if (pZone->doesCircleTouch(
-              v_player->getState()->FrontWheelP,
-              v_player->getState()->Parameters()->WheelRadius()) ||
-            pZone->doesCircleTouch(
-              v_player->getState()->RearWheelP,
-              v_player->getState()->Parameters()->WheelRadius()) ||
-            pZone->doesCircleTouch(
-              v_player->getState()->HeadP,
-              v_player->getState()->Parameters()->HeadSize())) {
+        if (pZone->doesCircleTouch(v_state->FrontWheelP, wheelRadius) ||
+            pZone->doesCircleTouch(v_state->RearWheelP, wheelRadius) ||
+            pZone->doesCircleTouch(v_state->HeadP, headSize)) {
           /* In the zone -- did he just enter it? */
           if (v_player->setTouching(pZone, true) == PlayerLocalBiker::added) {
             createGameEvent(new MGE_PlayerEntersZone(getTime(), pZone, j));
@@ -1064,6 +1155,21 @@ void Scene::_UpdateZones(void) {
           }
         }
       }
+
+      /* zones touched during the last update but now too far to be in the
+         near ones have been left */
+      if (v_player->ZonesTouching().size() > 0) {
+        std::vector<Zone *> v_touching = v_player->ZonesTouching();
+
+        for (unsigned int i = 0; i < v_touching.size(); i++) {
+          if (std::find(zones.begin(), zones.end(), v_touching[i]) ==
+              zones.end()) {
+            v_player->setTouching(v_touching[i], false);
+            createGameEvent(
+              new MGE_PlayerLeavesZone(getTime(), v_touching[i], j));
+          }
+        }
+      }
     }
   }
 }
@@ -1204,7 +1310,9 @@ void Scene::touchEntity(int i_player, Entity *pEntity, bool bHead) {
       v_checkpoint->activate(m_pLevelSrc->EntitiesDestroyed(),
                              m_players[i_player]->getState()->Dir);
       if (m_motoGameHooks != NULL) {
+        lockSharedResources();
         m_motoGameHooks->OnTakeCheckpoint(i_player);
+        unlockSharedResources();
       }
       m_checkpoint = v_checkpoint;
     }
@@ -1435,7 +1543,9 @@ void Scene::killPlayer(int i_player) {
       m_players[i_player]->isFinished() == false) {
     m_players[i_player]->setDead(true, getTime());
     if (m_motoGameHooks != NULL) {
+      lockSharedResources();
       m_motoGameHooks->OnPlayerDies(i_player);
+      unlockSharedResources();
     }
     m_players[i_player]->setBodyDetach(true);
     m_players[i_player]->getControler()->stopControls();
@@ -1495,6 +1605,7 @@ void Scene::entityDestroyed(
     getLevelSrc()->spawnEntity(v_stars);
 
     if (m_motoGameHooks != NULL) {
+      lockSharedResources();
       m_motoGameHooks->OnEntityToTakeDestroyed();
 
       if (i_takenByPlayer == -1) {
@@ -1502,6 +1613,7 @@ void Scene::entityDestroyed(
       } else {
         m_motoGameHooks->OnEntityToTakeTakenByPlayer(i_takenByPlayer);
       }
+      unlockSharedResources();
     }
 
     /* update timediff */
@@ -1544,7 +1656,9 @@ void Scene::makePlayerWin(int i_player) {
       m_players[i_player]->isFinished() == false) {
     m_players[i_player]->setFinished(true, getTime());
     if (m_motoGameHooks != NULL) {
+      lockSharedResources();
       m_motoGameHooks->OnPlayerWins(i_player);
+      unlockSharedResources();
     }
   }
 }
@@ -1685,16 +1799,142 @@ void Scene::fastforward(int i_time) {
   m_time += i_time;
 }
 
-void Scene::fastrewind(int i_time) {
-  if (getLevelSrc() != NULL) {
-    if (getLevelSrc()->isScripted() == false &&
-        getLevelSrc()->isPhysics() == false) {
-      m_time -= i_time;
-      if (m_time < 0)
-        m_time = 0;
-      onRewinding();
+bool Scene::fastrewind(int i_time) {
+  if (getLevelSrc() == NULL) {
+    return false;
+  }
+
+  if (getLevelSrc()->isScripted() || getLevelSrc()->isPhysics()) {
+    return rewindToSnapshot(m_time - i_time);
+  }
+
+  m_time -= i_time;
+  if (m_time < 0)
+    m_time = 0;
+  onRewinding();
+  return true;
+}
+
+SceneSnapshot *Scene::takeSnapshot() {
+  SceneSnapshot *v_snapshot = new SceneSnapshot();
+  std::vector<Block *> &v_blocks = m_pLevelSrc->Blocks();
+
+  v_snapshot->time = m_time;
+  v_snapshot->lastCallToEveryHundreath = m_lastCallToEveryHundreath;
+  v_snapshot->halfUpdate = m_halfUpdate;
+  v_snapshot->gravity = m_PhysGravity;
+  v_snapshot->arrow = m_Arrow;
+
+  for (unsigned int i = 0; i < v_blocks.size(); i++) {
+    if (v_blocks[i]->isDynamic()) {
+      BlockSnapshot v_block;
+      v_block.block = v_blocks[i];
+      v_block.position = v_blocks[i]->DynamicPosition();
+      v_block.rotation = v_blocks[i]->DynamicRotation();
+      v_block.center = v_blocks[i]->DynamicRotationCenter();
+      v_snapshot->blocks.push_back(v_block);
+    }
+  }
+
+  // destroyed entities can come back while rewinding
+  for (unsigned int n = 0; n < 2; n++) {
+    std::vector<Entity *> &v_entities =
+      n == 0 ? m_pLevelSrc->Entities() : m_pLevelSrc->EntitiesDestroyed();
+
+    for (unsigned int i = 0; i < v_entities.size(); i++) {
+      EntitySnapshot v_entity;
+      v_entity.entity = v_entities[i];
+      v_entity.position = v_entities[i]->DynamicPosition();
+      v_entity.drawAngle = v_entities[i]->DrawAngle();
+      v_snapshot->entities.push_back(v_entity);
+    }
+  }
+
+  for (unsigned int i = 0; i < m_SDynamicObjects.size(); i++) {
+    v_snapshot->dynamicObjects.push_back(m_SDynamicObjects[i]->clone());
+  }
+
+  return v_snapshot;
+}
+
+void Scene::restoreSnapshot(SceneSnapshot *i_snapshot) {
+  /* first revert what can be reverted (ie destroyed entities) */
+  for (unsigned int i = 0; i < m_players.size(); i++) {
+    m_players[i]->onSnapshotRestored(i_snapshot->time, this);
+  }
+  for (unsigned int i = 0; i < m_ghosts.size(); i++) {
+    m_ghosts[i]->onSnapshotRestored(i_snapshot->time, this);
+  }
+  cleanEventsQueue();
+
+  m_time = i_snapshot->time;
+  m_lastCallToEveryHundreath = i_snapshot->lastCallToEveryHundreath;
+  m_halfUpdate = i_snapshot->halfUpdate;
+  m_Arrow = i_snapshot->arrow;
+  if (m_PhysGravity != i_snapshot->gravity) {
+    setGravity(i_snapshot->gravity.x, i_snapshot->gravity.y);
+  }
+
+  for (unsigned int i = 0; i < i_snapshot->blocks.size(); i++) {
+    BlockSnapshot &v_block = i_snapshot->blocks[i];
+
+    if (v_block.block->DynamicRotationCenter() != v_block.center) {
+      v_block.block->setCenter(v_block.center);
+    }
+    v_block.block->setDynamicPosition(v_block.position);
+    v_block.block->setDynamicRotation(v_block.rotation);
+    if (m_chipmunkWorld != NULL && v_block.block->isPhysics()) {
+      v_block.block->setPhysicsPosition(
+        v_block.block->DynamicPositionCenter().x + v_block.position.x,
+        v_block.block->DynamicPositionCenter().y + v_block.position.y);
     }
+    m_Collision.moveDynBlock(v_block.block);
+  }
+
+  for (unsigned int i = 0; i < i_snapshot->entities.size(); i++) {
+    EntitySnapshot &v_entity = i_snapshot->entities[i];
+
+    v_entity.entity->setDrawAngle(v_entity.drawAngle);
+    SetEntityPos(v_entity.entity, v_entity.position.x, v_entity.position.y);
   }
+
+  cleanScriptDynamicObjects();
+  for (unsigned int i = 0; i < i_snapshot->dynamicObjects.size(); i++) {
+    m_SDynamicObjects.push_back(i_snapshot->dynamicObjects[i]->clone());
+  }
+}
+
+bool Scene::rewindToSnapshot(int i_time) {
+  SceneSnapshot *v_snapshot;
+  float v_speed_factor = m_speed_factor;
+  bool v_is_paused = m_is_paused;
+
+  if (m_snapshots == NULL) {
+    return false;
+  }
+
+  if (i_time < 0) {
+    i_time = 0;
+  }
+
+  v_snapshot = m_snapshots->nearest(i_time);
+  if (v_snapshot == NULL) {
+    return false;
+  }
+
+  restoreSnapshot(v_snapshot);
+  onRewinding();
+
+  /* simulate again from the snapshot to the requested time */
+  m_speed_factor = 1.0;
+  m_is_paused = false;
+  while (m_time < i_time) {
+    updateLevel(PHYS_STEP_SIZE, NULL, NULL, true, false);
+  }
+  m_speed_factor = v_speed_factor;
+  m_is_paused = v_is_paused;
+
+  return true;
 }
 
 void Scene::onRewinding() {
@@ -1801,7 +2041,25 @@ void Scene::onSomersaultDone(unsigned int i_player, bool i_counterclock) {
                                            i_counterclock ? 1 : 0);
   getLuaLibGame()->scriptCallVoidNumberArg(
     "OnSomersaultBy", i_counterclock ? 1 : 0, i_player);
+
+  lockSharedResources();
   m_motoGameHooks->OnPlayerSomersault(i_player, i_counterclock);
+  unlockSharedResources();
+}
+
+static SDL_mutex *sharedResourcesMutex() {
+  // created at the first call, thread safe initialization
+  static SDL_mutex *v_mutex = SDL_CreateMutex();
+
+  return v_mutex;
+}
+
+void Scene::lockSharedResources() {
+  SDL_LockMutex(sharedResourcesMutex());
+}
+
+void Scene::unlockSharedResources() {
+  SDL_UnlockMutex(sharedResourcesMutex());
 }
 
 SceneOnBikerHooks::SceneOnBikerHooks(Scene *i_motoGame, int i_playerNumber) {
@@ -64,6 +64,9 @@ class Biker;
 class ChipmunkWorld;
 class PhysicsSettings;
 class ScriptTimer;
+class SceneProfiler;
+struct SceneSnapshot;
+class SceneSnapshots;
 class XMScreen;
 
 /*===========================================================================
@@ -189,6 +192,11 @@ public:
     std::vector<RecordedGameEvent *> *v_ReplayEvents,
     bool bDisplayInformation = false);
 
+  /* scenes can be updated in parallel ; what they share with the rest of
+     the game (hooks, sounds, music, input, network) is used under this lock */
+  static void lockSharedResources();
+  static void unlockSharedResources();
+
   /* events */
   void createGameEvent(SceneEvent *p_event);
   void destroyGameEvent(SceneEvent *p_event);
@@ -329,7 +337,7 @@ public:
   PhysicsSettings *getPhysicsSettings();
 
   void fastforward(int i_time);
-  void fastrewind(int i_time);
+  bool fastrewind(int i_time); /* false if the scene can't be rewound */
   void pause();
   void faster(float i_increment = REPLAY_SPEED_INCREMENT);
   void slower(float i_increment = REPLAY_SPEED_INCREMENT);
@@ -361,6 +369,10 @@ public:
   bool playInitLevelDone()
     const; /* return true if init level (ie OnLoad function) is done */
 
+  /* time spent in each part of updateLevel is added to i_profiler (NULL to
+   * disable) */
+  void setProfiler(SceneProfiler *i_profiler);
+
 private:
   /* Data */
   std::vector<SceneEvent *> m_GameEventQueue;
@@ -417,12 +429,20 @@ private:
   // some part of the game can be update only half on the time
   bool m_halfUpdate;
 
+  // random cursor of the scene, restored at each update
+  unsigned int m_randomCursor;
+
   // does the playInitLevel part it done ?
   bool m_playInitLevel_done;
 
   std::vector<Camera *> m_cameras;
   unsigned int m_currentCamera;
 
+  SceneProfiler *m_profiler;
+
+  /* to rewind replays of scripted and physics levels */
+  SceneSnapshots *m_snapshots;
+
   void cleanGhosts();
   void cleanPlayers();
 
@@ -441,6 +461,10 @@ private:
   void cleanScriptDynamicObjects();
   void nextStateScriptDynamicObjects(int i_nbCents);
 
+  SceneSnapshot *takeSnapshot();
+  void restoreSnapshot(SceneSnapshot *i_snapshot);
+  bool rewindToSnapshot(int i_time);
+
   void _UpdateDynamicCollisionLines(void);
 };
 
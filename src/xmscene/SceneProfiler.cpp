@@ -0,0 +1,89 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "SceneProfiler.h"
+
+SceneProfiler::SceneProfiler() {
+  reset();
+}
+
+void SceneProfiler::reset() {
+  for (unsigned int i = 0; i < SPS_NB; i++) {
+    m_times[i] = 0.0;
+  }
+  m_nbSteps = 0;
+  m_lastLap = std::chrono::steady_clock::now();
+}
+
+void SceneProfiler::start() {
+  m_nbSteps++;
+  m_lastLap = std::chrono::steady_clock::now();
+}
+
+void SceneProfiler::lap(SceneProfilerSection i_section) {
+  std::chrono::steady_clock::time_point v_now =
+    std::chrono::steady_clock::now();
+
+  m_times[i_section] +=
+    std::chrono::duration<double>(v_now - m_lastLap).count();
+  m_lastLap = v_now;
+}
+
+unsigned int SceneProfiler::nbSteps() const {
+  return m_nbSteps;
+}
+
+double SceneProfiler::sectionTime(SceneProfilerSection i_section) const {
+  return m_times[i_section];
+}
+
+double SceneProfiler::totalTime() const {
+  double v_total = 0.0;
+
+  for (unsigned int i = 0; i < SPS_NB; i++) {
+    v_total += m_times[i];
+  }
+  return v_total;
+}
+
+const char *SceneProfiler::sectionName(SceneProfilerSection i_section) {
+  switch (i_section) {
+    case SPS_LEVEL:
+      return "level";
+    case SPS_PHYSICS:
+      return "physics blocks";
+    case SPS_ZONES:
+      return "zones";
+    case SPS_ENTITIES:
+      return "entities";
+    case SPS_SCRIPTS:
+      return "scripts";
+    case SPS_GHOSTS:
+      return "ghosts";
+    case SPS_PLAYERS:
+      return "players";
+    case SPS_EVENTS:
+      return "events";
+    case SPS_RECORDING:
+      return "recording";
+    default:
+      return "?";
+  }
+}
@@ -0,0 +1,65 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __SCENEPROFILER_H__
+#define __SCENEPROFILER_H__
+
+#include <chrono>
+
+/* parts of Scene::updateLevel, in the order they are run */
+enum SceneProfilerSection {
+  SPS_LEVEL,
+  SPS_PHYSICS,
+  SPS_ZONES,
+  SPS_ENTITIES,
+  SPS_SCRIPTS,
+  SPS_GHOSTS,
+  SPS_PLAYERS,
+  SPS_EVENTS,
+  SPS_RECORDING,
+  SPS_NB
+};
+
+/*===========================================================================
+  Accumulates the time spent in each part of the scene update
+  ===========================================================================*/
+class SceneProfiler {
+public:
+  SceneProfiler();
+
+  void reset();
+
+  /* call at the beginning of an update, then lap() after each section */
+  void start();
+  void lap(SceneProfilerSection i_section);
+
+  unsigned int nbSteps() const;
+  double sectionTime(SceneProfilerSection i_section) const; /* in seconds */
+  double totalTime() const;
+
+  static const char *sectionName(SceneProfilerSection i_section);
+
+private:
+  std::chrono::steady_clock::time_point m_lastLap;
+  double m_times[SPS_NB];
+  unsigned int m_nbSteps;
+};
+
+#endif
@@ -0,0 +1,86 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#include "SceneSnapshot.h"
+#include "xmoto/ScriptDynamicObjects.h"
+
+SceneSnapshot::SceneSnapshot() {
+  time = 0;
+  lastCallToEveryHundreath = 0;
+  halfUpdate = false;
+}
+
+SceneSnapshot::~SceneSnapshot() {
+  for (unsigned int i = 0; i < dynamicObjects.size(); i++) {
+    delete dynamicObjects[i];
+  }
+}
+
+SceneSnapshots::SceneSnapshots() {
+  m_first = 0;
+}
+
+SceneSnapshots::~SceneSnapshots() {
+  clear();
+}
+
+void SceneSnapshots::clear() {
+  for (unsigned int i = 0; i < m_snapshots.size(); i++) {
+    delete m_snapshots[i];
+  }
+  m_snapshots.clear();
+  m_first = 0;
+}
+
+bool SceneSnapshots::isTimeToSnapshot(int i_time) const {
+  if (m_snapshots.size() == 0) {
+    return true;
+  }
+
+  // after a rewind, the snapshots of the next times are still valid
+  int v_last = m_snapshots[(m_first + m_snapshots.size() - 1) %
+                           m_snapshots.size()]->time;
+  return i_time >= v_last + SCENE_SNAPSHOT_INTERVAL;
+}
+
+void SceneSnapshots::add(SceneSnapshot *i_snapshot) {
+  if (m_snapshots.size() < SCENE_SNAPSHOT_MAX) {
+    m_snapshots.push_back(i_snapshot);
+    return;
+  }
+
+  delete m_snapshots[m_first];
+  m_snapshots[m_first] = i_snapshot;
+  m_first = (m_first + 1) % m_snapshots.size();
+}
+
+SceneSnapshot *SceneSnapshots::nearest(int i_time) const {
+  SceneSnapshot *v_nearest = NULL;
+
+  for (unsigned int i = 0; i < m_snapshots.size(); i++) {
+    SceneSnapshot *v_snapshot = m_snapshots[(m_first + i) % m_snapshots.size()];
+    if (v_snapshot->time > i_time) {
+      break;
+    }
+    v_nearest = v_snapshot;
+  }
+
+  return v_nearest;
+}
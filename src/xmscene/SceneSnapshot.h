@@ -0,0 +1,91 @@
+/*=============================================================================
+XMOTO
+
+This file is part of XMOTO.
+
+XMOTO is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+XMOTO is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with XMOTO; if not, write to the Free Software
+Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+=============================================================================*/
+
+#ifndef __SCENESNAPSHOT_H__
+#define __SCENESNAPSHOT_H__
+
+#include "Scene.h"
+#include "helpers/VMath.h"
+#include <vector>
+
+/* hundredths between two snapshots */
+#define SCENE_SNAPSHOT_INTERVAL 100
+/* number of snapshots kept (5 minutes of game time) */
+#define SCENE_SNAPSHOT_MAX 300
+
+class Block;
+class Entity;
+class SDynamicObject;
+
+struct BlockSnapshot {
+  Block *block;
+  Vector2f position;
+  float rotation;
+  Vector2f center;
+};
+
+struct EntitySnapshot {
+  Entity *entity;
+  Vector2f position;
+  float drawAngle;
+};
+
+/*===========================================================================
+  State of a scene playing a replay which can't be computed backwards: the
+  replay events (block moves, gravity, dynamic objects...) are only played
+  forward
+  ===========================================================================*/
+struct SceneSnapshot {
+  SceneSnapshot();
+  ~SceneSnapshot();
+
+  int time;
+  int lastCallToEveryHundreath;
+  bool halfUpdate;
+  Vector2f gravity;
+  ArrowPointer arrow;
+  std::vector<BlockSnapshot> blocks;
+  std::vector<EntitySnapshot> entities;
+  std::vector<SDynamicObject *> dynamicObjects; /* owned copies */
+};
+
+/*===========================================================================
+  Ring buffer of the snapshots taken while a replay is played
+  ===========================================================================*/
+class SceneSnapshots {
+public:
+  SceneSnapshots();
+  ~SceneSnapshots();
+
+  void clear();
+
+  /* true if a snapshot must be taken at i_time */
+  bool isTimeToSnapshot(int i_time) const;
+  /* the oldest snapshot is removed when the buffer is full */
+  void add(SceneSnapshot *i_snapshot);
+  /* most recent snapshot taken at or before i_time, NULL if none */
+  SceneSnapshot *nearest(int i_time) const;
+
+private:
+  std::vector<SceneSnapshot *> m_snapshots;
+  unsigned int m_first; /* oldest snapshot once the buffer is full */
+};
+
+#endif
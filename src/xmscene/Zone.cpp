@@ -58,6 +58,11 @@ bool ZonePrimBox::doesCircleTouch(const Vector2f &i_cp, float i_cr) {
   return false;
 }
 
+void ZonePrimBox::addToAABB(AABB &io_bbox) const {
+  io_bbox.addPointToAABB2f(m_left, m_bottom);
+  io_bbox.addPointToAABB2f(m_right, m_top);
+}
+
 float ZonePrimBox::Left() const {
   return m_left;
 }
@@ -92,6 +97,13 @@ std::vector<ZonePrim *> &Zone::Prims() {
   return m_prims;
 }
 
+void Zone::updateAABB() {
+  m_BBox.reset();
+  for (unsigned int i = 0; i < m_prims.size(); i++) {
+    m_prims[i]->addToAABB(m_BBox);
+  }
+}
+
 /*===========================================================================
   Check whether the given circle touches the zone
   ===========================================================================*/
@@ -116,6 +128,7 @@ Zone *Zone::readFromXml(xmlNodePtr pElem) {
        pSubElem = XMLDocument::nextElement(pSubElem)) {
     v_zone->m_prims.push_back(ZonePrimBox::readFromXml(pSubElem));
   }
+  v_zone->updateAABB();
 
   return v_zone;
 }
@@ -152,6 +165,7 @@ Zone *Zone::readFromBinary(FileHandle *i_pfh) {
         break;
     }
   }
+  v_zone->updateAABB();
 
   return v_zone;
 }
@@ -39,6 +39,7 @@ public:
   virtual bool doesCircleTouch(const Vector2f &i_cp, float i_cr) = 0;
   virtual void saveBinary(FileHandle *i_pfh) = 0;
   virtual ZonePrimType Type() const = 0;
+  virtual void addToAABB(AABB &io_bbox) const = 0;
   static ZonePrim *readFromBinary(FileHandle *i_pfh);
 };
 
@@ -50,6 +51,7 @@ public:
   virtual bool doesCircleTouch(const Vector2f &i_cp, float i_cr);
   virtual void saveBinary(FileHandle *i_pfh);
   virtual ZonePrimType Type() const;
+  virtual void addToAABB(AABB &io_bbox) const;
   static ZonePrim *readFromXml(xmlNodePtr pElem);
   static ZonePrim *readFromBinary(FileHandle *i_pfh);
 
@@ -79,6 +81,8 @@ public:
   AABB &getAABB() { return m_BBox; }
 
 private:
+  void updateAABB();
+
   std::string m_id; /* Zone ID */
   std::vector<ZonePrim *> m_prims; /* Primitives forming zone */
   AABB m_BBox;